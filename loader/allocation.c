@@ -28,6 +28,8 @@
 
 #include <stdlib.h>
 
+#include "loader_environment.h"
+
 // A debug option to disable allocators at compile time to investigate future issues.
 #define DEBUG_DISABLE_APP_ALLOCATORS 0
 
@@ -107,19 +109,245 @@ void *loader_realloc(const VkAllocationCallbacks *pAllocator, void *pMemory, siz
     return pNewMem;
 }
 
+// Instance arena
+//
+// While an instance is being created, its INSTANCE and COMMAND scoped allocations are carved out of large chunks which are
+// themselves allocated with the instance's allocator. Every block is preceded by its size, which lets the most recent block
+// be freed or grown in place. Any other block is only reclaimed when the whole arena is released in vkDestroyInstance.
+// Once creation finishes the arena is sealed: blocks it handed out stay valid, but new allocations go back to the regular
+// allocator so the arena can't keep growing for the lifetime of the instance.
+
+#define LOADER_ARENA_CHUNK_SIZE (64 * 1024)
+// Anything larger than this goes straight to the instance allocator to not waste the remainder of a chunk
+#define LOADER_ARENA_MAX_BLOCK_SIZE (LOADER_ARENA_CHUNK_SIZE / 8)
+#define LOADER_ARENA_BLOCK_HEADER_SIZE sizeof(uint64_t)
+
+struct loader_arena_chunk {
+    struct loader_arena_chunk *next;
+    size_t capacity;
+    size_t used;
+    bool has_last_block;       // false once the most recent block was freed, as the one before it isn't tracked
+    size_t last_block_offset;  // offset of the most recent block's header
+    // Block storage follows, starting at loader_arena_chunk_data()
+};
+
+struct loader_instance_arena {
+    loader_platform_thread_mutex lock;
+    bool sealed;
+    struct loader_arena_chunk *chunks;  // newest first, only the newest chunk hands out new blocks
+};
+
+static uint8_t *loader_arena_chunk_data(struct loader_arena_chunk *chunk) {
+    return (uint8_t *)chunk + loader_aligned_size(sizeof(struct loader_arena_chunk));
+}
+
+static bool loader_arena_handles_scope(VkSystemAllocationScope allocation_scope) {
+    return allocation_scope == VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE || allocation_scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND;
+}
+
+// Returns the chunk pMemory was carved from, or NULL if it didn't come from the arena. Must hold arena->lock.
+static struct loader_arena_chunk *loader_arena_find_chunk(struct loader_instance_arena *arena, const void *pMemory) {
+    for (struct loader_arena_chunk *chunk = arena->chunks; NULL != chunk; chunk = chunk->next) {
+        const uint8_t *data = loader_arena_chunk_data(chunk);
+        if ((const uint8_t *)pMemory >= data && (const uint8_t *)pMemory < data + chunk->capacity) {
+            return chunk;
+        }
+    }
+    return NULL;
+}
+
+static bool loader_arena_is_last_block(struct loader_instance_arena *arena, struct loader_arena_chunk *chunk, const void *pMemory) {
+    return chunk == arena->chunks && chunk->has_last_block &&
+           loader_arena_chunk_data(chunk) + chunk->last_block_offset + LOADER_ARENA_BLOCK_HEADER_SIZE == (const uint8_t *)pMemory;
+}
+
+// Returns NULL if the block has to come from the regular allocator instead. Must hold arena->lock.
+static void *loader_arena_alloc_block(const struct loader_instance *inst, struct loader_instance_arena *arena, size_t size,
+                                      VkSystemAllocationScope allocation_scope, bool *out_of_memory) {
+    *out_of_memory = false;
+    if (arena->sealed || size == 0 || size > LOADER_ARENA_MAX_BLOCK_SIZE || !loader_arena_handles_scope(allocation_scope)) {
+        return NULL;
+    }
+    size_t block_size = LOADER_ARENA_BLOCK_HEADER_SIZE + loader_aligned_size(size);
+    struct loader_arena_chunk *chunk = arena->chunks;
+    if (NULL == chunk || chunk->capacity - chunk->used < block_size) {
+        chunk = loader_alloc(&inst->alloc_callbacks,
+                             loader_aligned_size(sizeof(struct loader_arena_chunk)) + LOADER_ARENA_CHUNK_SIZE,
+                             VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == chunk) {
+            *out_of_memory = true;
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        chunk->capacity = LOADER_ARENA_CHUNK_SIZE;
+        chunk->used = 0;
+        chunk->has_last_block = false;
+        chunk->last_block_offset = 0;
+        arena->chunks = chunk;
+    }
+    uint8_t *header = loader_arena_chunk_data(chunk) + chunk->used;
+    *(uint64_t *)header = (uint64_t)loader_aligned_size(size);
+    chunk->has_last_block = true;
+    chunk->last_block_offset = chunk->used;
+    chunk->used += block_size;
+    return header + LOADER_ARENA_BLOCK_HEADER_SIZE;
+}
+
+static void *loader_arena_alloc(const struct loader_instance *inst, size_t size, VkSystemAllocationScope allocation_scope,
+                                bool zero_memory) {
+    struct loader_instance_arena *arena = inst->arena;
+    bool out_of_memory = false;
+    loader_platform_thread_lock_mutex(&arena->lock);
+    void *pMemory = loader_arena_alloc_block(inst, arena, size, allocation_scope, &out_of_memory);
+    loader_platform_thread_unlock_mutex(&arena->lock);
+    if (NULL != pMemory) {
+        if (zero_memory) {
+            memset(pMemory, 0, size);
+        }
+        return pMemory;
+    }
+    if (out_of_memory) {
+        return NULL;
+    }
+    return zero_memory ? loader_calloc(&inst->alloc_callbacks, size, allocation_scope)
+                       : loader_alloc(&inst->alloc_callbacks, size, allocation_scope);
+}
+
+static void loader_arena_free(const struct loader_instance *inst, void *pMemory) {
+    if (NULL == pMemory) {
+        return;
+    }
+    struct loader_instance_arena *arena = inst->arena;
+    loader_platform_thread_lock_mutex(&arena->lock);
+    struct loader_arena_chunk *chunk = loader_arena_find_chunk(arena, pMemory);
+    if (NULL != chunk && loader_arena_is_last_block(arena, chunk, pMemory)) {
+        // Hand the most recent block back so short lived allocations don't use up the chunk
+        chunk->used = chunk->last_block_offset;
+        chunk->has_last_block = false;
+    }
+    loader_platform_thread_unlock_mutex(&arena->lock);
+    if (NULL == chunk) {
+        loader_free(&inst->alloc_callbacks, pMemory);
+    }
+}
+
+static void *loader_arena_realloc(const struct loader_instance *inst, void *pMemory, size_t orig_size, size_t size,
+                                  VkSystemAllocationScope allocation_scope) {
+    if (pMemory == NULL || orig_size == 0) {
+        return loader_arena_alloc(inst, size, allocation_scope, false);
+    }
+    if (size == 0) {
+        loader_arena_free(inst, pMemory);
+        return NULL;
+    }
+
+    struct loader_instance_arena *arena = inst->arena;
+    loader_platform_thread_lock_mutex(&arena->lock);
+    struct loader_arena_chunk *chunk = loader_arena_find_chunk(arena, pMemory);
+    if (NULL == chunk) {
+        loader_platform_thread_unlock_mutex(&arena->lock);
+        return loader_realloc(&inst->alloc_callbacks, pMemory, orig_size, size, allocation_scope);
+    }
+
+    uint64_t *header = (uint64_t *)((uint8_t *)pMemory - LOADER_ARENA_BLOCK_HEADER_SIZE);
+    size_t block_size = (size_t)*header;
+    size_t copy_size = orig_size < block_size ? orig_size : block_size;
+    void *pNewMem = NULL;
+    if (size <= block_size) {
+        pNewMem = pMemory;
+    } else if (!arena->sealed && loader_arena_is_last_block(arena, chunk, pMemory) &&
+               chunk->capacity - chunk->last_block_offset >= LOADER_ARENA_BLOCK_HEADER_SIZE + loader_aligned_size(size)) {
+        // Grow the most recent block in place
+        *header = (uint64_t)loader_aligned_size(size);
+        chunk->used = chunk->last_block_offset + LOADER_ARENA_BLOCK_HEADER_SIZE + loader_aligned_size(size);
+        pNewMem = pMemory;
+    }
+    loader_platform_thread_unlock_mutex(&arena->lock);
+
+    if (NULL == pNewMem) {
+        pNewMem = loader_arena_alloc(inst, size, allocation_scope, false);
+        if (NULL == pNewMem) {
+            return NULL;
+        }
+        memcpy(pNewMem, pMemory, copy_size);
+        loader_arena_free(inst, pMemory);
+    }
+    // Match loader_realloc, which clears out the newly allocated memory
+    if (size > copy_size) {
+        memset((uint8_t *)pNewMem + copy_size, 0, size - copy_size);
+    }
+    return pNewMem;
+}
+
+bool loader_instance_arena_enabled(const struct loader_instance *inst) {
+    char *env_value = loader_getenv(VK_LOADER_INSTANCE_ARENA_ENV_VAR, inst);
+    // NOLINTNEXTLINE(bugprone-not-null-terminated-result) - n=2 intentionally excludes "1x" values like "10"
+    bool enabled = NULL != env_value && 0 == strncmp(env_value, "1", 2);
+    loader_free_getenv(env_value, inst);
+    return enabled;
+}
+
+VkResult loader_instance_arena_create(struct loader_instance *inst) {
+    struct loader_instance_arena *arena =
+        loader_calloc(&inst->alloc_callbacks, sizeof(struct loader_instance_arena), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (NULL == arena) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    loader_platform_thread_create_mutex(&arena->lock);
+    inst->arena = arena;
+    return VK_SUCCESS;
+}
+
+void loader_instance_arena_seal(struct loader_instance *inst) {
+    if (NULL == inst->arena) {
+        return;
+    }
+    loader_platform_thread_lock_mutex(&inst->arena->lock);
+    inst->arena->sealed = true;
+    loader_platform_thread_unlock_mutex(&inst->arena->lock);
+}
+
+void loader_instance_arena_destroy(struct loader_instance *inst) {
+    struct loader_instance_arena *arena = inst->arena;
+    if (NULL == arena) {
+        return;
+    }
+    inst->arena = NULL;
+    while (NULL != arena->chunks) {
+        struct loader_arena_chunk *next = arena->chunks->next;
+        loader_free(&inst->alloc_callbacks, arena->chunks);
+        arena->chunks = next;
+    }
+    loader_platform_thread_delete_mutex(&arena->lock);
+    loader_free(&inst->alloc_callbacks, arena);
+}
+
 void *loader_instance_heap_alloc(const struct loader_instance *inst, size_t size, VkSystemAllocationScope allocation_scope) {
+    if (inst && inst->arena) {
+        return loader_arena_alloc(inst, size, allocation_scope, false);
+    }
     return loader_alloc(inst ? &inst->alloc_callbacks : NULL, size, allocation_scope);
 }
 
 void *loader_instance_heap_calloc(const struct loader_instance *inst, size_t size, VkSystemAllocationScope allocation_scope) {
+    if (inst && inst->arena) {
+        return loader_arena_alloc(inst, size, allocation_scope, true);
+    }
     return loader_calloc(inst ? &inst->alloc_callbacks : NULL, size, allocation_scope);
 }
 
 void loader_instance_heap_free(const struct loader_instance *inst, void *pMemory) {
+    if (inst && inst->arena) {
+        loader_arena_free(inst, pMemory);
+        return;
+    }
     loader_free(inst ? &inst->alloc_callbacks : NULL, pMemory);
 }
 void *loader_instance_heap_realloc(const struct loader_instance *inst, void *pMemory, size_t orig_size, size_t size,
                                    VkSystemAllocationScope allocation_scope) {
+    if (inst && inst->arena) {
+        return loader_arena_realloc(inst, pMemory, orig_size, size, allocation_scope);
+    }
     return loader_realloc(inst ? &inst->alloc_callbacks : NULL, pMemory, orig_size, size, allocation_scope);
 }
 
@@ -141,21 +369,34 @@ void *loader_device_heap_realloc(const struct loader_device *dev, void *pMemory,
 
 void *loader_alloc_with_instance_fallback(const VkAllocationCallbacks *pAllocator, const struct loader_instance *inst, size_t size,
                                           VkSystemAllocationScope allocation_scope) {
+    if (NULL == pAllocator && NULL != inst->arena) {
+        return loader_arena_alloc(inst, size, allocation_scope, false);
+    }
     return loader_alloc(NULL != pAllocator ? pAllocator : &inst->alloc_callbacks, size, allocation_scope);
 }
 
 void *loader_calloc_with_instance_fallback(const VkAllocationCallbacks *pAllocator, const struct loader_instance *instance,
                                            size_t size, VkSystemAllocationScope allocation_scope) {
+    if (NULL == pAllocator && NULL != instance->arena) {
+        return loader_arena_alloc(instance, size, allocation_scope, true);
+    }
     return loader_calloc(NULL != pAllocator ? pAllocator : &instance->alloc_callbacks, size, allocation_scope);
 }
 
 void loader_free_with_instance_fallback(const VkAllocationCallbacks *pAllocator, const struct loader_instance *instance,
                                         void *pMemory) {
+    if (NULL == pAllocator && NULL != instance->arena) {
+        loader_arena_free(instance, pMemory);
+        return;
+    }
     loader_free(NULL != pAllocator ? pAllocator : &instance->alloc_callbacks, pMemory);
 }
 
 void *loader_realloc_with_instance_fallback(const VkAllocationCallbacks *pAllocator, const struct loader_instance *instance,
                                             void *pMemory, size_t orig_size, size_t size,
                                             VkSystemAllocationScope allocation_scope) {
+    if (NULL == pAllocator && NULL != instance->arena) {
+        return loader_arena_realloc(instance, pMemory, orig_size, size, allocation_scope);
+    }
     return loader_realloc(NULL != pAllocator ? pAllocator : &instance->alloc_callbacks, pMemory, orig_size, size, allocation_scope);
 }
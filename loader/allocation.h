@@ -39,6 +39,14 @@ void loader_instance_heap_free(const struct loader_instance *instance, void *pMe
 void *loader_instance_heap_realloc(const struct loader_instance *instance, void *pMemory, size_t orig_size, size_t size,
                                    VkSystemAllocationScope allocation_scope);
 
+// Optional arena which serves the instance's INSTANCE and COMMAND scoped allocations from large chunks while it is being created,
+// enabled with VK_LOADER_INSTANCE_ARENA=1. The chunks come from the instance's allocator and are released in vkDestroyInstance.
+bool loader_instance_arena_enabled(const struct loader_instance *inst);
+VkResult loader_instance_arena_create(struct loader_instance *inst);
+// Stop serving new allocations from the arena, blocks already handed out stay valid until loader_instance_arena_destroy
+void loader_instance_arena_seal(struct loader_instance *inst);
+void loader_instance_arena_destroy(struct loader_instance *inst);
+
 void *loader_device_heap_alloc(const struct loader_device *device, size_t size, VkSystemAllocationScope allocationScope);
 void *loader_device_heap_calloc(const struct loader_device *device, size_t size, VkSystemAllocationScope allocationScope);
 void loader_device_heap_free(const struct loader_device *device, void *pMemory);
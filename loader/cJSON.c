@@ -138,6 +138,16 @@ static int case_insensitive_strcmp(const unsigned char *string1, const unsigned
 /* strlen of character literals resolved at compile time */
 #define static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
+/* Values of cJSON.in_situ. The root of an in situ parse is allocated with an in_situ_root_buffer right after it. */
+#define CJSON_IN_SITU_ITEM 1
+#define CJSON_IN_SITU_ROOT 2
+
+typedef struct {
+    void *buffer;
+    size_t length;
+    loader_cJSON_ReleaseBuffer release_buffer;
+} in_situ_root_buffer;
+
 /* Internal constructor. */
 static cJSON *cJSON_New_Item(const VkAllocationCallbacks *pAllocator) {
     cJSON *node = (cJSON *)loader_calloc(pAllocator, sizeof(cJSON), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
@@ -155,15 +165,29 @@ TEST_FUNCTION_EXPORT CJSON_PUBLIC(void) loader_cJSON_Delete(cJSON *item) {
         if (!(item->type & cJSON_IsReference) && (item->child != NULL)) {
             loader_cJSON_Delete(item->child);
         }
+        /* strings of in situ items live in the parsed buffer */
         if (!(item->type & cJSON_IsReference) && (item->valuestring != NULL)) {
-            loader_free(item->pAllocator, item->valuestring);
+            if (!item->in_situ) {
+                loader_free(item->pAllocator, item->valuestring);
+            }
             item->valuestring = NULL;
         }
         if (!(item->type & cJSON_StringIsConst) && (item->string != NULL)) {
-            loader_free(item->pAllocator, item->string);
+            if (!item->in_situ) {
+                loader_free(item->pAllocator, item->string);
+            }
             item->string = NULL;
         }
-        loader_free(item->pAllocator, item);
+        if (item->in_situ == CJSON_IN_SITU_ROOT) {
+            in_situ_root_buffer root_buffer = *(in_situ_root_buffer *)(item + 1);
+            const VkAllocationCallbacks *pAllocator = item->pAllocator;
+            loader_free(pAllocator, item);
+            if (root_buffer.release_buffer != NULL) {
+                root_buffer.release_buffer(pAllocator, root_buffer.buffer, root_buffer.length);
+            }
+        } else {
+            loader_free(item->pAllocator, item);
+        }
         item = next;
     }
 }
@@ -184,6 +208,7 @@ typedef struct {
     size_t offset;
     size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
     const VkAllocationCallbacks *pAllocator;
+    cJSON_bool in_situ; /* content is writable and strings are unescaped into it, see loader_cJSON_ParseInSitu */
 } parse_buffer;
 
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
@@ -561,13 +586,19 @@ static cJSON_bool parse_string(cJSON *const item, parse_buffer *const input_buff
             goto fail; /* string ended unexpectedly */
         }
 
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t)(input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char *)loader_calloc(input_buffer->pAllocator, allocation_length + sizeof(""),
-                                                VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
-        if (output == NULL) {
-            *out_of_memory = true;
-            goto fail; /* allocation failure */
+        if (input_buffer->in_situ) {
+            /* Unescaping never makes the string longer, so it is written over the literal itself and the terminator
+             * lands at the latest on the closing quote. */
+            output = (unsigned char *)buffer_at_offset(input_buffer) + 1;
+        } else {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t)(input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
+            output = (unsigned char *)loader_calloc(input_buffer->pAllocator, allocation_length + sizeof(""),
+                                                    VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+            if (output == NULL) {
+                *out_of_memory = true;
+                goto fail; /* allocation failure */
+            }
         }
     }
 
@@ -634,7 +665,7 @@ static cJSON_bool parse_string(cJSON *const item, parse_buffer *const input_buff
     return true;
 
 fail:
-    if (output != NULL) {
+    if (output != NULL && !input_buffer->in_situ) {
         loader_free(input_buffer->pAllocator, output);
         output = NULL;
     }
@@ -822,7 +853,7 @@ loader_cJSON_ParseWithOpts(const VkAllocationCallbacks *pAllocator, const char *
 CJSON_PUBLIC(cJSON *)
 loader_cJSON_ParseWithLengthOpts(const VkAllocationCallbacks *pAllocator, const char *value, size_t buffer_length,
                                  const char **return_parse_end, cJSON_bool require_null_terminated, bool *out_of_memory) {
-    parse_buffer buffer = {0, 0, 0, 0, 0};
+    parse_buffer buffer = {0, 0, 0, 0, 0, 0};
     cJSON *item = NULL;
 
     /* reset error position */
@@ -889,6 +920,44 @@ fail:
     return NULL;
 }
 
+CJSON_PUBLIC(cJSON *)
+loader_cJSON_ParseInSitu(const VkAllocationCallbacks *pAllocator, char *buffer, size_t buffer_length,
+                         loader_cJSON_ReleaseBuffer release_buffer, bool *out_of_memory) {
+    parse_buffer input = {0, 0, 0, 0, 0, 0};
+    cJSON *item = NULL;
+
+    if (buffer == NULL || 0 == buffer_length) {
+        return NULL;
+    }
+
+    input.content = (const unsigned char *)buffer;
+    input.length = buffer_length;
+    input.offset = 0;
+    input.pAllocator = pAllocator;
+    input.in_situ = true;
+
+    /* The root carries the buffer it owns right behind it */
+    item = (cJSON *)loader_calloc(pAllocator, sizeof(cJSON) + sizeof(in_situ_root_buffer), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (item == NULL) {
+        *out_of_memory = true;
+        return NULL;
+    }
+    item->pAllocator = pAllocator;
+    item->in_situ = CJSON_IN_SITU_ROOT;
+
+    if (!parse_value(item, buffer_skip_whitespace(skip_utf8_bom(&input)), out_of_memory)) {
+        /* release_buffer isn't set yet, so the caller keeps the buffer */
+        loader_cJSON_Delete(item);
+        return NULL;
+    }
+
+    in_situ_root_buffer *root_buffer = (in_situ_root_buffer *)(item + 1);
+    root_buffer->buffer = buffer;
+    root_buffer->length = buffer_length;
+    root_buffer->release_buffer = release_buffer;
+    return item;
+}
+
 /* Default options for loader_cJSON_Parse */
 CJSON_PUBLIC(cJSON *) loader_cJSON_Parse(const VkAllocationCallbacks *pAllocator, const char *value, bool *out_of_memory) {
     return loader_cJSON_ParseWithOpts(pAllocator, value, 0, 0, out_of_memory);
@@ -1155,6 +1224,9 @@ static cJSON_bool parse_array(cJSON *const item, parse_buffer *const input_buffe
             *out_of_memory = true;
             goto fail; /* allocation failure */
         }
+        if (input_buffer->in_situ) {
+            new_item->in_situ = CJSON_IN_SITU_ITEM;
+        }
 
         /* attach next item to list */
         if (head == NULL) {
@@ -1291,6 +1363,9 @@ static cJSON_bool parse_object(cJSON *const item, parse_buffer *const input_buff
             *out_of_memory = true;
             goto fail; /* allocation failure */
         }
+        if (input_buffer->in_situ) {
+            new_item->in_situ = CJSON_IN_SITU_ITEM;
+        }
 
         /* attach next item to list */
         if (head == NULL) {
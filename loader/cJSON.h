@@ -116,6 +116,8 @@ typedef struct cJSON {
 
     /* The type of the item, as above. */
     int type;
+    /* Set when the item was parsed by loader_cJSON_ParseInSitu: valuestring and string point into the parsed buffer. */
+    int in_situ;
 
     /* The item's string, if type==cJSON_String  and type == cJSON_Raw */
     char *valuestring;
@@ -162,6 +164,13 @@ loader_cJSON_ParseWithOpts(const struct VkAllocationCallbacks *pAllocator, const
 CJSON_PUBLIC(cJSON *)
 loader_cJSON_ParseWithLengthOpts(const struct VkAllocationCallbacks *pAllocator, const char *value, size_t buffer_length,
                                  const char **return_parse_end, cJSON_bool require_null_terminated, bool *out_of_memory);
+/* Parse a writable buffer in place: strings are unescaped into the buffer itself and the items reference them instead of
+ * allocating copies. On success the returned root takes ownership of the buffer and loader_cJSON_Delete hands it to
+ * release_buffer. On failure the buffer, whose contents may have been modified, still belongs to the caller. */
+typedef void (*loader_cJSON_ReleaseBuffer)(const struct VkAllocationCallbacks *pAllocator, void *buffer, size_t buffer_length);
+CJSON_PUBLIC(cJSON *)
+loader_cJSON_ParseInSitu(const struct VkAllocationCallbacks *pAllocator, char *buffer, size_t buffer_length,
+                         loader_cJSON_ReleaseBuffer release_buffer, bool *out_of_memory);
 
 /* Render a cJSON entity to text for transfer/storage. */
 TEST_FUNCTION_EXPORT CJSON_PUBLIC(char *) loader_cJSON_Print(const cJSON *item, bool *out_of_memory);
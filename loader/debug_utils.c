@@ -58,6 +58,7 @@ VkResult util_CreateDebugUtilsMessenger(struct loader_instance *inst, const VkDe
     new_dbg_function_node->pNext = inst->instance_only_dbg_function_head;
     inst->instance_only_dbg_function_head = new_dbg_function_node;
     inst->current_dbg_function_head = inst->instance_only_dbg_function_head;
+    util_UpdateDebugMessageFilter(inst);
 
     return VK_SUCCESS;
 }
@@ -108,6 +109,35 @@ VkBool32 util_SubmitDebugUtilsMessageEXT(const struct loader_instance *inst, VkD
     return bail;
 }
 
+void util_UpdateDebugMessageFilter(struct loader_instance *inst) {
+    inst->debug_messenger_severities = 0;
+    inst->debug_messenger_types = 0;
+    inst->debug_report_flags = 0;
+    for (VkLayerDbgFunctionNode *pTrav = inst->current_dbg_function_head; pTrav != NULL; pTrav = pTrav->pNext) {
+        if (pTrav->is_messenger) {
+            inst->debug_messenger_severities |= pTrav->messenger.messageSeverity;
+            inst->debug_messenger_types |= pTrav->messenger.messageType;
+        } else {
+            inst->debug_report_flags |= pTrav->report.msgFlags;
+        }
+    }
+}
+
+bool util_DebugMessageHasReceivers(const struct loader_instance *inst, VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+                                   VkDebugUtilsMessageTypeFlagsEXT messageTypes) {
+    // The masks are the union over all messengers, so this may say yes when no single messenger matches, but never says no
+    // when one does
+    if ((inst->debug_messenger_severities & messageSeverity) != 0 && (inst->debug_messenger_types & messageTypes) != 0) {
+        return true;
+    }
+    if (inst->debug_report_flags != 0) {
+        VkDebugReportFlagsEXT object_flags = 0;
+        debug_utils_AnnotFlagsToReportFlags(messageSeverity, messageTypes, &object_flags);
+        return (inst->debug_report_flags & object_flags) != 0;
+    }
+    return false;
+}
+
 void util_DestroyDebugUtilsMessenger(struct loader_instance *inst, VkDebugUtilsMessengerEXT messenger,
                                      const VkAllocationCallbacks *pAllocator) {
     VkLayerDbgFunctionNode *pTrav = inst->current_dbg_function_head;
@@ -119,6 +149,7 @@ void util_DestroyDebugUtilsMessenger(struct loader_instance *inst, VkDebugUtilsM
             if (inst->current_dbg_function_head == pTrav) inst->current_dbg_function_head = pTrav->pNext;
             if (inst->instance_only_dbg_function_head == pTrav) inst->instance_only_dbg_function_head = pTrav->pNext;
             loader_free_with_instance_fallback(pAllocator, inst, pTrav);
+            util_UpdateDebugMessageFilter(inst);
             break;
         }
         pPrev = pTrav;
@@ -230,6 +261,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDebugUtilsMessengerEXT(VkInstanc
     new_dbg_func_node->pUserData = pCreateInfo->pUserData;
     new_dbg_func_node->pNext = inst->current_dbg_function_head;
     inst->current_dbg_function_head = new_dbg_func_node;
+    util_UpdateDebugMessageFilter(inst);
     *pNextIndex = next_index;
     *pMessenger = (VkDebugUtilsMessengerEXT)(uintptr_t)pNextIndex;
     new_dbg_func_node->messenger.messenger = *pMessenger;
@@ -330,6 +362,7 @@ VkResult util_CreateDebugReportCallback(struct loader_instance *inst, const VkDe
     new_dbg_func_node->pNext = inst->instance_only_dbg_function_head;
     inst->instance_only_dbg_function_head = new_dbg_func_node;
     inst->current_dbg_function_head = inst->instance_only_dbg_function_head;
+    util_UpdateDebugMessageFilter(inst);
 
     return VK_SUCCESS;
 }
@@ -402,6 +435,7 @@ void util_DestroyDebugReportCallback(struct loader_instance *inst, VkDebugReport
             if (inst->instance_only_dbg_function_head == pTrav) inst->instance_only_dbg_function_head = pTrav->pNext;
             if (inst->current_dbg_function_head == pTrav) inst->current_dbg_function_head = pTrav->pNext;
             loader_free_with_instance_fallback(pAllocator, inst, pTrav);
+            util_UpdateDebugMessageFilter(inst);
             break;
         }
         pPrev = pTrav;
@@ -514,6 +548,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDebugReportCallbackEXT(VkInstanc
     new_dbg_func_node->pUserData = pCreateInfo->pUserData;
     new_dbg_func_node->pNext = inst->current_dbg_function_head;
     inst->current_dbg_function_head = new_dbg_func_node;
+    util_UpdateDebugMessageFilter(inst);
     *pNextIndex = next_index;
     *pCallback = (VkDebugReportCallbackEXT)(uintptr_t)pNextIndex;
     new_dbg_func_node->report.msgCallback = *pCallback;
@@ -617,6 +652,7 @@ void destroy_debug_callbacks_chain(struct loader_instance *inst, const VkAllocat
         pTrav = pNext;
     }
     inst->current_dbg_function_head = NULL;
+    util_UpdateDebugMessageFilter(inst);
 }
 
 VkResult add_debug_extensions_to_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list) {
@@ -56,6 +56,13 @@ VKAPI_ATTR void VKAPI_CALL terminator_SubmitDebugUtilsMessageEXT(VkInstance inst
                                                                  VkDebugUtilsMessageTypeFlagsEXT messageTypes,
                                                                  const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData);
 VkResult util_CreateDebugUtilsMessengers(struct loader_instance *inst, const void *pChain, const VkAllocationCallbacks *pAllocator);
+// Recomputes the union of the severities and types the messengers and report callbacks in current_dbg_function_head listen to.
+// Must be called whenever that list changes so that util_DebugMessageHasReceivers stays accurate.
+void util_UpdateDebugMessageFilter(struct loader_instance *inst);
+// Whether a message of this severity and type may reach any messenger or report callback. Lets loader_log skip formatting
+// messages nobody receives.
+bool util_DebugMessageHasReceivers(const struct loader_instance *inst, VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+                                   VkDebugUtilsMessageTypeFlagsEXT messageTypes);
 VkBool32 util_SubmitDebugUtilsMessageEXT(const struct loader_instance *inst, VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
                                          VkDebugUtilsMessageTypeFlagsEXT messageTypes,
                                          const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData);
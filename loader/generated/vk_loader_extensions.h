@@ -70,24 +70,28 @@ extern const char *const LOADER_INSTANCE_EXTENSIONS[];
 
 VKAPI_ATTR bool VKAPI_CALL loader_icd_init_entries(struct loader_instance* inst, struct loader_icd_term *icd_term);
 
+// The dispatch table init functions below fill the table with stubs which look up each command the first time it is called
+// instead of looking up every command up front when lazy is true.
+
 // Init Device function pointer dispatch table with core commands
 VKAPI_ATTR void VKAPI_CALL loader_init_device_dispatch_table(struct loader_dev_dispatch_table *dev_table, PFN_vkGetDeviceProcAddr gpa,
-                                                             VkDevice dev);
+                                                             VkDevice dev, bool lazy);
 
 // Init Device function pointer dispatch table with extension commands
 VKAPI_ATTR void VKAPI_CALL loader_init_device_extension_dispatch_table(struct loader_dev_dispatch_table *dev_table,
                                                                        PFN_vkGetInstanceProcAddr gipa,
                                                                        PFN_vkGetDeviceProcAddr gdpa,
                                                                        VkInstance inst,
-                                                                       VkDevice dev);
+                                                                       VkDevice dev,
+                                                                       bool lazy);
 
 // Init Instance function pointer dispatch table with core commands
 VKAPI_ATTR void VKAPI_CALL loader_init_instance_core_dispatch_table(VkLayerInstanceDispatchTable *table, PFN_vkGetInstanceProcAddr gpa,
-                                                                    VkInstance inst);
+                                                                    VkInstance inst, bool lazy);
 
 // Init Instance function pointer dispatch table with core commands
 VKAPI_ATTR void VKAPI_CALL loader_init_instance_extension_dispatch_table(VkLayerInstanceDispatchTable *table, PFN_vkGetInstanceProcAddr gpa,
-                                                                         VkInstance inst);
+                                                                         VkInstance inst, bool lazy);
 
 // Device command lookup function
 VKAPI_ATTR void* VKAPI_CALL loader_lookup_device_dispatch_table(const VkLayerDispatchTable *table, const char *name, bool* name_found);
@@ -96,6 +100,10 @@ VKAPI_ATTR void* VKAPI_CALL loader_lookup_device_dispatch_table(const VkLayerDis
 VKAPI_ATTR void* VKAPI_CALL loader_lookup_instance_dispatch_table(const VkLayerInstanceDispatchTable *table, const char *name,
                                                                   bool *found_name);
 
+// Core command trampoline lookup function, used by trampoline_get_proc_addr. Returns NULL if name is not a core command.
+// name_hash and name_length must come from loader_hash_string_length(name).
+void *loader_lookup_core_trampoline(const char *name, uint32_t name_hash, uint32_t name_length);
+
 // Loader core instance terminators
 VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(
     const VkInstanceCreateInfo*                 pCreateInfo,
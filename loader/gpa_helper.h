@@ -24,6 +24,15 @@
 
 #include "loader_common.h"
 
+// Loader-private entry point which applications can get from vkGetInstanceProcAddr to resolve many device functions in one call.
+// pFunctions[i] is set to the same function vkGetDeviceProcAddr(device, pNames[i]) returns.
+#define VK_LOADER_GET_DEVICE_PROC_ADDRS_NAME "vk_loaderGetDeviceProcAddrs"
+typedef void(VKAPI_PTR *PFN_vk_loaderGetDeviceProcAddrs)(VkDevice device, uint32_t nameCount, const char *const *pNames,
+                                                         PFN_vkVoidFunction *pFunctions);
+
+VKAPI_ATTR void VKAPI_CALL loader_get_device_proc_addrs(VkDevice device, uint32_t nameCount, const char *const *pNames,
+                                                        PFN_vkVoidFunction *pFunctions);
+
 void *trampoline_get_proc_addr(struct loader_instance *inst, const char *funcName);
 
 void *globalGetProcAddr(const char *name);
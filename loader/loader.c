@@ -61,6 +61,10 @@
 #include "loader_environment.h"
 #include "loader_json.h"
 #include "log.h"
+#include "log_sinks.h"
+#include "manifest_cache.h"
+#include "phase_timing.h"
+#include "worker_pool.h"
 #include "unknown_function_handling.h"
 #include "vk_loader_platform.h"
 #include "wsi.h"
@@ -95,6 +99,7 @@ struct activated_layer_info {
 // additionally CreateDevice and DestroyDevice needs to be locked
 loader_platform_thread_mutex loader_lock;
 loader_platform_thread_mutex loader_preload_icd_lock;
+loader_platform_thread_rwlock loader_object_lookup_lock;
 
 // A list of ICDs that gets initialized when the loader does its global initialization. This list should never be used by anything
 // other than EnumerateInstanceExtensionProperties(), vkDestroyInstance, and loader_release(). This list does not change
@@ -103,6 +108,25 @@ loader_platform_thread_mutex loader_preload_icd_lock;
 // vkCreateInstance.
 struct loader_icd_tramp_list preloaded_icds;
 
+// Layer libraries that stay loaded while no instance uses them, so that creating and destroying instances over and over doesn't
+// map and relocate the same layers every time. Only used when VK_LOADER_LAYER_LIBRARY_CACHE is set to the number of seconds an
+// unused library may stay loaded. Libraries that were idle for longer are unloaded the next time a layer library is loaded or
+// released, and all of them are unloaded in loader_release().
+struct loader_layer_library {
+    char *lib_name;
+    loader_platform_dl_handle handle;
+    uint32_t ref_count;
+    uint64_t idle_since_ns;  // when ref_count last dropped to 0
+};
+struct loader_layer_library_cache {
+    uint64_t idle_timeout_ns;  // 0 when the cache is disabled, set once during initialization and read without the lock
+    uint32_t count;
+    uint32_t capacity;
+    struct loader_layer_library *list;
+};
+loader_platform_thread_mutex loader_layer_library_lock;
+static struct loader_layer_library_cache layer_library_cache;
+
 // controls whether loader_platform_close_library() closes the libraries or not - controlled by an environment
 // variables - this is just the definition of the variable, usage is in vk_loader_platform.h
 bool loader_disable_dynamic_library_unloading;
@@ -739,7 +763,8 @@ bool has_vk_extension_property_array(const VkExtensionProperties *vk_ext_prop, c
 }
 
 // Search the given ext_list for an extension matching the given vk_ext_prop
-bool has_vk_extension_property(const VkExtensionProperties *vk_ext_prop, const struct loader_extension_list *ext_list) {
+TEST_FUNCTION_EXPORT bool has_vk_extension_property(const VkExtensionProperties *vk_ext_prop,
+                                                    const struct loader_extension_list *ext_list) {
     for (uint32_t i = 0; i < ext_list->count; i++) {
         if (compare_vk_extension_properties(&ext_list->list[i], vk_ext_prop)) return true;
     }
@@ -754,6 +779,78 @@ bool has_vk_dev_ext_property(const VkExtensionProperties *ext_prop, const struct
     return false;
 }
 
+// Extension lists shorter than this are searched by comparing against every entry, since building a name set costs an
+// allocation
+#define LOADER_EXTENSION_NAME_SET_MIN_COUNT 32
+
+// Open addressing hash set of extension names, keyed by loader_hash_string(). The names aren't copied, so the extension
+// properties they point into must not move or be freed while the set is in use.
+struct loader_extension_name_set {
+    uint32_t slot_count;  // Always a power of two
+    const char **slots;
+};
+
+static VkResult loader_init_extension_name_set(const struct loader_instance *inst, uint32_t max_name_count,
+                                               struct loader_extension_name_set *name_set) {
+    memset(name_set, 0, sizeof(struct loader_extension_name_set));
+    if (max_name_count > UINT32_MAX / 4) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    // Keep at least half of the slots empty so probe sequences stay short
+    uint32_t slot_count = 16;
+    while (slot_count < max_name_count * 2) {
+        slot_count *= 2;
+    }
+    name_set->slots = loader_instance_heap_calloc(inst, sizeof(const char *) * slot_count, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (NULL == name_set->slots) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    name_set->slot_count = slot_count;
+    return VK_SUCCESS;
+}
+
+static void loader_destroy_extension_name_set(const struct loader_instance *inst, struct loader_extension_name_set *name_set) {
+    loader_instance_heap_free(inst, (void *)name_set->slots);
+    memset(name_set, 0, sizeof(struct loader_extension_name_set));
+}
+
+// Returns the slot holding name, or the empty slot name would be inserted into
+static const char **loader_extension_name_set_find(const struct loader_extension_name_set *name_set, const char *name) {
+    uint32_t slot = loader_hash_string(name) & (name_set->slot_count - 1);
+    while (NULL != name_set->slots[slot] && strcmp(name_set->slots[slot], name) != 0) {
+        slot = (slot + 1) & (name_set->slot_count - 1);
+    }
+    return &name_set->slots[slot];
+}
+
+static bool loader_extension_name_set_contains(const struct loader_extension_name_set *name_set, const char *name) {
+    return NULL != *loader_extension_name_set_find(name_set, name);
+}
+
+// Add name to the set, returning false if it already contained it
+static bool loader_extension_name_set_insert(struct loader_extension_name_set *name_set, const char *name) {
+    const char **slot = loader_extension_name_set_find(name_set, name);
+    if (NULL != *slot) {
+        return false;
+    }
+    *slot = name;
+    return true;
+}
+
+// Create a name set holding every extension of ext_list, which must outlive the set and not grow while it is in use
+static VkResult loader_init_extension_name_set_from_list(const struct loader_instance *inst,
+                                                         const struct loader_extension_list *ext_list,
+                                                         struct loader_extension_name_set *name_set) {
+    VkResult res = loader_init_extension_name_set(inst, ext_list->count, name_set);
+    if (VK_SUCCESS != res) {
+        return res;
+    }
+    for (uint32_t i = 0; i < ext_list->count; i++) {
+        loader_extension_name_set_insert(name_set, ext_list->list[i].extensionName);
+    }
+    return VK_SUCCESS;
+}
+
 VkResult loader_append_layer_property(const struct loader_instance *inst, struct loader_layer_list *layer_list,
                                       struct loader_layer_properties *layer_property) {
     VkResult res = VK_SUCCESS;
@@ -825,6 +922,151 @@ bool loader_find_layer_name_in_blacklist(const char *layer_name, struct loader_l
     return false;
 }
 
+// now may have been taken before another thread released a library, which then became idle after it
+static bool loader_layer_library_expired(const struct loader_layer_library *library, uint64_t now) {
+    return 0 == library->ref_count && now >= library->idle_since_ns &&
+           now - library->idle_since_ns >= layer_library_cache.idle_timeout_ns;
+}
+
+// Unloads the cached layer libraries which no instance used for longer than the idle timeout. They are taken out of the cache
+// while holding loader_layer_library_lock, but closed and logged about after releasing it, since unloading a library runs its
+// destructors and logging may call back into the application.
+static void loader_evict_idle_layer_libraries(const struct loader_instance *inst, uint64_t now) {
+    struct loader_layer_library *evicted = NULL;
+    uint32_t evicted_count = 0;
+
+    loader_platform_thread_lock_mutex(&loader_layer_library_lock);
+    uint32_t idle_count = 0;
+    for (uint32_t i = 0; i < layer_library_cache.count; i++) {
+        struct loader_layer_library *library = &layer_library_cache.list[i];
+        if (loader_layer_library_expired(library, now)) {
+            idle_count++;
+        }
+    }
+    if (0 != idle_count) {
+        // If this fails the libraries simply stay cached until the next attempt
+        evicted = loader_calloc(NULL, sizeof(struct loader_layer_library) * idle_count, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    }
+    uint32_t i = 0;
+    while (NULL != evicted && i < layer_library_cache.count) {
+        struct loader_layer_library *library = &layer_library_cache.list[i];
+        if (!loader_layer_library_expired(library, now)) {
+            i++;
+            continue;
+        }
+        evicted[evicted_count++] = *library;
+        // Order doesn't matter, move the last entry into the hole
+        layer_library_cache.list[i] = layer_library_cache.list[--layer_library_cache.count];
+    }
+    loader_platform_thread_unlock_mutex(&loader_layer_library_lock);
+
+    for (i = 0; i < evicted_count; i++) {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Unloading idle layer library %s",
+                   evicted[i].lib_name);
+        loader_platform_close_library(evicted[i].handle);
+        loader_free(NULL, evicted[i].lib_name);
+    }
+    loader_free(NULL, evicted);
+}
+
+// Returns the cached handle for lib_name, loading the library if it isn't cached yet. Requires loader_layer_library_lock.
+static loader_platform_dl_handle loader_acquire_layer_library(const char *lib_name) {
+    for (uint32_t i = 0; i < layer_library_cache.count; i++) {
+        if (0 == strcmp(layer_library_cache.list[i].lib_name, lib_name)) {
+            layer_library_cache.list[i].ref_count++;
+            return layer_library_cache.list[i].handle;
+        }
+    }
+
+    loader_platform_dl_handle handle = loader_platform_open_library(lib_name);
+    if (NULL == handle) {
+        return NULL;
+    }
+    // Different names can refer to the same library, in which case the platform hands out the handle it already gave out
+    for (uint32_t i = 0; i < layer_library_cache.count; i++) {
+        if (layer_library_cache.list[i].handle == handle) {
+            loader_platform_close_library(handle);
+            layer_library_cache.list[i].ref_count++;
+            return handle;
+        }
+    }
+
+    // If the library can't be remembered it is simply closed again when released
+    if (layer_library_cache.count == layer_library_cache.capacity) {
+        uint32_t new_capacity = layer_library_cache.capacity > 0 ? layer_library_cache.capacity * 2 : 8;
+        struct loader_layer_library *new_list =
+            loader_realloc(NULL, layer_library_cache.list, sizeof(struct loader_layer_library) * layer_library_cache.capacity,
+                           sizeof(struct loader_layer_library) * new_capacity, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == new_list) {
+            return handle;
+        }
+        layer_library_cache.list = new_list;
+        layer_library_cache.capacity = new_capacity;
+    }
+    struct loader_layer_library *library = &layer_library_cache.list[layer_library_cache.count];
+    memset(library, 0, sizeof(struct loader_layer_library));
+    if (VK_SUCCESS != loader_copy_to_new_str(NULL, lib_name, &library->lib_name)) {
+        return handle;
+    }
+    library->handle = handle;
+    library->ref_count = 1;
+    layer_library_cache.count++;
+    return handle;
+}
+
+// Gives up one reference to a handle returned by loader_acquire_layer_library(). Returns false if the handle isn't cached, in which
+// case the caller has to close it. Requires loader_layer_library_lock.
+static bool loader_release_layer_library(loader_platform_dl_handle handle, uint64_t now) {
+    for (uint32_t i = 0; i < layer_library_cache.count; i++) {
+        struct loader_layer_library *library = &layer_library_cache.list[i];
+        if (library->handle == handle) {
+            if (library->ref_count > 0 && 0 == --library->ref_count) {
+                library->idle_since_ns = now;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Unloads every cached layer library no instance uses anymore and forgets about the rest
+void loader_unload_cached_layer_libraries(void) {
+    loader_platform_thread_lock_mutex(&loader_layer_library_lock);
+    struct loader_layer_library_cache cache = layer_library_cache;
+    layer_library_cache.list = NULL;
+    layer_library_cache.count = 0;
+    layer_library_cache.capacity = 0;
+    loader_platform_thread_unlock_mutex(&loader_layer_library_lock);
+
+    for (uint32_t i = 0; i < cache.count; i++) {
+        if (0 == cache.list[i].ref_count) {
+            loader_log(NULL, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Unloading idle layer library %s",
+                       cache.list[i].lib_name);
+            loader_platform_close_library(cache.list[i].handle);
+        }
+        loader_free(NULL, cache.list[i].lib_name);
+    }
+    loader_free(NULL, cache.list);
+}
+
+static void loader_close_layer_file(const struct loader_instance *inst, struct loader_layer_properties *prop) {
+    if (0 != layer_library_cache.idle_timeout_ns) {
+        uint64_t now = loader_platform_get_time_ns();
+        loader_platform_thread_lock_mutex(&loader_layer_library_lock);
+        bool cached = loader_release_layer_library(prop->lib_handle, now);
+        loader_platform_thread_unlock_mutex(&loader_layer_library_lock);
+        if (!cached) {
+            loader_platform_close_library(prop->lib_handle);
+        }
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Releasing cached layer library %s", prop->lib_name);
+        loader_evict_idle_layer_libraries(inst, now);
+    } else {
+        loader_platform_close_library(prop->lib_handle);
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Unloading layer library %s", prop->lib_name);
+    }
+    prop->lib_handle = NULL;
+}
+
 // Remove all layer properties entries from the list
 TEST_FUNCTION_EXPORT void loader_delete_layer_list_and_properties(const struct loader_instance *inst,
                                                                   struct loader_layer_list *layer_list) {
@@ -833,10 +1075,7 @@ TEST_FUNCTION_EXPORT void loader_delete_layer_list_and_properties(const struct l
 
     for (i = 0; i < layer_list->count; i++) {
         if (layer_list->list[i].lib_handle) {
-            loader_platform_close_library(layer_list->list[i].lib_handle);
-            loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Unloading layer library %s",
-                       layer_list->list[i].lib_name);
-            layer_list->list[i].lib_handle = NULL;
+            loader_close_layer_file(inst, &layer_list->list[i]);
         }
         loader_free_layer_properties(inst, &(layer_list->list[i]));
     }
@@ -999,15 +1238,18 @@ VkResult loader_add_instance_extensions(const struct loader_instance *inst,
     }
 
     // The count returned by the second call sizes the array, but never read past what we actually allocated.
+    // Drop the unsupported extensions in place so the rest can be merged into ext_list at once.
+    uint32_t supported_count = 0;
     for (i = 0; i < count && i < allocated_count; i++) {
         bool ext_unsupported = wsi_unsupported_instance_extension(&ext_props[i]);
         if (!ext_unsupported) {
-            res = loader_add_to_ext_list(inst, ext_list, 1, &ext_props[i]);
-            if (res != VK_SUCCESS) {
-                goto out;
+            if (supported_count != i) {
+                memcpy(&ext_props[supported_count], &ext_props[i], sizeof(VkExtensionProperties));
             }
+            supported_count++;
         }
     }
+    res = loader_add_to_ext_list(inst, ext_list, supported_count, ext_props);
 
 out:
     return res;
@@ -1017,7 +1259,7 @@ VkResult loader_add_device_extensions(const struct loader_instance *inst,
                                       PFN_vkEnumerateDeviceExtensionProperties fpEnumerateDeviceExtensionProperties,
                                       VkPhysicalDevice physical_device, const char *lib_name,
                                       struct loader_extension_list *ext_list) {
-    uint32_t i = 0, count = 0;
+    uint32_t count = 0;
     VkResult res = VK_SUCCESS;
     VkExtensionProperties *ext_props = NULL;
 
@@ -1041,17 +1283,94 @@ VkResult loader_add_device_extensions(const struct loader_instance *inst,
             return res;
         }
         // The count returned by the second call sizes the array, but never read past what we actually allocated.
-        for (i = 0; i < count && i < allocated_count; i++) {
-            res = loader_add_to_ext_list(inst, ext_list, 1, &ext_props[i]);
-            if (res != VK_SUCCESS) {
-                return res;
-            }
+        res = loader_add_to_ext_list(inst, ext_list, count < allocated_count ? count : allocated_count, ext_props);
+        if (res != VK_SUCCESS) {
+            return res;
         }
     }
 
     return VK_SUCCESS;
 }
 
+// The physical device snapshot is filled in while holding the instance's phys_dev_snapshot_lock, since it is reached both from
+// the vkEnumeratePhysicalDevices chain and from calls holding loader_lock instead.
+const VkPhysicalDeviceProperties *loader_get_phys_dev_term_properties(struct loader_physical_device_term *phys_dev_term) {
+    loader_platform_thread_mutex *snapshot_lock =
+        &((struct loader_instance *)phys_dev_term->this_icd_term->this_instance)->phys_dev_snapshot_lock;
+    loader_platform_thread_lock_mutex(snapshot_lock);
+    if (!phys_dev_term->has_properties_snapshot) {
+        phys_dev_term->this_icd_term->dispatch.GetPhysicalDeviceProperties(phys_dev_term->phys_dev,
+                                                                           &phys_dev_term->properties_snapshot);
+        phys_dev_term->has_properties_snapshot = true;
+    }
+    loader_platform_thread_unlock_mutex(snapshot_lock);
+    return &phys_dev_term->properties_snapshot;
+}
+
+// Queries the driver's device extensions the first time only; a failed query isn't cached so the next caller retries it.
+// The returned array is owned by phys_dev_term and lives until loader_free_phys_dev_term.
+VkResult loader_get_phys_dev_term_extensions(const struct loader_instance *inst, struct loader_physical_device_term *phys_dev_term,
+                                             uint32_t *pCount, const VkExtensionProperties **ppProperties) {
+    VkResult res = VK_SUCCESS;
+    VkExtensionProperties *ext_props = NULL;
+    uint32_t count = 0;
+    loader_platform_thread_mutex *snapshot_lock =
+        &((struct loader_instance *)phys_dev_term->this_icd_term->this_instance)->phys_dev_snapshot_lock;
+
+    loader_platform_thread_lock_mutex(snapshot_lock);
+    if (phys_dev_term->has_extensions_snapshot) {
+        goto out;
+    }
+
+    PFN_vkEnumerateDeviceExtensionProperties fpEnumerateDeviceExtensionProperties =
+        phys_dev_term->this_icd_term->dispatch.EnumerateDeviceExtensionProperties;
+    res = fpEnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL, &count, NULL);
+    if (res != VK_SUCCESS) {
+        goto out;
+    }
+    if (count > 0) {
+        ext_props = loader_instance_heap_calloc(inst, count * sizeof(VkExtensionProperties), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == ext_props) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        uint32_t allocated_count = count;
+        res = fpEnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL, &count, ext_props);
+        if (res != VK_SUCCESS) {
+            goto out;
+        }
+        // The count returned by the second call sizes the array, but never read past what we actually allocated.
+        if (count > allocated_count) {
+            count = allocated_count;
+        }
+    }
+
+    phys_dev_term->extensions_snapshot = ext_props;
+    phys_dev_term->extensions_snapshot_count = count;
+    phys_dev_term->has_extensions_snapshot = true;
+    ext_props = NULL;
+
+out:
+    loader_instance_heap_free(inst, ext_props);
+    if (VK_SUCCESS == res) {
+        *pCount = phys_dev_term->extensions_snapshot_count;
+        *ppProperties = phys_dev_term->extensions_snapshot;
+    } else {
+        *pCount = 0;
+        *ppProperties = NULL;
+    }
+    loader_platform_thread_unlock_mutex(snapshot_lock);
+    return res;
+}
+
+void loader_free_phys_dev_term(const struct loader_instance *inst, struct loader_physical_device_term *phys_dev_term) {
+    if (NULL == phys_dev_term) {
+        return;
+    }
+    loader_instance_heap_free(inst, phys_dev_term->extensions_snapshot);
+    loader_instance_heap_free(inst, phys_dev_term);
+}
+
 VkResult loader_init_generic_list(const struct loader_instance *inst, struct loader_generic_list *list_info, size_t element_size) {
     size_t capacity = 32 * element_size;
     list_info->count = 0;
@@ -1081,7 +1400,7 @@ VkResult loader_resize_generic_list(const struct loader_instance *inst, struct l
     return VK_SUCCESS;
 }
 
-void loader_destroy_generic_list(const struct loader_instance *inst, struct loader_generic_list *list) {
+TEST_FUNCTION_EXPORT void loader_destroy_generic_list(const struct loader_instance *inst, struct loader_generic_list *list) {
     loader_instance_heap_free(inst, list->list);
     memset(list, 0, sizeof(struct loader_generic_list));
 }
@@ -1134,10 +1453,58 @@ void loader_release_object_from_list(struct loader_used_object_list *list_info,
     }
 }
 
+// Append the non-duplicate extensions of props to ext_list by looking each of them up in a name set of ext_list, which keeps
+// merging long lists linear
+static VkResult loader_merge_into_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list,
+                                           uint32_t prop_list_count, const VkExtensionProperties *props) {
+    struct loader_extension_name_set name_set = {0};
+    VkResult res = VK_SUCCESS;
+
+    // The name set points into ext_list, so make room for every new extension before filling it
+    size_t needed_capacity = ((size_t)ext_list->count + prop_list_count) * sizeof(VkExtensionProperties);
+    if (needed_capacity > ext_list->capacity) {
+        size_t new_capacity = ext_list->capacity;
+        while (new_capacity < needed_capacity) {
+            new_capacity *= 2;
+        }
+        void *new_ptr = loader_instance_heap_realloc(inst, ext_list->list, ext_list->capacity, new_capacity,
+                                                     VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (new_ptr == NULL) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
+                       "loader_add_to_ext_list: Failed to reallocate space for extension list");
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        ext_list->list = new_ptr;
+        ext_list->capacity = new_capacity;
+    }
+
+    res = loader_init_extension_name_set(inst, ext_list->count + prop_list_count, &name_set);
+    if (VK_SUCCESS != res) {
+        goto out;
+    }
+    for (uint32_t i = 0; i < ext_list->count; i++) {
+        loader_extension_name_set_insert(&name_set, ext_list->list[i].extensionName);
+    }
+
+    for (uint32_t i = 0; i < prop_list_count; i++) {
+        const char **slot = loader_extension_name_set_find(&name_set, props[i].extensionName);
+        if (NULL != *slot) {
+            continue;
+        }
+        memcpy(&ext_list->list[ext_list->count], &props[i], sizeof(VkExtensionProperties));
+        *slot = ext_list->list[ext_list->count].extensionName;
+        ext_list->count++;
+    }
+
+out:
+    loader_destroy_extension_name_set(inst, &name_set);
+    return res;
+}
+
 // Append non-duplicate extension properties defined in props to the given ext_list.
 // Return - Vk_SUCCESS on success
-VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list,
-                                uint32_t prop_list_count, const VkExtensionProperties *props) {
+TEST_FUNCTION_EXPORT VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list,
+                                                     uint32_t prop_list_count, const VkExtensionProperties *props) {
     if (ext_list->list == NULL || ext_list->capacity == 0) {
         VkResult res = loader_init_generic_list(inst, (struct loader_generic_list *)ext_list, sizeof(VkExtensionProperties));
         if (VK_SUCCESS != res) {
@@ -1145,6 +1512,10 @@ VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loade
         }
     }
 
+    if (prop_list_count > 1 && ext_list->count + prop_list_count > LOADER_EXTENSION_NAME_SET_MIN_COUNT) {
+        return loader_merge_into_ext_list(inst, ext_list, prop_list_count, props);
+    }
+
     for (uint32_t i = 0; i < prop_list_count; i++) {
         const VkExtensionProperties *cur_ext = &props[i];
 
@@ -1362,6 +1733,9 @@ bool loader_implicit_layer_is_enabled(const struct loader_instance *inst, const
     bool forced_disabled = false;
     bool forced_enabled = false;
 
+    loader_pre_instance_cache_watch_env_var(prop->enable_env_var.name);
+    loader_pre_instance_cache_watch_env_var(prop->disable_env_var.name);
+
     if ((filters->disable_filter.disable_all || filters->disable_filter.disable_all_implicit ||
          check_name_matches_filter_environment_var(prop->info.layerName, &filters->disable_filter.additional_filters)) &&
         !check_name_matches_filter_environment_var(prop->info.layerName, &filters->allow_filter)) {
@@ -1671,14 +2045,105 @@ out:
     return res;
 }
 
+// All of the loader_device_index functions must be called with loader_object_lookup_lock held
+static uint32_t loader_device_index_home_slot(const struct loader_device_index *index, const void *dispatch) {
+    // Dispatch tables are pointer aligned so the low bits carry no information, mix the rest with a Fibonacci hash
+    uint64_t key = ((uint64_t)(uintptr_t)dispatch >> 3) * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(key >> 32) & (index->capacity - 1);
+}
+
+static uint32_t loader_device_index_find_slot(const struct loader_device_index *index, const void *dispatch) {
+    uint32_t slot = loader_device_index_home_slot(index, dispatch);
+    while (NULL != index->entries[slot].dispatch && index->entries[slot].dispatch != dispatch) {
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return slot;
+}
+
+static struct loader_device *loader_device_index_find(const struct loader_device_index *index, const void *dispatch) {
+    if (0 == index->count) {
+        return NULL;
+    }
+    return index->entries[loader_device_index_find_slot(index, dispatch)].dev;
+}
+
+static void loader_device_index_place(struct loader_device_index *index, const void *dispatch, struct loader_device *dev) {
+    uint32_t slot = loader_device_index_find_slot(index, dispatch);
+    if (NULL == index->entries[slot].dispatch) {
+        index->count++;
+    }
+    index->entries[slot].dispatch = dispatch;
+    index->entries[slot].dev = dev;
+}
+
+// Returns false if the index couldn't grow, the device can still be found by loader_get_icd_and_device() in that case
+static bool loader_device_index_insert(struct loader_device_index *index, const void *dispatch, struct loader_device *dev) {
+    // Keep the load factor at or below one half so probe sequences stay short
+    if ((index->count + 1) * 2 > index->capacity) {
+        struct loader_device_index new_index = {0};
+        new_index.capacity = index->capacity > 0 ? index->capacity * 2 : 64;
+        new_index.entries = loader_calloc(NULL, sizeof(struct loader_device_index_entry) * new_index.capacity,
+                                          VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == new_index.entries) {
+            return false;
+        }
+        for (uint32_t i = 0; i < index->capacity; i++) {
+            if (NULL != index->entries[i].dispatch) {
+                loader_device_index_place(&new_index, index->entries[i].dispatch, index->entries[i].dev);
+            }
+        }
+        loader_free(NULL, index->entries);
+        *index = new_index;
+    }
+    loader_device_index_place(index, dispatch, dev);
+    return true;
+}
+
+static void loader_device_index_remove(struct loader_device_index *index, const void *dispatch, const struct loader_device *dev) {
+    if (NULL == dispatch || 0 == index->count) {
+        return;
+    }
+    uint32_t mask = index->capacity - 1;
+    uint32_t hole = loader_device_index_find_slot(index, dispatch);
+    if (index->entries[hole].dev != dev) {
+        return;
+    }
+    // Shift back any following entries of the probe sequence which would become unreachable through the hole
+    for (uint32_t next = (hole + 1) & mask; NULL != index->entries[next].dispatch; next = (next + 1) & mask) {
+        uint32_t home = loader_device_index_home_slot(index, index->entries[next].dispatch);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->entries[hole] = index->entries[next];
+            hole = next;
+        }
+    }
+    index->entries[hole].dispatch = NULL;
+    index->entries[hole].dev = NULL;
+    index->count--;
+}
+
+// Must be called with loader_object_lookup_lock held for writing
+static void loader_unindex_logical_device(struct loader_device *dev) {
+    loader_device_index_remove(&loader.device_index, dev->icd_device_dispatch, dev);
+    loader_device_index_remove(&loader.device_index, dev->chain_device_dispatch, dev);
+    dev->icd_device_dispatch = NULL;
+    dev->chain_device_dispatch = NULL;
+}
+
 struct loader_icd_term *loader_get_icd_and_device(const void *device, struct loader_device **found_dev) {
     VkLayerDispatchTable *dispatch_table_device = loader_get_dispatch(device);
     if (NULL == dispatch_table_device) {
         *found_dev = NULL;
         return NULL;
     }
-    loader_platform_thread_lock_mutex(&loader_lock);
-    *found_dev = NULL;
+    loader_platform_thread_lock_rwlock_read(&loader_object_lookup_lock);
+    *found_dev = loader_device_index_find(&loader.device_index, dispatch_table_device);
+    if (NULL != *found_dev) {
+        struct loader_icd_term *icd_term = (*found_dev)->icd_term;
+        loader_platform_thread_unlock_rwlock_read(&loader_object_lookup_lock);
+        return icd_term;
+    }
+
+    // Fall back to searching every device, which covers devices that couldn't be added to the index
 
     for (struct loader_instance *inst = loader.instances; inst; inst = inst->next) {
         for (struct loader_icd_term *icd_term = inst->icd_terms; icd_term; icd_term = icd_term->next) {
@@ -1687,13 +2152,13 @@ struct loader_icd_term *loader_get_icd_and_device(const void *device, struct loa
                 if (loader_get_dispatch(dev->icd_device) == dispatch_table_device ||
                     (dev->chain_device != VK_NULL_HANDLE && loader_get_dispatch(dev->chain_device) == dispatch_table_device)) {
                     *found_dev = dev;
-                    loader_platform_thread_unlock_mutex(&loader_lock);
+                    loader_platform_thread_unlock_rwlock_read(&loader_object_lookup_lock);
                     return icd_term;
                 }
             }
         }
     }
-    loader_platform_thread_unlock_mutex(&loader_lock);
+    loader_platform_thread_unlock_rwlock_read(&loader_object_lookup_lock);
     return NULL;
 }
 
@@ -1722,9 +2187,29 @@ struct loader_device *loader_create_logical_device(const struct loader_instance
     return new_dev;
 }
 
+// dev->icd_device must already have its dispatch pointer initialized
 void loader_add_logical_device(struct loader_icd_term *icd_term, struct loader_device *dev) {
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
     dev->next = icd_term->logical_device_list;
     icd_term->logical_device_list = dev;
+    dev->icd_term = icd_term;
+    const void *dispatch = loader_get_dispatch(dev->icd_device);
+    if (NULL != dispatch && loader_device_index_insert(&loader.device_index, dispatch, dev)) {
+        dev->icd_device_dispatch = dispatch;
+    }
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
+}
+
+void loader_set_logical_device_chain_device(struct loader_device *dev, VkDevice chain_device) {
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
+    dev->chain_device = chain_device;
+    // Layers usually pass the dispatch pointer of the driver's device through, so only index it if it differs
+    const void *dispatch = loader_get_dispatch(chain_device);
+    if (NULL != dev->icd_term && NULL != dispatch && dispatch != dev->icd_device_dispatch &&
+        loader_device_index_insert(&loader.device_index, dispatch, dev)) {
+        dev->chain_device_dispatch = dispatch;
+    }
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
 }
 
 void loader_remove_logical_device(struct loader_icd_term *icd_term, struct loader_device *found_dev,
@@ -1733,6 +2218,7 @@ void loader_remove_logical_device(struct loader_icd_term *icd_term, struct loade
 
     if (!icd_term || !found_dev) return;
 
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
     prev_dev = NULL;
     dev = icd_term->logical_device_list;
     while (dev && dev != found_dev) {
@@ -1744,6 +2230,8 @@ void loader_remove_logical_device(struct loader_icd_term *icd_term, struct loade
         prev_dev->next = found_dev->next;
     else
         icd_term->logical_device_list = found_dev->next;
+    loader_unindex_logical_device(found_dev);
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
     loader_destroy_logical_device(found_dev, pAllocator);
 }
 
@@ -1790,6 +2278,11 @@ void loader_icd_close_objects(struct loader_instance *ptr_inst, struct loader_ic
 void loader_icd_destroy(struct loader_instance *ptr_inst, struct loader_icd_term *icd_term,
                         const VkAllocationCallbacks *pAllocator) {
     ptr_inst->icd_terms_count--;
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
+    for (struct loader_device *dev = icd_term->logical_device_list; dev; dev = dev->next) {
+        loader_unindex_logical_device(dev);
+    }
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
     for (struct loader_device *dev = icd_term->logical_device_list; dev;) {
         struct loader_device *next_dev = dev->next;
         loader_destroy_logical_device(dev, pAllocator);
@@ -1815,8 +2308,10 @@ struct loader_icd_term *loader_icd_add(struct loader_instance *ptr_inst, const s
     icd_term->this_instance = ptr_inst;
 
     // Prepend to the list
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
     icd_term->next = ptr_inst->icd_terms;
     ptr_inst->icd_terms = icd_term;
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
     ptr_inst->icd_terms_count++;
 
     return icd_term;
@@ -2112,18 +2607,70 @@ VkResult loader_scan_for_direct_drivers(const struct loader_instance *inst, cons
     return VK_SUCCESS;
 }
 
+// Outcome of opening a driver library and negotiating the loader/driver interface version with it
+struct loader_icd_negotiation {
+    loader_platform_dl_handle handle;         // NULL if the library could not be opened
+    PFN_vkGetInstanceProcAddr get_proc_addr;  // Set if vk_icdGetInstanceProcAddr was used to find the negotiation function
+    uint32_t interface_version;
+    bool negotiated;  // false if the driver doesn't support any interface version the loader does
+};
+
+// Open the driver library filename and negotiate the loader/driver interface version with it.
+// This neither logs nor touches the instance, so it can run for several drivers at once on worker threads.
+static void loader_open_and_negotiate_icd(const char *filename, struct loader_icd_negotiation *negotiation) {
+    PFN_vkNegotiateLoaderICDInterfaceVersion fp_negotiate_icd_version = NULL;
+    uint64_t phase_begin = loader_phase_begin();
+    memset(negotiation, 0, sizeof(struct loader_icd_negotiation));
+
+// TODO implement smarter opening/closing of libraries. For now this
+// function leaves libraries open and the scanned_icd_clear closes them
+#if defined(__Fuchsia__)
+    negotiation->handle = loader_platform_open_driver(filename);
+#else
+    negotiation->handle = loader_platform_open_library(filename);
+#endif
+    if (NULL == negotiation->handle) {
+        goto out;
+    }
+
+    // Try to load the driver's exported vk_icdNegotiateLoaderICDInterfaceVersion
+    fp_negotiate_icd_version = loader_platform_get_proc_address(negotiation->handle, "vk_icdNegotiateLoaderICDInterfaceVersion");
+
+    // If it isn't exported, we are dealing with either a v0, v1, or a v7 and up driver
+    if (NULL == fp_negotiate_icd_version) {
+        // Try to load the driver's exported vk_icdGetInstanceProcAddr - if this is a v7 or up driver, we can use it to get
+        // the driver's vk_icdNegotiateLoaderICDInterfaceVersion function
+        negotiation->get_proc_addr = loader_platform_get_proc_address(negotiation->handle, "vk_icdGetInstanceProcAddr");
+
+        // If we successfully loaded vk_icdGetInstanceProcAddr, try to get vk_icdNegotiateLoaderICDInterfaceVersion
+        if (negotiation->get_proc_addr) {
+            fp_negotiate_icd_version = (PFN_vk_icdNegotiateLoaderICDInterfaceVersion)negotiation->get_proc_addr(
+                NULL, "vk_icdNegotiateLoaderICDInterfaceVersion");
+        }
+    }
+
+    // Try to negotiate the Loader and Driver Interface Versions
+    // loader_get_icd_interface_version will check if fp_negotiate_icd_version is NULL, so we don't have to.
+    // If it *is* NULL, that means this driver uses interface version 0 or 1
+    negotiation->negotiated = loader_get_icd_interface_version(fp_negotiate_icd_version, &negotiation->interface_version);
+
+out:
+    loader_phase_end(LOADER_PHASE_DRIVER_LOAD, phase_begin, filename);
+}
+
 VkResult loader_scanned_icd_add(const struct loader_instance *inst, struct loader_icd_tramp_list *icd_tramp_list,
-                                const char *filename, uint32_t api_version, enum loader_layer_library_status *lib_status) {
+                                const char *filename, uint32_t api_version, enum loader_layer_library_status *lib_status,
+                                struct loader_icd_negotiation *negotiation) {
     loader_platform_dl_handle handle = NULL;
     PFN_vkCreateInstance fp_create_inst = NULL;
     PFN_vkEnumerateInstanceExtensionProperties fp_get_inst_ext_props = NULL;
     PFN_vkGetInstanceProcAddr fp_get_proc_addr = NULL;
     PFN_GetPhysicalDeviceProcAddr fp_get_phys_dev_proc_addr = NULL;
-    PFN_vkNegotiateLoaderICDInterfaceVersion fp_negotiate_icd_version = NULL;
 #if defined(VK_USE_PLATFORM_WIN32_KHR)
     PFN_vk_icdEnumerateAdapterPhysicalDevices fp_enum_dxgi_adapter_phys_devs = NULL;
 #endif
     struct loader_scanned_icd *new_scanned_icd = NULL;
+    struct loader_icd_negotiation local_negotiation;
     uint32_t interface_vers;
     VkResult res = VK_SUCCESS;
 
@@ -2135,13 +2682,15 @@ VkResult loader_scanned_icd_add(const struct loader_instance *inst, struct loade
         goto out;
     }
 
-// TODO implement smarter opening/closing of libraries. For now this
-// function leaves libraries open and the scanned_icd_clear closes them
-#if defined(__Fuchsia__)
-    handle = loader_platform_open_driver(filename);
-#else
-    handle = loader_platform_open_library(filename);
-#endif
+    // Open the library here unless a worker thread already did. Libraries which failed to open on a worker thread are opened
+    // again so that the error reported by the platform comes from this thread.
+    if (NULL == negotiation || NULL == negotiation->handle) {
+        loader_open_and_negotiate_icd(filename, &local_negotiation);
+        negotiation = &local_negotiation;
+    }
+    handle = negotiation->handle;
+    fp_get_proc_addr = negotiation->get_proc_addr;
+    interface_vers = negotiation->interface_version;
     if (NULL == handle) {
         loader_handle_load_library_error(inst, filename, lib_status);
         if (lib_status && *lib_status == LOADER_LAYER_LIB_ERROR_OUT_OF_MEMORY) {
@@ -2152,26 +2701,7 @@ VkResult loader_scanned_icd_add(const struct loader_instance *inst, struct loade
         goto out;
     }
 
-    // Try to load the driver's exported vk_icdNegotiateLoaderICDInterfaceVersion
-    fp_negotiate_icd_version = loader_platform_get_proc_address(handle, "vk_icdNegotiateLoaderICDInterfaceVersion");
-
-    // If it isn't exported, we are dealing with either a v0, v1, or a v7 and up driver
-    if (NULL == fp_negotiate_icd_version) {
-        // Try to load the driver's exported vk_icdGetInstanceProcAddr - if this is a v7 or up driver, we can use it to get
-        // the driver's vk_icdNegotiateLoaderICDInterfaceVersion function
-        fp_get_proc_addr = loader_platform_get_proc_address(handle, "vk_icdGetInstanceProcAddr");
-
-        // If we successfully loaded vk_icdGetInstanceProcAddr, try to get vk_icdNegotiateLoaderICDInterfaceVersion
-        if (fp_get_proc_addr) {
-            fp_negotiate_icd_version =
-                (PFN_vk_icdNegotiateLoaderICDInterfaceVersion)fp_get_proc_addr(NULL, "vk_icdNegotiateLoaderICDInterfaceVersion");
-        }
-    }
-
-    // Try to negotiate the Loader and Driver Interface Versions
-    // loader_get_icd_interface_version will check if fp_negotiate_icd_version is NULL, so we don't have to.
-    // If it *is* NULL, that means this driver uses interface version 0 or 1
-    if (!loader_get_icd_interface_version(fp_negotiate_icd_version, &interface_vers)) {
+    if (!negotiation->negotiated) {
         loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
                    "loader_scanned_icd_add: ICD %s doesn't support interface version compatible with loader, skip this ICD.",
                    filename);
@@ -2345,11 +2875,19 @@ BOOL __stdcall loader_initialize(PINIT_ONCE InitOnce, PVOID Parameter, PVOID *Co
 void loader_initialize(void) {
     loader_platform_thread_create_mutex(&loader_lock);
     loader_platform_thread_create_mutex(&loader_preload_icd_lock);
+    loader_platform_thread_create_mutex(&loader_layer_library_lock);
+    loader_platform_thread_create_rwlock(&loader_object_lookup_lock);
     init_global_loader_settings();
+    init_global_log_sinks();
+    init_global_phase_timing();
+    init_global_manifest_cache();
+    init_global_envvar_snapshot();
 #endif
 
     // initialize logging
     loader_init_global_debug_level();
+    loader_init_phase_timing();
+    loader_init_settings_watcher();
 #if defined(_WIN32)
     windows_initialization();
 #endif
@@ -2371,6 +2909,18 @@ void loader_initialize(void) {
         loader_disable_dynamic_library_unloading = false;
     }
     loader_free_getenv(loader_disable_dynamic_library_unloading_env_var, NULL);
+
+    char *layer_library_cache_env_var = loader_getenv(VK_LOADER_LAYER_LIBRARY_CACHE_ENV_VAR, NULL);
+    layer_library_cache.idle_timeout_ns = 0;
+    if (NULL != layer_library_cache_env_var) {
+        unsigned long idle_seconds = strtoul(layer_library_cache_env_var, NULL, 10);
+        if (idle_seconds > 0) {
+            layer_library_cache.idle_timeout_ns = (uint64_t)idle_seconds * 1000000000ULL;
+            loader_log(NULL, VULKAN_LOADER_INFO_BIT, 0, "Vulkan Loader: unused layer libraries stay loaded for %lu seconds",
+                       idle_seconds);
+        }
+    }
+    loader_free_getenv(layer_library_cache_env_var, NULL);
 #if defined(LOADER_USE_UNSAFE_FILE_SEARCH)
     loader_log(NULL, VULKAN_LOADER_WARN_BIT, 0, "Vulkan Loader: unsafe searching is enabled");
 #endif
@@ -2380,13 +2930,25 @@ void loader_initialize(void) {
 }
 
 void loader_release(void) {
+    // The settings watcher uses most of the global state, so it goes first
+    teardown_global_settings_watcher();
+
     // Guarantee release of the preloaded ICD libraries. This may have already been called in vkDestroyInstance.
     loader_unload_preloaded_icds();
+    loader_unload_cached_layer_libraries();
 
     // release mutexes
+    teardown_global_envvar_snapshot();
+    teardown_global_manifest_cache();
     teardown_global_loader_settings();
+    teardown_global_log_sinks();
+    teardown_global_phase_timing();
     loader_platform_thread_delete_mutex(&loader_lock);
     loader_platform_thread_delete_mutex(&loader_preload_icd_lock);
+    loader_platform_thread_delete_mutex(&loader_layer_library_lock);
+    loader_free(NULL, loader.device_index.entries);
+    memset(&loader.device_index, 0, sizeof(loader.device_index));
+    loader_platform_thread_delete_rwlock(&loader_object_lookup_lock);
 }
 
 // Preload the ICD libraries that are likely to be needed so we don't repeatedly load/unload them later
@@ -3401,6 +3963,7 @@ VkResult add_data_files(const struct loader_instance *inst, struct loader_string
 #if !defined(_WIN32)
     char temp_path[2048];
 #endif
+    bool use_manifest_cache = loader_manifest_cache_enabled(inst);
 
     for (size_t i = 0; i < search_paths->count; i++) {
         // Now, parse the paths
@@ -3446,6 +4009,17 @@ VkResult add_data_files(const struct loader_instance *inst, struct loader_string
                     break;
                 }
             } else {  // Otherwise, treat it as a directory
+                struct loader_manifest_cache_stamp dir_stamp = {0};
+                if (use_manifest_cache) {
+                    VkResult cache_res = loader_manifest_cache_get_directory(inst, cur_file, &dir_stamp, out_files);
+                    if (VK_SUCCESS == cache_res) {
+                        continue;
+                    } else if (VK_ERROR_OUT_OF_HOST_MEMORY == cache_res) {
+                        vk_result = cache_res;
+                        goto out;
+                    }
+                }
+                uint32_t first_file = out_files->count;
                 DIR *dir_stream = loader_opendir(inst, cur_file);
                 if (NULL == dir_stream) {
                     continue;
@@ -3482,6 +4056,9 @@ VkResult add_data_files(const struct loader_instance *inst, struct loader_string
                 if (vk_result != VK_SUCCESS) {
                     goto out;
                 }
+                if (use_manifest_cache) {
+                    loader_manifest_cache_store_directory(cur_file, &dir_stamp, out_files, first_file);
+                }
             }
         }
     }
@@ -3493,9 +4070,10 @@ out:
 
 // Look for data files in the provided paths, but first check the environment override to determine if we should use that
 // instead.
+// If out_search_paths is not NULL, it receives the list of paths which were searched.
 VkResult read_data_files_in_search_paths(const struct loader_instance *inst, enum loader_data_files_type manifest_type,
                                          const struct loader_string_list *path_overrides, bool *override_active,
-                                         struct loader_string_list *out_files) {
+                                         struct loader_string_list *out_files, struct loader_string_list *out_search_paths) {
     VkResult vk_result = VK_SUCCESS;
     char *override_env = NULL;
     char *additional_env = NULL;
@@ -3828,6 +4406,10 @@ out:
 #warning read_data_files_in_search_paths unsupported platform
 #endif
 
+    if (VK_SUCCESS == vk_result && NULL != out_search_paths) {
+        *out_search_paths = search_paths;
+        memset(&search_paths, 0, sizeof(struct loader_string_list));
+    }
     free_string_list(inst, &search_paths);
 
     return vk_result;
@@ -3857,14 +4439,16 @@ out:
 // Linux Layer| dirs     | dirs
 
 VkResult loader_get_data_files(const struct loader_instance *inst, enum loader_data_files_type manifest_type,
-                               const struct loader_string_list *path_overrides, struct loader_string_list *out_files) {
+                               const struct loader_string_list *path_overrides, struct loader_string_list *out_files,
+                               struct loader_string_list *out_search_paths) {
     VkResult res = VK_SUCCESS;
     bool override_active = false;
+    uint64_t phase_begin = loader_phase_begin();
 
     // Free and init the out_files information so there's no false data left from uninitialized variables.
     free_string_list(inst, out_files);
 
-    res = read_data_files_in_search_paths(inst, manifest_type, path_overrides, &override_active, out_files);
+    res = read_data_files_in_search_paths(inst, manifest_type, path_overrides, &override_active, out_files, out_search_paths);
     if (VK_SUCCESS != res) {
         goto out;
     }
@@ -3905,37 +4489,63 @@ out:
     if (VK_SUCCESS != res) {
         free_string_list(inst, out_files);
     }
+    loader_phase_end(LOADER_PHASE_MANIFEST_DISCOVERY, phase_begin, NULL);
 
     return res;
 }
 
-struct ICDManifestInfo {
-    char *full_library_path;
-    uint32_t version;
-};
-
 // Takes a json file, opens, reads, and parses an ICD Manifest out of it.
 // Should only return VK_SUCCESS, VK_ERROR_INCOMPATIBLE_DRIVER, or VK_ERROR_OUT_OF_HOST_MEMORY
 VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *file_str, struct ICDManifestInfo *icd,
                                    bool *skipped_portability_drivers) {
     VkResult res = VK_SUCCESS;
-    cJSON *icd_manifest_json = NULL;
+    struct loader_icd_manifest_fields fields = {0};
+    bool use_manifest_cache = false;
+    struct loader_manifest_cache_stamp manifest_stamp = {0};
 
     if (file_str == NULL) {
         goto out;
     }
 
-    res = loader_get_json(inst, file_str, &icd_manifest_json);
-    if (res == VK_ERROR_OUT_OF_HOST_MEMORY) {
-        goto out;
-    }
-    if (res != VK_SUCCESS || NULL == icd_manifest_json) {
-        res = VK_ERROR_INCOMPATIBLE_DRIVER;
+    use_manifest_cache = loader_manifest_cache_enabled(inst);
+    if (use_manifest_cache) {
+        res = loader_manifest_cache_get_driver(inst, file_str, &manifest_stamp, &icd->full_library_path, &icd->version,
+                                               &icd->is_portability_driver);
+        if (VK_SUCCESS == res) {
+            if (icd->is_portability_driver && inst && !inst->portability_enumeration_enabled) {
+                if (skipped_portability_drivers) {
+                    *skipped_portability_drivers = true;
+                }
+                res = VK_ERROR_INCOMPATIBLE_DRIVER;
+            }
+            goto out;
+        } else if (VK_ERROR_OUT_OF_HOST_MEMORY == res) {
+            goto out;
+        }
+        res = VK_SUCCESS;
+    }
+
+    // Well formed manifests are read in a single pass, anything else goes through cJSON which reports what is wrong with it
+    res = loader_read_icd_manifest_fields(inst, file_str, &fields);
+    if (VK_INCOMPLETE == res) {
+        cJSON *icd_manifest_json = NULL;
+        res = loader_get_json(inst, file_str, &icd_manifest_json);
+        if (res == VK_ERROR_OUT_OF_HOST_MEMORY) {
+            goto out;
+        }
+        if (res != VK_SUCCESS || NULL == icd_manifest_json) {
+            res = VK_ERROR_INCOMPATIBLE_DRIVER;
+            goto out;
+        }
+        res = loader_get_icd_manifest_fields_from_json(inst, icd_manifest_json, &fields);
+    }
+    if (VK_ERROR_OUT_OF_HOST_MEMORY == res) {
+        loader_log(inst, VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
+                   "loader_parse_icd_manifest: Out of memory while reading ICD JSON %s", file_str);
         goto out;
     }
 
-    cJSON *file_format_version_json = loader_cJSON_GetObjectItem(icd_manifest_json, "file_format_version");
-    if (file_format_version_json == NULL) {
+    if (!fields.has_file_format_version) {
         loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
                    "loader_parse_icd_manifest: ICD JSON %s does not have a \'file_format_version\' field. Skipping ICD JSON.",
                    file_str);
@@ -3943,7 +4553,7 @@ VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *fil
         goto out;
     }
 
-    char *file_vers_str = loader_cJSON_GetStringValue(file_format_version_json);
+    char *file_vers_str = fields.file_format_version;
     if (NULL == file_vers_str) {
         // Only reason the print can fail is if there was an allocation issue
         loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
@@ -3963,11 +4573,9 @@ VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *fil
                    json_file_version.major, json_file_version.minor, json_file_version.patch);
     }
 
-    cJSON *itemICD = loader_cJSON_GetObjectItem(icd_manifest_json, "ICD");
-    if (itemICD == NULL) {
+    if (!fields.has_icd) {
         // Don't warn if this happens to be a layer manifest file
-        if (loader_cJSON_GetObjectItem(icd_manifest_json, "layer") == NULL &&
-            loader_cJSON_GetObjectItem(icd_manifest_json, "layers") == NULL) {
+        if (!fields.has_layer) {
             loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
                        "loader_parse_icd_manifest: Can not find \'ICD\' object in ICD JSON file %s. Skipping ICD JSON", file_str);
         }
@@ -3975,45 +4583,38 @@ VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *fil
         goto out;
     }
 
-    cJSON *library_path_json = loader_cJSON_GetObjectItem(itemICD, "library_path");
-    if (library_path_json == NULL) {
+    if (!fields.has_library_path) {
         loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
                    "loader_parse_icd_manifest: Failed to find \'library_path\' object in ICD JSON file %s. Skipping ICD JSON.",
                    file_str);
         res = VK_ERROR_INCOMPATIBLE_DRIVER;
         goto out;
     }
-    bool out_of_memory = false;
-    char *library_path = loader_cJSON_Print(library_path_json, &out_of_memory);
-    if (out_of_memory) {
-        loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
-                   "loader_parse_icd_manifest: Failed retrieving ICD JSON %s \'library_path\' field. Skipping ICD JSON.", file_str);
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-        goto out;
-    } else if (!library_path || strlen(library_path) == 0) {
+    if (!fields.library_path || strlen(fields.library_path) == 0) {
         loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
                    "loader_parse_icd_manifest: ICD JSON %s \'library_path\' field is empty. Skipping ICD JSON.", file_str);
         res = VK_ERROR_INCOMPATIBLE_DRIVER;
-        loader_instance_heap_free(inst, library_path);
         goto out;
     }
 
     // Print out the paths being searched if debugging is enabled
-    loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "Searching for ICD drivers named %s", library_path);
+    loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "Searching for ICD drivers named %s",
+               fields.library_path);
     // This function takes ownership of library_path - so we don't need to clean it up
+    char *library_path = fields.library_path;
+    fields.library_path = NULL;
     res = combine_manifest_directory_and_library_path(inst, library_path, file_str, &icd->full_library_path);
     if (VK_SUCCESS != res) {
         goto out;
     }
 
-    cJSON *api_version_json = loader_cJSON_GetObjectItem(itemICD, "api_version");
-    if (api_version_json == NULL) {
+    if (!fields.has_api_version) {
         loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
                    "loader_parse_icd_manifest: ICD JSON %s does not have an \'api_version\' field. Skipping ICD JSON.", file_str);
         res = VK_ERROR_INCOMPATIBLE_DRIVER;
         goto out;
     }
-    char *version_str = loader_cJSON_GetStringValue(api_version_json);
+    char *version_str = fields.api_version;
     if (NULL == version_str) {
         // Only reason the print can fail is if there was an allocation issue
         loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
@@ -4034,8 +4635,8 @@ VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *fil
 
     // Skip over ICD's which contain a true "is_portability_driver" value whenever the application doesn't enable
     // portability enumeration.
-    cJSON *is_portability_driver_json = loader_cJSON_GetObjectItem(itemICD, "is_portability_driver");
-    if (loader_cJSON_IsTrue(is_portability_driver_json) && inst && !inst->portability_enumeration_enabled) {
+    icd->is_portability_driver = fields.is_portability_driver;
+    if (icd->is_portability_driver && inst && !inst->portability_enumeration_enabled) {
         if (skipped_portability_drivers) {
             *skipped_portability_drivers = true;
         }
@@ -4043,7 +4644,7 @@ VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *fil
         goto out;
     }
 
-    char *library_arch_str = loader_cJSON_GetStringValue(loader_cJSON_GetObjectItem(itemICD, "library_arch"));
+    char *library_arch_str = fields.library_arch;
     if (library_arch_str != NULL) {
         if ((strncmp(library_arch_str, "32", 2) == 0 && sizeof(void *) != 4) ||
             (strncmp(library_arch_str, "64", 2) == 0 && sizeof(void *) != 8)) {
@@ -4054,11 +4655,63 @@ VkResult loader_parse_icd_manifest(const struct loader_instance *inst, char *fil
             goto out;
         }
     }
+
+    if (use_manifest_cache) {
+        loader_manifest_cache_store_driver(file_str, &manifest_stamp, icd->full_library_path, icd->version,
+                                           icd->is_portability_driver);
+    }
 out:
-    loader_cJSON_Delete(icd_manifest_json);
+    loader_free_icd_manifest_fields(inst, &fields);
     return res;
 }
 
+// Add the driver described by icd_details to icd_tramp_list, logging why it was skipped if it can't be used.
+// Only returns an error if the loader ran out of memory.
+static VkResult loader_icd_scan_add_driver(const struct loader_instance *inst, struct loader_icd_tramp_list *icd_tramp_list,
+                                           const struct ICDManifestInfo *icd_details, struct loader_icd_negotiation *negotiation) {
+    enum loader_layer_library_status lib_status;
+    VkResult icd_res = loader_scanned_icd_add(inst, icd_tramp_list, icd_details->full_library_path, icd_details->version,
+                                              &lib_status, negotiation);
+    if (VK_ERROR_OUT_OF_HOST_MEMORY == icd_res) {
+        return icd_res;
+    } else if (VK_ERROR_INCOMPATIBLE_DRIVER == icd_res) {
+        switch (lib_status) {
+            case LOADER_LAYER_LIB_NOT_LOADED:
+            case LOADER_LAYER_LIB_ERROR_FAILED_TO_LOAD:
+                loader_log(inst, VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
+                           "loader_icd_scan: Failed loading library associated with ICD JSON %s. Ignoring this JSON",
+                           icd_details->full_library_path);
+                break;
+            case LOADER_LAYER_LIB_ERROR_WRONG_BIT_TYPE: {
+                loader_log(inst, VULKAN_LOADER_DRIVER_BIT, 0, "Requested ICD %s was wrong bit-type. Ignoring this JSON",
+                           icd_details->full_library_path);
+                break;
+            }
+            case LOADER_LAYER_LIB_SUCCESS_LOADED:
+            case LOADER_LAYER_LIB_ERROR_OUT_OF_MEMORY:
+                // Shouldn't be able to reach this but if it is, best to report a debug
+                loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
+                           "Shouldn't reach this. A valid version of requested ICD %s was loaded but something bad "
+                           "happened afterwards.",
+                           icd_details->full_library_path);
+                break;
+        }
+    }
+    return VK_SUCCESS;
+}
+
+struct loader_icd_scan_parallel_open {
+    const struct ICDManifestInfo *icd_details;
+    const uint32_t *selected_drivers;  // Indices into icd_details of the drivers to open, in manifest order
+    struct loader_icd_negotiation *negotiations;
+};
+
+static void loader_icd_scan_open_driver_task(void *user_data, uint32_t task_index) {
+    struct loader_icd_scan_parallel_open *parallel_open = (struct loader_icd_scan_parallel_open *)user_data;
+    const struct ICDManifestInfo *icd_details = &parallel_open->icd_details[parallel_open->selected_drivers[task_index]];
+    loader_open_and_negotiate_icd(icd_details->full_library_path, &parallel_open->negotiations[task_index]);
+}
+
 // Try to find the Vulkan ICD driver(s).
 //
 // This function scans the default system loader path(s) or path specified by either the
@@ -4080,6 +4733,14 @@ VkResult loader_icd_scan(const struct loader_instance *inst, struct loader_icd_t
     struct loader_envvar_filter select_filter = {0};
     struct loader_envvar_filter disable_filter = {0};
     struct ICDManifestInfo *icd_details = NULL;
+    bool icd_details_from_snapshot = false;
+    struct loader_string_list search_paths = {0};
+    struct loader_string_list settings_driver_files = {0};
+    uint32_t scan_snapshot_flags = 0;
+    uint32_t worker_thread_count = loader_get_worker_thread_count(inst);
+    uint32_t *selected_drivers = NULL;
+    uint32_t selected_driver_count = 0;
+    struct loader_icd_negotiation *negotiations = NULL;
 
     // Set up the ICD Trampoline list so elements can be written into it.
     res = loader_init_scanned_icd_list(inst, icd_tramp_list);
@@ -4098,7 +4759,8 @@ VkResult loader_icd_scan(const struct loader_instance *inst, struct loader_icd_t
         goto out;
     }
 
-    if (loader_settings_should_use_driver_environment_variables(inst)) {
+    bool use_driver_env_vars = loader_settings_should_use_driver_environment_variables(inst);
+    if (use_driver_env_vars) {
         // Parse the filter environment variables to determine if we have any special behavior
         res = parse_generic_filter_environment_var(inst, VK_DRIVERS_SELECT_ENV_VAR, &select_filter);
         if (VK_SUCCESS != res) {
@@ -4110,34 +4772,94 @@ VkResult loader_icd_scan(const struct loader_instance *inst, struct loader_icd_t
         }
     }
 
-    // Get a list of manifest files for ICDs
-    res = loader_get_data_files(inst, LOADER_DATA_FILE_MANIFEST_DRIVER, NULL, &manifest_files);
-    if (VK_SUCCESS != res) {
-        goto out;
+    bool use_scan_snapshot = loader_scan_snapshot_enabled(inst);
+    if (use_scan_snapshot) {
+        // The drivers listed in the settings file are part of what identifies the scan
+        res = loader_settings_get_additional_driver_files(inst, &settings_driver_files);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+        if (use_driver_env_vars) {
+            scan_snapshot_flags |= LOADER_SCAN_SNAPSHOT_USE_DRIVER_ENV_VARS;
+        }
+        if (loader_settings_should_use_additional_drivers_exclusively(inst)) {
+            scan_snapshot_flags |= LOADER_SCAN_SNAPSHOT_ADDITIONAL_DRIVERS_EXCLUSIVE;
+        }
+        res = loader_scan_snapshot_get_drivers(inst, &settings_driver_files, scan_snapshot_flags, &manifest_files, &icd_details);
+        if (VK_SUCCESS == res) {
+            icd_details_from_snapshot = true;
+        } else if (VK_ERROR_OUT_OF_HOST_MEMORY == res) {
+            goto out;
+        }
+        res = VK_SUCCESS;
     }
 
-    // Add any drivers provided by the loader settings file
-    res = loader_settings_get_additional_driver_files(inst, &manifest_files);
-    if (VK_SUCCESS != res) {
-        goto out;
+    if (!icd_details_from_snapshot) {
+        // Get a list of manifest files for ICDs
+        res = loader_get_data_files(inst, LOADER_DATA_FILE_MANIFEST_DRIVER, NULL, &manifest_files,
+                                    use_scan_snapshot ? &search_paths : NULL);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+
+        // Add any drivers provided by the loader settings file
+        res = loader_settings_get_additional_driver_files(inst, &manifest_files);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+        loader_pre_instance_cache_watch_paths(&search_paths);
+        loader_pre_instance_cache_watch_paths(&manifest_files);
+
+        icd_details = loader_stack_alloc(sizeof(struct ICDManifestInfo) * manifest_files.count);
+        if (NULL == icd_details) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        memset(icd_details, 0, sizeof(struct ICDManifestInfo) * manifest_files.count);
     }
 
-    icd_details = loader_stack_alloc(sizeof(struct ICDManifestInfo) * manifest_files.count);
-    if (NULL == icd_details) {
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-        goto out;
+    // Only a freshly made scan which doesn't depend on the application's create info is worth remembering
+    bool scan_snapshot_complete = use_scan_snapshot && !icd_details_from_snapshot;
+
+    // With worker threads, the driver libraries are opened and negotiated with concurrently after all manifests were filtered
+    if (worker_thread_count > 1 && manifest_files.count > 1) {
+        selected_drivers = loader_stack_alloc(sizeof(uint32_t) * manifest_files.count);
+        negotiations = loader_stack_alloc(sizeof(struct loader_icd_negotiation) * manifest_files.count);
+        if (NULL == selected_drivers || NULL == negotiations) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        memset(negotiations, 0, sizeof(struct loader_icd_negotiation) * manifest_files.count);
     }
-    memset(icd_details, 0, sizeof(struct ICDManifestInfo) * manifest_files.count);
 
     for (uint32_t i = 0; i < manifest_files.count; i++) {
         VkResult icd_res = VK_SUCCESS;
 
-        icd_res = loader_parse_icd_manifest(inst, manifest_files.list[i], &icd_details[i], skipped_portability_drivers);
-        if (VK_ERROR_OUT_OF_HOST_MEMORY == icd_res) {
-            res = icd_res;
-            goto out;
-        } else if (VK_ERROR_INCOMPATIBLE_DRIVER == icd_res) {
-            continue;
+        if (icd_details_from_snapshot) {
+            // Manifests which failed to parse have no library path
+            if (NULL == icd_details[i].full_library_path) {
+                continue;
+            }
+            if (icd_details[i].is_portability_driver && inst && !inst->portability_enumeration_enabled) {
+                if (skipped_portability_drivers) {
+                    *skipped_portability_drivers = true;
+                }
+                continue;
+            }
+        } else {
+            icd_res = loader_parse_icd_manifest(inst, manifest_files.list[i], &icd_details[i], skipped_portability_drivers);
+            if (VK_ERROR_OUT_OF_HOST_MEMORY == icd_res) {
+                res = icd_res;
+                goto out;
+            } else if (VK_ERROR_INCOMPATIBLE_DRIVER == icd_res) {
+                // Portability drivers may have been skipped before the rest of the manifest was checked
+                if (icd_details[i].is_portability_driver) {
+                    scan_snapshot_complete = false;
+                }
+                loader_instance_heap_free(inst, icd_details[i].full_library_path);
+                icd_details[i].full_library_path = NULL;
+                continue;
+            }
         }
 
         if (select_filter.count > 0 || disable_filter.count > 0) {
@@ -4170,48 +4892,76 @@ VkResult loader_icd_scan(const struct loader_instance *inst, struct loader_icd_t
             }
         }
 
-        enum loader_layer_library_status lib_status;
-        icd_res =
-            loader_scanned_icd_add(inst, icd_tramp_list, icd_details[i].full_library_path, icd_details[i].version, &lib_status);
-        if (VK_ERROR_OUT_OF_HOST_MEMORY == icd_res) {
-            res = icd_res;
+        if (NULL != negotiations) {
+            // Opened and added in manifest order once the worker threads are done with every selected driver
+            selected_drivers[selected_driver_count++] = i;
+            continue;
+        }
+
+        res = loader_icd_scan_add_driver(inst, icd_tramp_list, &icd_details[i], NULL);
+        if (VK_ERROR_OUT_OF_HOST_MEMORY == res) {
             goto out;
-        } else if (VK_ERROR_INCOMPATIBLE_DRIVER == icd_res) {
-            switch (lib_status) {
-                case LOADER_LAYER_LIB_NOT_LOADED:
-                case LOADER_LAYER_LIB_ERROR_FAILED_TO_LOAD:
-                    loader_log(inst, VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
-                               "loader_icd_scan: Failed loading library associated with ICD JSON %s. Ignoring this JSON",
-                               icd_details[i].full_library_path);
-                    break;
-                case LOADER_LAYER_LIB_ERROR_WRONG_BIT_TYPE: {
-                    loader_log(inst, VULKAN_LOADER_DRIVER_BIT, 0, "Requested ICD %s was wrong bit-type. Ignoring this JSON",
-                               icd_details[i].full_library_path);
-                    break;
+        }
+    }
+
+    if (selected_driver_count > 0) {
+        struct loader_icd_scan_parallel_open parallel_open = {0};
+        parallel_open.icd_details = icd_details;
+        parallel_open.selected_drivers = selected_drivers;
+        parallel_open.negotiations = negotiations;
+        loader_run_tasks_in_parallel(selected_driver_count, worker_thread_count, loader_icd_scan_open_driver_task, &parallel_open);
+
+        for (uint32_t i = 0; i < selected_driver_count; i++) {
+            res = loader_icd_scan_add_driver(inst, icd_tramp_list, &icd_details[selected_drivers[i]], &negotiations[i]);
+            if (VK_ERROR_OUT_OF_HOST_MEMORY == res) {
+                // loader_icd_scan_add_driver took ownership of the libraries of drivers up to and including i
+                for (uint32_t j = i + 1; j < selected_driver_count; j++) {
+                    if (NULL != negotiations[j].handle) {
+                        loader_platform_close_library(negotiations[j].handle);
+                    }
                 }
-                case LOADER_LAYER_LIB_SUCCESS_LOADED:
-                case LOADER_LAYER_LIB_ERROR_OUT_OF_MEMORY:
-                    // Shouldn't be able to reach this but if it is, best to report a debug
-                    loader_log(inst, VULKAN_LOADER_WARN_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
-                               "Shouldn't reach this. A valid version of requested ICD %s was loaded but something bad "
-                               "happened afterwards.",
-                               icd_details[i].full_library_path);
-                    break;
+                goto out;
             }
         }
     }
 
+    if (scan_snapshot_complete) {
+        loader_scan_snapshot_store_drivers(inst, &settings_driver_files, scan_snapshot_flags, &search_paths, &manifest_files,
+                                           icd_details);
+    }
+
 out:
     if (NULL != icd_details) {
         // Successfully got the icd_details structure, which means we need to free the paths contained within
         for (uint32_t i = 0; i < manifest_files.count; i++) {
             loader_instance_heap_free(inst, icd_details[i].full_library_path);
         }
+        if (icd_details_from_snapshot) {
+            loader_instance_heap_free(inst, icd_details);
+        }
     }
     free_string_list(inst, &manifest_files);
+    free_string_list(inst, &search_paths);
+    free_string_list(inst, &settings_driver_files);
+    loader_manifest_cache_flush(inst);
     return res;
 }
 
+struct loader_layer_manifest_parallel_parse {
+    const struct loader_string_list *manifest_files;
+    cJSON **json;  // One parse tree per manifest file, NULL if it couldn't be read or parsed
+};
+
+// Runs on a worker thread, so the application's allocation callbacks must not be called from here. The trees are built with the
+// system allocator instead, which is only equivalent to the instance's allocator when the application didn't supply one.
+static void loader_parse_layer_manifest_task(void *user_data, uint32_t task_index) {
+    struct loader_layer_manifest_parallel_parse *parallel_parse = (struct loader_layer_manifest_parallel_parse *)user_data;
+    const char *file_str = parallel_parse->manifest_files->list[task_index];
+    if (NULL != file_str) {
+        loader_get_json_without_logging(NULL, file_str, &parallel_parse->json[task_index]);
+    }
+}
+
 // Gets the layer data files corresponding to manifest_type & path_override, then parses the resulting json objects
 // into instance_layers
 // Manifest type must be either implicit or explicit
@@ -4220,11 +4970,46 @@ VkResult loader_parse_instance_layers(struct loader_instance *inst, enum loader_
     assert(manifest_type == LOADER_DATA_FILE_MANIFEST_IMPLICIT_LAYER || manifest_type == LOADER_DATA_FILE_MANIFEST_EXPLICIT_LAYER);
     VkResult res = VK_SUCCESS;
     struct loader_string_list manifest_files = {0};
+    bool is_implicit = manifest_type == LOADER_DATA_FILE_MANIFEST_IMPLICIT_LAYER;
+    bool use_manifest_cache = loader_manifest_cache_enabled(inst);
+    bool use_scan_snapshot = loader_scan_snapshot_enabled(inst);
+    struct loader_string_list search_paths = {0};
+    uint32_t scan_first_layer = instance_layers->count;
+    cJSON **parsed_json = NULL;
 
-    res = loader_get_data_files(inst, manifest_type, path_overrides, &manifest_files);
+    if (use_scan_snapshot) {
+        res = loader_scan_snapshot_get_layers(inst, is_implicit, path_overrides, instance_layers);
+        if (VK_SUCCESS == res || VK_ERROR_OUT_OF_HOST_MEMORY == res) {
+            goto out;
+        }
+        res = VK_SUCCESS;
+    }
+
+    res = loader_get_data_files(inst, manifest_type, path_overrides, &manifest_files, use_scan_snapshot ? &search_paths : NULL);
     if (VK_SUCCESS != res) {
         goto out;
     }
+    loader_pre_instance_cache_watch_paths(&search_paths);
+    loader_pre_instance_cache_watch_paths(&manifest_files);
+
+    // Read and parse all of the manifests on worker threads up front, then add their layers in order below so that the layer
+    // order, and with it which duplicate layer is kept, doesn't change. The manifest cache already skips parsing for most files.
+    // Strings taken from the trees end up owned by the instance, so this is skipped when the application supplied its own
+    // allocator, as its callbacks are neither safe to call from the worker threads nor interchangeable with the system allocator.
+    uint32_t worker_thread_count = loader_get_worker_thread_count(inst);
+    bool app_allocator = NULL != inst && NULL != inst->alloc_callbacks.pfnAllocation;
+    if (worker_thread_count > 1 && manifest_files.count > 1 && !use_manifest_cache && !app_allocator) {
+        parsed_json = loader_stack_alloc(sizeof(cJSON *) * manifest_files.count);
+        if (NULL == parsed_json) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        memset(parsed_json, 0, sizeof(cJSON *) * manifest_files.count);
+        struct loader_layer_manifest_parallel_parse parallel_parse = {0};
+        parallel_parse.manifest_files = &manifest_files;
+        parallel_parse.json = parsed_json;
+        loader_run_tasks_in_parallel(manifest_files.count, worker_thread_count, loader_parse_layer_manifest_task, &parallel_parse);
+    }
 
     for (uint32_t i = 0; i < manifest_files.count; i++) {
         char *file_str = manifest_files.list[i];
@@ -4232,28 +5017,69 @@ VkResult loader_parse_instance_layers(struct loader_instance *inst, enum loader_
             continue;
         }
 
-        // Parse file into JSON struct
-        cJSON *json = NULL;
-        VkResult local_res = loader_get_json(inst, file_str, &json);
-        if (VK_ERROR_OUT_OF_HOST_MEMORY == local_res) {
-            res = VK_ERROR_OUT_OF_HOST_MEMORY;
-            goto out;
-        } else if (VK_SUCCESS != local_res || NULL == json) {
-            continue;
+        struct loader_manifest_cache_stamp manifest_stamp = {0};
+        if (use_manifest_cache) {
+            VkResult cache_res = loader_manifest_cache_get_layers(inst, file_str, is_implicit, &manifest_stamp, instance_layers);
+            if (VK_SUCCESS == cache_res) {
+                continue;
+            } else if (VK_ERROR_OUT_OF_HOST_MEMORY == cache_res) {
+                res = VK_ERROR_OUT_OF_HOST_MEMORY;
+                goto out;
+            }
         }
 
-        local_res = loader_add_layer_properties(inst, instance_layers, json,
-                                                manifest_type == LOADER_DATA_FILE_MANIFEST_IMPLICIT_LAYER, file_str);
-        loader_cJSON_Delete(json);
+        // Use the JSON struct if a worker thread already parsed the file. Otherwise well formed manifests are read in a single
+        // pass, and anything else is parsed into a JSON struct by cJSON which reports what is wrong with it. Files which failed
+        // on a worker thread are read again so that the error gets logged.
+        uint32_t first_layer = instance_layers->count;
+        cJSON *json = NULL;
+        VkResult local_res = VK_INCOMPLETE;
+        if (NULL != parsed_json && NULL != parsed_json[i]) {
+            json = parsed_json[i];
+            parsed_json[i] = NULL;
+        } else {
+            local_res = loader_read_layer_manifest(inst, file_str, is_implicit, instance_layers);
+        }
+        if (VK_INCOMPLETE == local_res) {
+            if (NULL == json) {
+                local_res = loader_get_json(inst, file_str, &json);
+                if (VK_ERROR_OUT_OF_HOST_MEMORY == local_res) {
+                    res = VK_ERROR_OUT_OF_HOST_MEMORY;
+                    goto out;
+                } else if (VK_SUCCESS != local_res || NULL == json) {
+                    continue;
+                }
+            }
+            local_res = loader_add_layer_properties(inst, instance_layers, json, is_implicit, file_str);
+            loader_cJSON_Delete(json);
+        }
 
         // If the error is anything other than out of memory we still want to try to load the other layers
         if (VK_ERROR_OUT_OF_HOST_MEMORY == local_res) {
             res = VK_ERROR_OUT_OF_HOST_MEMORY;
             goto out;
         }
+        if (use_manifest_cache) {
+            loader_manifest_cache_store_layers(file_str, is_implicit, &manifest_stamp, instance_layers, first_layer);
+        }
+    }
+
+    if (use_scan_snapshot) {
+        loader_scan_snapshot_store_layers(inst, is_implicit, path_overrides, &search_paths, &manifest_files, instance_layers,
+                                          scan_first_layer);
     }
 out:
+    if (NULL != parsed_json) {
+        // Only left over if the loop above bailed out early
+        for (uint32_t i = 0; i < manifest_files.count; i++) {
+            loader_cJSON_Delete(parsed_json[i]);
+        }
+    }
     free_string_list(inst, &manifest_files);
+    free_string_list(inst, &search_paths);
+    if (use_manifest_cache) {
+        loader_manifest_cache_flush(inst);
+    }
 
     return res;
 }
@@ -4659,25 +5485,35 @@ struct loader_instance *loader_get_instance(const VkInstance instance) {
         return NULL;
     } else {
         disp = loader_get_instance_layer_dispatch(instance);
-        loader_platform_thread_lock_mutex(&loader_lock);
+        loader_platform_thread_lock_rwlock_read(&loader_object_lookup_lock);
         for (struct loader_instance *inst = loader.instances; inst; inst = inst->next) {
             if (&inst->disp->layer_inst_disp == disp) {
                 ptr_instance = inst;
                 break;
             }
         }
-        loader_platform_thread_unlock_mutex(&loader_lock);
+        loader_platform_thread_unlock_rwlock_read(&loader_object_lookup_lock);
     }
     return ptr_instance;
 }
 
 loader_platform_dl_handle loader_open_layer_file(const struct loader_instance *inst, struct loader_layer_properties *prop) {
-    if ((prop->lib_handle = loader_platform_open_library(prop->lib_name)) == NULL) {
+    uint64_t phase_begin = loader_phase_begin();
+    if (0 != layer_library_cache.idle_timeout_ns) {
+        loader_evict_idle_layer_libraries(inst, loader_platform_get_time_ns());
+        loader_platform_thread_lock_mutex(&loader_layer_library_lock);
+        prop->lib_handle = loader_acquire_layer_library(prop->lib_name);
+        loader_platform_thread_unlock_mutex(&loader_layer_library_lock);
+    } else {
+        prop->lib_handle = loader_platform_open_library(prop->lib_name);
+    }
+    if (prop->lib_handle == NULL) {
         loader_handle_load_library_error(inst, prop->lib_name, &prop->lib_status);
     } else {
         prop->lib_status = LOADER_LAYER_LIB_SUCCESS_LOADED;
         loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Loading layer library %s", prop->lib_name);
     }
+    loader_phase_end(LOADER_PHASE_LAYER_LOAD, phase_begin, prop->lib_name);
 
     return prop->lib_handle;
 }
@@ -4910,7 +5746,8 @@ VKAPI_ATTR VkResult VKAPI_CALL loader_layer_create_device(VkInstance instance, V
     // Initialize WSI device extensions as part of core dispatch since loader
     // has dedicated trampoline code for these
     loader_init_device_extension_dispatch_table(&dev->loader_dispatch, inst->disp->layer_inst_disp.GetInstanceProcAddr,
-                                                dev->loader_dispatch.core_dispatch.GetDeviceProcAddr, inst->instance, *pDevice);
+                                                dev->loader_dispatch.core_dispatch.GetDeviceProcAddr, inst->instance, *pDevice,
+                                                inst->lazy_dispatch);
 
 out:
 
@@ -4921,6 +5758,7 @@ out:
             // Need to iterate the linked lists and remove the device from it. Don't delete
             // the device here since it may not have been added to the icd_term and there
             // are other allocations attached to it.
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
             struct loader_icd_term *icd_term = inst->icd_terms;
             bool found = false;
             while (!found && NULL != icd_term) {
@@ -4933,6 +5771,7 @@ out:
                         } else if (prev_dev) {
                             prev_dev->next = cur_dev->next;
                         }
+                        loader_unindex_logical_device(cur_dev);
 
                         found = true;
                         break;
@@ -4942,6 +5781,7 @@ out:
                 }
                 icd_term = icd_term->next;
             }
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
             // Now destroy the device and the allocations associated with it.
             loader_destroy_logical_device(dev, pAllocator);
         }
@@ -5283,7 +6123,7 @@ VkResult loader_create_instance_chain(const VkInstanceCreateInfo *pCreateInfo, c
         // Copy the current disp table into the terminator_dispatch table so we can use it in loader_gpa_instance_terminator()
         memcpy(&inst->terminator_dispatch, &inst->disp->layer_inst_disp, sizeof(VkLayerInstanceDispatchTable));
 
-        loader_init_instance_core_dispatch_table(&inst->disp->layer_inst_disp, next_gipa, *created_instance);
+        loader_init_instance_core_dispatch_table(&inst->disp->layer_inst_disp, next_gipa, *created_instance, inst->lazy_dispatch);
         inst->instance = *created_instance;
 
         if (pCreateInfo->enabledLayerCount > 0 && pCreateInfo->ppEnabledLayerNames != NULL) {
@@ -5305,7 +6145,88 @@ VkResult loader_create_instance_chain(const VkInstanceCreateInfo *pCreateInfo, c
 
 void loader_activate_instance_layer_extensions(struct loader_instance *inst, VkInstance created_inst) {
     loader_init_instance_extension_dispatch_table(&inst->disp->layer_inst_disp, inst->disp->layer_inst_disp.GetInstanceProcAddr,
-                                                  created_inst);
+                                                  created_inst, inst->lazy_dispatch);
+}
+
+bool loader_lazy_dispatch_enabled(const struct loader_instance *inst) {
+    char *env_value = loader_getenv(VK_LOADER_LAZY_DISPATCH_ENV_VAR, inst);
+    // NOLINTNEXTLINE(bugprone-not-null-terminated-result) - n=2 intentionally excludes "1x" values like "10"
+    bool enabled = NULL != env_value && 0 == strncmp(env_value, "1", 2);
+    loader_free_getenv(env_value, inst);
+    return enabled;
+}
+
+PFN_vkVoidFunction loader_lazy_resolve_device_command(const VkLayerDispatchTable *table, size_t table_offset,
+                                                      PFN_vkVoidFunction stub, const char *name) {
+    if (NULL == table) {
+        loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
+                   "%s: Invalid dispatchable handle", name);
+        abort(); /* Intentionally fail so user can correct issue. */
+    }
+
+    // The dispatch table is the first member of struct loader_device
+    const struct loader_device *dev = (const struct loader_device *)table;
+    PFN_vkVoidFunction *entry = (PFN_vkVoidFunction *)((char *)table + table_offset);
+    PFN_vkVoidFunction addr = (PFN_vkVoidFunction)loader_platform_atomic_load_pointer((void *const *)entry);
+    if (addr == stub) {
+        addr = table->GetDeviceProcAddr(dev->chain_device, name);
+        // Threads racing to resolve the same command all store the same pointer, so whichever store lands last is correct
+        loader_platform_atomic_store_pointer((void **)entry, (void *)addr);
+    }
+    return addr;
+}
+
+// Find the instance owning a lazily populated instance dispatch table, either through the VkInstance handle passed down the call
+// chain or through the dispatch table pointer stored in a dispatchable object
+static PFN_vkVoidFunction loader_lazy_resolve_instance_table_command(VkInstance instance, const VkLayerInstanceDispatchTable *disp,
+                                                                     size_t table_offset, PFN_vkVoidFunction stub,
+                                                                     const char *name) {
+    struct loader_instance *found_inst = NULL;
+    loader_platform_thread_lock_rwlock_read(&loader_object_lookup_lock);
+    for (struct loader_instance *inst = loader.instances; inst; inst = inst->next) {
+        if ((VK_NULL_HANDLE != instance && inst->instance == instance) || &inst->disp->layer_inst_disp == disp) {
+            found_inst = inst;
+            break;
+        }
+    }
+    loader_platform_thread_unlock_rwlock_read(&loader_object_lookup_lock);
+    if (NULL == found_inst) {
+        loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
+                   "%s: Unable to find the instance owning the dispatchable handle", name);
+        abort(); /* Intentionally fail so user can correct issue. */
+    }
+
+    PFN_vkVoidFunction *entry = (PFN_vkVoidFunction *)((char *)&found_inst->disp->layer_inst_disp + table_offset);
+    PFN_vkVoidFunction addr = (PFN_vkVoidFunction)loader_platform_atomic_load_pointer((void *const *)entry);
+    if (addr == stub) {
+        addr = found_inst->disp->layer_inst_disp.GetInstanceProcAddr(found_inst->instance, name);
+        // Threads racing to resolve the same command all store the same pointer, so whichever store lands last is correct
+        loader_platform_atomic_store_pointer((void **)entry, (void *)addr);
+    }
+    return addr;
+}
+
+PFN_vkVoidFunction loader_lazy_resolve_instance_command(VkInstance instance, size_t table_offset,
+                                                        PFN_vkVoidFunction stub, const char *name) {
+    if (VK_NULL_HANDLE == instance) {
+        loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
+                   "%s: Invalid instance handle", name);
+        abort(); /* Intentionally fail so user can correct issue. */
+    }
+    return loader_lazy_resolve_instance_table_command(instance, loader_get_instance_layer_dispatch(instance), table_offset, stub,
+                                                      name);
+}
+
+PFN_vkVoidFunction loader_lazy_resolve_physical_device_command(VkPhysicalDevice physical_device, size_t table_offset,
+                                                               PFN_vkVoidFunction stub, const char *name) {
+    if (VK_NULL_HANDLE == physical_device) {
+        loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
+                   "%s: Invalid physicalDevice handle", name);
+        abort(); /* Intentionally fail so user can correct issue. */
+    }
+    // Physical devices handed down the call chain carry the dispatch table of the instance they were enumerated from
+    return loader_lazy_resolve_instance_table_command(VK_NULL_HANDLE, loader_get_instance_layer_dispatch(physical_device),
+                                                      table_offset, stub, name);
 }
 
 #if defined(__APPLE__)
@@ -5543,7 +6464,7 @@ VkResult loader_create_device_chain(const VkPhysicalDevice pd, const VkDeviceCre
         if (res != VK_SUCCESS) {
             return res;
         }
-        dev->chain_device = created_device;
+        loader_set_logical_device_chain_device(dev, created_device);
 
         // Because we changed the pNext chain to use our own VkDeviceGroupDeviceCreateInfo, we need to fixup the chain to
         // point back at the original VkDeviceGroupDeviceCreateInfo.
@@ -5570,7 +6491,7 @@ VkResult loader_create_device_chain(const VkPhysicalDevice pd, const VkDeviceCre
     }
 
     // Initialize device dispatch table
-    loader_init_device_dispatch_table(&dev->loader_dispatch, nextGDPA, dev->chain_device);
+    loader_init_device_dispatch_table(&dev->loader_dispatch, nextGDPA, dev->chain_device, inst->lazy_dispatch);
     // Initialize the dispatch table to functions which need terminators
     // These functions point directly to the driver, not the terminator functions
     init_extension_device_proc_terminator_dispatch(dev);
@@ -5626,6 +6547,7 @@ VkResult loader_validate_instance_extensions(struct loader_instance *inst, const
 
     struct loader_pointer_layer_list active_layers = {0};
     struct loader_pointer_layer_list expanded_layers = {0};
+    struct loader_extension_name_set icd_ext_names = {0};
 
     if (pCreateInfo->enabledExtensionCount > 0 && pCreateInfo->ppEnabledExtensionNames == NULL) {
         loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
@@ -5670,6 +6592,16 @@ VkResult loader_validate_instance_extensions(struct loader_instance *inst, const
             goto out;
         }
     }
+
+    // Look the enabled extensions up in a name set of the driver extensions rather than scanning icd_exts for each of them
+    bool use_icd_ext_names = pCreateInfo->enabledExtensionCount > 1 && icd_exts->count > LOADER_EXTENSION_NAME_SET_MIN_COUNT;
+    if (use_icd_ext_names) {
+        res = loader_init_extension_name_set_from_list(inst, icd_exts, &icd_ext_names);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+    }
+
     for (uint32_t i = 0; i < pCreateInfo->enabledExtensionCount; i++) {
         VkStringErrorFlags result = vk_string_validate(MaxLoaderStringLength, pCreateInfo->ppEnabledExtensionNames[i]);
         if (result != VK_STRING_ERROR_NONE) {
@@ -5707,9 +6639,11 @@ VkResult loader_validate_instance_extensions(struct loader_instance *inst, const
             }
         }
 
-        extension_prop = get_extension_property(pCreateInfo->ppEnabledExtensionNames[i], icd_exts);
-
-        if (extension_prop) {
+        if (use_icd_ext_names) {
+            if (loader_extension_name_set_contains(&icd_ext_names, pCreateInfo->ppEnabledExtensionNames[i])) {
+                continue;
+            }
+        } else if (NULL != get_extension_property(pCreateInfo->ppEnabledExtensionNames[i], icd_exts)) {
             continue;
         }
 
@@ -5746,6 +6680,7 @@ VkResult loader_validate_instance_extensions(struct loader_instance *inst, const
 out:
     loader_destroy_pointer_layer_list(inst, &active_layers);
     loader_destroy_pointer_layer_list(inst, &expanded_layers);
+    loader_destroy_extension_name_set(inst, &icd_ext_names);
     if (enabled_layers_env != NULL) {
         loader_free_getenv(enabled_layers_env, inst);
     }
@@ -5760,6 +6695,18 @@ VkResult loader_validate_device_extensions(struct loader_instance *this_instance
     if (pCreateInfo->enabledExtensionCount == 0 || pCreateInfo->ppEnabledExtensionNames == NULL) {
         return VK_SUCCESS;
     }
+
+    VkResult res = VK_SUCCESS;
+    // Drivers expose hundreds of device extensions, so look the enabled ones up in a name set rather than scanning icd_exts
+    struct loader_extension_name_set icd_ext_names = {0};
+    bool use_icd_ext_names = pCreateInfo->enabledExtensionCount > 1 && icd_exts->count > LOADER_EXTENSION_NAME_SET_MIN_COUNT;
+    if (use_icd_ext_names) {
+        res = loader_init_extension_name_set_from_list(this_instance, icd_exts, &icd_ext_names);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+    }
+
     for (uint32_t i = 0; i < pCreateInfo->enabledExtensionCount; i++) {
         if (pCreateInfo->ppEnabledExtensionNames[i] == NULL) {
             continue;
@@ -5769,17 +6716,21 @@ VkResult loader_validate_device_extensions(struct loader_instance *this_instance
             loader_log(this_instance, VULKAN_LOADER_ERROR_BIT, 0,
                        "loader_validate_device_extensions: Device ppEnabledExtensionNames contains "
                        "string that is too long or is badly formed");
-            return VK_ERROR_EXTENSION_NOT_PRESENT;
+            res = VK_ERROR_EXTENSION_NOT_PRESENT;
+            goto out;
         }
 
         const char *extension_name = pCreateInfo->ppEnabledExtensionNames[i];
-        VkExtensionProperties *extension_prop = get_extension_property(extension_name, icd_exts);
-
-        if (extension_prop) {
+        if (use_icd_ext_names) {
+            if (loader_extension_name_set_contains(&icd_ext_names, extension_name)) {
+                continue;
+            }
+        } else if (NULL != get_extension_property(extension_name, icd_exts)) {
             continue;
         }
 
         // Not in global list, search activated layer extension lists
+        VkExtensionProperties *extension_prop = NULL;
         for (uint32_t j = 0; j < activated_device_layers->count; j++) {
             struct loader_layer_properties *layer_prop = activated_device_layers->list[j];
 
@@ -5796,10 +6747,14 @@ VkResult loader_validate_device_extensions(struct loader_instance *this_instance
                        "loader_validate_device_extensions: Device extension %s not supported by selected physical device "
                        "or enabled layers.",
                        pCreateInfo->ppEnabledExtensionNames[i]);
-            return VK_ERROR_EXTENSION_NOT_PRESENT;
+            res = VK_ERROR_EXTENSION_NOT_PRESENT;
+            goto out;
         }
     }
-    return VK_SUCCESS;
+
+out:
+    loader_destroy_extension_name_set(this_instance, &icd_ext_names);
+    return res;
 }
 
 // Terminator functions for the Instance chain
@@ -5897,7 +6852,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(const VkInstanceCreateI
         } else if (VK_SUCCESS != res) {
             // Something bad happened with this ICD, so free it and try the
             // next.
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
             ptr_instance->icd_terms = icd_term->next;
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
             icd_term->next = NULL;
             loader_icd_destroy(ptr_instance, icd_term, pAllocator);
             continue;
@@ -5912,7 +6869,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(const VkInstanceCreateI
                 goto out;
             } else {
                 // Something bad happened with this ICD, so free it and try the next.
+                loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
                 ptr_instance->icd_terms = icd_term->next;
+                loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
                 icd_term->next = NULL;
                 loader_icd_destroy(ptr_instance, icd_term, pAllocator);
                 continue;
@@ -6047,7 +7006,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(const VkInstanceCreateI
                        "terminator_CreateInstance: Received return code %i from call to vkCreateInstance in ICD %s. Skipping "
                        "this driver.",
                        icd_result, icd_term->scanned_icd->lib_name);
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
             ptr_instance->icd_terms = icd_term->next;
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
             icd_term->next = NULL;
             loader_icd_destroy(ptr_instance, icd_term, pAllocator);
             continue;
@@ -6057,7 +7018,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(const VkInstanceCreateI
             loader_log(ptr_instance, VULKAN_LOADER_WARN_BIT, 0,
                        "terminator_CreateInstance: Failed to find required entrypoints in ICD %s. Skipping this driver.",
                        icd_term->scanned_icd->lib_name);
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
             ptr_instance->icd_terms = icd_term->next;
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
             icd_term->next = NULL;
             loader_icd_destroy(ptr_instance, icd_term, pAllocator);
             continue;
@@ -6128,7 +7091,9 @@ out:
 
         while (NULL != ptr_instance->icd_terms) {
             icd_term = ptr_instance->icd_terms;
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
             ptr_instance->icd_terms = icd_term->next;
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
             if (NULL != icd_term->instance) {
                 loader_icd_close_objects(ptr_instance, icd_term);
                 icd_term->dispatch.DestroyInstance(icd_term->instance, pAllocator);
@@ -6157,6 +7122,7 @@ VKAPI_ATTR void VKAPI_CALL terminator_DestroyInstance(VkInstance instance, const
     }
 
     // Remove this instance from the list of instances:
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
     struct loader_instance *prev = NULL;
     struct loader_instance *next = loader.instances;
     while (next != NULL) {
@@ -6171,6 +7137,7 @@ VKAPI_ATTR void VKAPI_CALL terminator_DestroyInstance(VkInstance instance, const
         prev = next;
         next = next->next;
     }
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
 
     struct loader_icd_term *icd_terms = ptr_instance->icd_terms;
     while (NULL != icd_terms) {
@@ -6196,7 +7163,7 @@ VKAPI_ATTR void VKAPI_CALL terminator_DestroyInstance(VkInstance instance, const
             }
         }
         for (uint32_t i = 0; i < ptr_instance->phys_dev_count_term; i++) {
-            loader_instance_heap_free(ptr_instance, ptr_instance->phys_devs_term[i]);
+            loader_free_phys_dev_term(ptr_instance, ptr_instance->phys_devs_term[i]);
         }
         loader_instance_heap_free(ptr_instance, ptr_instance->phys_devs_term);
     }
@@ -6222,6 +7189,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDevice(VkPhysicalDevice physical
     struct loader_device *dev = (struct loader_device *)*pDevice;
     PFN_vkCreateDevice fpCreateDevice = icd_term->dispatch.CreateDevice;
     struct loader_extension_list icd_exts;
+    struct loader_extension_name_set icd_ext_names = {0};
 
     VkBaseOutStructure *caller_dgci_container = NULL;
     VkDeviceGroupDeviceCreateInfo *caller_dgci = NULL;
@@ -6281,12 +7249,28 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDevice(VkPhysicalDevice physical
         goto out;
     }
 
-    res = loader_add_device_extensions(icd_term->this_instance, icd_term->dispatch.EnumerateDeviceExtensionProperties,
-                                       phys_dev_term->phys_dev, icd_term->scanned_icd->lib_name, &icd_exts);
+    uint32_t driver_ext_count = 0;
+    const VkExtensionProperties *driver_exts = NULL;
+    res = loader_get_phys_dev_term_extensions(icd_term->this_instance, phys_dev_term, &driver_ext_count, &driver_exts);
+    if (res != VK_SUCCESS) {
+        loader_log(icd_term->this_instance, VULKAN_LOADER_ERROR_BIT, 0,
+                   "terminator_CreateDevice: Error getting physical device extension info from library %s",
+                   icd_term->scanned_icd->lib_name);
+        goto out;
+    }
+    res = loader_add_to_ext_list(icd_term->this_instance, &icd_exts, driver_ext_count, driver_exts);
     if (res != VK_SUCCESS) {
         goto out;
     }
 
+    bool use_icd_ext_names = pCreateInfo->enabledExtensionCount > 1 && icd_exts.count > LOADER_EXTENSION_NAME_SET_MIN_COUNT;
+    if (use_icd_ext_names) {
+        res = loader_init_extension_name_set_from_list(icd_term->this_instance, &icd_exts, &icd_ext_names);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+    }
+
     for (uint32_t i = 0; i < pCreateInfo->enabledExtensionCount; i++) {
         if (pCreateInfo->ppEnabledExtensionNames == NULL) {
             continue;
@@ -6295,8 +7279,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDevice(VkPhysicalDevice physical
         if (extension_name == NULL) {
             continue;
         }
-        VkExtensionProperties *prop = get_extension_property(extension_name, &icd_exts);
-        if (prop) {
+        bool supported = use_icd_ext_names ? loader_extension_name_set_contains(&icd_ext_names, extension_name)
+                                           : NULL != get_extension_property(extension_name, &icd_exts);
+        if (supported) {
             filtered_extension_names[localCreateInfo.enabledExtensionCount] = (char *)extension_name;
             localCreateInfo.enabledExtensionCount++;
         } else {
@@ -6305,6 +7290,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDevice(VkPhysicalDevice physical
                        icd_term->scanned_icd->lib_name);
         }
     }
+    loader_destroy_extension_name_set(icd_term->this_instance, &icd_ext_names);
 
     // Before we continue, If KHX_device_group is the list of enabled and viable extensions, then we then need to look for the
     // corresponding VkDeviceGroupDeviceCreateInfo struct in the device list and replace all the physical device values (which
@@ -6470,11 +7456,10 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDevice(VkPhysicalDevice physical
     dev->layer_extensions.ext_debug_utils_enabled = icd_term->this_instance->enabled_extensions.ext_debug_utils;
     dev->driver_extensions.ext_debug_utils_enabled = icd_term->this_instance->enabled_extensions.ext_debug_utils;
 
-    VkPhysicalDeviceProperties properties;
-    icd_term->dispatch.GetPhysicalDeviceProperties(phys_dev_term->phys_dev, &properties);
+    const VkPhysicalDeviceProperties *properties = loader_get_phys_dev_term_properties(phys_dev_term);
 
     loader_log(icd_term->this_instance, VULKAN_LOADER_LAYER_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
-               "       Using \"%s\" with driver: \"%s\"", properties.deviceName, icd_term->scanned_icd->lib_name);
+               "       Using \"%s\" with driver: \"%s\"", properties->deviceName, icd_term->scanned_icd->lib_name);
 
     res = fpCreateDevice(phys_dev_term->phys_dev, &localCreateInfo, pAllocator, &dev->icd_device);
     if (res != VK_SUCCESS) {
@@ -6484,15 +7469,16 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDevice(VkPhysicalDevice physical
     }
 
     *pDevice = dev->icd_device;
-    loader_add_logical_device(icd_term, dev);
 
-    // Init dispatch pointer in new device object
+    // Init dispatch pointer in new device object, before adding it so it gets indexed by that pointer
     loader_init_dispatch(*pDevice, &dev->loader_dispatch);
+    loader_add_logical_device(icd_term, dev);
 
 out:
     if (NULL != icd_exts.list) {
         loader_destroy_generic_list(icd_term->this_instance, (struct loader_generic_list *)&icd_exts);
     }
+    loader_destroy_extension_name_set(icd_term->this_instance, &icd_ext_names);
 
     // Restore pNext pointer to old VkDeviceGroupDeviceCreateInfo
     // in the chain to maintain consistency for the caller.
@@ -6510,12 +7496,15 @@ VkResult setup_loader_tramp_phys_devs(struct loader_instance *inst, uint32_t phy
     VkResult res = VK_SUCCESS;
     uint32_t found_count = 0;
     uint32_t old_count = inst->phys_dev_count_tramp;
-    uint32_t new_count = inst->total_gpu_count;
     struct loader_physical_device_tramp **new_phys_devs = NULL;
 
     if (0 == phys_dev_count) {
         return VK_SUCCESS;
     }
+    // total_gpu_count belongs to the terminator side of the bookkeeping
+    loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
+    uint32_t new_count = inst->total_gpu_count;
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
     if (phys_dev_count > new_count) {
         new_count = phys_dev_count;
     }
@@ -6649,9 +7638,11 @@ out:
             }
             loader_instance_heap_free(inst, new_phys_devs);
         } else {
+            loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
             if (new_count > inst->total_gpu_count) {
                 inst->total_gpu_count = new_count;
             }
+            loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
             // Free everything in the old array that was not copied into the new array
             // here.  We can't attempt to do that before here since the previous loop
             // looking before the "out:" label may hit an out of memory condition resulting
@@ -6659,7 +7650,7 @@ out:
             if (NULL != inst->phys_devs_tramp) {
                 for (uint32_t i = 0; i < inst->phys_dev_count_tramp; i++) {
                     bool found = false;
-                    for (uint32_t j = 0; j < inst->total_gpu_count; j++) {
+                    for (uint32_t j = 0; j < new_count; j++) {
                         if (inst->phys_devs_tramp[i] == new_phys_devs[j]) {
                             found = true;
                             break;
@@ -6676,7 +7667,9 @@ out:
         }
     }
     if (VK_SUCCESS != res) {
+        loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
         inst->total_gpu_count = 0;
+        loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
     }
 
     return res;
@@ -6736,7 +7729,7 @@ VkResult check_and_add_to_new_phys_devs(struct loader_instance *inst, VkPhysical
     }
     // If this physical device is new, we need to allocate space for it.
     new_phys_devs[idx] =
-        loader_instance_heap_alloc(inst, sizeof(struct loader_physical_device_term), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        loader_instance_heap_calloc(inst, sizeof(struct loader_physical_device_term), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
     if (NULL == new_phys_devs[idx]) {
         loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
                    "check_and_add_to_new_phys_devs:  Failed to allocate physical device terminator object %d", idx);
@@ -6761,6 +7754,8 @@ VkResult check_and_add_to_new_phys_devs(struct loader_instance *inst, VkPhysical
  * They also need to be setup - the icd_term, icd_index, phys_dev, and disp (dispatch table) all need the correct data.
  * Additionally, we need to keep using already setup physical devices as they may be in use, thus anything enumerated
  * that is already in inst->phys_devs_term will be carried over.
+ *
+ * Requires the instance's phys_dev_term_lock.
  */
 
 VkResult setup_loader_term_phys_devs(struct loader_instance *inst) {
@@ -6773,6 +7768,7 @@ VkResult setup_loader_term_phys_devs(struct loader_instance *inst) {
     uint32_t new_phys_devs_capacity = 0;
     uint32_t new_phys_devs_count = 0;
     struct loader_physical_device_term **new_phys_devs = NULL;
+    uint64_t phase_begin = loader_phase_begin();
 
 #if defined(_WIN32)
     // Get the physical devices supported by platform sorting mechanism into a separate list
@@ -6898,7 +7894,7 @@ VkResult setup_loader_term_phys_devs(struct loader_instance *inst) {
     if (is_linux_sort_enabled(inst)) {
         for (uint32_t dev = new_phys_devs_count; dev < new_phys_devs_capacity; ++dev) {
             new_phys_devs[dev] =
-                loader_instance_heap_alloc(inst, sizeof(struct loader_physical_device_term), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+                loader_instance_heap_calloc(inst, sizeof(struct loader_physical_device_term), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
             if (NULL == new_phys_devs[dev]) {
                 loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
                            "setup_loader_term_phys_devs:  Failed to allocate physical device terminator object %d", dev);
@@ -6922,7 +7918,7 @@ VkResult setup_loader_term_phys_devs(struct loader_instance *inst) {
                     loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_DRIVER_BIT, 0,
                                "Copying old device %u into new device %u", old_idx, new_idx);
                     // Free the old new_phys_devs info since we're not using it before we assign the new info
-                    loader_instance_heap_free(inst, new_phys_devs[new_idx]);
+                    loader_free_phys_dev_term(inst, new_phys_devs[new_idx]);
                     new_phys_devs[new_idx] = inst->phys_devs_term[old_idx];
                     break;
                 }
@@ -6970,7 +7966,7 @@ out:
                     }
                 }
                 if (!found) {
-                    loader_instance_heap_free(inst, new_phys_devs[i]);
+                    loader_free_phys_dev_term(inst, new_phys_devs[i]);
                 }
             }
             loader_instance_heap_free(inst, new_phys_devs);
@@ -6991,7 +7987,7 @@ out:
                     }
                 }
                 if (!found) {
-                    loader_instance_heap_free(inst, inst->phys_devs_term[i]);
+                    loader_free_phys_dev_term(inst, inst->phys_devs_term[i]);
                 }
             }
             loader_instance_heap_free(inst, inst->phys_devs_term);
@@ -7011,6 +8007,7 @@ out:
         }
         loader_instance_heap_free(inst, windows_sorted_devices_array);
     }
+    loader_phase_end(LOADER_PHASE_PHYSICAL_DEVICE_SETUP, phase_begin, NULL);
 
     return res;
 }
@@ -7019,13 +8016,41 @@ out:
  * This saves address space, which for 32 bit applications is scarce.
  * This must only be called after a call to vkEnumeratePhysicalDevices that isn't just querying the count
  */
+// Requires the instance's phys_dev_lock. Code holding only loader_lock or surface_lock also walks icd_terms, so both are taken
+// as well once it's clear that a driver has to go, followed by phys_dev_term_lock which guards the physical device counts.
 void unload_drivers_without_physical_devices(struct loader_instance *inst) {
+    bool has_driver_to_unload = false;
+    loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
+    for (struct loader_icd_term *icd_term = inst->icd_terms; NULL != icd_term; icd_term = icd_term->next) {
+        if (icd_term->physical_device_count == 0) {
+            has_driver_to_unload = true;
+            break;
+        }
+    }
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
+    if (!has_driver_to_unload) {
+        return;
+    }
+    loader_platform_thread_lock_mutex(&loader_lock);
+    loader_platform_thread_lock_mutex(&inst->surface_lock);
+    loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
+
     struct loader_icd_term *cur_icd_term = inst->icd_terms;
     struct loader_icd_term *prev_icd_term = NULL;
 
     while (NULL != cur_icd_term) {
         struct loader_icd_term *next_icd_term = cur_icd_term->next;
         if (cur_icd_term->physical_device_count == 0) {
+            // Lookups only hold loader_object_lookup_lock while walking icd_terms, so the driver has to be out of the list
+            // before it is destroyed
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
+            if (NULL == prev_icd_term) {
+                inst->icd_terms = next_icd_term;
+            } else {
+                prev_icd_term->next = next_icd_term;
+            }
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
+
             uint32_t cur_scanned_icd_index = UINT32_MAX;
             if (inst->icd_tramp_list.scanned_list) {
                 for (uint32_t i = 0; i < inst->icd_tramp_list.count; i++) {
@@ -7076,16 +8101,15 @@ void unload_drivers_without_physical_devices(struct loader_instance *inst) {
                 loader_unload_scanned_icd(inst, scanned_icd_to_remove);
             }
 
-            if (NULL == prev_icd_term) {
-                inst->icd_terms = next_icd_term;
-            } else {
-                prev_icd_term->next = next_icd_term;
-            }
         } else {
             prev_icd_term = cur_icd_term;
         }
         cur_icd_term = next_icd_term;
     }
+
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
+    loader_platform_thread_unlock_mutex(&inst->surface_lock);
+    loader_platform_thread_unlock_mutex(&loader_lock);
 }
 
 VkResult setup_loader_tramp_phys_dev_groups(struct loader_instance *inst, uint32_t group_count,
@@ -7137,6 +8161,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumeratePhysicalDevices(VkInstance in
     struct loader_instance *inst = (struct loader_instance *)instance;
     VkResult res = VK_SUCCESS;
 
+    // Layers may call down here without going through the trampoline, see phys_dev_term_lock
+    loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
+
     // Always call the setup loader terminator physical devices because they may
     // have changed at any point.
     res = setup_loader_term_phys_devs(inst);
@@ -7175,7 +8202,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumeratePhysicalDevices(VkInstance in
     }
 
 out:
-
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
     return res;
 }
 
@@ -7183,24 +8210,13 @@ VkResult check_physical_device_extensions_for_driver_properties_extension(struct
                                                                           bool *supports_driver_properties) {
     *supports_driver_properties = false;
     uint32_t extension_count = 0;
-    VkResult res = phys_dev_term->this_icd_term->dispatch.EnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL,
-                                                                                             &extension_count, NULL);
-    if (res != VK_SUCCESS || extension_count == 0) {
-        return VK_SUCCESS;
-    }
-    VkExtensionProperties *extension_data = loader_stack_alloc(sizeof(VkExtensionProperties) * extension_count);
-    if (NULL == extension_data) {
-        return VK_ERROR_OUT_OF_HOST_MEMORY;
-    }
-
-    uint32_t allocated_count = extension_count;
-    res = phys_dev_term->this_icd_term->dispatch.EnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL, &extension_count,
-                                                                                    extension_data);
-    if (res != VK_SUCCESS) {
-        return VK_SUCCESS;
+    const VkExtensionProperties *extension_data = NULL;
+    VkResult res = loader_get_phys_dev_term_extensions(phys_dev_term->this_icd_term->this_instance, phys_dev_term,
+                                                       &extension_count, &extension_data);
+    if (res == VK_ERROR_OUT_OF_HOST_MEMORY) {
+        return res;
     }
-    // The count returned by the second call sizes the array, but never read past what we actually allocated.
-    for (uint32_t j = 0; j < extension_count && j < allocated_count; j++) {
+    for (uint32_t j = 0; j < extension_count; j++) {
         if (!strcmp(extension_data[j].extensionName, VK_KHR_DRIVER_PROPERTIES_EXTENSION_NAME)) {
             *supports_driver_properties = true;
             return VK_SUCCESS;
@@ -7239,7 +8255,7 @@ VkResult loader_apply_settings_device_configurations(struct loader_instance *ins
     for (uint32_t i = 0; i < inst->phys_dev_count_term; i++) {
         struct loader_physical_device_term *phys_dev_term = inst->phys_devs_term[i];
 
-        phys_dev_term->this_icd_term->dispatch.GetPhysicalDeviceProperties(phys_dev_term->phys_dev, &pd_details[i].properties);
+        pd_details[i].properties = *loader_get_phys_dev_term_properties(phys_dev_term);
         if (pd_details[i].properties.apiVersion < VK_API_VERSION_1_1) {
             // Device isn't eligible for sorting
             continue;
@@ -7424,12 +8440,20 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateDeviceExtensionProperties(VkP
     // user is querying driver extensions and has supplied their own storage - just fill it out
     else if (pProperties) {
         struct loader_icd_term *icd_term = phys_dev_term->this_icd_term;
-        uint32_t written_count = *pPropertyCount;
-        VkResult res =
-            icd_term->dispatch.EnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL, &written_count, pProperties);
+        uint32_t driver_ext_count = 0;
+        const VkExtensionProperties *driver_exts = NULL;
+        VkResult res = loader_get_phys_dev_term_extensions(icd_term->this_instance, phys_dev_term, &driver_ext_count, &driver_exts);
         if (res != VK_SUCCESS) {
             return res;
         }
+        uint32_t written_count = *pPropertyCount < driver_ext_count ? *pPropertyCount : driver_ext_count;
+        if (written_count > 0) {
+            memcpy(pProperties, driver_exts, sizeof(VkExtensionProperties) * written_count);
+        }
+        if (written_count < driver_ext_count) {
+            *pPropertyCount = written_count;
+            return VK_INCOMPLETE;
+        }
 
         // Iterate over active layers, if they are an implicit layer, add their device extensions
         // After calling into the driver, written_count contains the amount of device extensions written. We can therefore write
@@ -7463,40 +8487,57 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateDeviceExtensionProperties(VkP
     // This case is during the call down the instance chain with pLayerName == NULL and pProperties == NULL
     struct loader_icd_term *icd_term = phys_dev_term->this_icd_term;
     struct loader_extension_list all_exts = {0};
+    uint32_t driver_ext_count = 0;
+    const VkExtensionProperties *driver_exts = NULL;
     VkResult res;
 
-    // We need to find the count without duplicates. This requires querying the driver for the names of the extensions.
-    res = icd_term->dispatch.EnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL, &all_exts.count, NULL);
+    // We need to find the count without duplicates. This requires the names of the driver's extensions.
+    res = loader_get_phys_dev_term_extensions(icd_term->this_instance, phys_dev_term, &driver_ext_count, &driver_exts);
     if (res != VK_SUCCESS) {
         goto out;
     }
     // Then allocate memory to store the physical device extension list + the extensions layers provide
-    // all_exts.count currently is the number of driver extensions
-    all_exts.capacity = sizeof(VkExtensionProperties) * (all_exts.count + 20);
+    all_exts.capacity = sizeof(VkExtensionProperties) * (driver_ext_count + 20);
     all_exts.list = loader_instance_heap_alloc(icd_term->this_instance, all_exts.capacity, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
     if (NULL == all_exts.list) {
         res = VK_ERROR_OUT_OF_HOST_MEMORY;
         goto out;
     }
 
-    // Get the available device extensions and put them in all_exts.list
-    res = icd_term->dispatch.EnumerateDeviceExtensionProperties(phys_dev_term->phys_dev, NULL, &all_exts.count, all_exts.list);
-    if (res != VK_SUCCESS) {
-        goto out;
+    // Put the available device extensions in all_exts.list
+    if (driver_ext_count > 0) {
+        memcpy(all_exts.list, driver_exts, sizeof(VkExtensionProperties) * driver_ext_count);
     }
+    all_exts.count = driver_ext_count;
 
     // Iterate over active layers, if they are an implicit layer, add their device extensions to all_exts.list
-    for (uint32_t i = 0; i < icd_term->this_instance->expanded_activated_layer_list.count; i++) {
-        struct loader_layer_properties *layer_props = icd_term->this_instance->expanded_activated_layer_list.list[i];
-        if (0 == (layer_props->type_flags & VK_LAYER_TYPE_FLAG_EXPLICIT_LAYER)) {
-            struct loader_device_extension_list *layer_ext_list = &layer_props->device_extension_list;
-            for (uint32_t j = 0; j < layer_ext_list->count; j++) {
-                res = loader_add_to_ext_list(icd_term->this_instance, &all_exts, 1, &layer_ext_list->list[j].props);
-                if (res != VK_SUCCESS) {
-                    goto out;
+    // The layer extensions are gathered first so that they are merged with the driver extensions in one go
+    const struct loader_pointer_layer_list *active_layers = &icd_term->this_instance->expanded_activated_layer_list;
+    uint32_t layer_ext_count = 0;
+    for (uint32_t i = 0; i < active_layers->count; i++) {
+        if (0 == (active_layers->list[i]->type_flags & VK_LAYER_TYPE_FLAG_EXPLICIT_LAYER)) {
+            layer_ext_count += active_layers->list[i]->device_extension_list.count;
+        }
+    }
+    if (layer_ext_count > 0) {
+        VkExtensionProperties *layer_exts = loader_stack_alloc(sizeof(VkExtensionProperties) * layer_ext_count);
+        if (NULL == layer_exts) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        uint32_t written_layer_exts = 0;
+        for (uint32_t i = 0; i < active_layers->count; i++) {
+            if (0 == (active_layers->list[i]->type_flags & VK_LAYER_TYPE_FLAG_EXPLICIT_LAYER)) {
+                struct loader_device_extension_list *layer_ext_list = &active_layers->list[i]->device_extension_list;
+                for (uint32_t j = 0; j < layer_ext_list->count; j++) {
+                    memcpy(&layer_exts[written_layer_exts++], &layer_ext_list->list[j].props, sizeof(VkExtensionProperties));
                 }
             }
         }
+        res = loader_add_to_ext_list(icd_term->this_instance, &all_exts, layer_ext_count, layer_exts);
+        if (res != VK_SUCCESS) {
+            goto out;
+        }
     }
 
     // Write out the final de-duplicated count to pPropertyCount
@@ -7560,6 +8601,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceVersion(uint32_t *pAp
     // NOTE: The Vulkan WG doesn't want us checking pApiVersion for NULL, but instead
     // prefers us crashing.
     *pApiVersion = VK_HEADER_VERSION_COMPLETE;
+    loader_pre_instance_cache_set_result(pApiVersion, 1, sizeof(uint32_t), VK_SUCCESS);
     return VK_SUCCESS;
 }
 
@@ -7577,13 +8619,13 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceExtensionProperties(c
     struct loader_icd_tramp_list icd_tramp_list;
     uint32_t copy_size;
     VkResult res = VK_SUCCESS;
-    struct loader_envvar_all_filters layer_filters = {0};
+    struct loader_envvar_snapshot envvar_snapshot;
 
     memset(&local_ext_list, 0, sizeof(local_ext_list));
     memset(&instance_layers, 0, sizeof(instance_layers));
     memset(&icd_tramp_list, 0, sizeof(icd_tramp_list));
 
-    res = parse_layer_environment_var_filters(NULL, &layer_filters);
+    res = loader_get_global_envvar_snapshot(&envvar_snapshot);
     if (VK_SUCCESS != res) {
         goto out;
     }
@@ -7596,7 +8638,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceExtensionProperties(c
             goto out;
         }
 
-        res = loader_scan_for_layers(NULL, &instance_layers, &layer_filters);
+        res = loader_scan_for_layers(NULL, &instance_layers, &envvar_snapshot.layer_filters);
         if (VK_SUCCESS != res) {
             goto out;
         }
@@ -7625,7 +8667,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceExtensionProperties(c
         loader_clear_scanned_icd_list(NULL, &icd_tramp_list);
 
         // Append enabled implicit layers.
-        res = loader_scan_for_implicit_layers(NULL, &instance_layers, &layer_filters);
+        res = loader_scan_for_implicit_layers(NULL, &instance_layers, &envvar_snapshot.layer_filters);
         if (VK_SUCCESS != res) {
             goto out;
         }
@@ -7642,8 +8684,10 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceExtensionProperties(c
 
     if (global_ext_list == NULL) {
         res = VK_ERROR_LAYER_NOT_PRESENT;
+        loader_pre_instance_cache_set_result(NULL, 0, sizeof(VkExtensionProperties), res);
         goto out;
     }
+    loader_pre_instance_cache_set_result(global_ext_list->list, global_ext_list->count, sizeof(VkExtensionProperties), VK_SUCCESS);
 
     if (pProperties == NULL) {
         *pPropertyCount = global_ext_list->count;
@@ -7679,17 +8723,17 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceLayerProperties(uint3
                                                                            VkLayerProperties *pProperties) {
     VkResult result = VK_SUCCESS;
     struct loader_layer_list instance_layer_list = {0};
-    struct loader_envvar_all_filters layer_filters = {0};
+    struct loader_envvar_snapshot envvar_snapshot;
 
     LOADER_PLATFORM_THREAD_ONCE(&once_init, loader_initialize);
 
-    result = parse_layer_environment_var_filters(NULL, &layer_filters);
+    result = loader_get_global_envvar_snapshot(&envvar_snapshot);
     if (VK_SUCCESS != result) {
         goto out;
     }
 
     // Get layer libraries
-    result = loader_scan_for_layers(NULL, &instance_layer_list, &layer_filters);
+    result = loader_scan_for_layers(NULL, &instance_layer_list, &envvar_snapshot.layer_filters);
     if (VK_SUCCESS != result) {
         goto out;
     }
@@ -7702,6 +8746,26 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumerateInstanceLayerProperties(uint3
         }
     }
 
+    // The complete list is remembered, since this call may only be asking for the count
+    if (loader_pre_instance_cache_is_recording()) {
+        VkLayerProperties *all_properties = NULL;
+        if (layers_to_write_out > 0) {
+            all_properties =
+                loader_alloc(NULL, sizeof(VkLayerProperties) * layers_to_write_out, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+        }
+        if (layers_to_write_out == 0 || NULL != all_properties) {
+            uint32_t all_properties_index = 0;
+            for (uint32_t i = 0; i < instance_layer_list.count; i++) {
+                if (instance_layer_list.list[i].settings_control_value == LOADER_SETTINGS_LAYER_CONTROL_ON ||
+                    instance_layer_list.list[i].settings_control_value == LOADER_SETTINGS_LAYER_CONTROL_DEFAULT) {
+                    memcpy(&all_properties[all_properties_index++], &instance_layer_list.list[i].info, sizeof(VkLayerProperties));
+                }
+            }
+            loader_pre_instance_cache_set_result(all_properties, layers_to_write_out, sizeof(VkLayerProperties), VK_SUCCESS);
+        }
+        loader_free(NULL, all_properties);
+    }
+
     if (pProperties == NULL) {
         *pPropertyCount = layers_to_write_out;
         goto out;
@@ -7755,6 +8819,9 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_EnumeratePhysicalDeviceGroups(
     struct loader_icd_physical_devices *sorted_phys_dev_array = NULL;
     uint32_t sorted_count = 0;
 
+    // Layers may call down here without going through the trampoline, see phys_dev_term_lock
+    loader_platform_thread_lock_mutex(&inst->phys_dev_term_lock);
+
     // For each ICD, query the number of physical device groups, and then get an
     // internal value for those physical devices.
     icd_term = inst->icd_terms;
@@ -8206,6 +9273,7 @@ out:
     } else {
         *pPhysicalDeviceGroupCount = total_count;
     }
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_term_lock);
     return res;
 }
 
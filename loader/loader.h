@@ -81,6 +81,11 @@ static inline void loader_init_dispatch(void *obj, const void *data) {
 extern struct loader_struct loader;
 extern loader_platform_thread_mutex loader_lock;
 extern loader_platform_thread_mutex loader_preload_icd_lock;
+extern loader_platform_thread_mutex loader_layer_library_lock;
+// Guards loader.instances, the icd_terms list of each instance, and the logical_device_list of each icd_term so that
+// loader_get_instance() and loader_get_icd_and_device() only need to take it for reading. Code changing those lists must hold
+// loader_lock and take this lock for writing around the change itself.
+extern loader_platform_thread_rwlock loader_object_lookup_lock;
 
 bool compare_vk_extension_properties(const VkExtensionProperties *op1, const VkExtensionProperties *op2);
 
@@ -100,6 +105,7 @@ void loader_initialize(void);
 void loader_release(void);
 void loader_preload_icds(void);
 void loader_unload_preloaded_icds(void);
+TEST_FUNCTION_EXPORT void loader_unload_cached_layer_libraries(void);
 VkResult loader_init_library_list(struct loader_layer_list *instance_layers, loader_platform_dl_handle **libs);
 
 // Allocate a new string able to hold source_str and place it in dest_str
@@ -147,12 +153,18 @@ VkResult loader_get_next_available_entry(const struct loader_instance *inst, str
 void loader_release_object_from_list(struct loader_used_object_list *list_info, uint32_t index_to_free);
 bool has_vk_extension_property_array(const VkExtensionProperties *vk_ext_prop, const uint32_t count,
                                      const VkExtensionProperties *ext_array);
-bool has_vk_extension_property(const VkExtensionProperties *vk_ext_prop, const struct loader_extension_list *ext_list);
+TEST_FUNCTION_EXPORT bool has_vk_extension_property(const VkExtensionProperties *vk_ext_prop,
+                                                    const struct loader_extension_list *ext_list);
 // This function takes ownership of layer_property in the case that allocation fails
 VkResult loader_append_layer_property(const struct loader_instance *inst, struct loader_layer_list *layer_list,
                                       struct loader_layer_properties *layer_property);
-VkResult loader_add_layer_properties(const struct loader_instance *inst, struct loader_layer_list *layer_instance_list, cJSON *json,
-                                     bool is_implicit, char *filename);
+TEST_FUNCTION_EXPORT VkResult loader_add_layer_properties(const struct loader_instance *inst,
+                                                          struct loader_layer_list *layer_instance_list, cJSON *json,
+                                                          bool is_implicit, char *filename);
+bool is_valid_layer_json_version(const loader_api_version *layer_json);
+// Takes ownership of library_path
+VkResult combine_manifest_directory_and_library_path(const struct loader_instance *inst, char *library_path,
+                                                     const char *manifest_file_path, char **out_fullpath);
 bool loader_find_layer_name_in_list(const char *name, const struct loader_pointer_layer_list *layer_list);
 VkResult loader_add_layer_properties_to_list(const struct loader_instance *inst, struct loader_pointer_layer_list *list,
                                              struct loader_layer_properties *props);
@@ -163,14 +175,24 @@ VkResult loader_add_meta_layer(const struct loader_instance *inst, const struct
                                struct loader_layer_properties *prop, struct loader_pointer_layer_list *target_list,
                                struct loader_pointer_layer_list *expanded_target_list, const struct loader_layer_list *source_list,
                                bool *out_found_all_component_layers);
-VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list,
-                                uint32_t prop_list_count, const VkExtensionProperties *props);
+// Lists which end up longer than a few dozen entries are merged through a hash set of the extension names.
+TEST_FUNCTION_EXPORT VkResult loader_add_to_ext_list(const struct loader_instance *inst, struct loader_extension_list *ext_list,
+                                                     uint32_t prop_list_count, const VkExtensionProperties *props);
+// Takes ownership of entrys, which may be NULL
+VkResult loader_add_to_dev_ext_list(const struct loader_instance *inst, struct loader_device_extension_list *ext_list,
+                                    const VkExtensionProperties *props, struct loader_string_list *entrys);
 VkResult loader_add_device_extensions(const struct loader_instance *inst,
                                       PFN_vkEnumerateDeviceExtensionProperties fpEnumerateDeviceExtensionProperties,
                                       VkPhysicalDevice physical_device, const char *lib_name,
                                       struct loader_extension_list *ext_list);
+// Each physical device terminator caches the driver's properties and device extensions the first time they are needed, so
+// sorting, the settings device configurations and the terminators only query a driver once per physical device.
+const VkPhysicalDeviceProperties *loader_get_phys_dev_term_properties(struct loader_physical_device_term *phys_dev_term);
+VkResult loader_get_phys_dev_term_extensions(const struct loader_instance *inst, struct loader_physical_device_term *phys_dev_term,
+                                             uint32_t *pCount, const VkExtensionProperties **ppProperties);
+void loader_free_phys_dev_term(const struct loader_instance *inst, struct loader_physical_device_term *phys_dev_term);
 VkResult loader_init_generic_list(const struct loader_instance *inst, struct loader_generic_list *list_info, size_t element_size);
-void loader_destroy_generic_list(const struct loader_instance *inst, struct loader_generic_list *list);
+TEST_FUNCTION_EXPORT void loader_destroy_generic_list(const struct loader_instance *inst, struct loader_generic_list *list);
 void loader_destroy_pointer_layer_list(const struct loader_instance *inst, struct loader_pointer_layer_list *layer_list);
 TEST_FUNCTION_EXPORT void loader_delete_layer_list_and_properties(const struct loader_instance *inst,
                                                                   struct loader_layer_list *layer_list);
@@ -194,6 +216,8 @@ struct loader_instance *loader_get_instance(const VkInstance instance);
 loader_platform_dl_handle loader_open_layer_file(const struct loader_instance *inst, struct loader_layer_properties *prop);
 struct loader_device *loader_create_logical_device(const struct loader_instance *inst, const VkAllocationCallbacks *pAllocator);
 void loader_add_logical_device(struct loader_icd_term *icd_term, struct loader_device *found_dev);
+// Sets the device handle returned from the top of the device call chain and makes it findable by loader_get_icd_and_device()
+void loader_set_logical_device_chain_device(struct loader_device *dev, VkDevice chain_device);
 void loader_remove_logical_device(struct loader_icd_term *icd_term, struct loader_device *found_dev,
                                   const VkAllocationCallbacks *pAllocator);
 // NOTE: Outside of loader, this entry-point is only provided for error
@@ -209,6 +233,18 @@ VkResult loader_create_instance_chain(const VkInstanceCreateInfo *pCreateInfo, c
 
 void loader_activate_instance_layer_extensions(struct loader_instance *inst, VkInstance created_inst);
 
+// Whether the VK_LOADER_LAZY_DISPATCH environment variable enables lazy dispatch table population.
+bool loader_lazy_dispatch_enabled(const struct loader_instance *inst);
+
+// Used by the lazy dispatch stubs: look up the command name down the call chain, store it in the dispatch table entry at
+// table_offset if that entry still holds stub, and return it.
+PFN_vkVoidFunction loader_lazy_resolve_device_command(const VkLayerDispatchTable *table, size_t table_offset,
+                                                      PFN_vkVoidFunction stub, const char *name);
+PFN_vkVoidFunction loader_lazy_resolve_instance_command(VkInstance instance, size_t table_offset,
+                                                        PFN_vkVoidFunction stub, const char *name);
+PFN_vkVoidFunction loader_lazy_resolve_physical_device_command(VkPhysicalDevice physical_device, size_t table_offset,
+                                                               PFN_vkVoidFunction stub, const char *name);
+
 VKAPI_ATTR VkResult VKAPI_CALL loader_layer_create_device(VkInstance instance, VkPhysicalDevice physicalDevice,
                                                           const VkDeviceCreateInfo *pCreateInfo,
                                                           const VkAllocationCallbacks *pAllocator, VkDevice *pDevice,
@@ -241,6 +277,9 @@ VkResult add_data_files(const struct loader_instance *inst, struct loader_string
                         struct loader_string_list *out_files);
 
 loader_api_version loader_make_version(uint32_t version);
+loader_api_version loader_make_full_version(uint32_t version);
+// Parses "major.minor.patch" or "variant.major.minor.patch", cutting up vers_str in the process
+uint32_t loader_parse_version_string(char *vers_str);
 loader_api_version loader_combine_version(uint32_t major, uint32_t minor, uint32_t patch);
 
 // Helper macros for determining if a version is valid or not
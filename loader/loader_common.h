@@ -82,6 +82,32 @@ static inline uint32_t loader_hash_string(const char *str) {
     return hash;
 }
 
+// Same as loader_hash_string(), but also writes the number of bytes which were hashed to length.
+static inline uint32_t loader_hash_string_length(const char *str, uint32_t *length) {
+    uint32_t hash = 2166136261u;
+    uint32_t i = 0;
+    for (; i < (uint32_t)MaxLoaderStringLength && str[i]; ++i) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    *length = i;
+    return hash;
+}
+
+// Slot of the name with hash name_hash in one of the minimal perfect hash tables generated into
+// loader/generated/vk_loader_extensions.c. The hash selects one of seed_count seeds, which the generator picked so that no two
+// names in the table end up in the same slot. Mirrored in Python as loader_perfect_hash_slot() in
+// scripts/generators/loader_extension_generator.py (see HashString.PerfectHashSlotMatchesGenerator in
+// tests/loader_hash_string_tests.cpp).
+static inline uint32_t loader_perfect_hash_slot(uint32_t name_hash, const uint16_t *seeds, uint32_t seed_count,
+                                                uint32_t slot_count) {
+    uint32_t x = name_hash ^ ((uint32_t)seeds[name_hash % seed_count] * 0x9e3779b9u);
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    return x % slot_count;
+}
+
 // form of all dynamic lists/arrays
 // only the list element should be changed
 struct loader_generic_list {
@@ -279,6 +305,12 @@ struct loader_device {
 
     struct loader_device *next;
 
+    // The icd_term whose logical_device_list contains this device
+    struct loader_icd_term *icd_term;
+    // Dispatch table pointers this device is registered under in loader.device_index, NULL if not registered
+    const void *icd_device_dispatch;
+    const void *chain_device_dispatch;
+
     // Makes vkGetDeviceProcAddr check if core functions are supported by the current app_api_version.
     // Only set to true if VK_KHR_maintenance5 is enabled.
     bool should_ignore_device_commands_from_newer_version;
@@ -315,6 +347,13 @@ struct loader_icd_tramp_list {
     struct loader_scanned_icd *scanned_list;
 };
 
+// Contents of a driver manifest file which the loader needs to load the driver
+struct ICDManifestInfo {
+    char *full_library_path;
+    uint32_t version;
+    bool is_portability_driver;
+};
+
 struct loader_instance_dispatch_table {
     VkLayerInstanceDispatchTable layer_inst_disp;  // must be first entry in structure
 
@@ -325,6 +364,66 @@ struct loader_instance_dispatch_table {
 // Unique magic number identifier for the loader.
 #define LOADER_MAGIC_NUMBER 0x10ADED010110ADEDUL
 
+typedef enum loader_filter_string_type {
+    FILTER_STRING_FULLNAME = 0,
+    FILTER_STRING_SUBSTRING,
+    FILTER_STRING_PREFIX,
+    FILTER_STRING_SUFFIX,
+    FILTER_STRING_SPECIAL,
+} loader_filter_string_type;
+
+struct loader_envvar_filter_value {
+    char value[VK_MAX_EXTENSION_NAME_SIZE];
+    size_t length;
+    loader_filter_string_type type;
+};
+
+#define MAX_ADDITIONAL_FILTERS 16
+struct loader_envvar_filter {
+    uint32_t count;
+    struct loader_envvar_filter_value filters[MAX_ADDITIONAL_FILTERS];
+};
+struct loader_envvar_disable_layers_filter {
+    struct loader_envvar_filter additional_filters;
+    bool disable_all;
+    bool disable_all_implicit;
+    bool disable_all_explicit;
+};
+
+struct loader_envvar_all_filters {
+    struct loader_envvar_filter enable_filter;
+    struct loader_envvar_disable_layers_filter disable_filter;
+    struct loader_envvar_filter allow_filter;
+};
+
+struct loader_envvar_id_filter_value {
+    uint32_t begin;
+    uint32_t end;
+};
+
+struct loader_envvar_id_filter {
+    uint32_t count;
+    struct loader_envvar_id_filter_value filters[MAX_ADDITIONAL_FILTERS];
+};
+
+// The filter environment variables of an instance (or of calls made without one), parsed once so that hot paths like
+// vkEnumeratePhysicalDevices don't read and parse the environment again every time
+struct loader_envvar_snapshot {
+    struct loader_envvar_all_filters layer_filters;
+    struct loader_envvar_id_filter device_id_filter;
+    struct loader_envvar_id_filter vendor_id_filter;
+    struct loader_envvar_id_filter driver_id_filter;
+};
+
+// Number of slots in the maps used to find unknown functions by name - twice the number of functions they can hold so that
+// probe sequences stay short
+#define LOADER_UNKNOWN_FUNCTION_MAP_SIZE (MAX_NUM_UNKNOWN_EXTS * 2)
+
+struct loader_unknown_function_map_entry {
+    uint32_t name_hash;
+    uint32_t index_plus_one;  // Index into the function name array plus one, zero marks an empty slot
+};
+
 // Per instance structure
 struct loader_instance {
     struct loader_instance_dispatch_table *disp;  // must be first entry in structure
@@ -336,9 +435,24 @@ struct loader_instance {
     // Vulkan API version the app is intending to use.
     loader_api_version app_api_version;
 
+    // Filter environment variables as they were when the instance was created, never modified afterwards
+    struct loader_envvar_snapshot envvar_snapshot;
+
     // We need to manually track physical devices over time.  If the user
     // re-queries the information, we don't want to delete old data or
     // create new data unless necessary.
+    // phys_dev_count_tramp and phys_devs_tramp are guarded by phys_dev_lock, which the trampolines hold across the whole
+    // vkEnumeratePhysicalDevices and vkEnumeratePhysicalDeviceGroups chains so that instances enumerating on different threads
+    // never wait on each other. It may be followed by loader_lock.
+    loader_platform_thread_mutex phys_dev_lock;
+    // The terminator side of the bookkeeping, total_gpu_count, phys_dev_count_term, phys_devs_term, phys_dev_group_count_term,
+    // phys_dev_groups_term and the physical_device_count of every icd_term, is guarded by phys_dev_term_lock instead. The
+    // terminators take it themselves because layers may call down the chain while holding phys_dev_lock, loader_lock, surface_lock
+    // or nothing at all, so it comes after all of those. Only phys_dev_snapshot_lock, loader_preload_icd_lock and
+    // loader_object_lookup_lock may be taken while holding it.
+    loader_platform_thread_mutex phys_dev_term_lock;
+    // Guards filling in the snapshots of every loader_physical_device_term, nothing else is locked while holding it
+    loader_platform_thread_mutex phys_dev_snapshot_lock;
     uint32_t total_gpu_count;
     uint32_t phys_dev_count_term;
     struct loader_physical_device_term **phys_devs_term;
@@ -364,6 +478,13 @@ struct loader_instance {
     uint32_t phys_dev_ext_disp_function_count;
     char *phys_dev_ext_disp_functions[MAX_NUM_UNKNOWN_EXTS];
 
+    // Open addressing hash maps, keyed by loader_hash_string(), which find the index of an unknown function name without
+    // comparing against every name in the arrays above
+    struct loader_unknown_function_map_entry dev_ext_disp_function_map[LOADER_UNKNOWN_FUNCTION_MAP_SIZE];
+    struct loader_unknown_function_map_entry phys_dev_ext_disp_function_map[LOADER_UNKNOWN_FUNCTION_MAP_SIZE];
+    // Whether the dispatch entries of each unknown physical device function were last set up for a trampoline or terminator
+    bool phys_dev_ext_disp_function_is_tramp[MAX_NUM_UNKNOWN_EXTS];
+
     struct loader_msg_callback_map_entry *icd_msg_callback_map;
 
     struct loader_string_list enabled_layer_names;
@@ -388,10 +509,16 @@ struct loader_instance {
     struct loader_used_object_list surfaces_list;
     struct loader_used_object_list debug_utils_messengers_list;
     struct loader_used_object_list debug_report_callbacks_list;
+    // Guards surfaces_list and the surface_list of every icd_term, surfaces of different instances never wait on each other
+    loader_platform_thread_mutex surface_lock;
 
     // Stores debug callbacks - used in the log.
     VkLayerDbgFunctionNode *current_dbg_function_head;        // Current head
     VkLayerDbgFunctionNode *instance_only_dbg_function_head;  // Only used for instance create/destroy
+    // Everything the debug functions in current_dbg_function_head listen to, see util_UpdateDebugMessageFilter
+    VkDebugUtilsMessageSeverityFlagsEXT debug_messenger_severities;
+    VkDebugUtilsMessageTypeFlagsEXT debug_messenger_types;
+    VkDebugReportFlagsEXT debug_report_flags;
 
     VkAllocationCallbacks alloc_callbacks;
 
@@ -404,6 +531,12 @@ struct loader_instance {
 
     bool create_terminator_invalid_extension;
     bool supports_get_dev_prop_2;
+
+    // Set when VK_LOADER_LAZY_DISPATCH=1 - dispatch tables are filled with stubs that look up each command on first use
+    bool lazy_dispatch;
+
+    // Set when VK_LOADER_INSTANCE_ARENA=1 - see allocation.h
+    struct loader_instance_arena *arena;
 };
 
 // VkPhysicalDevice requires special treatment by loader.  Firstly, terminator
@@ -435,6 +568,14 @@ struct loader_physical_device_term {
     struct loader_instance_dispatch_table *disp;  // must be first entry in structure
     struct loader_icd_term *this_icd_term;
     VkPhysicalDevice phys_dev;  // object from ICD
+
+    // Snapshot of what the driver reports for this physical device, filled in on first use and never modified afterwards.
+    // Only access these through loader_get_phys_dev_term_properties and loader_get_phys_dev_term_extensions.
+    bool has_properties_snapshot;
+    bool has_extensions_snapshot;
+    VkPhysicalDeviceProperties properties_snapshot;
+    uint32_t extensions_snapshot_count;
+    VkExtensionProperties *extensions_snapshot;
 };
 
 #if defined(LOADER_ENABLE_LINUX_SORT)
@@ -446,6 +587,9 @@ struct LinuxSortedDeviceInfo {
     VkPhysicalDevice physical_device;
     bool default_device;
 
+    // Terminator object the device info was read from, when sorting the plain physical device list
+    struct loader_physical_device_term *term;
+
     // Loader specific items about the driver providing support for this physical device
     struct loader_icd_term *icd_term;
 
@@ -473,8 +617,22 @@ struct loader_physical_device_group_term {
 #endif  // LOADER_ENABLE_LINUX_SORT
 };
 
+struct loader_device_index_entry {
+    const void *dispatch;
+    struct loader_device *dev;
+};
+
+// Open addressing hash table from the dispatch table pointer of a VkDevice to its loader_device, used by
+// loader_get_icd_and_device() so that finding a device doesn't require walking every device of every instance.
+struct loader_device_index {
+    uint32_t capacity;  // Zero or a power of two
+    uint32_t count;
+    struct loader_device_index_entry *entries;
+};
+
 struct loader_struct {
     struct loader_instance *instances;
+    struct loader_device_index device_index;
 };
 
 struct loader_scanned_icd {
@@ -511,45 +669,3 @@ struct loader_msg_callback_map_entry {
     VkDebugReportCallbackEXT icd_obj;
     VkDebugReportCallbackEXT loader_obj;
 };
-
-typedef enum loader_filter_string_type {
-    FILTER_STRING_FULLNAME = 0,
-    FILTER_STRING_SUBSTRING,
-    FILTER_STRING_PREFIX,
-    FILTER_STRING_SUFFIX,
-    FILTER_STRING_SPECIAL,
-} loader_filter_string_type;
-
-struct loader_envvar_filter_value {
-    char value[VK_MAX_EXTENSION_NAME_SIZE];
-    size_t length;
-    loader_filter_string_type type;
-};
-
-#define MAX_ADDITIONAL_FILTERS 16
-struct loader_envvar_filter {
-    uint32_t count;
-    struct loader_envvar_filter_value filters[MAX_ADDITIONAL_FILTERS];
-};
-struct loader_envvar_disable_layers_filter {
-    struct loader_envvar_filter additional_filters;
-    bool disable_all;
-    bool disable_all_implicit;
-    bool disable_all_explicit;
-};
-
-struct loader_envvar_all_filters {
-    struct loader_envvar_filter enable_filter;
-    struct loader_envvar_disable_layers_filter disable_filter;
-    struct loader_envvar_filter allow_filter;
-};
-
-struct loader_envvar_id_filter_value {
-    uint32_t begin;
-    uint32_t end;
-};
-
-struct loader_envvar_id_filter {
-    uint32_t count;
-    struct loader_envvar_id_filter_value filters[MAX_ADDITIONAL_FILTERS];
-};
@@ -624,3 +624,97 @@ bool check_id_matches_filter_environment_var(const uint32_t id, const struct loa
     }
     return false;
 }
+
+VkResult loader_parse_envvar_snapshot(const struct loader_instance *inst, struct loader_envvar_snapshot *snapshot) {
+    memset(snapshot, 0, sizeof(struct loader_envvar_snapshot));
+    VkResult res = parse_layer_environment_var_filters(inst, &snapshot->layer_filters);
+    if (VK_SUCCESS != res) {
+        return res;
+    }
+    parse_id_filter_environment_var(inst, VK_DEVICE_ID_FILTER_ENV_VAR, &snapshot->device_id_filter);
+    parse_id_filter_environment_var(inst, VK_VENDOR_ID_FILTER_ENV_VAR, &snapshot->vendor_id_filter);
+    parse_id_filter_environment_var(inst, VK_DRIVER_ID_FILTER_ENV_VAR, &snapshot->driver_id_filter);
+    return VK_SUCCESS;
+}
+
+// Every environment variable that goes into a loader_envvar_snapshot
+static const char *const envvar_snapshot_env_vars[] = {
+    VK_LAYERS_ENABLE_ENV_VAR,    VK_LAYERS_DISABLE_ENV_VAR,   VK_LAYERS_ALLOW_ENV_VAR,
+    VK_DEVICE_ID_FILTER_ENV_VAR, VK_VENDOR_ID_FILTER_ENV_VAR, VK_DRIVER_ID_FILTER_ENV_VAR,
+};
+#define ENVVAR_SNAPSHOT_ENV_VAR_COUNT (sizeof(envvar_snapshot_env_vars) / sizeof(envvar_snapshot_env_vars[0]))
+
+// The snapshot used by calls made without an instance. Applications may change the environment between those calls, so the
+// unparsed values are kept to notice when the snapshot has to be parsed again.
+struct loader_global_envvar_snapshot {
+    bool valid;
+    char *values[ENVVAR_SNAPSHOT_ENV_VAR_COUNT];  // NULL when the environment variable was not set
+    struct loader_envvar_snapshot snapshot;
+};
+
+static loader_platform_thread_mutex global_envvar_snapshot_lock;
+static struct loader_global_envvar_snapshot global_envvar_snapshot;
+
+static void global_envvar_snapshot_clear(void) {
+    for (size_t i = 0; i < ENVVAR_SNAPSHOT_ENV_VAR_COUNT; i++) {
+        loader_instance_heap_free(NULL, global_envvar_snapshot.values[i]);
+    }
+    memset(&global_envvar_snapshot, 0, sizeof(global_envvar_snapshot));
+}
+
+void init_global_envvar_snapshot(void) {
+    loader_platform_thread_create_mutex(&global_envvar_snapshot_lock);
+    // Clear out the snapshot in case the process was loaded & unloaded
+    memset(&global_envvar_snapshot, 0, sizeof(global_envvar_snapshot));
+}
+
+void teardown_global_envvar_snapshot(void) {
+    global_envvar_snapshot_clear();
+    loader_platform_thread_delete_mutex(&global_envvar_snapshot_lock);
+}
+
+VkResult loader_get_global_envvar_snapshot(struct loader_envvar_snapshot *snapshot) {
+    VkResult res = VK_SUCCESS;
+    char *values[ENVVAR_SNAPSHOT_ENV_VAR_COUNT] = {0};
+
+    loader_platform_thread_lock_mutex(&global_envvar_snapshot_lock);
+
+    // Reading the environment is cheap compared to parsing it, so only parse again when a value actually changed
+    bool unchanged = global_envvar_snapshot.valid;
+    for (size_t i = 0; i < ENVVAR_SNAPSHOT_ENV_VAR_COUNT; i++) {
+        values[i] = loader_getenv(envvar_snapshot_env_vars[i], NULL);
+        if (unchanged) {
+            const char *previous = global_envvar_snapshot.values[i];
+            unchanged = NULL == values[i] ? NULL == previous : NULL != previous && 0 == strcmp(values[i], previous);
+        }
+    }
+
+    if (!unchanged) {
+        global_envvar_snapshot_clear();
+        res = loader_parse_envvar_snapshot(NULL, &global_envvar_snapshot.snapshot);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+        for (size_t i = 0; i < ENVVAR_SNAPSHOT_ENV_VAR_COUNT; i++) {
+            if (NULL != values[i]) {
+                res = loader_copy_to_new_str(NULL, values[i], &global_envvar_snapshot.values[i]);
+                if (VK_SUCCESS != res) {
+                    goto out;
+                }
+            }
+        }
+        global_envvar_snapshot.valid = true;
+    }
+
+    memcpy(snapshot, &global_envvar_snapshot.snapshot, sizeof(struct loader_envvar_snapshot));
+
+out:
+    if (VK_SUCCESS != res) {
+        global_envvar_snapshot_clear();
+    }
+    loader_platform_thread_unlock_mutex(&global_envvar_snapshot_lock);
+    for (size_t i = 0; i < ENVVAR_SNAPSHOT_ENV_VAR_COUNT; i++) {
+        loader_free_getenv(values[i], NULL);
+    }
+    return res;
+}
@@ -58,3 +58,12 @@ VkResult loader_add_environment_layers(struct loader_instance *inst, const char
 void parse_id_filter_environment_var(const struct loader_instance *inst, const char *env_var_name,
                                      struct loader_envvar_id_filter *filter_struct);
 bool check_id_matches_filter_environment_var(const uint32_t id, const struct loader_envvar_id_filter *filter_struct);
+
+// Parse every filter environment variable into snapshot
+VkResult loader_parse_envvar_snapshot(const struct loader_instance *inst, struct loader_envvar_snapshot *snapshot);
+
+void init_global_envvar_snapshot(void);
+void teardown_global_envvar_snapshot(void);
+// Copy the filters that apply to calls made without an instance into snapshot. They are only parsed again once one of the
+// environment variables they come from changes.
+VkResult loader_get_global_envvar_snapshot(struct loader_envvar_snapshot *snapshot);
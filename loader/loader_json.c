@@ -25,6 +25,7 @@
 #include "loader_json.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <float.h>
 #include <limits.h>
 #include <math.h>
@@ -37,15 +38,26 @@
 #include "allocation.h"
 #include "loader.h"
 #include "log.h"
+#include "phase_timing.h"
+#include "wsi.h"
 
 #if COMMON_UNIX_PLATFORMS
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #endif
 
+// The parsed JSON tree references strings inside the buffer a file was read into (see loader_cJSON_ParseInSitu), so the tree
+// owns that buffer and releases it once deleted. Buffers that aren't mapped are allocated directly with the allocation
+// callbacks the tree keeps, instead of through the instance, which is what they are released with.
+static void loader_json_free_buffer(const VkAllocationCallbacks *pAllocator, void *buffer, size_t buffer_length) {
+    (void)buffer_length;
+    loader_free(pAllocator, buffer);
+}
+
 #ifdef _WIN32
-static VkResult loader_read_entire_file(const struct loader_instance *inst, const char *filename, size_t *out_len,
-                                        char **out_buff) {
+static VkResult loader_read_entire_file(const struct loader_instance *inst, const char *filename, bool log_errors, size_t *out_len,
+                                        char **out_buff, loader_cJSON_ReleaseBuffer *out_release_buffer) {
     HANDLE file_handle = INVALID_HANDLE_VALUE;
     DWORD len = 0, read_len = 0;
     VkResult res = VK_SUCCESS;
@@ -72,25 +84,35 @@ static VkResult loader_read_entire_file(const struct loader_instance *inst, cons
         }
     }
     if (INVALID_HANDLE_VALUE == file_handle) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to open JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to open JSON file %s", filename);
+        }
         res = VK_ERROR_INITIALIZATION_FAILED;
         goto out;
     }
     len = GetFileSize(file_handle, NULL);
     if (INVALID_FILE_SIZE == len) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read file size of JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read file size of JSON file %s", filename);
+        }
         res = VK_ERROR_INITIALIZATION_FAILED;
         goto out;
     }
-    *out_buff = (char *)loader_instance_heap_calloc(inst, len + 1, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    *out_buff = (char *)loader_calloc(inst ? &inst->alloc_callbacks : NULL, len + 1, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
     if (NULL == *out_buff) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to allocate memory to read JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to allocate memory to read JSON file %s",
+                       filename);
+        }
         res = VK_ERROR_OUT_OF_HOST_MEMORY;
         goto out;
     }
+    *out_release_buffer = loader_json_free_buffer;
     read_ok = ReadFile(file_handle, *out_buff, len, &read_len, NULL);
     if (len != read_len || false == read_ok) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read entire JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read entire JSON file %s", filename);
+        }
         res = VK_ERROR_INITIALIZATION_FAILED;
         goto out;
     }
@@ -104,31 +126,71 @@ out:
     return res;
 }
 #elif COMMON_UNIX_PLATFORMS
-static VkResult loader_read_entire_file(const struct loader_instance *inst, const char *filename, size_t *out_len,
-                                        char **out_buff) {
+// Files at least this big are mapped instead of read. Mapping costs extra system calls plus the page faults, which only pays off
+// once copying the file into a heap buffer would be more expensive.
+#define LOADER_JSON_MMAP_MIN_SIZE (16 * 1024)
+
+// A mapped file that gets truncated while it is parsed raises SIGBUS when the pages past its new end are touched, where a read
+// into a heap buffer only ends up with a short or failed read. So only map files that nobody but root can write to, such as the
+// manifests installed into system directories. Replacing those by renaming a new file over them, which is what installers do,
+// leaves the mapped pages of the old file intact.
+static bool loader_json_can_map_file(const struct stat *stats) {
+    return S_ISREG(stats->st_mode) && stats->st_size >= LOADER_JSON_MMAP_MIN_SIZE && 0 == stats->st_uid &&
+           0 == (stats->st_mode & (S_IWGRP | S_IWOTH));
+}
+
+static void loader_json_unmap_buffer(const VkAllocationCallbacks *pAllocator, void *buffer, size_t buffer_length) {
+    (void)pAllocator;
+    munmap(buffer, buffer_length);
+}
+
+static VkResult loader_read_entire_file(const struct loader_instance *inst, const char *filename, bool log_errors, size_t *out_len,
+                                        char **out_buff, loader_cJSON_ReleaseBuffer *out_release_buffer) {
     FILE *file = NULL;
     struct stat stats = {0};
     VkResult res = VK_SUCCESS;
 
+    // Opened with fopen rather than open so that everything that intercepts or redirects fopen keeps working
     file = fopen(filename, "rb");
     if (NULL == file) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to open JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to open JSON file %s", filename);
+        }
         res = VK_ERROR_INITIALIZATION_FAILED;
         goto out;
     }
     if (-1 == fstat(fileno(file), &stats)) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read file size of JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read file size of JSON file %s", filename);
+        }
         res = VK_ERROR_INITIALIZATION_FAILED;
         goto out;
     }
-    *out_buff = (char *)loader_instance_heap_calloc(inst, stats.st_size + 1, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (loader_json_can_map_file(&stats)) {
+        // Mapped privately and writable so parsing in place can unescape strings into the pages without touching the file
+        void *mapping = mmap(NULL, (size_t)stats.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+        if (MAP_FAILED != mapping) {
+            *out_buff = (char *)mapping;
+            *out_len = (size_t)stats.st_size;
+            *out_release_buffer = loader_json_unmap_buffer;
+            goto out;
+        }
+        // Fall back to reading the file
+    }
+    *out_buff = (char *)loader_calloc(inst ? &inst->alloc_callbacks : NULL, stats.st_size + 1, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
     if (NULL == *out_buff) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to allocate memory to read JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to allocate memory to read JSON file %s",
+                       filename);
+        }
         res = VK_ERROR_OUT_OF_HOST_MEMORY;
         goto out;
     }
+    *out_release_buffer = loader_json_free_buffer;
     if (stats.st_size != (long int)fread(*out_buff, sizeof(char), stats.st_size, file)) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read entire JSON file %s", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Failed to read entire JSON file %s", filename);
+        }
         res = VK_ERROR_INITIALIZATION_FAILED;
         goto out;
     }
@@ -147,46 +209,68 @@ out:
 }
 #else
 #warning fopen not available on this platform
-VkResult loader_read_entire_file(const struct loader_instance *inst, const char *filename, size_t *out_len, char **out_buff) {
+VkResult loader_read_entire_file(const struct loader_instance *inst, const char *filename, bool log_errors, size_t *out_len,
+                                 char **out_buff, loader_cJSON_ReleaseBuffer *out_release_buffer) {
     return VK_ERROR_INITIALIZATION_FAILED;
 }
 #endif
 
-TEST_FUNCTION_EXPORT VkResult loader_get_json(const struct loader_instance *inst, const char *filename, cJSON **json) {
+static VkResult loader_read_json(const struct loader_instance *inst, const char *filename, bool log_errors, cJSON **json) {
     char *json_buf = NULL;
+    loader_cJSON_ReleaseBuffer release_json_buf = NULL;
+    const VkAllocationCallbacks *pAllocator = inst ? &inst->alloc_callbacks : NULL;
     VkResult res = VK_SUCCESS;
+    uint64_t phase_begin = loader_phase_begin();
 
     assert(json != NULL);
 
     size_t json_len = 0;
     *json = NULL;
-    res = loader_read_entire_file(inst, filename, &json_len, &json_buf);
+    res = loader_read_entire_file(inst, filename, log_errors, &json_len, &json_buf, &release_json_buf);
     if (VK_SUCCESS != res) {
         goto out;
     }
     bool out_of_memory = false;
-    // Parse text from file
-    *json = loader_cJSON_ParseWithLength(inst ? &inst->alloc_callbacks : NULL, json_buf, json_len, &out_of_memory);
+    // Parse text from file, the strings in the tree point into json_buf which the tree now owns
+    *json = loader_cJSON_ParseInSitu(pAllocator, json_buf, json_len, release_json_buf, &out_of_memory);
+    if (NULL != *json) {
+        json_buf = NULL;
+    }
     if (out_of_memory) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Out of Memory error occurred while parsing JSON file %s.",
-                   filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
+                       "loader_get_json: Out of Memory error occurred while parsing JSON file %s.", filename);
+        }
         res = VK_ERROR_OUT_OF_HOST_MEMORY;
         goto out;
     } else if (*json == NULL) {
-        loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Invalid JSON file %s.", filename);
+        if (log_errors) {
+            loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0, "loader_get_json: Invalid JSON file %s.", filename);
+        }
         goto out;
     }
 
 out:
-    loader_instance_heap_free(inst, json_buf);
+    if (NULL != json_buf && NULL != release_json_buf) {
+        release_json_buf(pAllocator, json_buf, json_len);
+    }
     if (res != VK_SUCCESS && *json != NULL) {
         loader_cJSON_Delete(*json);
         *json = NULL;
     }
+    loader_phase_end(LOADER_PHASE_JSON_PARSE, phase_begin, filename);
 
     return res;
 }
 
+TEST_FUNCTION_EXPORT VkResult loader_get_json(const struct loader_instance *inst, const char *filename, cJSON **json) {
+    return loader_read_json(inst, filename, true, json);
+}
+
+VkResult loader_get_json_without_logging(const struct loader_instance *inst, const char *filename, cJSON **json) {
+    return loader_read_json(inst, filename, false, json);
+}
+
 VkResult loader_parse_json_string_to_existing_str(cJSON *object, const char *key, size_t out_str_len, char *out_string) {
     if (NULL == key) {
         return VK_ERROR_INITIALIZATION_FAILED;
@@ -272,3 +356,1074 @@ out:
 
     return res;
 }
+
+// Single pass parser for driver manifests. Rather than building a cJSON tree and then looking up each field, the manifest is
+// walked once, the fields the loader uses are unescaped in place in the file buffer and everything else is only validated.
+//
+// It only accepts strictly well formed JSON laid out the way the driver manifest schema describes. Anything else, from a syntax
+// error to a field with an unexpected type, makes it give up with VK_INCOMPLETE so the caller parses the file with cJSON instead,
+// which keeps the diagnostics and the lenient parts of cJSON's behavior in one place. Where it does succeed it has to find exactly
+// what loader_get_icd_manifest_fields_from_json would: keys are compared case insensitively and the first matching key wins.
+
+// Deeper nesting than this isn't part of any manifest, leave it to cJSON
+#define LOADER_JSON_STREAM_MAX_DEPTH 64
+
+typedef struct loader_json_stream {
+    char *cur;
+    char *end;
+    size_t depth;
+} loader_json_stream;
+
+static void loader_json_stream_skip_whitespace(loader_json_stream *stream) {
+    while (stream->cur < stream->end &&
+           (*stream->cur == ' ' || *stream->cur == '\t' || *stream->cur == '\n' || *stream->cur == '\r')) {
+        stream->cur++;
+    }
+}
+
+static bool loader_json_stream_consume(loader_json_stream *stream, char c) {
+    loader_json_stream_skip_whitespace(stream);
+    if (stream->cur < stream->end && *stream->cur == c) {
+        stream->cur++;
+        return true;
+    }
+    return false;
+}
+
+static bool loader_json_stream_hex4(const char *input, uint32_t *out_code) {
+    uint32_t code = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        char c = input[i];
+        code <<= 4;
+        if (c >= '0' && c <= '9') {
+            code |= (uint32_t)(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            code |= (uint32_t)(10 + c - 'A');
+        } else if (c >= 'a' && c <= 'f') {
+            code |= (uint32_t)(10 + c - 'a');
+        } else {
+            return false;
+        }
+    }
+    *out_code = code;
+    return true;
+}
+
+// Parses the string at the current position and unescapes it in place, the same way cJSON does. *out_string is NUL terminated and
+// *out_has_control_chars is set if the unescaped string contains any byte below 0x20, including an embedded NUL.
+static bool loader_json_stream_string(loader_json_stream *stream, char **out_string, bool *out_has_control_chars) {
+    loader_json_stream_skip_whitespace(stream);
+    if (stream->cur >= stream->end || *stream->cur != '\"') {
+        return false;
+    }
+    char *input = stream->cur + 1;
+    char *output = input;
+    bool has_control_chars = false;
+    *out_string = output;
+    while (true) {
+        if (input >= stream->end) {
+            return false;
+        }
+        unsigned char c = (unsigned char)*input;
+        if (c == '\"') {
+            break;
+        }
+        if (c < 0x20) {
+            return false;
+        }
+        if (c != '\\') {
+            *output++ = *input++;
+            continue;
+        }
+        if (stream->end - input < 2) {
+            return false;
+        }
+        switch (input[1]) {
+            case 'b':
+                *output++ = '\b';
+                has_control_chars = true;
+                break;
+            case 'f':
+                *output++ = '\f';
+                has_control_chars = true;
+                break;
+            case 'n':
+                *output++ = '\n';
+                has_control_chars = true;
+                break;
+            case 'r':
+                *output++ = '\r';
+                has_control_chars = true;
+                break;
+            case 't':
+                *output++ = '\t';
+                has_control_chars = true;
+                break;
+            case '\"':
+            case '\\':
+            case '/':
+                *output++ = input[1];
+                break;
+            case 'u': {
+                uint32_t codepoint = 0;
+                uint32_t second_code = 0;
+                if (stream->end - input < 6 || !loader_json_stream_hex4(input + 2, &codepoint)) {
+                    return false;
+                }
+                if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    return false;
+                }
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    if (stream->end - input < 12 || input[6] != '\\' || input[7] != 'u' ||
+                        !loader_json_stream_hex4(input + 8, &second_code) || second_code < 0xDC00 || second_code > 0xDFFF) {
+                        return false;
+                    }
+                    codepoint = 0x10000 + (((codepoint & 0x3FF) << 10) | (second_code & 0x3FF));
+                    input += 6;
+                }
+                if (codepoint < 0x20) {
+                    has_control_chars = true;
+                }
+                if (codepoint < 0x80) {
+                    *output++ = (char)codepoint;
+                } else if (codepoint < 0x800) {
+                    *output++ = (char)(0xC0 | (codepoint >> 6));
+                    *output++ = (char)(0x80 | (codepoint & 0x3F));
+                } else if (codepoint < 0x10000) {
+                    *output++ = (char)(0xE0 | (codepoint >> 12));
+                    *output++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+                    *output++ = (char)(0x80 | (codepoint & 0x3F));
+                } else {
+                    *output++ = (char)(0xF0 | (codepoint >> 18));
+                    *output++ = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+                    *output++ = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+                    *output++ = (char)(0x80 | (codepoint & 0x3F));
+                }
+                input += 4;
+                break;
+            }
+            default:
+                return false;
+        }
+        input += 2;
+    }
+    // Unescaping never makes a string longer, so at the latest this overwrites the closing quote
+    *output = '\0';
+    stream->cur = input + 1;
+    if (NULL != out_has_control_chars) {
+        *out_has_control_chars = has_control_chars;
+    }
+    return true;
+}
+
+static bool loader_json_stream_number(loader_json_stream *stream) {
+    char *start = stream->cur;
+    char *p = stream->cur;
+    if (p < stream->end && *p == '-') {
+        p++;
+    }
+    if (p >= stream->end || *p < '0' || *p > '9') {
+        return false;
+    }
+    if (*p == '0') {
+        p++;
+    } else {
+        while (p < stream->end && *p >= '0' && *p <= '9') p++;
+    }
+    if (p < stream->end && *p == '.') {
+        p++;
+        if (p >= stream->end || *p < '0' || *p > '9') {
+            return false;
+        }
+        while (p < stream->end && *p >= '0' && *p <= '9') p++;
+    }
+    if (p < stream->end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < stream->end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p >= stream->end || *p < '0' || *p > '9') {
+            return false;
+        }
+        while (p < stream->end && *p >= '0' && *p <= '9') p++;
+    }
+    // cJSON copies numbers into a 64 byte buffer before converting them, and reads longer ones differently
+    if (p - start >= 63) {
+        return false;
+    }
+    stream->cur = p;
+    return true;
+}
+
+static bool loader_json_stream_literal(loader_json_stream *stream, const char *literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(stream->end - stream->cur) < length || strncmp(stream->cur, literal, length) != 0) {
+        return false;
+    }
+    stream->cur += length;
+    return true;
+}
+
+static bool loader_json_stream_skip_value(loader_json_stream *stream, bool *out_is_true);
+
+// Validates and steps over the members of an object or the elements of an array, up to and including the closing character
+static bool loader_json_stream_skip_container(loader_json_stream *stream, char close) {
+    if (++stream->depth > LOADER_JSON_STREAM_MAX_DEPTH) {
+        return false;
+    }
+    if (!loader_json_stream_consume(stream, close)) {
+        do {
+            if (close == '}') {
+                char *key = NULL;
+                if (!loader_json_stream_string(stream, &key, NULL) || !loader_json_stream_consume(stream, ':')) {
+                    return false;
+                }
+            }
+            if (!loader_json_stream_skip_value(stream, NULL)) {
+                return false;
+            }
+        } while (loader_json_stream_consume(stream, ','));
+        if (!loader_json_stream_consume(stream, close)) {
+            return false;
+        }
+    }
+    stream->depth--;
+    return true;
+}
+
+// Validates and steps over any value, out_is_true is set if the value was the literal true
+static bool loader_json_stream_skip_value(loader_json_stream *stream, bool *out_is_true) {
+    char *string = NULL;
+    loader_json_stream_skip_whitespace(stream);
+    if (NULL != out_is_true) {
+        *out_is_true = false;
+    }
+    if (stream->cur >= stream->end) {
+        return false;
+    }
+    switch (*stream->cur) {
+        case '\"':
+            return loader_json_stream_string(stream, &string, NULL);
+        case '{':
+            stream->cur++;
+            return loader_json_stream_skip_container(stream, '}');
+        case '[':
+            stream->cur++;
+            return loader_json_stream_skip_container(stream, ']');
+        case 't':
+            if (NULL != out_is_true) {
+                *out_is_true = true;
+            }
+            return loader_json_stream_literal(stream, "true");
+        case 'f':
+            return loader_json_stream_literal(stream, "false");
+        case 'n':
+            return loader_json_stream_literal(stream, "null");
+        default:
+            return loader_json_stream_number(stream);
+    }
+}
+
+// Same comparison as cJSON's, which loader_cJSON_GetObjectItem uses to match keys
+static bool loader_json_stream_key_equals(const char *key, const char *name) {
+    for (; tolower((unsigned char)*key) == tolower((unsigned char)*name); key++, name++) {
+        if (*key == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads a string value the manifest schema expects, giving up on anything else so cJSON decides what it means. Strings with
+// control characters are left to cJSON too, since loader_cJSON_Print doesn't reproduce them as is.
+static bool loader_json_stream_string_field(loader_json_stream *stream, char **out_string) {
+    bool has_control_chars = false;
+    return loader_json_stream_string(stream, out_string, &has_control_chars) && !has_control_chars;
+}
+
+static bool loader_json_stream_icd_object(loader_json_stream *stream, struct loader_icd_manifest_fields *fields) {
+    bool found_portability = false;
+    bool found_arch = false;
+    if (!loader_json_stream_consume(stream, '{')) {
+        return false;
+    }
+    stream->depth++;
+    if (loader_json_stream_consume(stream, '}')) {
+        stream->depth--;
+        return true;
+    }
+    do {
+        char *key = NULL;
+        bool has_control_chars = false;
+        if (!loader_json_stream_string(stream, &key, &has_control_chars) || has_control_chars ||
+            !loader_json_stream_consume(stream, ':')) {
+            return false;
+        }
+        bool handled = false;
+        if (!fields->has_library_path && loader_json_stream_key_equals(key, "library_path")) {
+            fields->has_library_path = handled = true;
+            if (!loader_json_stream_string_field(stream, &fields->library_path)) {
+                return false;
+            }
+        } else if (!fields->has_api_version && loader_json_stream_key_equals(key, "api_version")) {
+            fields->has_api_version = handled = true;
+            if (!loader_json_stream_string_field(stream, &fields->api_version)) {
+                return false;
+            }
+        } else if (!found_portability && loader_json_stream_key_equals(key, "is_portability_driver")) {
+            found_portability = handled = true;
+            if (!loader_json_stream_skip_value(stream, &fields->is_portability_driver)) {
+                return false;
+            }
+        } else if (!found_arch && loader_json_stream_key_equals(key, "library_arch")) {
+            found_arch = handled = true;
+            loader_json_stream_skip_whitespace(stream);
+            if (stream->cur < stream->end && *stream->cur == '\"') {
+                if (!loader_json_stream_string_field(stream, &fields->library_arch)) {
+                    return false;
+                }
+            } else if (!loader_json_stream_skip_value(stream, NULL)) {
+                return false;
+            }
+        }
+        if (!handled && !loader_json_stream_skip_value(stream, NULL)) {
+            return false;
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    stream->depth--;
+    return loader_json_stream_consume(stream, '}');
+}
+
+static bool loader_json_stream_icd_manifest(loader_json_stream *stream, struct loader_icd_manifest_fields *fields) {
+    if (stream->end - stream->cur >= 3 && strncmp(stream->cur, "\xEF\xBB\xBF", 3) == 0) {
+        stream->cur += 3;
+    }
+    if (!loader_json_stream_consume(stream, '{')) {
+        return false;
+    }
+    stream->depth++;
+    if (loader_json_stream_consume(stream, '}')) {
+        return true;
+    }
+    do {
+        char *key = NULL;
+        bool has_control_chars = false;
+        if (!loader_json_stream_string(stream, &key, &has_control_chars) || has_control_chars ||
+            !loader_json_stream_consume(stream, ':')) {
+            return false;
+        }
+        bool handled = false;
+        if (!fields->has_file_format_version && loader_json_stream_key_equals(key, "file_format_version")) {
+            fields->has_file_format_version = handled = true;
+            if (!loader_json_stream_string_field(stream, &fields->file_format_version)) {
+                return false;
+            }
+        } else if (!fields->has_icd && loader_json_stream_key_equals(key, "ICD")) {
+            fields->has_icd = handled = true;
+            if (!loader_json_stream_icd_object(stream, fields)) {
+                return false;
+            }
+        } else if (loader_json_stream_key_equals(key, "layer") || loader_json_stream_key_equals(key, "layers")) {
+            fields->has_layer = true;
+        }
+        if (!handled && !loader_json_stream_skip_value(stream, NULL)) {
+            return false;
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    // Like cJSON, ignore whatever follows the root object
+    return loader_json_stream_consume(stream, '}');
+}
+
+VkResult loader_read_icd_manifest_fields(const struct loader_instance *inst, const char *filename,
+                                         struct loader_icd_manifest_fields *fields) {
+    loader_json_stream stream = {0};
+    VkResult res = VK_SUCCESS;
+    uint64_t phase_begin = loader_phase_begin();
+
+    memset(fields, 0, sizeof(*fields));
+    // Failures to read the file are left for loader_get_json to report
+    res = loader_read_entire_file(inst, filename, false, &fields->buffer_length, &fields->buffer, &fields->release_buffer);
+    if (VK_SUCCESS != res) {
+        res = VK_INCOMPLETE;
+        goto out;
+    }
+    stream.cur = fields->buffer;
+    stream.end = fields->buffer + fields->buffer_length;
+    if (!loader_json_stream_icd_manifest(&stream, fields)) {
+        // library_path may still point into the buffer
+        fields->library_path = NULL;
+        res = VK_INCOMPLETE;
+        goto out;
+    }
+    // library_path is handed off to the caller, so it needs its own allocation like the one loader_cJSON_Print makes
+    if (NULL != fields->library_path) {
+        char *library_path_in_buffer = fields->library_path;
+        size_t library_path_len = strlen(library_path_in_buffer) + 1;
+        fields->library_path = loader_instance_heap_alloc(inst, library_path_len, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+        if (NULL == fields->library_path) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        loader_strncpy(fields->library_path, library_path_len, library_path_in_buffer, library_path_len);
+    }
+
+out:
+    if (VK_SUCCESS != res) {
+        loader_free_icd_manifest_fields(inst, fields);
+    }
+    loader_phase_end(LOADER_PHASE_JSON_PARSE, phase_begin, filename);
+    return res;
+}
+
+VkResult loader_get_icd_manifest_fields_from_json(const struct loader_instance *inst, cJSON *json,
+                                                  struct loader_icd_manifest_fields *fields) {
+    (void)inst;
+    memset(fields, 0, sizeof(*fields));
+    fields->json = json;
+
+    cJSON *file_format_version_json = loader_cJSON_GetObjectItem(json, "file_format_version");
+    fields->has_file_format_version = NULL != file_format_version_json;
+    fields->file_format_version = loader_cJSON_GetStringValue(file_format_version_json);
+
+    fields->has_layer = loader_cJSON_GetObjectItem(json, "layer") != NULL || loader_cJSON_GetObjectItem(json, "layers") != NULL;
+
+    cJSON *itemICD = loader_cJSON_GetObjectItem(json, "ICD");
+    fields->has_icd = NULL != itemICD;
+    if (NULL == itemICD) {
+        return VK_SUCCESS;
+    }
+
+    cJSON *library_path_json = loader_cJSON_GetObjectItem(itemICD, "library_path");
+    fields->has_library_path = NULL != library_path_json;
+    if (NULL != library_path_json) {
+        bool out_of_memory = false;
+        fields->library_path = loader_cJSON_Print(library_path_json, &out_of_memory);
+        if (out_of_memory) {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    cJSON *api_version_json = loader_cJSON_GetObjectItem(itemICD, "api_version");
+    fields->has_api_version = NULL != api_version_json;
+    fields->api_version = loader_cJSON_GetStringValue(api_version_json);
+
+    fields->is_portability_driver = loader_cJSON_IsTrue(loader_cJSON_GetObjectItem(itemICD, "is_portability_driver"));
+    fields->library_arch = loader_cJSON_GetStringValue(loader_cJSON_GetObjectItem(itemICD, "library_arch"));
+    return VK_SUCCESS;
+}
+
+void loader_free_icd_manifest_fields(const struct loader_instance *inst, struct loader_icd_manifest_fields *fields) {
+    loader_instance_heap_free(inst, fields->library_path);
+    loader_cJSON_Delete(fields->json);
+    if (NULL != fields->buffer && NULL != fields->release_buffer) {
+        fields->release_buffer(inst ? &inst->alloc_callbacks : NULL, fields->buffer, fields->buffer_length);
+    }
+    memset(fields, 0, sizeof(*fields));
+}
+
+// Single pass reader for layer manifests, built on the same parser as the driver manifest reader. It fills the
+// loader_layer_properties of every layer in the file directly, but only handles manifests which loader_add_layer_properties would
+// accept without logging more than the messages every well formed layer produces. Anything else, including layers that would be
+// skipped, makes it give up with VK_INCOMPLETE before touching the layer list, so that loader_add_layer_properties can read the
+// file and report what is wrong with it. The checks below mirror loader_read_layer_json and have to be kept in sync with it.
+
+struct loader_json_stream_layer_manifest {
+    const struct loader_instance *inst;
+    const char *filename;
+    bool is_implicit;
+    struct loader_layer_list layers;  // Only appended to the caller's list once the whole file was read
+
+    char *file_format_version;
+    bool has_layers_array;
+    bool has_layer_object;
+    // What depends on file_format_version, which may come after the layers in the file
+    bool has_meta_layer;
+    bool has_override_paths;
+    bool has_pre_instance_functions;
+    bool uses_deprecated_gpa_tags;
+};
+
+// Whether loader_cJSON_PrintPreallocated fits the string into size bytes. It sets aside an extra byte for every quote and
+// backslash, even though the loader's printing doesn't escape them, as well as one byte on top of the null terminator.
+static bool loader_json_stream_string_fits(const char *string, size_t size) {
+    size_t needed = 2;
+    for (; *string != '\0'; string++) {
+        needed += (*string == '\"' || *string == '\\') ? 2 : 1;
+    }
+    return needed <= size;
+}
+
+// Reads an array of strings the way loader_parse_json_array_of_strings does, except that anything which isn't a string is left
+// to cJSON
+static VkResult loader_json_stream_string_array(const struct loader_instance *inst, loader_json_stream *stream,
+                                                struct loader_string_list *string_list) {
+    if (!loader_json_stream_consume(stream, '[')) {
+        return VK_INCOMPLETE;
+    }
+    if (loader_json_stream_consume(stream, ']')) {
+        return VK_SUCCESS;
+    }
+    do {
+        char *string = NULL;
+        char *copy = NULL;
+        if (!loader_json_stream_string_field(stream, &string)) {
+            return VK_INCOMPLETE;
+        }
+        VkResult res = loader_copy_to_new_str(inst, string, &copy);
+        if (VK_SUCCESS != res) {
+            return res;
+        }
+        res = append_str_to_string_list(inst, string_list, copy);
+        if (VK_SUCCESS != res) {
+            return res;
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    return loader_json_stream_consume(stream, ']') ? VK_SUCCESS : VK_INCOMPLETE;
+}
+
+// Reads a string which loader_read_layer_json prints with loader_parse_json_string into a new allocation
+static VkResult loader_json_stream_printed_string(const struct loader_instance *inst, loader_json_stream *stream,
+                                                  char **out_string) {
+    char *string = NULL;
+    if (!loader_json_stream_string_field(stream, &string)) {
+        return VK_INCOMPLETE;
+    }
+    return loader_copy_to_new_str(inst, string, out_string);
+}
+
+// Reads one element of "instance_extensions" or "device_extensions". entrypoints is NULL for instance extensions.
+static VkResult loader_json_stream_extension(const struct loader_instance *inst, loader_json_stream *stream,
+                                             VkExtensionProperties *ext_prop, bool *out_has_entrypoints,
+                                             struct loader_string_list *entrypoints) {
+    bool found_name = false;
+    bool found_spec_version = false;
+    bool found_entrypoints = false;
+    if (!loader_json_stream_consume(stream, '{')) {
+        return VK_INCOMPLETE;
+    }
+    if (!loader_json_stream_consume(stream, '}')) {
+        do {
+            char *key = NULL;
+            char *value = NULL;
+            bool has_control_chars = false;
+            if (!loader_json_stream_string(stream, &key, &has_control_chars) || has_control_chars ||
+                !loader_json_stream_consume(stream, ':')) {
+                return VK_INCOMPLETE;
+            }
+            if (!found_name && loader_json_stream_key_equals(key, "name")) {
+                found_name = true;
+                if (!loader_json_stream_string_field(stream, &value) ||
+                    !loader_json_stream_string_fits(value, VK_MAX_EXTENSION_NAME_SIZE)) {
+                    return VK_INCOMPLETE;
+                }
+                loader_strncpy(ext_prop->extensionName, VK_MAX_EXTENSION_NAME_SIZE, value, strlen(value) + 1);
+            } else if (!found_spec_version && loader_json_stream_key_equals(key, "spec_version")) {
+                found_spec_version = true;
+                if (!loader_json_stream_string_field(stream, &value)) {
+                    return VK_INCOMPLETE;
+                }
+                ext_prop->specVersion = (uint32_t)strtoul(value, NULL, 10);
+            } else if (NULL != entrypoints && !found_entrypoints && loader_json_stream_key_equals(key, "entrypoints")) {
+                found_entrypoints = true;
+                VkResult res = loader_json_stream_string_array(inst, stream, entrypoints);
+                if (VK_SUCCESS != res) {
+                    return res;
+                }
+            } else if (!loader_json_stream_skip_value(stream, NULL)) {
+                return VK_INCOMPLETE;
+            }
+        } while (loader_json_stream_consume(stream, ','));
+        if (!loader_json_stream_consume(stream, '}')) {
+            return VK_INCOMPLETE;
+        }
+    }
+    // loader_read_layer_json silently skips extensions without a name
+    if (!found_name) {
+        return VK_INCOMPLETE;
+    }
+    if (NULL != out_has_entrypoints) {
+        *out_has_entrypoints = found_entrypoints;
+    }
+    return VK_SUCCESS;
+}
+
+static VkResult loader_json_stream_instance_extensions(const struct loader_instance *inst, loader_json_stream *stream,
+                                                       struct loader_extension_list *ext_list) {
+    if (!loader_json_stream_consume(stream, '[')) {
+        return VK_INCOMPLETE;
+    }
+    if (loader_json_stream_consume(stream, ']')) {
+        return VK_SUCCESS;
+    }
+    do {
+        VkExtensionProperties ext_prop = {0};
+        VkResult res = loader_json_stream_extension(inst, stream, &ext_prop, NULL, NULL);
+        if (VK_SUCCESS != res) {
+            return res;
+        }
+        if (!wsi_unsupported_instance_extension(&ext_prop)) {
+            res = loader_add_to_ext_list(inst, ext_list, 1, &ext_prop);
+            if (VK_SUCCESS != res) {
+                return res;
+            }
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    return loader_json_stream_consume(stream, ']') ? VK_SUCCESS : VK_INCOMPLETE;
+}
+
+static VkResult loader_json_stream_device_extensions(const struct loader_instance *inst, loader_json_stream *stream,
+                                                     struct loader_device_extension_list *ext_list) {
+    if (!loader_json_stream_consume(stream, '[')) {
+        return VK_INCOMPLETE;
+    }
+    if (loader_json_stream_consume(stream, ']')) {
+        return VK_SUCCESS;
+    }
+    do {
+        VkExtensionProperties ext_prop = {0};
+        bool has_entrypoints = false;
+        struct loader_string_list entrypoints = {0};
+        VkResult res = loader_json_stream_extension(inst, stream, &ext_prop, &has_entrypoints, &entrypoints);
+        if (VK_SUCCESS != res) {
+            free_string_list(inst, &entrypoints);
+            return res;
+        }
+        // Takes ownership of the entrypoints
+        res = loader_add_to_dev_ext_list(inst, ext_list, &ext_prop, has_entrypoints ? &entrypoints : NULL);
+        if (VK_SUCCESS != res) {
+            return res;
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    return loader_json_stream_consume(stream, ']') ? VK_SUCCESS : VK_INCOMPLETE;
+}
+
+// Reads "functions" and "pre_instance_functions", whose members are all strings. names and out_strings have name_count elements.
+static VkResult loader_json_stream_function_names(const struct loader_instance *inst, loader_json_stream *stream,
+                                                  uint32_t name_count, const char *const *names, char **out_strings) {
+    if (!loader_json_stream_consume(stream, '{')) {
+        return VK_INCOMPLETE;
+    }
+    if (loader_json_stream_consume(stream, '}')) {
+        return VK_SUCCESS;
+    }
+    do {
+        char *key = NULL;
+        bool has_control_chars = false;
+        if (!loader_json_stream_string(stream, &key, &has_control_chars) || has_control_chars ||
+            !loader_json_stream_consume(stream, ':')) {
+            return VK_INCOMPLETE;
+        }
+        uint32_t index = 0;
+        while (index < name_count && !loader_json_stream_key_equals(key, names[index])) {
+            index++;
+        }
+        // Only the first of several matching keys counts
+        if (index < name_count && NULL == out_strings[index]) {
+            VkResult res = loader_json_stream_printed_string(inst, stream, &out_strings[index]);
+            if (VK_SUCCESS != res) {
+                return res;
+            }
+        } else if (!loader_json_stream_skip_value(stream, NULL)) {
+            return VK_INCOMPLETE;
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    return loader_json_stream_consume(stream, '}') ? VK_SUCCESS : VK_INCOMPLETE;
+}
+
+// Reads "enable_environment" or "disable_environment", of which loader_read_layer_json only looks at the first member, and only
+// if its value is a string. *out_found is left alone if the value isn't an object or its first member doesn't count.
+static VkResult loader_json_stream_environment(const struct loader_instance *inst, loader_json_stream *stream, bool *out_found,
+                                               struct loader_name_value *env_var) {
+    loader_json_stream_skip_whitespace(stream);
+    if (stream->cur >= stream->end || *stream->cur != '{') {
+        return loader_json_stream_skip_value(stream, NULL) ? VK_SUCCESS : VK_INCOMPLETE;
+    }
+    stream->cur++;
+    if (loader_json_stream_consume(stream, '}')) {
+        return VK_SUCCESS;
+    }
+    bool first = true;
+    do {
+        char *key = NULL;
+        char *value = NULL;
+        if (!loader_json_stream_string(stream, &key, NULL) || !loader_json_stream_consume(stream, ':')) {
+            return VK_INCOMPLETE;
+        }
+        loader_json_stream_skip_whitespace(stream);
+        if (first && stream->cur < stream->end && *stream->cur == '\"') {
+            // The name and value are copied as they are, without printing them
+            if (!loader_json_stream_string(stream, &value, NULL)) {
+                return VK_INCOMPLETE;
+            }
+            VkResult res = loader_copy_to_new_str(inst, key, &env_var->name);
+            if (VK_SUCCESS != res) {
+                return res;
+            }
+            res = loader_copy_to_new_str(inst, value, &env_var->value);
+            if (VK_SUCCESS != res) {
+                return res;
+            }
+            *out_found = true;
+        } else if (!loader_json_stream_skip_value(stream, NULL)) {
+            return VK_INCOMPLETE;
+        }
+        first = false;
+    } while (loader_json_stream_consume(stream, ','));
+    return loader_json_stream_consume(stream, '}') ? VK_SUCCESS : VK_INCOMPLETE;
+}
+
+static VkResult loader_json_stream_layer(struct loader_json_stream_layer_manifest *manifest, loader_json_stream *stream) {
+    static const char *const function_names[] = {"vkNegotiateLoaderLayerInterfaceVersion", "vkGetInstanceProcAddr",
+                                                 "vkGetDeviceProcAddr"};
+    static const char *const pre_instance_function_names[] = {"vkEnumerateInstanceExtensionProperties",
+                                                              "vkEnumerateInstanceLayerProperties", "vkEnumerateInstanceVersion"};
+    const struct loader_instance *inst = manifest->inst;
+    struct loader_layer_properties props = {0};
+    struct loader_string_list blacklisted_layers = {0};
+    char *function_strings[3] = {NULL, NULL, NULL};
+    char *pre_instance_function_strings[3] = {NULL, NULL, NULL};
+    char *library_path = NULL;
+    bool found_name = false, found_type = false, found_api_version = false, found_implementation_version = false;
+    bool found_description = false, found_library_path = false, found_component_layers = false, found_override_paths = false;
+    bool found_blacklisted_layers = false, found_app_keys = false, found_functions = false, found_pre_instance = false;
+    bool found_instance_extensions = false, found_device_extensions = false, found_library_arch = false;
+    bool found_disable_environment = false, found_enable_environment = false;
+    bool has_disable_environment = false, has_enable_environment = false;
+    VkResult res = VK_INCOMPLETE;
+
+    if (!loader_json_stream_consume(stream, '{')) {
+        goto out;
+    }
+    if (!loader_json_stream_consume(stream, '}')) {
+        do {
+            char *key = NULL;
+            char *value = NULL;
+            bool has_control_chars = false;
+            VkResult member_res = VK_SUCCESS;
+            if (!loader_json_stream_string(stream, &key, &has_control_chars) || has_control_chars ||
+                !loader_json_stream_consume(stream, ':')) {
+                goto out;
+            }
+            if (!found_name && loader_json_stream_key_equals(key, "name")) {
+                found_name = true;
+                if (!loader_json_stream_string_field(stream, &value) ||
+                    !loader_json_stream_string_fits(value, VK_MAX_EXTENSION_NAME_SIZE)) {
+                    goto out;
+                }
+                loader_strncpy(props.info.layerName, VK_MAX_EXTENSION_NAME_SIZE, value, strlen(value) + 1);
+            } else if (!found_type && loader_json_stream_key_equals(key, "type")) {
+                found_type = true;
+                // Device layers are deprecated and anything else is skipped
+                if (!loader_json_stream_string(stream, &value, NULL) || (strcmp(value, "INSTANCE") && strcmp(value, "GLOBAL"))) {
+                    goto out;
+                }
+            } else if (!found_api_version && loader_json_stream_key_equals(key, "api_version")) {
+                found_api_version = true;
+                if (!loader_json_stream_string(stream, &value, NULL)) {
+                    goto out;
+                }
+                props.info.specVersion = loader_parse_version_string(value);
+                if (VK_API_VERSION_VARIANT(props.info.specVersion) != 0) {
+                    goto out;
+                }
+            } else if (!found_implementation_version && loader_json_stream_key_equals(key, "implementation_version")) {
+                found_implementation_version = true;
+                if (!loader_json_stream_string(stream, &value, NULL)) {
+                    goto out;
+                }
+                props.info.implementationVersion = (uint32_t)strtoul(value, NULL, 10);
+            } else if (!found_description && loader_json_stream_key_equals(key, "description")) {
+                found_description = true;
+                if (!loader_json_stream_string_field(stream, &value) ||
+                    !loader_json_stream_string_fits(value, VK_MAX_DESCRIPTION_SIZE)) {
+                    goto out;
+                }
+                loader_strncpy(props.info.description, VK_MAX_DESCRIPTION_SIZE, value, strlen(value) + 1);
+            } else if (!found_library_path && loader_json_stream_key_equals(key, "library_path")) {
+                found_library_path = true;
+                member_res = loader_json_stream_printed_string(inst, stream, &library_path);
+            } else if (!found_component_layers && loader_json_stream_key_equals(key, "component_layers")) {
+                found_component_layers = true;
+                member_res = loader_json_stream_string_array(inst, stream, &props.component_layer_names);
+            } else if (!found_override_paths && loader_json_stream_key_equals(key, "override_paths")) {
+                found_override_paths = true;
+                member_res = loader_json_stream_string_array(inst, stream, &props.override_paths);
+            } else if (!found_blacklisted_layers && loader_json_stream_key_equals(key, "blacklisted_layers")) {
+                found_blacklisted_layers = true;
+                member_res = loader_json_stream_string_array(inst, stream, &blacklisted_layers);
+            } else if (!found_app_keys && loader_json_stream_key_equals(key, "app_keys")) {
+                found_app_keys = true;
+                member_res = loader_json_stream_string_array(inst, stream, &props.app_key_paths);
+            } else if (!found_functions && loader_json_stream_key_equals(key, "functions")) {
+                found_functions = true;
+                member_res = loader_json_stream_function_names(inst, stream, 3, function_names, function_strings);
+            } else if (!found_pre_instance && loader_json_stream_key_equals(key, "pre_instance_functions")) {
+                found_pre_instance = true;
+                // Only implicit layers may have them, explicit layers get a warning
+                if (!manifest->is_implicit) {
+                    goto out;
+                }
+                member_res =
+                    loader_json_stream_function_names(inst, stream, 3, pre_instance_function_names, pre_instance_function_strings);
+            } else if (!found_instance_extensions && loader_json_stream_key_equals(key, "instance_extensions")) {
+                found_instance_extensions = true;
+                member_res = loader_json_stream_instance_extensions(inst, stream, &props.instance_extension_list);
+            } else if (!found_device_extensions && loader_json_stream_key_equals(key, "device_extensions")) {
+                found_device_extensions = true;
+                member_res = loader_json_stream_device_extensions(inst, stream, &props.device_extension_list);
+            } else if (manifest->is_implicit && !found_disable_environment &&
+                       loader_json_stream_key_equals(key, "disable_environment")) {
+                found_disable_environment = true;
+                member_res = loader_json_stream_environment(inst, stream, &has_disable_environment, &props.disable_env_var);
+            } else if (manifest->is_implicit && !found_enable_environment &&
+                       loader_json_stream_key_equals(key, "enable_environment")) {
+                found_enable_environment = true;
+                member_res = loader_json_stream_environment(inst, stream, &has_enable_environment, &props.enable_env_var);
+            } else if (!found_library_arch && loader_json_stream_key_equals(key, "library_arch")) {
+                found_library_arch = true;
+                loader_json_stream_skip_whitespace(stream);
+                if (stream->cur < stream->end && *stream->cur == '\"') {
+                    // Layers built for another architecture are skipped
+                    if (!loader_json_stream_string(stream, &value, NULL) || (strncmp(value, "32", 2) == 0 && sizeof(void *) != 4) ||
+                        (strncmp(value, "64", 2) == 0 && sizeof(void *) != 8)) {
+                        goto out;
+                    }
+                } else if (!loader_json_stream_skip_value(stream, NULL)) {
+                    goto out;
+                }
+            } else if (!loader_json_stream_skip_value(stream, NULL)) {
+                goto out;
+            }
+            if (VK_SUCCESS != member_res) {
+                res = member_res;
+                goto out;
+            }
+        } while (loader_json_stream_consume(stream, ','));
+        if (!loader_json_stream_consume(stream, '}')) {
+            goto out;
+        }
+    }
+
+    // Everything that would make loader_read_layer_json skip the layer or warn about it
+    if (!found_name || !found_type || !found_api_version || !found_implementation_version || !found_description) {
+        goto out;
+    }
+    if (0 != strncmp(props.info.layerName, "VK_LAYER_", 9)) {
+        goto out;
+    }
+    if ((NULL != library_path) == found_component_layers) {
+        goto out;
+    }
+    if (manifest->is_implicit && !has_disable_environment) {
+        goto out;
+    }
+    props.is_override = 0 == strcmp(props.info.layerName, VK_OVERRIDE_LAYER_NAME);
+    if (found_app_keys && !props.is_override) {
+        goto out;
+    }
+
+    props.type_flags = VK_LAYER_TYPE_FLAG_INSTANCE_LAYER;
+    if (!manifest->is_implicit) {
+        props.type_flags |= VK_LAYER_TYPE_FLAG_EXPLICIT_LAYER;
+    }
+    if (found_component_layers) {
+        props.type_flags |= VK_LAYER_TYPE_FLAG_META_LAYER;
+        manifest->has_meta_layer = true;
+    }
+    if (props.is_override) {
+        props.blacklist_layer_names = blacklisted_layers;
+        memset(&blacklisted_layers, 0, sizeof(blacklisted_layers));
+    }
+    manifest->has_override_paths |= NULL != props.override_paths.list;
+    manifest->has_pre_instance_functions |= found_pre_instance;
+    props.functions.str_negotiate_interface = function_strings[0];
+    props.functions.str_gipa = function_strings[1];
+    props.functions.str_gdpa = function_strings[2];
+    memset(function_strings, 0, sizeof(function_strings));
+    manifest->uses_deprecated_gpa_tags |=
+        NULL == props.functions.str_negotiate_interface && (NULL != props.functions.str_gipa || NULL != props.functions.str_gdpa);
+    props.pre_instance_functions.enumerate_instance_extension_properties = pre_instance_function_strings[0];
+    props.pre_instance_functions.enumerate_instance_layer_properties = pre_instance_function_strings[1];
+    props.pre_instance_functions.enumerate_instance_version = pre_instance_function_strings[2];
+    memset(pre_instance_function_strings, 0, sizeof(pre_instance_function_strings));
+
+    res = loader_copy_to_new_str(inst, manifest->filename, &props.manifest_file_name);
+    if (VK_SUCCESS != res) {
+        goto out;
+    }
+    if (NULL != library_path) {
+        // Takes ownership of library_path
+        res = combine_manifest_directory_and_library_path(inst, library_path, manifest->filename, &props.lib_name);
+        library_path = NULL;
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+    }
+    res = loader_append_layer_property(inst, &manifest->layers, &props);
+
+out:
+    if (VK_SUCCESS != res) {
+        loader_free_layer_properties(inst, &props);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        loader_instance_heap_free(inst, function_strings[i]);
+        loader_instance_heap_free(inst, pre_instance_function_strings[i]);
+    }
+    loader_instance_heap_free(inst, library_path);
+    free_string_list(inst, &blacklisted_layers);
+    return res;
+}
+
+static VkResult loader_json_stream_layer_manifest_root(struct loader_json_stream_layer_manifest *manifest,
+                                                       loader_json_stream *stream) {
+    bool found_file_format_version = false;
+    if (stream->end - stream->cur >= 3 && strncmp(stream->cur, "\xEF\xBB\xBF", 3) == 0) {
+        stream->cur += 3;
+    }
+    if (!loader_json_stream_consume(stream, '{')) {
+        return VK_INCOMPLETE;
+    }
+    if (loader_json_stream_consume(stream, '}')) {
+        return VK_INCOMPLETE;
+    }
+    do {
+        char *key = NULL;
+        bool has_control_chars = false;
+        VkResult res = VK_SUCCESS;
+        // loader_add_layer_properties reads every member following the first "layer" as another layer, whatever its name
+        if (manifest->has_layer_object) {
+            return VK_INCOMPLETE;
+        }
+        if (!loader_json_stream_string(stream, &key, &has_control_chars) || has_control_chars ||
+            !loader_json_stream_consume(stream, ':')) {
+            return VK_INCOMPLETE;
+        }
+        if (!found_file_format_version && loader_json_stream_key_equals(key, "file_format_version")) {
+            found_file_format_version = true;
+            if (!loader_json_stream_string(stream, &manifest->file_format_version, NULL)) {
+                return VK_INCOMPLETE;
+            }
+        } else if (loader_json_stream_key_equals(key, "layers")) {
+            // "layers" takes precedence over "layer", so a file with both is left to cJSON along with repeated "layers"
+            if (manifest->has_layers_array) {
+                return VK_INCOMPLETE;
+            }
+            manifest->has_layers_array = true;
+            if (!loader_json_stream_consume(stream, '[')) {
+                return VK_INCOMPLETE;
+            }
+            if (!loader_json_stream_consume(stream, ']')) {
+                do {
+                    res = loader_json_stream_layer(manifest, stream);
+                    if (VK_SUCCESS != res) {
+                        return res;
+                    }
+                } while (loader_json_stream_consume(stream, ','));
+                if (!loader_json_stream_consume(stream, ']')) {
+                    return VK_INCOMPLETE;
+                }
+            }
+        } else if (loader_json_stream_key_equals(key, "layer")) {
+            if (manifest->has_layers_array) {
+                return VK_INCOMPLETE;
+            }
+            manifest->has_layer_object = true;
+            res = loader_json_stream_layer(manifest, stream);
+            if (VK_SUCCESS != res) {
+                return res;
+            }
+        } else if (!loader_json_stream_skip_value(stream, NULL)) {
+            return VK_INCOMPLETE;
+        }
+    } while (loader_json_stream_consume(stream, ','));
+    // Like cJSON, ignore whatever follows the root object
+    if (!loader_json_stream_consume(stream, '}')) {
+        return VK_INCOMPLETE;
+    }
+    // A file without either is reported by loader_add_layer_properties, unless it is a driver manifest
+    if (!found_file_format_version || (!manifest->has_layers_array && !manifest->has_layer_object)) {
+        return VK_INCOMPLETE;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult loader_read_layer_manifest(const struct loader_instance *inst, const char *filename, bool is_implicit,
+                                    struct loader_layer_list *layer_instance_list) {
+    struct loader_json_stream_layer_manifest manifest = {0};
+    loader_json_stream stream = {0};
+    char *buffer = NULL;
+    size_t buffer_length = 0;
+    loader_cJSON_ReleaseBuffer release_buffer = NULL;
+    char *version_string = NULL;
+    VkResult res = VK_SUCCESS;
+    uint64_t phase_begin = loader_phase_begin();
+
+    manifest.inst = inst;
+    manifest.filename = filename;
+    manifest.is_implicit = is_implicit;
+
+    // Failures to read the file are left for loader_get_json to report
+    res = loader_read_entire_file(inst, filename, false, &buffer_length, &buffer, &release_buffer);
+    if (VK_SUCCESS != res) {
+        res = VK_INCOMPLETE;
+        goto out;
+    }
+    stream.cur = buffer;
+    stream.end = buffer + buffer_length;
+    res = loader_json_stream_layer_manifest_root(&manifest, &stream);
+    if (VK_SUCCESS != res) {
+        goto out;
+    }
+
+    // loader_parse_version_string cuts up the string it is given, and the original is logged below
+    res = loader_copy_to_new_str(inst, manifest.file_format_version, &version_string);
+    if (VK_SUCCESS != res) {
+        goto out;
+    }
+    loader_api_version json_version = loader_make_full_version(loader_parse_version_string(version_string));
+    if (!is_valid_layer_json_version(&json_version) ||
+        (manifest.has_layers_array && !loader_check_version_meets_required(loader_combine_version(1, 0, 1), json_version)) ||
+        ((manifest.has_meta_layer || manifest.has_override_paths) &&
+         !loader_check_version_meets_required(LOADER_VERSION_1_1_0, json_version)) ||
+        (manifest.has_pre_instance_functions &&
+         !loader_check_version_meets_required(loader_combine_version(1, 1, 2), json_version))) {
+        res = VK_INCOMPLETE;
+        goto out;
+    }
+    if (loader_check_version_meets_required(LOADER_VERSION_1_1_0, json_version)) {
+        // Using vkGetInstanceProcAddr or vkGetDeviceProcAddr instead of vkNegotiateLoaderLayerInterfaceVersion logs a message
+        if (manifest.uses_deprecated_gpa_tags) {
+            res = VK_INCOMPLETE;
+            goto out;
+        }
+    } else {
+        // vkNegotiateLoaderLayerInterfaceVersion is only looked at starting with file version 1.1.0
+        for (uint32_t i = 0; i < manifest.layers.count; i++) {
+            loader_instance_heap_free(inst, manifest.layers.list[i].functions.str_negotiate_interface);
+            manifest.layers.list[i].functions.str_negotiate_interface = NULL;
+        }
+    }
+
+    loader_log(inst, VULKAN_LOADER_INFO_BIT, 0, "Found manifest file %s (file version %s)", filename,
+               manifest.file_format_version);
+    for (uint32_t i = 0; i < manifest.layers.count; i++) {
+        if (manifest.layers.list[i].type_flags & VK_LAYER_TYPE_FLAG_META_LAYER) {
+            loader_log(inst, VULKAN_LOADER_INFO_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Encountered meta-layer \"%s\"",
+                       manifest.layers.list[i].info.layerName);
+        }
+        res = loader_append_layer_property(inst, layer_instance_list, &manifest.layers.list[i]);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+    }
+
+out:
+    loader_instance_heap_free(inst, version_string);
+    // Appended layers were cleared out of the list, so this only frees the layers that were never handed over
+    loader_delete_layer_list_and_properties(inst, &manifest.layers);
+    if (NULL != buffer && NULL != release_buffer) {
+        release_buffer(inst ? &inst->alloc_callbacks : NULL, buffer, buffer_length);
+    }
+    loader_phase_end(LOADER_PHASE_JSON_PARSE, phase_begin, filename);
+    return res;
+}
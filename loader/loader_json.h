@@ -32,6 +32,7 @@
 
 // Forward decls
 struct loader_instance;
+struct loader_layer_list;
 struct loader_string_list;
 
 // Read a JSON file into a buffer.
@@ -40,6 +41,10 @@ struct loader_string_list;
 //            This returned buffer should be freed by caller.
 TEST_FUNCTION_EXPORT VkResult loader_get_json(const struct loader_instance *inst, const char *filename, cJSON **json);
 
+// Same as loader_get_json but never logs, so that it can be called from worker threads. On failure *json is NULL and the caller
+// is expected to call loader_get_json to report why the file couldn't be read.
+VkResult loader_get_json_without_logging(const struct loader_instance *inst, const char *filename, cJSON **json);
+
 // Given a cJSON object, find the string associated with the key and puts an pre-allocated string into out_string.
 // Length is given by out_str_len, and this function truncates the string with a null terminator if it the provided space isn't
 // large enough.
@@ -53,3 +58,44 @@ VkResult loader_parse_json_string(cJSON *object, const char *key, char **out_str
 // out_array_of_strings. It is the callers responsibility to free out_array_of_strings.
 VkResult loader_parse_json_array_of_strings(const struct loader_instance *inst, cJSON *object, const char *key,
                                             struct loader_string_list *string_list);
+
+// The parts of a driver manifest loader_parse_icd_manifest looks at. The has_* members say whether the key is present at all,
+// while the string members are NULL unless the value is a string, except library_path which holds the printed value.
+struct loader_icd_manifest_fields {
+    bool has_file_format_version;
+    char *file_format_version;
+    bool has_icd;
+    bool has_layer;  // "layer" or "layers" is present, which tells layer manifests apart from broken driver manifests
+    bool has_library_path;
+    char *library_path;  // Allocated, the caller may take ownership of it
+    bool has_api_version;
+    char *api_version;
+    char *library_arch;
+    bool is_portability_driver;
+
+    // What the strings point into
+    cJSON *json;
+    char *buffer;
+    size_t buffer_length;
+    loader_cJSON_ReleaseBuffer release_buffer;
+};
+
+// Reads the fields of a driver manifest in a single pass over the file, without building a cJSON tree.
+// Returns VK_INCOMPLETE if the file couldn't be read or isn't a well formed driver manifest, in which case the caller should parse
+// it with loader_get_json and loader_get_icd_manifest_fields_from_json, which also report what is wrong with it.
+TEST_FUNCTION_EXPORT VkResult loader_read_icd_manifest_fields(const struct loader_instance *inst, const char *filename,
+                                                              struct loader_icd_manifest_fields *fields);
+
+// Looks up the fields of a driver manifest in an already parsed cJSON tree, taking ownership of json.
+TEST_FUNCTION_EXPORT VkResult loader_get_icd_manifest_fields_from_json(const struct loader_instance *inst, cJSON *json,
+                                                                       struct loader_icd_manifest_fields *fields);
+
+TEST_FUNCTION_EXPORT void loader_free_icd_manifest_fields(const struct loader_instance *inst,
+                                                          struct loader_icd_manifest_fields *fields);
+
+// Reads every layer of a layer manifest in a single pass over the file, without building a cJSON tree, and appends them to
+// layer_instance_list. Returns VK_INCOMPLETE without adding any layer if the file couldn't be read, isn't well formed or has
+// anything loader_add_layer_properties would warn about or skip, in which case the caller should parse it with loader_get_json
+// and loader_add_layer_properties instead.
+TEST_FUNCTION_EXPORT VkResult loader_read_layer_manifest(const struct loader_instance *inst, const char *filename, bool is_implicit,
+                                                         struct loader_layer_list *layer_instance_list);
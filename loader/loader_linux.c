@@ -233,6 +233,75 @@ void linux_env_var_default_device(struct loader_instance *inst, uint32_t device_
     }
 }
 
+// Fill out the sorting information for a physical device from the properties and extensions cached on its terminator object.
+static VkResult linux_read_device_info(struct loader_instance *inst, bool app_is_vulkan_1_1,
+                                       struct loader_physical_device_term *phys_dev_term,
+                                       struct LinuxSortedDeviceInfo *device_info) {
+    struct loader_icd_term *icd_term = phys_dev_term->this_icd_term;
+    const VkPhysicalDeviceProperties *dev_props = loader_get_phys_dev_term_properties(phys_dev_term);
+
+    device_info->physical_device = phys_dev_term->phys_dev;
+    device_info->icd_term = icd_term;
+    device_info->has_pci_bus_info = false;
+    device_info->device_type = dev_props->deviceType;
+    strncpy(device_info->device_name, dev_props->deviceName, VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+    device_info->device_name[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1] = '\0';
+    device_info->vendor_id = dev_props->vendorID;
+    device_info->device_id = dev_props->deviceID;
+
+    bool device_is_1_1_capable =
+        loader_check_version_meets_required(LOADER_VERSION_1_1_0, loader_make_version(dev_props->apiVersion));
+
+    uint32_t ext_count = 0;
+    const VkExtensionProperties *ext_props = NULL;
+    VkResult res = loader_get_phys_dev_term_extensions(inst, phys_dev_term, &ext_count, &ext_props);
+    if (res == VK_ERROR_OUT_OF_HOST_MEMORY) {
+        return res;
+    }
+    for (uint32_t ext = 0; ext < ext_count; ++ext) {
+        if (!strcmp(ext_props[ext].extensionName, VK_EXT_PCI_BUS_INFO_EXTENSION_NAME)) {
+            device_info->has_pci_bus_info = true;
+            break;
+        }
+    }
+
+    if (device_info->has_pci_bus_info) {
+        VkPhysicalDevicePCIBusInfoPropertiesEXT pci_props = (VkPhysicalDevicePCIBusInfoPropertiesEXT){
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT};
+        VkPhysicalDeviceProperties2 dev_props2 =
+            (VkPhysicalDeviceProperties2){.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &pci_props};
+
+        PFN_vkGetPhysicalDeviceProperties2 GetPhysDevProps2 = NULL;
+        if (app_is_vulkan_1_1 && device_is_1_1_capable) {
+            GetPhysDevProps2 = icd_term->dispatch.GetPhysicalDeviceProperties2;
+        } else {
+            GetPhysDevProps2 = (PFN_vkGetPhysicalDeviceProperties2)icd_term->dispatch.GetPhysicalDeviceProperties2KHR;
+        }
+        if (NULL != GetPhysDevProps2) {
+            GetPhysDevProps2(device_info->physical_device, &dev_props2);
+            device_info->pci_domain = pci_props.pciDomain;
+            device_info->pci_bus = pci_props.pciBus;
+            device_info->pci_device = pci_props.pciDevice;
+            device_info->pci_function = pci_props.pciFunction;
+        } else {
+            device_info->has_pci_bus_info = false;
+        }
+    }
+    return VK_SUCCESS;
+}
+
+// Returns the terminator object a previous vkEnumeratePhysicalDevices call created for physical_device, if there is one, so its
+// cached driver information can be reused instead of querying the driver again.
+static struct loader_physical_device_term *linux_find_existing_phys_dev_term(struct loader_instance *inst,
+                                                                             VkPhysicalDevice physical_device) {
+    for (uint32_t i = 0; i < inst->phys_dev_count_term; ++i) {
+        if (NULL != inst->phys_devs_term[i] && inst->phys_devs_term[i]->phys_dev == physical_device) {
+            return inst->phys_devs_term[i];
+        }
+    }
+    return NULL;
+}
+
 // This function allocates an array in sorted_devices which must be freed by the caller if not null
 VkResult linux_read_sorted_physical_devices(struct loader_instance *inst, uint32_t icd_count,
                                             struct loader_icd_physical_devices *icd_devices, uint32_t phys_dev_count,
@@ -254,67 +323,18 @@ VkResult linux_read_sorted_physical_devices(struct loader_instance *inst, uint32
     uint32_t index = 0;
     for (uint32_t icd_idx = 0; icd_idx < icd_count; ++icd_idx) {
         for (uint32_t phys_dev = 0; phys_dev < icd_devices[icd_idx].device_count; ++phys_dev) {
-            struct loader_icd_term *icd_term = icd_devices[icd_idx].icd_term;
-            VkPhysicalDeviceProperties dev_props = {};
-
-            sorted_device_info[index].physical_device = icd_devices[icd_idx].physical_devices[phys_dev];
-            sorted_device_info[index].icd_term = icd_term;
-            sorted_device_info[index].has_pci_bus_info = false;
-
-            icd_term->dispatch.GetPhysicalDeviceProperties(sorted_device_info[index].physical_device, &dev_props);
-            sorted_device_info[index].device_type = dev_props.deviceType;
-            strncpy(sorted_device_info[index].device_name, dev_props.deviceName, VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
-            sorted_device_info[index].device_name[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1] = '\0';
-            sorted_device_info[index].vendor_id = dev_props.vendorID;
-            sorted_device_info[index].device_id = dev_props.deviceID;
-
-            bool device_is_1_1_capable =
-                loader_check_version_meets_required(LOADER_VERSION_1_1_0, loader_make_version(dev_props.apiVersion));
-            if (!sorted_device_info[index].has_pci_bus_info) {
-                uint32_t ext_count = 0;
-                icd_term->dispatch.EnumerateDeviceExtensionProperties(sorted_device_info[index].physical_device, NULL, &ext_count,
-                                                                      NULL);
-                if (ext_count > 0) {
-                    VkExtensionProperties *ext_props =
-                        (VkExtensionProperties *)loader_stack_alloc(sizeof(VkExtensionProperties) * ext_count);
-                    if (NULL == ext_props) {
-                        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-                        goto out;
-                    }
-                    uint32_t allocated_count = ext_count;
-                    icd_term->dispatch.EnumerateDeviceExtensionProperties(sorted_device_info[index].physical_device, NULL,
-                                                                          &ext_count, ext_props);
-                    // The count returned by the second call sizes the array, but never read past what we actually allocated.
-                    for (uint32_t ext = 0; ext < ext_count && ext < allocated_count; ++ext) {
-                        if (!strcmp(ext_props[ext].extensionName, VK_EXT_PCI_BUS_INFO_EXTENSION_NAME)) {
-                            sorted_device_info[index].has_pci_bus_info = true;
-                            break;
-                        }
-                    }
-                }
-            }
-
-            if (sorted_device_info[index].has_pci_bus_info) {
-                VkPhysicalDevicePCIBusInfoPropertiesEXT pci_props = (VkPhysicalDevicePCIBusInfoPropertiesEXT){
-                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT};
-                VkPhysicalDeviceProperties2 dev_props2 =
-                    (VkPhysicalDeviceProperties2){.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &pci_props};
-
-                PFN_vkGetPhysicalDeviceProperties2 GetPhysDevProps2 = NULL;
-                if (app_is_vulkan_1_1 && device_is_1_1_capable) {
-                    GetPhysDevProps2 = icd_term->dispatch.GetPhysicalDeviceProperties2;
-                } else {
-                    GetPhysDevProps2 = (PFN_vkGetPhysicalDeviceProperties2)icd_term->dispatch.GetPhysicalDeviceProperties2KHR;
-                }
-                if (NULL != GetPhysDevProps2) {
-                    GetPhysDevProps2(sorted_device_info[index].physical_device, &dev_props2);
-                    sorted_device_info[index].pci_domain = pci_props.pciDomain;
-                    sorted_device_info[index].pci_bus = pci_props.pciBus;
-                    sorted_device_info[index].pci_device = pci_props.pciDevice;
-                    sorted_device_info[index].pci_function = pci_props.pciFunction;
-                } else {
-                    sorted_device_info[index].has_pci_bus_info = false;
-                }
+            struct loader_physical_device_term *phys_dev_term = sorted_device_term[index];
+            phys_dev_term->this_icd_term = icd_devices[icd_idx].icd_term;
+            phys_dev_term->phys_dev = icd_devices[icd_idx].physical_devices[phys_dev];
+            loader_set_dispatch((void *)phys_dev_term, inst->disp);
+            sorted_device_info[index].term = phys_dev_term;
+
+            // The caller swaps in the terminator object from a previous call, so read the information through that one
+            struct loader_physical_device_term *existing_term = linux_find_existing_phys_dev_term(inst, phys_dev_term->phys_dev);
+            res = linux_read_device_info(inst, app_is_vulkan_1_1, NULL != existing_term ? existing_term : phys_dev_term,
+                                         &sorted_device_info[index]);
+            if (res != VK_SUCCESS) {
+                goto out;
             }
             loader_log(inst, VULKAN_LOADER_INFO_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "           [%u] %s", index,
                        sorted_device_info[index].device_name);
@@ -333,9 +353,7 @@ VkResult linux_read_sorted_physical_devices(struct loader_instance *inst, uint32
 
     // Add all others after (they've already been sorted)
     for (uint32_t dev = 0; dev < phys_dev_count; ++dev) {
-        sorted_device_term[dev]->this_icd_term = sorted_device_info[dev].icd_term;
-        sorted_device_term[dev]->phys_dev = sorted_device_info[dev].physical_device;
-        loader_set_dispatch((void *)sorted_device_term[dev], inst->disp);
+        sorted_device_term[dev] = sorted_device_info[dev].term;
         loader_log(inst, VULKAN_LOADER_INFO_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "           [%u] %s  %s", dev,
                    sorted_device_info[dev].device_name, (sorted_device_info[dev].default_device ? "[default]" : ""));
     }
@@ -357,69 +375,23 @@ VkResult linux_sort_physical_device_groups(struct loader_instance *inst, uint32_
     for (uint32_t group = 0; group < group_count; ++group) {
         loader_log(inst, VULKAN_LOADER_INFO_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "           Group %u", group);
 
-        struct loader_icd_term *icd_term = sorted_group_term[group].this_icd_term;
         for (uint32_t gpu = 0; gpu < sorted_group_term[group].group_props.physicalDeviceCount; ++gpu) {
-            VkPhysicalDeviceProperties dev_props = {};
-
-            sorted_group_term[group].internal_device_info[gpu].physical_device =
-                sorted_group_term[group].group_props.physicalDevices[gpu];
-            sorted_group_term[group].internal_device_info[gpu].has_pci_bus_info = false;
-
-            icd_term->dispatch.GetPhysicalDeviceProperties(sorted_group_term[group].internal_device_info[gpu].physical_device,
-                                                           &dev_props);
-            sorted_group_term[group].internal_device_info[gpu].device_type = dev_props.deviceType;
-            strncpy(sorted_group_term[group].internal_device_info[gpu].device_name, dev_props.deviceName,
-                    VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
-            sorted_group_term[group].internal_device_info[gpu].device_name[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1] = '\0';
-            sorted_group_term[group].internal_device_info[gpu].vendor_id = dev_props.vendorID;
-            sorted_group_term[group].internal_device_info[gpu].device_id = dev_props.deviceID;
-
-            bool device_is_1_1_capable =
-                loader_check_version_meets_required(LOADER_VERSION_1_1_0, loader_make_version(dev_props.apiVersion));
-            if (!sorted_group_term[group].internal_device_info[gpu].has_pci_bus_info) {
-                uint32_t ext_count;
-                icd_term->dispatch.EnumerateDeviceExtensionProperties(
-                    sorted_group_term[group].internal_device_info[gpu].physical_device, NULL, &ext_count, NULL);
-                if (ext_count > 0) {
-                    VkExtensionProperties *ext_props =
-                        (VkExtensionProperties *)loader_stack_alloc(sizeof(VkExtensionProperties) * ext_count);
-                    if (NULL == ext_props) {
-                        return VK_ERROR_OUT_OF_HOST_MEMORY;
-                    }
-                    uint32_t allocated_count = ext_count;
-                    icd_term->dispatch.EnumerateDeviceExtensionProperties(
-                        sorted_group_term[group].internal_device_info[gpu].physical_device, NULL, &ext_count, ext_props);
-                    // The count returned by the second call sizes the array, but never read past what we actually allocated.
-                    for (uint32_t ext = 0; ext < ext_count && ext < allocated_count; ++ext) {
-                        if (!strcmp(ext_props[ext].extensionName, VK_EXT_PCI_BUS_INFO_EXTENSION_NAME)) {
-                            sorted_group_term[group].internal_device_info[gpu].has_pci_bus_info = true;
-                            break;
-                        }
-                    }
-                }
+            VkPhysicalDevice physical_device = sorted_group_term[group].group_props.physicalDevices[gpu];
+
+            // Group members are normally already known from vkEnumeratePhysicalDevices, otherwise read them through a
+            // temporary terminator object whose cached extensions are released right after.
+            struct loader_physical_device_term temp_term = {0};
+            struct loader_physical_device_term *phys_dev_term = linux_find_existing_phys_dev_term(inst, physical_device);
+            if (NULL == phys_dev_term) {
+                temp_term.this_icd_term = sorted_group_term[group].this_icd_term;
+                temp_term.phys_dev = physical_device;
+                phys_dev_term = &temp_term;
             }
-
-            if (sorted_group_term[group].internal_device_info[gpu].has_pci_bus_info) {
-                VkPhysicalDevicePCIBusInfoPropertiesEXT pci_props = (VkPhysicalDevicePCIBusInfoPropertiesEXT){
-                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT};
-                VkPhysicalDeviceProperties2 dev_props2 =
-                    (VkPhysicalDeviceProperties2){.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &pci_props};
-
-                PFN_vkGetPhysicalDeviceProperties2 GetPhysDevProps2 = NULL;
-                if (app_is_vulkan_1_1 && device_is_1_1_capable) {
-                    GetPhysDevProps2 = icd_term->dispatch.GetPhysicalDeviceProperties2;
-                } else {
-                    GetPhysDevProps2 = (PFN_vkGetPhysicalDeviceProperties2)icd_term->dispatch.GetPhysicalDeviceProperties2KHR;
-                }
-                if (NULL != GetPhysDevProps2) {
-                    GetPhysDevProps2(sorted_group_term[group].internal_device_info[gpu].physical_device, &dev_props2);
-                    sorted_group_term[group].internal_device_info[gpu].pci_domain = pci_props.pciDomain;
-                    sorted_group_term[group].internal_device_info[gpu].pci_bus = pci_props.pciBus;
-                    sorted_group_term[group].internal_device_info[gpu].pci_device = pci_props.pciDevice;
-                    sorted_group_term[group].internal_device_info[gpu].pci_function = pci_props.pciFunction;
-                } else {
-                    sorted_group_term[group].internal_device_info[gpu].has_pci_bus_info = false;
-                }
+            res = linux_read_device_info(inst, app_is_vulkan_1_1, phys_dev_term,
+                                         &sorted_group_term[group].internal_device_info[gpu]);
+            loader_instance_heap_free(inst, temp_term.extensions_snapshot);
+            if (res != VK_SUCCESS) {
+                return res;
             }
             loader_log(inst, VULKAN_LOADER_INFO_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "               [%u] %s", gpu,
                        sorted_group_term[group].internal_device_info[gpu].device_name);
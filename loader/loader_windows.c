@@ -39,6 +39,9 @@
 #include "loader_environment.h"
 #include "loader.h"
 #include "log.h"
+#include "log_sinks.h"
+#include "manifest_cache.h"
+#include "phase_timing.h"
 
 #include <cfgmgr32.h>
 #include <initguid.h>
@@ -102,7 +105,13 @@ BOOL WINAPI DllMain(HINSTANCE hinst, DWORD reason, LPVOID reserved) {
             // Only initialize necessary sync primitives
             loader_platform_thread_create_mutex(&loader_lock);
             loader_platform_thread_create_mutex(&loader_preload_icd_lock);
+            loader_platform_thread_create_mutex(&loader_layer_library_lock);
+            loader_platform_thread_create_rwlock(&loader_object_lookup_lock);
             init_global_loader_settings();
+            init_global_log_sinks();
+            init_global_phase_timing();
+            init_global_manifest_cache();
+            init_global_envvar_snapshot();
             break;
         case DLL_PROCESS_DETACH:
             if (NULL == reserved) {
@@ -34,6 +34,7 @@
 #include "debug_utils.h"
 #include "loader_common.h"
 #include "loader_environment.h"
+#include "log_sinks.h"
 #include "settings.h"
 #include "vk_loader_platform.h"
 
@@ -134,9 +135,57 @@ void generate_debug_flag_str(VkFlags msg_type, size_t cmd_line_size, char *cmd_l
 #undef STRNCAT_TO_BUFFER
 }
 
+// Whether msg_type passes the filter for printing to stderr, from the instance's settings file or else VK_LOADER_DEBUG
+static bool loader_log_should_print(const struct loader_instance *inst, VkFlags msg_type) {
+    // Always log to stderr if this is a fatal error
+    if (0 != (msg_type & VULKAN_LOADER_FATAL_ERROR_BIT)) {
+        return true;
+    }
+    if (inst && inst->settings.settings_active && inst->settings.debug_level > 0) {
+        // The current instance settings have some debugging options, so only they decide
+        return 0 != (msg_type & inst->settings.debug_level);
+    }
+    // Check the global settings and if that doesn't say to skip, check the environment variable
+    return 0 != (msg_type & g_loader_debug);
+}
+
 void DECORATE_PRINTF(4, 5)
     loader_log(const struct loader_instance *inst, VkFlags msg_type, int32_t msg_code, const char *format, ...) {
     (void)msg_code;
+    VkDebugUtilsMessageSeverityFlagBitsEXT severity = 0;
+    VkDebugUtilsMessageTypeFlagsEXT type = 0;
+
+    if ((msg_type & VULKAN_LOADER_INFO_BIT) != 0) {
+        severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+    } else if ((msg_type & VULKAN_LOADER_WARN_BIT) != 0) {
+        severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+    } else if ((msg_type & VULKAN_LOADER_ERROR_BIT) != 0) {
+        severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    } else if ((msg_type & VULKAN_LOADER_DEBUG_BIT) != 0) {
+        severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
+    } else if ((msg_type & VULKAN_LOADER_LAYER_BIT) != 0 || (msg_type & VULKAN_LOADER_DRIVER_BIT) != 0) {
+        // Just driver or just layer bit should be treated as an info message in debug utils.
+        severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+    }
+
+    if ((msg_type & VULKAN_LOADER_PERF_BIT) != 0) {
+        type = VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+    } else if ((msg_type & VULKAN_LOADER_VALIDATION_BIT) != 0) {
+        // For loader logging, if it's a validation message, we still want to also keep the general flag as well
+        // so messages of type validation can still be triggered for general message callbacks.
+        type = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT;
+    } else {
+        type = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT;
+    }
+
+    // Most messages are debug or info messages nobody listens to, so find out who receives the message before formatting it
+    bool send_to_callbacks = inst && util_DebugMessageHasReceivers(inst, severity, type);
+    bool print = loader_log_should_print(inst, msg_type);
+    bool send_to_sinks = 0 != (msg_type & loader_get_log_sink_filters());
+    if (!send_to_callbacks && !print && !send_to_sinks) {
+        return;
+    }
+
     char msg[512] = {0};
 
     va_list ap;
@@ -147,35 +196,10 @@ void DECORATE_PRINTF(4, 5)
     }
     va_end(ap);
 
-    if (inst) {
-        VkDebugUtilsMessageSeverityFlagBitsEXT severity = 0;
-        VkDebugUtilsMessageTypeFlagsEXT type = 0;
+    if (send_to_callbacks) {
         VkDebugUtilsMessengerCallbackDataEXT callback_data = {0};
         VkDebugUtilsObjectNameInfoEXT object_name = {0};
 
-        if ((msg_type & VULKAN_LOADER_INFO_BIT) != 0) {
-            severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
-        } else if ((msg_type & VULKAN_LOADER_WARN_BIT) != 0) {
-            severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
-        } else if ((msg_type & VULKAN_LOADER_ERROR_BIT) != 0) {
-            severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
-        } else if ((msg_type & VULKAN_LOADER_DEBUG_BIT) != 0) {
-            severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
-        } else if ((msg_type & VULKAN_LOADER_LAYER_BIT) != 0 || (msg_type & VULKAN_LOADER_DRIVER_BIT) != 0) {
-            // Just driver or just layer bit should be treated as an info message in debug utils.
-            severity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
-        }
-
-        if ((msg_type & VULKAN_LOADER_PERF_BIT) != 0) {
-            type = VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
-        } else if ((msg_type & VULKAN_LOADER_VALIDATION_BIT) != 0) {
-            // For loader logging, if it's a validation message, we still want to also keep the general flag as well
-            // so messages of type validation can still be triggered for general message callbacks.
-            type = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT;
-        } else {
-            type = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT;
-        }
-
         callback_data.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT;
         callback_data.pMessageIdName = "Loader Message";
         callback_data.pMessage = msg;
@@ -188,17 +212,8 @@ void DECORATE_PRINTF(4, 5)
         util_SubmitDebugUtilsMessageEXT(inst, severity, type, &callback_data);
     }
 
-    // Always log to stderr if this is a fatal error
-    if (0 == (msg_type & VULKAN_LOADER_FATAL_ERROR_BIT)) {
-        if (inst && inst->settings.settings_active && inst->settings.debug_level > 0) {
-            // Exit early if the current instance settings have some debugging options but do match the current msg_type
-            if (0 == (msg_type & inst->settings.debug_level)) {
-                return;
-            }
-            // Check the global settings and if that doesn't say to skip, check the environment variable
-        } else if (0 == (msg_type & g_loader_debug)) {
-            return;
-        }
+    if (!print && !send_to_sinks) {
+        return;
     }
 
 #if defined(DEBUG)
@@ -260,6 +275,13 @@ void DECORATE_PRINTF(4, 5)
     // Assert that we didn't write more than what is available in cmd_line_msg
     assert(cmd_line_size > num_used);
 
+    if (send_to_sinks) {
+        loader_write_to_log_sinks(msg_type, cmd_line_msg, msg);
+    }
+    if (!print) {
+        return;
+    }
+
     // NOLINTBEGIN(cert-err33-c) - this is the logger itself; no sane recovery from a failed stderr write
     fputs(cmd_line_msg, stderr);
     fputs(msg, stderr);
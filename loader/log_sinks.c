@@ -0,0 +1,425 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "log_sinks.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if COMMON_UNIX_PLATFORMS
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "allocation.h"
+#include "log.h"
+#include "vk_loader_platform.h"
+
+// Large enough for the header and the 512 byte message buffer of loader_log, plus the newline and the null terminator
+#define LOADER_LOG_SINK_SLOT_SIZE 640
+
+struct loader_log_sink {
+    char *destination;
+    FILE *file;
+    bool owns_file;  // false for stdout and stderr
+    // Written by the thread that logs instead of the writer thread, so that the messages appear in order with the application's
+    // own output to stdout and stderr
+    bool synchronous;
+    uint32_t filters;
+};
+
+struct loader_log_sink_slot {
+    uint32_t sink_mask;  // bit i is set if the message goes to sinks[i]
+    uint32_t length;  // not counting the null terminator
+    char text[LOADER_LOG_SINK_SLOT_SIZE];
+};
+
+// Producers fill the slot at head and the writer thread consumes the slots in [tail, head) in place, without holding the lock
+// while writing them out. Both indices only ever increase and wrap around, so head - tail is the number of queued messages.
+struct loader_log_sinks {
+    loader_platform_thread_mutex lock;             // guards everything below
+    loader_platform_thread_cond messages_queued;   // signalled when head moved or the writer should exit
+    loader_platform_thread_cond messages_written;  // signalled when tail moved or the writer exited
+
+    uint32_t sink_count;
+    struct loader_log_sink sinks[LOADER_MAX_LOG_SINKS];
+    uint32_t filters;  // union of the filters of all sinks
+
+    struct loader_log_sink_slot *slots;  // LOADER_LOG_SINK_RING_SIZE slots, allocated along with the writer thread
+    uint32_t head;
+    uint32_t tail;
+
+    loader_platform_thread writer;
+    bool writer_running;
+    bool writer_exit_requested;
+};
+
+static struct loader_log_sinks log_sinks;
+
+#if COMMON_UNIX_PLATFORMS
+// Process which the lock and the writer thread belong to, or minus the pid of a process whose thread is re-creating them. Read
+// before taking the lock, since in the child of a fork() the lock may still be held by a thread which only exists in the parent.
+static pid_t log_sinks_pid;
+#endif
+
+// Read without taking the lock by loader_log, just like the global debug level
+static uint32_t log_sink_filters;
+
+static FILE *log_sink_open(const char *destination, bool *owns_file) {
+    *owns_file = false;
+    if (0 == strcmp(destination, "stdout")) {
+        return stdout;
+    }
+    if (0 == strcmp(destination, "stderr")) {
+        return stderr;
+    }
+    *owns_file = true;
+#if COMMON_UNIX_PLATFORMS
+    // Go through open() so the file isn't inherited by child processes
+    int flags = O_WRONLY | O_APPEND | O_CREAT;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+    int fd = open(destination, flags, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    FILE *file = fdopen(fd, "a");
+    if (NULL == file) {
+        close(fd);
+    }
+    return file;
+#else
+    return loader_fopen(destination, "a");
+#endif
+}
+
+static void log_sink_write_slot(const struct loader_log_sink *sinks, uint32_t sink_count, const struct loader_log_sink_slot *slot) {
+    for (uint32_t i = 0; i < sink_count; i++) {
+        if (0 != (slot->sink_mask & (1U << i)) && NULL != sinks[i].file) {
+            // Written with fputs like the output of loader_log
+            // NOLINTNEXTLINE(cert-err33-c) - this is the logger itself; no sane recovery from a failed write
+            fputs(slot->text, sinks[i].file);
+        }
+    }
+}
+
+static void log_sink_flush_files(const struct loader_log_sink *sinks, uint32_t sink_count, uint32_t sink_mask) {
+    for (uint32_t i = 0; i < sink_count; i++) {
+        if (0 != (sink_mask & (1U << i)) && NULL != sinks[i].file) {
+            // NOLINTNEXTLINE(cert-err33-c) - this is the logger itself; no sane recovery from a failed flush
+            fflush(sinks[i].file);
+        }
+    }
+}
+
+static LOADER_PLATFORM_THREAD_ENTRY(log_sink_writer_main, arg) {
+    (void)arg;
+    loader_platform_thread_lock_mutex(&log_sinks.lock);
+    for (;;) {
+        while (log_sinks.head == log_sinks.tail && !log_sinks.writer_exit_requested) {
+            loader_platform_thread_cond_wait(&log_sinks.messages_queued, &log_sinks.lock);
+        }
+        if (log_sinks.head == log_sinks.tail) {
+            break;
+        }
+        uint32_t end = log_sinks.head;
+        uint32_t sink_count = log_sinks.sink_count;
+        loader_platform_thread_unlock_mutex(&log_sinks.lock);
+
+        // The sinks are only replaced once everything queued has been written, so they can be used without the lock
+        uint32_t written_mask = 0;
+        for (uint32_t index = log_sinks.tail; index != end; index++) {
+            log_sink_write_slot(log_sinks.sinks, sink_count, &log_sinks.slots[index % LOADER_LOG_SINK_RING_SIZE]);
+            written_mask |= log_sinks.slots[index % LOADER_LOG_SINK_RING_SIZE].sink_mask;
+        }
+        log_sink_flush_files(log_sinks.sinks, sink_count, written_mask);
+
+        loader_platform_thread_lock_mutex(&log_sinks.lock);
+        log_sinks.tail = end;
+        loader_platform_thread_cond_broadcast(&log_sinks.messages_written);
+    }
+    log_sinks.writer_running = false;
+    loader_platform_thread_cond_broadcast(&log_sinks.messages_written);
+    loader_platform_thread_unlock_mutex(&log_sinks.lock);
+    LOADER_PLATFORM_THREAD_RETURN;
+}
+
+// Must be called before taking the lock. The child of a fork() only has the thread which called it, so in there the lock and the
+// condition variables are created anew, the writer thread is forgotten about and anything that was still queued is left to the
+// parent's writer. Messages are then written directly until a new writer is started.
+static void log_sinks_forget_writer_after_fork(void) {
+#if COMMON_UNIX_PLATFORMS
+    pid_t pid = getpid();
+    for (;;) {
+        pid_t owner = __atomic_load_n(&log_sinks_pid, __ATOMIC_ACQUIRE);
+        if (owner == pid) {
+            return;
+        }
+        if (owner == -pid) {
+            // Another thread of this process is re-creating the lock
+            sched_yield();
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&log_sinks_pid, &owner, -pid, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+    }
+    // The old lock and condition variables are abandoned rather than deleted, they may be in use by threads of the parent
+    loader_platform_thread_create_mutex(&log_sinks.lock);
+    loader_platform_thread_create_cond(&log_sinks.messages_queued);
+    loader_platform_thread_create_cond(&log_sinks.messages_written);
+    log_sinks.writer_running = false;
+    log_sinks.writer_exit_requested = false;
+    log_sinks.head = 0;
+    log_sinks.tail = 0;
+    __atomic_store_n(&log_sinks_pid, pid, __ATOMIC_RELEASE);
+#endif
+}
+
+// Must be called with the lock held. Waits until the writer thread wrote out every queued message.
+static void log_sinks_wait_until_written(void) {
+    while (log_sinks.writer_running && log_sinks.head != log_sinks.tail) {
+        loader_platform_thread_cond_wait(&log_sinks.messages_written, &log_sinks.lock);
+    }
+}
+
+// Must be called with the lock held
+static void log_sinks_start_writer(void) {
+    if (log_sinks.writer_running) {
+        return;
+    }
+    if (NULL == log_sinks.slots) {
+        log_sinks.slots = loader_calloc(NULL, sizeof(struct loader_log_sink_slot) * LOADER_LOG_SINK_RING_SIZE,
+                                        VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == log_sinks.slots) {
+            return;
+        }
+    }
+    log_sinks.head = 0;
+    log_sinks.tail = 0;
+    log_sinks.writer_exit_requested = false;
+    log_sinks.writer_running = loader_platform_thread_create(&log_sinks.writer, log_sink_writer_main, NULL);
+}
+
+// Must be called with the lock held
+static void log_sinks_close_all(void) {
+    log_sinks_wait_until_written();
+    for (uint32_t i = 0; i < log_sinks.sink_count; i++) {
+        if (log_sinks.sinks[i].owns_file && NULL != log_sinks.sinks[i].file) {
+            // NOLINTNEXTLINE(cert-err33-c) - nothing can be done about a failure to close a log file
+            fclose(log_sinks.sinks[i].file);
+        } else if (NULL != log_sinks.sinks[i].file) {
+            // NOLINTNEXTLINE(cert-err33-c) - this is the logger itself; no sane recovery from a failed flush
+            fflush(log_sinks.sinks[i].file);
+        }
+        loader_free(NULL, log_sinks.sinks[i].destination);
+    }
+    memset(log_sinks.sinks, 0, sizeof(log_sinks.sinks));
+    log_sinks.sink_count = 0;
+    log_sinks.filters = 0;
+    log_sink_filters = 0;
+}
+
+void init_global_log_sinks(void) {
+    loader_platform_thread_create_mutex(&log_sinks.lock);
+    loader_platform_thread_create_cond(&log_sinks.messages_queued);
+    loader_platform_thread_create_cond(&log_sinks.messages_written);
+#if COMMON_UNIX_PLATFORMS
+    __atomic_store_n(&log_sinks_pid, getpid(), __ATOMIC_RELEASE);
+#endif
+}
+
+void teardown_global_log_sinks(void) {
+    log_sinks_forget_writer_after_fork();
+    loader_platform_thread_lock_mutex(&log_sinks.lock);
+    log_sinks_close_all();
+    bool writer_running = log_sinks.writer_running;
+    if (writer_running) {
+        log_sinks.writer_exit_requested = true;
+        loader_platform_thread_cond_broadcast(&log_sinks.messages_queued);
+        while (log_sinks.writer_running) {
+            loader_platform_thread_cond_wait(&log_sinks.messages_written, &log_sinks.lock);
+        }
+    }
+    loader_platform_thread_unlock_mutex(&log_sinks.lock);
+
+    if (writer_running) {
+#if defined(_WIN32)
+        // This runs from DllMain, where waiting on a thread to exit deadlocks on the OS loader lock. The writer already said that
+        // it is done, so only the handle needs to be released.
+        loader_platform_thread_detach(log_sinks.writer);
+#else
+        loader_platform_thread_join(log_sinks.writer);
+#endif
+    }
+    loader_free(NULL, log_sinks.slots);
+    log_sinks.slots = NULL;
+    loader_platform_thread_delete_cond(&log_sinks.messages_written);
+    loader_platform_thread_delete_cond(&log_sinks.messages_queued);
+    loader_platform_thread_delete_mutex(&log_sinks.lock);
+}
+
+void loader_configure_log_sinks(uint32_t log_location_count, const loader_settings_log_location *log_locations) {
+    if (log_location_count > LOADER_MAX_LOG_SINKS) {
+        log_location_count = LOADER_MAX_LOG_SINKS;
+    }
+    // Remember which destinations couldn't be opened, and only report them once the lock was released
+    uint32_t failed_mask = 0;
+
+    bool has_asynchronous_sink = false;
+
+    log_sinks_forget_writer_after_fork();
+    loader_platform_thread_lock_mutex(&log_sinks.lock);
+    bool unchanged = log_location_count == log_sinks.sink_count;
+    for (uint32_t i = 0; unchanged && i < log_location_count; i++) {
+        unchanged = log_locations[i].filters == log_sinks.sinks[i].filters &&
+                    0 == strcmp(log_locations[i].destination, log_sinks.sinks[i].destination);
+    }
+    if (unchanged) {
+        loader_platform_thread_unlock_mutex(&log_sinks.lock);
+        return;
+    }
+
+    log_sinks_close_all();
+    for (uint32_t i = 0; i < log_location_count; i++) {
+        struct loader_log_sink *sink = &log_sinks.sinks[log_sinks.sink_count];
+        size_t destination_size = strlen(log_locations[i].destination) + 1;
+        sink->destination = loader_calloc(NULL, destination_size, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == sink->destination) {
+            break;
+        }
+        loader_strncpy(sink->destination, destination_size, log_locations[i].destination, destination_size);
+        sink->filters = log_locations[i].filters;
+        // Keep sinks which failed to open so that the comparison above stays valid, they just never receive anything
+        sink->file = log_sink_open(sink->destination, &sink->owns_file);
+        sink->synchronous = !sink->owns_file;
+        if (NULL == sink->file) {
+            failed_mask |= 1U << i;
+        } else {
+            log_sinks.filters |= sink->filters;
+            has_asynchronous_sink |= !sink->synchronous && 0 != sink->filters;
+        }
+        log_sinks.sink_count++;
+    }
+    if (has_asynchronous_sink) {
+        log_sinks_start_writer();
+    }
+    log_sink_filters = log_sinks.filters;
+    loader_platform_thread_unlock_mutex(&log_sinks.lock);
+
+    for (uint32_t i = 0; i < log_location_count; i++) {
+        if (0 != (failed_mask & (1U << i))) {
+            loader_log(NULL, VULKAN_LOADER_WARN_BIT, 0, "Unable to open log location \"%s\" from the loader settings file",
+                       log_locations[i].destination);
+        }
+    }
+}
+
+uint32_t loader_get_log_sink_filters(void) { return log_sink_filters; }
+
+void loader_write_to_log_sinks(VkFlags msg_type, const char *header, const char *message) {
+    // The message is put together in direct_slot, written from there to the synchronous sinks and copied into the ring for the
+    // others. Without a writer thread, it is written to every sink right away.
+    struct loader_log_sink_slot direct_slot;
+    struct loader_log_sink_slot *slot = NULL;
+    size_t header_length = 0;
+    size_t message_length = 0;
+    uint32_t direct_mask = 0;
+    uint32_t queued_mask = 0;
+    // stdout and stderr are never closed, so the synchronous sinks are written after releasing the lock and a slow terminal
+    // doesn't hold up the threads logging to the other sinks
+    FILE *synchronous_files[LOADER_MAX_LOG_SINKS];
+    uint32_t synchronous_file_count = 0;
+
+    log_sinks_forget_writer_after_fork();
+    loader_platform_thread_lock_mutex(&log_sinks.lock);
+    for (uint32_t i = 0; i < log_sinks.sink_count; i++) {
+        if (0 != (msg_type & log_sinks.sinks[i].filters)) {
+            if (log_sinks.sinks[i].synchronous) {
+                if (NULL != log_sinks.sinks[i].file) {
+                    synchronous_files[synchronous_file_count++] = log_sinks.sinks[i].file;
+                }
+            } else if (!log_sinks.writer_running) {
+                direct_mask |= 1U << i;
+            } else {
+                queued_mask |= 1U << i;
+            }
+        }
+    }
+    if (0 == synchronous_file_count && 0 == direct_mask && 0 == queued_mask) {
+        goto out;
+    }
+
+    header_length = strlen(header);
+    message_length = strlen(message);
+    if (header_length > LOADER_LOG_SINK_SLOT_SIZE - 2) {
+        header_length = LOADER_LOG_SINK_SLOT_SIZE - 2;
+    }
+    if (message_length > LOADER_LOG_SINK_SLOT_SIZE - 2 - header_length) {
+        message_length = LOADER_LOG_SINK_SLOT_SIZE - 2 - header_length;
+    }
+    memcpy(direct_slot.text, header, header_length);
+    memcpy(direct_slot.text + header_length, message, message_length);
+    direct_slot.text[header_length + message_length] = '\n';
+    direct_slot.text[header_length + message_length + 1] = '\0';
+    direct_slot.length = (uint32_t)(header_length + message_length + 1);
+
+    if (0 != direct_mask) {
+        direct_slot.sink_mask = direct_mask;
+        log_sink_write_slot(log_sinks.sinks, log_sinks.sink_count, &direct_slot);
+        log_sink_flush_files(log_sinks.sinks, log_sinks.sink_count, direct_mask);
+    }
+    if (0 != queued_mask) {
+        while (log_sinks.writer_running && log_sinks.head - log_sinks.tail >= LOADER_LOG_SINK_RING_SIZE) {
+            loader_platform_thread_cond_wait(&log_sinks.messages_written, &log_sinks.lock);
+        }
+        direct_slot.sink_mask = queued_mask;
+        if (log_sinks.writer_running) {
+            slot = &log_sinks.slots[log_sinks.head % LOADER_LOG_SINK_RING_SIZE];
+            slot->sink_mask = queued_mask;
+            slot->length = direct_slot.length;
+            memcpy(slot->text, direct_slot.text, direct_slot.length + 1);
+            log_sinks.head++;
+            loader_platform_thread_cond_broadcast(&log_sinks.messages_queued);
+        } else {
+            // The writer thread went away while waiting for room in the ring
+            log_sink_write_slot(log_sinks.sinks, log_sinks.sink_count, &direct_slot);
+            log_sink_flush_files(log_sinks.sinks, log_sinks.sink_count, queued_mask);
+        }
+    }
+out:
+    loader_platform_thread_unlock_mutex(&log_sinks.lock);
+
+    for (uint32_t i = 0; i < synchronous_file_count; i++) {
+        // NOLINTBEGIN(cert-err33-c) - this is the logger itself; no sane recovery from a failed write
+        fputs(direct_slot.text, synchronous_files[i]);
+        fflush(synchronous_files[i]);
+        // NOLINTEND(cert-err33-c)
+    }
+}
+
+void loader_flush_log_sinks(void) {
+    log_sinks_forget_writer_after_fork();
+    loader_platform_thread_lock_mutex(&log_sinks.lock);
+    log_sinks_wait_until_written();
+    loader_platform_thread_unlock_mutex(&log_sinks.lock);
+}
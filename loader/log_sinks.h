@@ -0,0 +1,59 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "settings.h"
+
+// Process wide log sinks for the "log_locations" of the global loader settings file.
+//
+// Each destination is a file path opened for appending, or "stdout" / "stderr". Messages matching the filters of a file are
+// copied into a bounded ring of fixed size slots and written out by a background writer thread, so that threads which log while
+// holding loader_lock don't wait on file I/O. The ring is only full when the writer can't keep up, in which case loggers wait for
+// a free slot instead of dropping messages. "stdout" and "stderr" are written synchronously by the thread that logs, like the
+// output requested through "stderr_log" or VK_LOADER_DEBUG, so that they stay in order with the application's own output.
+//
+// The child of a fork() doesn't inherit the writer thread. It writes every message directly instead, and leaves what was still
+// queued at the time of the fork to the parent.
+
+// Upper bound on the number of destinations used at the same time, any further ones are ignored
+#define LOADER_MAX_LOG_SINKS 16
+
+// Number of messages that may be queued before loggers wait for the writer thread
+#define LOADER_LOG_SINK_RING_SIZE 256
+
+// Needs to be called during startup and shutdown, like init_global_loader_settings and teardown_global_loader_settings
+void init_global_log_sinks(void);
+void teardown_global_log_sinks(void);
+
+// Replaces the active sinks with log_locations, waiting for queued messages to be written to the old ones first. Does nothing if
+// the destinations and filters are the same as the active ones.
+void loader_configure_log_sinks(uint32_t log_location_count, const loader_settings_log_location* log_locations);
+
+// Union of the filters of the active sinks, so that loader_log can tell if anybody will receive a message before formatting it
+uint32_t loader_get_log_sink_filters(void);
+
+// Queues a message for every sink whose filters match msg_type
+void loader_write_to_log_sinks(VkFlags msg_type, const char* header, const char* message);
+
+// Waits until every queued message has been written out and flushed
+TEST_FUNCTION_EXPORT void loader_flush_log_sinks(void);
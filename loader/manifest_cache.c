@@ -0,0 +1,1585 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "manifest_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if COMMON_UNIX_PLATFORMS
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include "allocation.h"
+#include "loader.h"
+#include "loader_environment.h"
+#include "log.h"
+#include "vk_loader_platform.h"
+
+#if COMMON_UNIX_PLATFORMS
+
+// Bump whenever the layout of the file or of any serialized payload changes
+#define MANIFEST_CACHE_FORMAT_VERSION 1
+#define MANIFEST_CACHE_MAGIC "VKLDRMC"  // 7 characters + null terminator = 8 bytes
+#define MANIFEST_CACHE_NULL_STRING UINT32_MAX
+#define MANIFEST_CACHE_DIRECTORY_NAME "vulkan"
+#if UINTPTR_MAX == UINT32_MAX
+#define MANIFEST_CACHE_FILE_NAME "loader_manifest_cache_32.bin"
+#else
+#define MANIFEST_CACHE_FILE_NAME "loader_manifest_cache_64.bin"
+#endif
+
+enum loader_manifest_cache_entry_kind {
+    LOADER_MANIFEST_CACHE_ENTRY_DIRECTORY = 1,
+    LOADER_MANIFEST_CACHE_ENTRY_DRIVER = 2,
+    LOADER_MANIFEST_CACHE_ENTRY_IMPLICIT_LAYER = 3,
+    LOADER_MANIFEST_CACHE_ENTRY_EXPLICIT_LAYER = 4,
+};
+
+struct loader_manifest_cache_entry {
+    uint32_t kind;
+    uint32_t path_hash;
+    char *path;
+    struct loader_manifest_cache_stamp stamp;
+    uint32_t data_size;
+    uint8_t *data;  // Serialized payload, format depends on kind
+};
+
+struct loader_manifest_cache {
+    bool loaded;
+    bool dirty;
+    char *file_path;  // NULL if no cache location could be determined
+    uint32_t count;
+    uint32_t capacity;  // In number of entries
+    struct loader_manifest_cache_entry *entries;
+};
+
+// All access to global_manifest_cache must be done while holding this lock. Everything inside of global_manifest_cache is
+// allocated with the system allocator since it outlives any instance.
+static loader_platform_thread_mutex loader_manifest_cache_lock;
+static struct loader_manifest_cache global_manifest_cache;
+
+// Growable byte buffer used to serialize entries and the file itself
+struct manifest_cache_writer {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+};
+
+struct manifest_cache_reader {
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+    bool failed;
+};
+
+static void writer_put(struct manifest_cache_writer *writer, const void *src, size_t len) {
+    if (writer->failed || len == 0) {
+        return;
+    }
+    if (writer->size + len > writer->capacity) {
+        size_t new_capacity = writer->capacity > 0 ? writer->capacity : 256;
+        while (new_capacity < writer->size + len) {
+            new_capacity *= 2;
+        }
+        uint8_t *new_data = loader_realloc(NULL, writer->data, writer->capacity, new_capacity, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == new_data) {
+            writer->failed = true;
+            return;
+        }
+        writer->data = new_data;
+        writer->capacity = new_capacity;
+    }
+    memcpy(writer->data + writer->size, src, len);
+    writer->size += len;
+}
+
+static void writer_put_u32(struct manifest_cache_writer *writer, uint32_t value) { writer_put(writer, &value, sizeof(value)); }
+
+static void writer_put_string(struct manifest_cache_writer *writer, const char *str) {
+    if (NULL == str) {
+        writer_put_u32(writer, MANIFEST_CACHE_NULL_STRING);
+        return;
+    }
+    size_t len = strlen(str);
+    writer_put_u32(writer, (uint32_t)len);
+    writer_put(writer, str, len);
+}
+
+static void writer_put_string_list(struct manifest_cache_writer *writer, const struct loader_string_list *string_list) {
+    writer_put_u32(writer, string_list->count);
+    for (uint32_t i = 0; i < string_list->count; i++) {
+        writer_put_string(writer, string_list->list[i]);
+    }
+}
+
+static bool reader_get(struct manifest_cache_reader *reader, void *dst, size_t len) {
+    if (reader->failed || len > reader->size - reader->offset) {
+        reader->failed = true;
+        return false;
+    }
+    memcpy(dst, reader->data + reader->offset, len);
+    reader->offset += len;
+    return true;
+}
+
+static uint32_t reader_get_u32(struct manifest_cache_reader *reader) {
+    uint32_t value = 0;
+    reader_get(reader, &value, sizeof(value));
+    return value;
+}
+
+// Reads a string that was written with writer_put_string, allocating it with the instance allocator.
+// out_str is NULL if a NULL string was written.
+static VkResult reader_get_string(const struct loader_instance *inst, struct manifest_cache_reader *reader, char **out_str) {
+    *out_str = NULL;
+    uint32_t len = reader_get_u32(reader);
+    if (reader->failed) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (len == MANIFEST_CACHE_NULL_STRING) {
+        return VK_SUCCESS;
+    }
+    if (len > reader->size - reader->offset) {
+        reader->failed = true;
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    char *str = loader_instance_heap_alloc(inst, (size_t)len + 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (NULL == str) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    memcpy(str, reader->data + reader->offset, len);
+    str[len] = '\0';
+    reader->offset += len;
+    *out_str = str;
+    return VK_SUCCESS;
+}
+
+// Reads a string list that was written with writer_put_string_list. On failure the caller is responsible for freeing
+// string_list.
+static VkResult reader_get_string_list(const struct loader_instance *inst, struct manifest_cache_reader *reader,
+                                       struct loader_string_list *string_list) {
+    uint32_t count = reader_get_u32(reader);
+    // Each string takes at least 4 bytes, so this rejects absurd counts before allocating anything
+    if (reader->failed || count > (reader->size - reader->offset) / sizeof(uint32_t)) {
+        reader->failed = true;
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (count == 0) {
+        return VK_SUCCESS;
+    }
+    VkResult res = create_string_list(inst, count, string_list);
+    if (VK_SUCCESS != res) {
+        return res;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        char *str = NULL;
+        res = reader_get_string(inst, reader, &str);
+        if (VK_SUCCESS != res) {
+            return res;
+        }
+        if (NULL == str) {
+            reader->failed = true;
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        res = append_str_to_string_list(inst, string_list, str);
+        if (VK_SUCCESS != res) {
+            return res;
+        }
+    }
+    return VK_SUCCESS;
+}
+
+// Stamps are written field by field, valid is implied by the entry being there at all
+static void writer_put_stamp(struct manifest_cache_writer *writer, const struct loader_manifest_cache_stamp *stamp) {
+    const uint64_t fields[] = {stamp->device, stamp->inode, stamp->size, stamp->mtime_sec, stamp->mtime_nsec};
+    writer_put(writer, fields, sizeof(fields));
+}
+
+static bool reader_get_stamp(struct manifest_cache_reader *reader, struct loader_manifest_cache_stamp *stamp) {
+    uint64_t fields[5] = {0};
+    if (!reader_get(reader, fields, sizeof(fields))) {
+        return false;
+    }
+    stamp->valid = true;
+    stamp->device = fields[0];
+    stamp->inode = fields[1];
+    stamp->size = fields[2];
+    stamp->mtime_sec = fields[3];
+    stamp->mtime_nsec = fields[4];
+    return true;
+}
+
+static bool manifest_cache_get_stamp(const char *path, struct loader_manifest_cache_stamp *stamp) {
+    struct stat stats = {0};
+    memset(stamp, 0, sizeof(struct loader_manifest_cache_stamp));
+    if (0 != stat(path, &stats)) {
+        return false;
+    }
+    stamp->valid = true;
+    stamp->device = (uint64_t)stats.st_dev;
+    stamp->inode = (uint64_t)stats.st_ino;
+    stamp->size = (uint64_t)stats.st_size;
+    stamp->mtime_sec = (uint64_t)stats.st_mtime;
+#if defined(__linux__)
+    stamp->mtime_nsec = (uint64_t)stats.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    stamp->mtime_nsec = (uint64_t)stats.st_mtimespec.tv_nsec;
+#else
+    stamp->mtime_nsec = 0;
+#endif
+    return true;
+}
+
+static bool manifest_cache_stamps_equal(const struct loader_manifest_cache_stamp *a, const struct loader_manifest_cache_stamp *b) {
+    return a->valid && b->valid && a->device == b->device && a->inode == b->inode && a->size == b->size &&
+           a->mtime_sec == b->mtime_sec && a->mtime_nsec == b->mtime_nsec;
+}
+
+static void manifest_cache_free_entry(struct loader_manifest_cache_entry *entry) {
+    loader_free(NULL, entry->path);
+    loader_free(NULL, entry->data);
+    memset(entry, 0, sizeof(struct loader_manifest_cache_entry));
+}
+
+static void manifest_cache_clear(struct loader_manifest_cache *cache) {
+    for (uint32_t i = 0; i < cache->count; i++) {
+        manifest_cache_free_entry(&cache->entries[i]);
+    }
+    loader_free(NULL, cache->entries);
+    loader_free(NULL, cache->file_path);
+    memset(cache, 0, sizeof(struct loader_manifest_cache));
+}
+
+static struct loader_manifest_cache_entry *manifest_cache_find(struct loader_manifest_cache *cache, uint32_t kind,
+                                                               const char *path) {
+    uint32_t path_hash = loader_hash_string(path);
+    for (uint32_t i = 0; i < cache->count; i++) {
+        struct loader_manifest_cache_entry *entry = &cache->entries[i];
+        if (entry->kind == kind && entry->path_hash == path_hash && 0 == strcmp(entry->path, path)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Adds a new entry without checking whether there already is one for path. Takes ownership of path and data, which must have
+// been allocated with the system allocator.
+static void manifest_cache_append(struct loader_manifest_cache *cache, uint32_t kind, char *path,
+                                  const struct loader_manifest_cache_stamp *stamp, uint8_t *data, uint32_t data_size) {
+    if (cache->count == cache->capacity) {
+        uint32_t new_capacity = cache->capacity > 0 ? cache->capacity * 2 : 64;
+        void *new_entries = loader_realloc(NULL, cache->entries, sizeof(struct loader_manifest_cache_entry) * cache->capacity,
+                                           sizeof(struct loader_manifest_cache_entry) * new_capacity,
+                                           VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == new_entries) {
+            loader_free(NULL, path);
+            loader_free(NULL, data);
+            return;
+        }
+        cache->entries = new_entries;
+        cache->capacity = new_capacity;
+    }
+    struct loader_manifest_cache_entry *entry = &cache->entries[cache->count++];
+    entry->kind = kind;
+    entry->path_hash = loader_hash_string(path);
+    entry->path = path;
+    entry->stamp = *stamp;
+    entry->data = data;
+    entry->data_size = data_size;
+    cache->dirty = true;
+}
+
+// Adds or replaces the entry for path. Takes ownership of data, which must have been allocated with the system allocator.
+static void manifest_cache_insert(struct loader_manifest_cache *cache, uint32_t kind, const char *path,
+                                  const struct loader_manifest_cache_stamp *stamp, uint8_t *data, uint32_t data_size) {
+    struct loader_manifest_cache_entry *entry = manifest_cache_find(cache, kind, path);
+    if (NULL != entry) {
+        loader_free(NULL, entry->data);
+        entry->stamp = *stamp;
+        entry->data = data;
+        entry->data_size = data_size;
+        cache->dirty = true;
+        return;
+    }
+    size_t path_len = strlen(path);
+    char *path_copy = loader_alloc(NULL, path_len + 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (NULL == path_copy) {
+        loader_free(NULL, data);
+        return;
+    }
+    memcpy(path_copy, path, path_len + 1);
+    manifest_cache_append(cache, kind, path_copy, stamp, data, data_size);
+}
+
+// Builds the path of the cache file. Returns NULL if neither XDG_CACHE_HOME nor HOME are usable.
+static char *manifest_cache_get_file_path(const struct loader_instance *inst) {
+    char *file_path = NULL;
+    const char *suffix = "";
+    char *base = loader_secure_getenv("XDG_CACHE_HOME", inst);
+    if (NULL == base || '\0' == base[0]) {
+        loader_free_getenv(base, inst);
+        base = loader_secure_getenv("HOME", inst);
+        suffix = "/.cache";
+    }
+    if (NULL == base || '\0' == base[0]) {
+        goto out;
+    }
+
+    size_t path_len = strlen(base) + strlen(suffix) + strlen(MANIFEST_CACHE_DIRECTORY_NAME) + strlen(MANIFEST_CACHE_FILE_NAME) + 3;
+    file_path = loader_alloc(NULL, path_len, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (NULL == file_path) {
+        goto out;
+    }
+    snprintf(file_path, path_len, "%s%s/%s/%s", base, suffix, MANIFEST_CACHE_DIRECTORY_NAME, MANIFEST_CACHE_FILE_NAME);
+
+out:
+    loader_free_getenv(base, inst);
+    return file_path;
+}
+
+// Parse the file contents into cache. Any malformed content causes the whole file to be ignored.
+static void manifest_cache_deserialize(struct loader_manifest_cache *cache, const uint8_t *data, size_t size) {
+    struct manifest_cache_reader reader = {data, size, 0, false};
+    char magic[sizeof(MANIFEST_CACHE_MAGIC)] = {0};
+    reader_get(&reader, magic, sizeof(magic));
+    uint32_t format_version = reader_get_u32(&reader);
+    uint32_t pointer_size = reader_get_u32(&reader);
+    uint32_t entry_count = reader_get_u32(&reader);
+    if (reader.failed || 0 != memcmp(magic, MANIFEST_CACHE_MAGIC, sizeof(magic)) ||
+        format_version != MANIFEST_CACHE_FORMAT_VERSION || pointer_size != sizeof(void *)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint32_t kind = reader_get_u32(&reader);
+        uint32_t path_len = reader_get_u32(&reader);
+        if (reader.failed || path_len == MANIFEST_CACHE_NULL_STRING || path_len > reader.size - reader.offset) {
+            break;
+        }
+        char *path = loader_alloc(NULL, (size_t)path_len + 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == path) {
+            break;
+        }
+        reader_get(&reader, path, path_len);
+        path[path_len] = '\0';
+
+        struct loader_manifest_cache_stamp stamp = {0};
+        reader_get_stamp(&reader, &stamp);
+        uint32_t data_size = reader_get_u32(&reader);
+        uint8_t *entry_data = NULL;
+        if (!reader.failed && data_size <= reader.size - reader.offset) {
+            entry_data = loader_alloc(NULL, data_size > 0 ? data_size : 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        }
+        if (NULL == entry_data || !reader_get(&reader, entry_data, data_size)) {
+            loader_free(NULL, entry_data);
+            loader_free(NULL, path);
+            break;
+        }
+        // The file was written from a cache which had one entry per path, so there is no need to look for an existing one
+        manifest_cache_append(cache, kind, path, &stamp, entry_data, data_size);
+    }
+    // Entries that were just read from disk don't need to be written back
+    cache->dirty = false;
+}
+
+// Loads the cache file the first time the cache is used in this process. Must be called with loader_manifest_cache_lock held.
+static void manifest_cache_ensure_loaded(const struct loader_instance *inst) {
+    struct loader_manifest_cache *cache = &global_manifest_cache;
+    if (cache->loaded) {
+        return;
+    }
+    cache->loaded = true;
+    cache->file_path = manifest_cache_get_file_path(inst);
+    if (NULL == cache->file_path) {
+        return;
+    }
+
+    FILE *file = fopen(cache->file_path, "rb");
+    if (NULL == file) {
+        return;
+    }
+    uint8_t *data = NULL;
+    struct stat stats = {0};
+    // Don't trust a cache file that somebody else could have written
+    if (0 != fstat(fileno(file), &stats) || stats.st_uid != geteuid() || stats.st_size <= 0) {
+        goto out;
+    }
+    data = loader_alloc(NULL, (size_t)stats.st_size, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (NULL == data) {
+        goto out;
+    }
+    if ((size_t)stats.st_size != fread(data, 1, (size_t)stats.st_size, file)) {
+        goto out;
+    }
+    manifest_cache_deserialize(cache, data, (size_t)stats.st_size);
+out:
+    loader_free(NULL, data);
+    fclose(file);
+}
+
+static uint32_t manifest_cache_layer_kind(bool is_implicit) {
+    return is_implicit ? LOADER_MANIFEST_CACHE_ENTRY_IMPLICIT_LAYER : LOADER_MANIFEST_CACHE_ENTRY_EXPLICIT_LAYER;
+}
+
+// Only the fields filled in by loader_read_layer_json are serialized, everything else is runtime state
+static void manifest_cache_write_layer(struct manifest_cache_writer *writer, const struct loader_layer_properties *props) {
+    writer_put(writer, &props->info, sizeof(VkLayerProperties));
+    writer_put_u32(writer, (uint32_t)props->type_flags);
+    writer_put_string(writer, props->manifest_file_name);
+    writer_put_string(writer, props->lib_name);
+    writer_put_string(writer, props->functions.str_gipa);
+    writer_put_string(writer, props->functions.str_gdpa);
+    writer_put_string(writer, props->functions.str_negotiate_interface);
+    writer_put_u32(writer, props->instance_extension_list.count);
+    for (uint32_t i = 0; i < props->instance_extension_list.count; i++) {
+        writer_put(writer, &props->instance_extension_list.list[i], sizeof(VkExtensionProperties));
+    }
+    writer_put_u32(writer, props->device_extension_list.count);
+    for (uint32_t i = 0; i < props->device_extension_list.count; i++) {
+        writer_put(writer, &props->device_extension_list.list[i].props, sizeof(VkExtensionProperties));
+        writer_put_string_list(writer, &props->device_extension_list.list[i].entrypoints);
+    }
+    writer_put_string(writer, props->disable_env_var.name);
+    writer_put_string(writer, props->disable_env_var.value);
+    writer_put_string(writer, props->enable_env_var.name);
+    writer_put_string(writer, props->enable_env_var.value);
+    writer_put_string_list(writer, &props->component_layer_names);
+    writer_put_string(writer, props->pre_instance_functions.enumerate_instance_extension_properties);
+    writer_put_string(writer, props->pre_instance_functions.enumerate_instance_layer_properties);
+    writer_put_string(writer, props->pre_instance_functions.enumerate_instance_version);
+    writer_put_string_list(writer, &props->override_paths);
+    writer_put_u32(writer, props->is_override ? 1 : 0);
+    writer_put_string_list(writer, &props->blacklist_layer_names);
+    writer_put_string_list(writer, &props->app_key_paths);
+}
+
+static VkResult manifest_cache_read_layer(const struct loader_instance *inst, struct manifest_cache_reader *reader,
+                                          struct loader_layer_properties *props) {
+    VkResult res = VK_SUCCESS;
+    if (!reader_get(reader, &props->info, sizeof(VkLayerProperties))) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    props->type_flags = (enum layer_type_flags)reader_get_u32(reader);
+    res = reader_get_string(inst, reader, &props->manifest_file_name);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->lib_name);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->functions.str_gipa);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->functions.str_gdpa);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->functions.str_negotiate_interface);
+    if (VK_SUCCESS != res) return res;
+
+    uint32_t instance_extension_count = reader_get_u32(reader);
+    for (uint32_t i = 0; i < instance_extension_count && !reader->failed; i++) {
+        VkExtensionProperties ext_prop = {0};
+        if (!reader_get(reader, &ext_prop, sizeof(VkExtensionProperties))) {
+            break;
+        }
+        res = loader_add_to_ext_list(inst, &props->instance_extension_list, 1, &ext_prop);
+        if (VK_SUCCESS != res) return res;
+    }
+    uint32_t device_extension_count = reader_get_u32(reader);
+    for (uint32_t i = 0; i < device_extension_count && !reader->failed; i++) {
+        VkExtensionProperties ext_prop = {0};
+        struct loader_string_list entrys = {0};
+        if (!reader_get(reader, &ext_prop, sizeof(VkExtensionProperties))) {
+            break;
+        }
+        res = reader_get_string_list(inst, reader, &entrys);
+        if (VK_SUCCESS != res) {
+            free_string_list(inst, &entrys);
+            return res;
+        }
+        // loader_add_to_dev_ext_list takes ownership of entrys
+        res = loader_add_to_dev_ext_list(inst, &props->device_extension_list, &ext_prop, NULL != entrys.list ? &entrys : NULL);
+        if (VK_SUCCESS != res) return res;
+    }
+
+    res = reader_get_string(inst, reader, &props->disable_env_var.name);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->disable_env_var.value);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->enable_env_var.name);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->enable_env_var.value);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string_list(inst, reader, &props->component_layer_names);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->pre_instance_functions.enumerate_instance_extension_properties);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->pre_instance_functions.enumerate_instance_layer_properties);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string(inst, reader, &props->pre_instance_functions.enumerate_instance_version);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string_list(inst, reader, &props->override_paths);
+    if (VK_SUCCESS != res) return res;
+    props->is_override = reader_get_u32(reader) != 0;
+    res = reader_get_string_list(inst, reader, &props->blacklist_layer_names);
+    if (VK_SUCCESS != res) return res;
+    res = reader_get_string_list(inst, reader, &props->app_key_paths);
+    if (VK_SUCCESS != res) return res;
+
+    return reader->failed ? VK_ERROR_INITIALIZATION_FAILED : VK_SUCCESS;
+}
+
+static void manifest_cache_write_layer_list(struct manifest_cache_writer *writer, const struct loader_layer_list *layers,
+                                            uint32_t first_layer) {
+    writer_put_u32(writer, layers->count - first_layer);
+    for (uint32_t i = first_layer; i < layers->count; i++) {
+        manifest_cache_write_layer(writer, &layers->list[i]);
+    }
+}
+
+// Appends every layer written by manifest_cache_write_layer_list to layers. If anything goes wrong, the layers which were
+// appended are removed again. Returns VK_INCOMPLETE if the payload is malformed.
+static VkResult manifest_cache_read_layer_list(const struct loader_instance *inst, struct manifest_cache_reader *reader,
+                                               struct loader_layer_list *layers) {
+    VkResult res = VK_SUCCESS;
+    uint32_t first_layer = layers->count;
+    uint32_t count = reader_get_u32(reader);
+    for (uint32_t i = 0; i < count && !reader->failed; i++) {
+        struct loader_layer_properties props = {0};
+        res = manifest_cache_read_layer(inst, reader, &props);
+        if (VK_SUCCESS != res) {
+            loader_free_layer_properties(inst, &props);
+            break;
+        }
+        // loader_append_layer_property frees props on failure
+        res = loader_append_layer_property(inst, layers, &props);
+        if (VK_SUCCESS != res) {
+            break;
+        }
+    }
+    if (VK_ERROR_OUT_OF_HOST_MEMORY != res && reader->failed) {
+        res = VK_INCOMPLETE;
+    }
+    if (VK_SUCCESS != res) {
+        while (layers->count > first_layer) {
+            loader_remove_layer_in_list(inst, layers, layers->count - 1);
+        }
+    }
+    return res;
+}
+
+// Removes every string in [first, string_list->count) from string_list
+static void manifest_cache_truncate_string_list(const struct loader_instance *inst, struct loader_string_list *string_list,
+                                                uint32_t first) {
+    while (string_list->count > first) {
+        string_list->count--;
+        loader_instance_heap_free(inst, string_list->list[string_list->count]);
+        string_list->list[string_list->count] = NULL;
+    }
+}
+
+// Copies the entry's payload if it is still valid for the file or directory at path. The copy is made so that the payload can be
+// decoded without holding loader_manifest_cache_lock. Returns false if there is no valid entry, in which case stamp is what the
+// caller has to hand to manifest_cache_store once it read path itself.
+static bool manifest_cache_lookup(const struct loader_instance *inst, uint32_t kind, const char *path,
+                                  struct loader_manifest_cache_stamp *stamp, struct manifest_cache_reader *reader) {
+    if (!manifest_cache_get_stamp(path, stamp)) {
+        return false;
+    }
+    bool found = false;
+    loader_platform_thread_lock_mutex(&loader_manifest_cache_lock);
+    manifest_cache_ensure_loaded(inst);
+    struct loader_manifest_cache_entry *entry = manifest_cache_find(&global_manifest_cache, kind, path);
+    if (NULL != entry && manifest_cache_stamps_equal(&entry->stamp, stamp)) {
+        uint8_t *data = loader_alloc(NULL, entry->data_size > 0 ? entry->data_size : 1, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+        if (NULL != data) {
+            memcpy(data, entry->data, entry->data_size);
+            reader->data = data;
+            reader->size = entry->data_size;
+            reader->offset = 0;
+            reader->failed = false;
+            found = true;
+        }
+    }
+    loader_platform_thread_unlock_mutex(&loader_manifest_cache_lock);
+    return found;
+}
+
+// Takes ownership of the writer's buffer. stamp must have been taken before path was read, so that a change made while it was
+// being read leaves the entry stale instead of filing the old contents under the new identity.
+static void manifest_cache_store(uint32_t kind, const char *path, const struct loader_manifest_cache_stamp *stamp,
+                                 struct manifest_cache_writer *writer) {
+    if (writer->failed || writer->size > UINT32_MAX || !stamp->valid) {
+        loader_free(NULL, writer->data);
+        return;
+    }
+    loader_platform_thread_lock_mutex(&loader_manifest_cache_lock);
+    // Make sure the on-disk contents are loaded first, otherwise they would be discarded on the next flush
+    manifest_cache_ensure_loaded(NULL);
+    manifest_cache_insert(&global_manifest_cache, kind, path, stamp, writer->data, (uint32_t)writer->size);
+    loader_platform_thread_unlock_mutex(&loader_manifest_cache_lock);
+}
+
+// Scan snapshots
+//
+// A scan snapshot is the outcome of a whole driver or layer scan - the ordered list of manifests that were found and what was
+// parsed out of them. They live for the lifetime of the process and are only reused when the key (environment variables and
+// settings which influence the scan) matches and none of the searched paths or manifest files changed on disk.
+
+#define LOADER_SCAN_SNAPSHOT_MAX_COUNT 8
+
+// The stat() identity of a searched path when the snapshot was made. Paths which did not exist are recorded too, so that creating
+// them later invalidates the snapshot.
+struct loader_scan_snapshot_stamp {
+    char *path;
+    bool exists;
+    struct loader_manifest_cache_stamp stamp;
+};
+
+// Snapshots are immutable once published. They are reference counted so a snapshot can be decoded without holding
+// loader_scan_snapshot_lock while another thread replaces it.
+struct loader_scan_snapshot {
+    uint32_t ref_count;
+    uint8_t *key;
+    size_t key_size;
+    uint32_t stamp_count;
+    struct loader_scan_snapshot_stamp *stamps;
+    uint8_t *data;  // Serialized payload, same format as the corresponding manifest cache entry kind
+    size_t data_size;
+};
+
+struct loader_scan_snapshot_table {
+    struct loader_scan_snapshot *entries[LOADER_SCAN_SNAPSHOT_MAX_COUNT];
+    uint32_t next_eviction;
+};
+
+// Both tables are guarded by loader_scan_snapshot_lock
+static loader_platform_thread_mutex loader_scan_snapshot_lock;
+static struct loader_scan_snapshot_table scan_snapshots;
+static struct loader_scan_snapshot_table pre_instance_results;
+
+// Environment variables which change where manifests are searched for
+static const char *const scan_snapshot_env_vars[] = {
+    VK_DRIVER_FILES_ENV_VAR,
+    VK_ICD_FILENAMES_ENV_VAR,
+    VK_ADDITIONAL_DRIVER_FILES_ENV_VAR,
+    VK_EXPLICIT_LAYER_PATH_ENV_VAR,
+    VK_ADDITIONAL_EXPLICIT_LAYER_PATH_ENV_VAR,
+    VK_IMPLICIT_LAYER_PATH_ENV_VAR,
+    VK_ADDITIONAL_IMPLICIT_LAYER_PATH_ENV_VAR,
+    "XDG_CONFIG_HOME",
+    "XDG_CONFIG_DIRS",
+    "XDG_DATA_HOME",
+    "XDG_DATA_DIRS",
+    "HOME",
+#if defined(__APPLE__)
+    VK_LOADER_SEARCH_ONLY_IN_BUNDLE_ENV_VAR,
+#endif
+};
+
+// The key holds everything besides the contents of the file system which determines the outcome of a scan.
+static void scan_snapshot_build_key(const struct loader_instance *inst, uint32_t kind, const struct loader_string_list *extra_paths,
+                                    uint32_t settings_flags, struct manifest_cache_writer *key) {
+    writer_put_u32(key, kind);
+    for (size_t i = 0; i < sizeof(scan_snapshot_env_vars) / sizeof(scan_snapshot_env_vars[0]); i++) {
+        char *value = loader_secure_getenv(scan_snapshot_env_vars[i], inst);
+        writer_put_string(key, value);
+        loader_free_getenv(value, inst);
+    }
+    if (NULL != extra_paths) {
+        writer_put_string_list(key, extra_paths);
+    } else {
+        writer_put_u32(key, 0);
+    }
+    writer_put_u32(key, settings_flags);
+}
+
+static void scan_snapshot_free(struct loader_scan_snapshot *snapshot) {
+    for (uint32_t i = 0; i < snapshot->stamp_count; i++) {
+        loader_free(NULL, snapshot->stamps[i].path);
+    }
+    loader_free(NULL, snapshot->stamps);
+    loader_free(NULL, snapshot->key);
+    loader_free(NULL, snapshot->data);
+    loader_free(NULL, snapshot);
+}
+
+static void scan_snapshot_release(struct loader_scan_snapshot *snapshot) {
+    loader_platform_thread_lock_mutex(&loader_scan_snapshot_lock);
+    bool should_free = --snapshot->ref_count == 0;
+    loader_platform_thread_unlock_mutex(&loader_scan_snapshot_lock);
+    if (should_free) {
+        scan_snapshot_free(snapshot);
+    }
+}
+
+static bool scan_snapshot_is_current(const struct loader_scan_snapshot *snapshot) {
+    for (uint32_t i = 0; i < snapshot->stamp_count; i++) {
+        struct loader_manifest_cache_stamp stamp = {0};
+        bool exists = manifest_cache_get_stamp(snapshot->stamps[i].path, &stamp);
+        if (exists != snapshot->stamps[i].exists || (exists && !manifest_cache_stamps_equal(&stamp, &snapshot->stamps[i].stamp))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns a referenced snapshot matching key which is still up to date, or NULL if there is none.
+static struct loader_scan_snapshot *scan_snapshot_acquire(struct loader_scan_snapshot_table *table,
+                                                          const struct manifest_cache_writer *key) {
+    struct loader_scan_snapshot *snapshot = NULL;
+    if (key->failed) {
+        return NULL;
+    }
+    loader_platform_thread_lock_mutex(&loader_scan_snapshot_lock);
+    for (uint32_t i = 0; i < LOADER_SCAN_SNAPSHOT_MAX_COUNT; i++) {
+        struct loader_scan_snapshot *candidate = table->entries[i];
+        if (NULL != candidate && candidate->key_size == key->size && 0 == memcmp(candidate->key, key->data, key->size)) {
+            candidate->ref_count++;
+            snapshot = candidate;
+            break;
+        }
+    }
+    loader_platform_thread_unlock_mutex(&loader_scan_snapshot_lock);
+
+    // Checking the stamps requires stat() calls, so do it without holding the lock
+    if (NULL != snapshot && !scan_snapshot_is_current(snapshot)) {
+        scan_snapshot_release(snapshot);
+        snapshot = NULL;
+    }
+    return snapshot;
+}
+
+static bool scan_snapshot_add_stamps(struct loader_scan_snapshot *snapshot, const struct loader_string_list *paths) {
+    for (uint32_t i = 0; i < paths->count; i++) {
+        if (NULL == paths->list[i]) {
+            continue;
+        }
+        size_t path_len = strlen(paths->list[i]);
+        char *path = loader_alloc(NULL, path_len + 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == path) {
+            return false;
+        }
+        memcpy(path, paths->list[i], path_len + 1);
+        struct loader_scan_snapshot_stamp *stamp = &snapshot->stamps[snapshot->stamp_count++];
+        stamp->path = path;
+        stamp->exists = manifest_cache_get_stamp(path, &stamp->stamp);
+    }
+    return true;
+}
+
+// Replaces any snapshot with the same key. Takes ownership of the key and payload buffers.
+static void scan_snapshot_publish(struct loader_scan_snapshot_table *table, struct manifest_cache_writer *key,
+                                  const struct loader_string_list *search_paths, const struct loader_string_list *manifest_files,
+                                  struct manifest_cache_writer *payload) {
+    struct loader_scan_snapshot *snapshot = NULL;
+    if (key->failed || payload->failed) {
+        goto fail;
+    }
+    snapshot = loader_calloc(NULL, sizeof(struct loader_scan_snapshot), VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (NULL == snapshot) {
+        goto fail;
+    }
+    uint32_t stamp_capacity = search_paths->count + manifest_files->count;
+    if (stamp_capacity > 0) {
+        snapshot->stamps = loader_calloc(NULL, sizeof(struct loader_scan_snapshot_stamp) * stamp_capacity,
+                                         VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == snapshot->stamps) {
+            goto fail;
+        }
+    }
+    if (!scan_snapshot_add_stamps(snapshot, search_paths) || !scan_snapshot_add_stamps(snapshot, manifest_files)) {
+        goto fail;
+    }
+    snapshot->key = key->data;
+    snapshot->key_size = key->size;
+    snapshot->data = payload->data;
+    snapshot->data_size = payload->size;
+    key->data = NULL;
+    payload->data = NULL;
+    // This reference belongs to the table
+    snapshot->ref_count = 1;
+
+    loader_platform_thread_lock_mutex(&loader_scan_snapshot_lock);
+    uint32_t slot = LOADER_SCAN_SNAPSHOT_MAX_COUNT;
+    for (uint32_t i = 0; i < LOADER_SCAN_SNAPSHOT_MAX_COUNT && slot == LOADER_SCAN_SNAPSHOT_MAX_COUNT; i++) {
+        struct loader_scan_snapshot *existing = table->entries[i];
+        if (NULL != existing && existing->key_size == snapshot->key_size &&
+            0 == memcmp(existing->key, snapshot->key, snapshot->key_size)) {
+            slot = i;
+        }
+    }
+    for (uint32_t i = 0; i < LOADER_SCAN_SNAPSHOT_MAX_COUNT && slot == LOADER_SCAN_SNAPSHOT_MAX_COUNT; i++) {
+        if (NULL == table->entries[i]) {
+            slot = i;
+        }
+    }
+    if (slot == LOADER_SCAN_SNAPSHOT_MAX_COUNT) {
+        slot = table->next_eviction;
+        table->next_eviction = (table->next_eviction + 1) % LOADER_SCAN_SNAPSHOT_MAX_COUNT;
+    }
+    struct loader_scan_snapshot *old_snapshot = table->entries[slot];
+    table->entries[slot] = snapshot;
+    bool should_free_old = NULL != old_snapshot && --old_snapshot->ref_count == 0;
+    loader_platform_thread_unlock_mutex(&loader_scan_snapshot_lock);
+
+    if (should_free_old) {
+        scan_snapshot_free(old_snapshot);
+    }
+    return;
+
+fail:
+    if (NULL != snapshot) {
+        scan_snapshot_free(snapshot);
+    }
+    loader_free(NULL, key->data);
+    loader_free(NULL, payload->data);
+}
+
+static void scan_snapshot_clear(struct loader_scan_snapshot_table *table) {
+    for (uint32_t i = 0; i < LOADER_SCAN_SNAPSHOT_MAX_COUNT; i++) {
+        if (NULL != table->entries[i] && --table->entries[i]->ref_count == 0) {
+            scan_snapshot_free(table->entries[i]);
+        }
+        table->entries[i] = NULL;
+    }
+    table->next_eviction = 0;
+}
+
+// Pre-instance results
+//
+// These live in pre_instance_results, reusing the scan snapshot machinery. The stamps are every path consulted while the result
+// was computed. The payload starts with the names and values of the environment variables named by implicit layer manifests,
+// since those are only known after the manifests were read and so can't be part of the key.
+
+// The recording of the one pre-instance call currently being computed. Calls on other threads made while it is in progress
+// aren't recorded, they only miss out on being remembered.
+struct loader_pre_instance_recording {
+    bool active;
+    bool failed;  // Something couldn't be recorded, the result must not be remembered
+    bool has_result;
+    uint64_t thread_id;
+    struct loader_string_list paths;
+    struct loader_string_list env_var_names;
+    VkResult result;
+    uint32_t count;
+    size_t element_size;
+    uint8_t *elements;
+};
+
+static loader_platform_thread_mutex loader_pre_instance_recording_lock;
+static struct loader_pre_instance_recording pre_instance_recording;
+
+// Environment variables which change the outcome of every pre-instance call, besides those which change where manifests are found
+static const char *const pre_instance_env_vars[] = {
+    VK_LAYERS_ENABLE_ENV_VAR,  VK_LAYERS_DISABLE_ENV_VAR,  VK_LAYERS_ALLOW_ENV_VAR,
+    VK_DRIVERS_SELECT_ENV_VAR, VK_DRIVERS_DISABLE_ENV_VAR, "VK_LOADER_DISABLE_INST_EXT_FILTER",
+};
+
+static void pre_instance_build_key(enum loader_pre_instance_query query, const char *layer_name,
+                                   struct manifest_cache_writer *key) {
+    scan_snapshot_build_key(NULL, (uint32_t)query, NULL, 0, key);
+    // An empty layer name means the same as no layer name
+    writer_put_string(key, (NULL != layer_name && '\0' != layer_name[0]) ? layer_name : NULL);
+    for (size_t i = 0; i < sizeof(pre_instance_env_vars) / sizeof(pre_instance_env_vars[0]); i++) {
+        char *value = loader_getenv(pre_instance_env_vars[i], NULL);
+        writer_put_string(key, value);
+        loader_free_getenv(value, NULL);
+    }
+}
+
+// Whether the environment variables recorded at the start of a pre-instance result payload still have the same values
+static bool pre_instance_env_vars_unchanged(struct manifest_cache_reader *reader) {
+    bool unchanged = true;
+    uint32_t env_var_count = reader_get_u32(reader);
+    for (uint32_t i = 0; i < env_var_count && unchanged && !reader->failed; i++) {
+        char *name = NULL;
+        char *value = NULL;
+        if (VK_SUCCESS != reader_get_string(NULL, reader, &name) || VK_SUCCESS != reader_get_string(NULL, reader, &value) ||
+            NULL == name) {
+            unchanged = false;
+        } else {
+            char *current_value = loader_getenv(name, NULL);
+            unchanged = NULL == value ? NULL == current_value : NULL != current_value && 0 == strcmp(value, current_value);
+            loader_free_getenv(current_value, NULL);
+        }
+        loader_instance_heap_free(NULL, name);
+        loader_instance_heap_free(NULL, value);
+    }
+    return unchanged && !reader->failed;
+}
+
+// A pre-instance result computed from a reused scan snapshot depends on everything the snapshot depends on
+static void scan_snapshot_watch_stamps(const struct loader_scan_snapshot *snapshot) {
+    for (uint32_t i = 0; i < snapshot->stamp_count; i++) {
+        loader_pre_instance_cache_watch_path(snapshot->stamps[i].path);
+    }
+}
+
+// Must be called with loader_pre_instance_recording_lock held
+static bool pre_instance_recording_is_current_thread(void) {
+    return pre_instance_recording.active && pre_instance_recording.thread_id == loader_platform_get_thread_id();
+}
+
+// Must be called with loader_pre_instance_recording_lock held
+static void pre_instance_recording_add_string(struct loader_string_list *list, const char *str) {
+    char *copy = NULL;
+    if (VK_SUCCESS != loader_copy_to_new_str(NULL, str, &copy) ||
+        VK_SUCCESS != append_str_to_string_list_if_unique(NULL, list, copy)) {
+        pre_instance_recording.failed = true;
+    }
+}
+
+static void pre_instance_recording_free(struct loader_pre_instance_recording *recording) {
+    free_string_list(NULL, &recording->paths);
+    free_string_list(NULL, &recording->env_var_names);
+    loader_free(NULL, recording->elements);
+    memset(recording, 0, sizeof(struct loader_pre_instance_recording));
+}
+
+#endif  // COMMON_UNIX_PLATFORMS
+
+void init_global_manifest_cache(void) {
+#if COMMON_UNIX_PLATFORMS
+    loader_platform_thread_create_mutex(&loader_manifest_cache_lock);
+    loader_platform_thread_create_mutex(&loader_scan_snapshot_lock);
+    loader_platform_thread_create_mutex(&loader_pre_instance_recording_lock);
+    // Clear out the caches in case the process was loaded & unloaded
+    manifest_cache_clear(&global_manifest_cache);
+    scan_snapshot_clear(&scan_snapshots);
+    scan_snapshot_clear(&pre_instance_results);
+    pre_instance_recording_free(&pre_instance_recording);
+#endif
+}
+
+void teardown_global_manifest_cache(void) {
+#if COMMON_UNIX_PLATFORMS
+    manifest_cache_clear(&global_manifest_cache);
+    scan_snapshot_clear(&scan_snapshots);
+    scan_snapshot_clear(&pre_instance_results);
+    pre_instance_recording_free(&pre_instance_recording);
+    loader_platform_thread_delete_mutex(&loader_pre_instance_recording_lock);
+    loader_platform_thread_delete_mutex(&loader_scan_snapshot_lock);
+    loader_platform_thread_delete_mutex(&loader_manifest_cache_lock);
+#endif
+}
+
+bool loader_manifest_cache_enabled(const struct loader_instance *inst) {
+#if COMMON_UNIX_PLATFORMS
+    char *env_value = loader_getenv(VK_LOADER_MANIFEST_CACHE_ENV_VAR, inst);
+    // NOLINTNEXTLINE(bugprone-not-null-terminated-result) - n=2 intentionally excludes "1x" values like "10"
+    bool enabled = NULL != env_value && 0 == strncmp(env_value, "1", 2);
+    loader_free_getenv(env_value, inst);
+    return enabled;
+#else
+    (void)inst;
+    return false;
+#endif
+}
+
+VkResult loader_manifest_cache_get_directory(const struct loader_instance *inst, const char *dir_path,
+                                             struct loader_manifest_cache_stamp *stamp, struct loader_string_list *out_files) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_reader reader = {0};
+    if (!manifest_cache_lookup(inst, LOADER_MANIFEST_CACHE_ENTRY_DIRECTORY, dir_path, stamp, &reader)) {
+        return VK_INCOMPLETE;
+    }
+    VkResult res = VK_SUCCESS;
+    uint32_t first_file = out_files->count;
+    uint32_t count = reader_get_u32(&reader);
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+        char *file_name = NULL;
+        res = reader_get_string(inst, &reader, &file_name);
+        if (VK_SUCCESS != res) {
+            break;
+        }
+        if (NULL == file_name) {
+            reader.failed = true;
+            break;
+        }
+        res = append_str_to_string_list(inst, out_files, file_name);
+        if (VK_SUCCESS != res) {
+            break;
+        }
+    }
+    if (VK_ERROR_OUT_OF_HOST_MEMORY != res && reader.failed) {
+        res = VK_INCOMPLETE;
+    }
+    if (VK_SUCCESS != res) {
+        manifest_cache_truncate_string_list(inst, out_files, first_file);
+    } else {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "Using cached contents of directory %s", dir_path);
+    }
+    loader_free(NULL, (void *)reader.data);
+    return res;
+#else
+    (void)inst;
+    (void)dir_path;
+    (void)out_files;
+    memset(stamp, 0, sizeof(struct loader_manifest_cache_stamp));
+    return VK_INCOMPLETE;
+#endif
+}
+
+void loader_manifest_cache_store_directory(const char *dir_path, const struct loader_manifest_cache_stamp *stamp,
+                                           const struct loader_string_list *files, uint32_t first_file) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer writer = {0};
+    writer_put_u32(&writer, files->count - first_file);
+    for (uint32_t i = first_file; i < files->count; i++) {
+        writer_put_string(&writer, files->list[i]);
+    }
+    manifest_cache_store(LOADER_MANIFEST_CACHE_ENTRY_DIRECTORY, dir_path, stamp, &writer);
+#else
+    (void)dir_path;
+    (void)stamp;
+    (void)files;
+    (void)first_file;
+#endif
+}
+
+VkResult loader_manifest_cache_get_driver(const struct loader_instance *inst, const char *manifest_path,
+                                          struct loader_manifest_cache_stamp *stamp, char **full_library_path, uint32_t *version,
+                                          bool *is_portability_driver) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_reader reader = {0};
+    if (!manifest_cache_lookup(inst, LOADER_MANIFEST_CACHE_ENTRY_DRIVER, manifest_path, stamp, &reader)) {
+        return VK_INCOMPLETE;
+    }
+    char *library_path = NULL;
+    VkResult res = reader_get_string(inst, &reader, &library_path);
+    uint32_t cached_version = reader_get_u32(&reader);
+    uint32_t cached_is_portability_driver = reader_get_u32(&reader);
+    if (VK_SUCCESS == res && (reader.failed || NULL == library_path)) {
+        res = VK_INCOMPLETE;
+    }
+    if (VK_SUCCESS == res) {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "Using cached contents of ICD manifest file %s",
+                   manifest_path);
+        *full_library_path = library_path;
+        *version = cached_version;
+        *is_portability_driver = cached_is_portability_driver != 0;
+    } else {
+        loader_instance_heap_free(inst, library_path);
+    }
+    loader_free(NULL, (void *)reader.data);
+    return res;
+#else
+    (void)inst;
+    (void)manifest_path;
+    (void)full_library_path;
+    (void)version;
+    (void)is_portability_driver;
+    memset(stamp, 0, sizeof(struct loader_manifest_cache_stamp));
+    return VK_INCOMPLETE;
+#endif
+}
+
+void loader_manifest_cache_store_driver(const char *manifest_path, const struct loader_manifest_cache_stamp *stamp,
+                                        const char *full_library_path, uint32_t version, bool is_portability_driver) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer writer = {0};
+    writer_put_string(&writer, full_library_path);
+    writer_put_u32(&writer, version);
+    writer_put_u32(&writer, is_portability_driver ? 1 : 0);
+    manifest_cache_store(LOADER_MANIFEST_CACHE_ENTRY_DRIVER, manifest_path, stamp, &writer);
+#else
+    (void)manifest_path;
+    (void)stamp;
+    (void)full_library_path;
+    (void)version;
+    (void)is_portability_driver;
+#endif
+}
+
+VkResult loader_manifest_cache_get_layers(const struct loader_instance *inst, const char *manifest_path, bool is_implicit,
+                                          struct loader_manifest_cache_stamp *stamp, struct loader_layer_list *layers) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_reader reader = {0};
+    if (!manifest_cache_lookup(inst, manifest_cache_layer_kind(is_implicit), manifest_path, stamp, &reader)) {
+        return VK_INCOMPLETE;
+    }
+    VkResult res = manifest_cache_read_layer_list(inst, &reader, layers);
+    if (VK_SUCCESS == res) {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Using cached contents of layer manifest file %s",
+                   manifest_path);
+    }
+    loader_free(NULL, (void *)reader.data);
+    return res;
+#else
+    (void)inst;
+    (void)manifest_path;
+    (void)is_implicit;
+    (void)layers;
+    memset(stamp, 0, sizeof(struct loader_manifest_cache_stamp));
+    return VK_INCOMPLETE;
+#endif
+}
+
+void loader_manifest_cache_store_layers(const char *manifest_path, bool is_implicit,
+                                        const struct loader_manifest_cache_stamp *stamp, const struct loader_layer_list *layers,
+                                        uint32_t first_layer) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer writer = {0};
+    manifest_cache_write_layer_list(&writer, layers, first_layer);
+    manifest_cache_store(manifest_cache_layer_kind(is_implicit), manifest_path, stamp, &writer);
+#else
+    (void)manifest_path;
+    (void)is_implicit;
+    (void)stamp;
+    (void)layers;
+    (void)first_layer;
+#endif
+}
+
+void loader_manifest_cache_flush(const struct loader_instance *inst) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer writer = {0};
+    char *temp_path = NULL;
+    FILE *file = NULL;
+    bool write_failed = false;
+
+    loader_platform_thread_lock_mutex(&loader_manifest_cache_lock);
+    struct loader_manifest_cache *cache = &global_manifest_cache;
+    if (!cache->dirty || NULL == cache->file_path) {
+        goto out;
+    }
+    cache->dirty = false;
+
+    // Drop entries for files and directories which no longer exist or changed, so the cache doesn't grow without bound
+    uint32_t live_count = 0;
+    for (uint32_t i = 0; i < cache->count; i++) {
+        struct loader_manifest_cache_stamp stamp = {0};
+        if (!manifest_cache_get_stamp(cache->entries[i].path, &stamp) ||
+            !manifest_cache_stamps_equal(&stamp, &cache->entries[i].stamp)) {
+            manifest_cache_free_entry(&cache->entries[i]);
+            continue;
+        }
+        cache->entries[live_count++] = cache->entries[i];
+    }
+    cache->count = live_count;
+
+    writer_put(&writer, MANIFEST_CACHE_MAGIC, sizeof(MANIFEST_CACHE_MAGIC));
+    writer_put_u32(&writer, MANIFEST_CACHE_FORMAT_VERSION);
+    writer_put_u32(&writer, (uint32_t)sizeof(void *));
+    writer_put_u32(&writer, cache->count);
+    for (uint32_t i = 0; i < cache->count; i++) {
+        struct loader_manifest_cache_entry *entry = &cache->entries[i];
+        writer_put_u32(&writer, entry->kind);
+        writer_put_string(&writer, entry->path);
+        writer_put_stamp(&writer, &entry->stamp);
+        writer_put_u32(&writer, entry->data_size);
+        writer_put(&writer, entry->data, entry->data_size);
+    }
+    if (writer.failed) {
+        goto out;
+    }
+
+    // The directory may not exist yet, failure is caught when opening the file
+    char *last_separator = strrchr(cache->file_path, '/');
+    if (NULL != last_separator) {
+        *last_separator = '\0';
+        mkdir(cache->file_path, 0700);
+        *last_separator = '/';
+    }
+
+    // Write to a temporary file and rename it over the old cache so that concurrent processes never see a partial file
+    size_t temp_path_len = strlen(cache->file_path) + 32;
+    temp_path = loader_alloc(NULL, temp_path_len, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (NULL == temp_path) {
+        goto out;
+    }
+    snprintf(temp_path, temp_path_len, "%s.%ld.tmp", cache->file_path, (long)getpid());
+    file = fopen(temp_path, "wb");
+    if (NULL == file) {
+        goto out;
+    }
+    bool write_ok = writer.size == fwrite(writer.data, 1, writer.size, file);
+    write_ok = (0 == fclose(file)) && write_ok;
+    file = NULL;
+    if (!write_ok || 0 != rename(temp_path, cache->file_path)) {
+        remove(temp_path);
+        write_failed = true;
+    }
+
+out:
+    if (NULL != file) {
+        fclose(file);
+    }
+    loader_platform_thread_unlock_mutex(&loader_manifest_cache_lock);
+    if (write_failed) {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "Failed to write manifest cache file %s", temp_path);
+    }
+    loader_free(NULL, temp_path);
+    loader_free(NULL, writer.data);
+#else
+    (void)inst;
+#endif
+}
+
+bool loader_scan_snapshot_enabled(const struct loader_instance *inst) {
+#if COMMON_UNIX_PLATFORMS
+    char *env_value = loader_getenv(VK_LOADER_SCAN_CACHE_ENV_VAR, inst);
+    // NOLINTNEXTLINE(bugprone-not-null-terminated-result) - n=2 intentionally excludes "1x" values like "10"
+    bool enabled = NULL != env_value && 0 == strncmp(env_value, "1", 2);
+    loader_free_getenv(env_value, inst);
+    return enabled;
+#else
+    (void)inst;
+    return false;
+#endif
+}
+
+VkResult loader_scan_snapshot_get_layers(const struct loader_instance *inst, bool is_implicit,
+                                         const struct loader_string_list *path_overrides, struct loader_layer_list *layers) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer key = {0};
+    scan_snapshot_build_key(inst, manifest_cache_layer_kind(is_implicit), path_overrides, 0, &key);
+    struct loader_scan_snapshot *snapshot = scan_snapshot_acquire(&scan_snapshots, &key);
+    loader_free(NULL, key.data);
+    if (NULL == snapshot) {
+        return VK_INCOMPLETE;
+    }
+    scan_snapshot_watch_stamps(snapshot);
+
+    struct manifest_cache_reader reader = {snapshot->data, snapshot->data_size, 0, false};
+    VkResult res = manifest_cache_read_layer_list(inst, &reader, layers);
+    scan_snapshot_release(snapshot);
+    if (VK_SUCCESS == res) {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_LAYER_BIT, 0, "Reusing the results of an earlier %s layer scan",
+                   is_implicit ? "implicit" : "explicit");
+    }
+    return res;
+#else
+    (void)inst;
+    (void)is_implicit;
+    (void)path_overrides;
+    (void)layers;
+    return VK_INCOMPLETE;
+#endif
+}
+
+void loader_scan_snapshot_store_layers(const struct loader_instance *inst, bool is_implicit,
+                                       const struct loader_string_list *path_overrides,
+                                       const struct loader_string_list *search_paths,
+                                       const struct loader_string_list *manifest_files, const struct loader_layer_list *layers,
+                                       uint32_t first_layer) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer key = {0};
+    struct manifest_cache_writer payload = {0};
+    scan_snapshot_build_key(inst, manifest_cache_layer_kind(is_implicit), path_overrides, 0, &key);
+    manifest_cache_write_layer_list(&payload, layers, first_layer);
+    scan_snapshot_publish(&scan_snapshots, &key, search_paths, manifest_files, &payload);
+#else
+    (void)inst;
+    (void)is_implicit;
+    (void)path_overrides;
+    (void)search_paths;
+    (void)manifest_files;
+    (void)layers;
+    (void)first_layer;
+#endif
+}
+
+VkResult loader_scan_snapshot_get_drivers(const struct loader_instance *inst,
+                                          const struct loader_string_list *settings_driver_files, uint32_t settings_flags,
+                                          struct loader_string_list *manifest_files, struct ICDManifestInfo **out_details) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer key = {0};
+    scan_snapshot_build_key(inst, LOADER_MANIFEST_CACHE_ENTRY_DRIVER, settings_driver_files, settings_flags, &key);
+    struct loader_scan_snapshot *snapshot = scan_snapshot_acquire(&scan_snapshots, &key);
+    loader_free(NULL, key.data);
+    if (NULL == snapshot) {
+        return VK_INCOMPLETE;
+    }
+    scan_snapshot_watch_stamps(snapshot);
+
+    VkResult res = VK_SUCCESS;
+    struct ICDManifestInfo *details = NULL;
+    struct manifest_cache_reader reader = {snapshot->data, snapshot->data_size, 0, false};
+    uint32_t count = reader_get_u32(&reader);
+    // Each driver takes at least 16 bytes, so this rejects absurd counts before allocating anything
+    if (reader.failed || count > (reader.size - reader.offset) / 16) {
+        res = VK_INCOMPLETE;
+        goto out;
+    }
+    details = loader_instance_heap_calloc(inst, sizeof(struct ICDManifestInfo) * (count > 0 ? count : 1),
+                                          VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    if (NULL == details) {
+        res = VK_ERROR_OUT_OF_HOST_MEMORY;
+        goto out;
+    }
+    for (uint32_t i = 0; i < count && VK_SUCCESS == res; i++) {
+        char *manifest_path = NULL;
+        res = reader_get_string(inst, &reader, &manifest_path);
+        if (VK_SUCCESS != res) {
+            break;
+        }
+        if (NULL == manifest_path) {
+            reader.failed = true;
+            break;
+        }
+        res = append_str_to_string_list(inst, manifest_files, manifest_path);
+        if (VK_SUCCESS != res) {
+            break;
+        }
+        // full_library_path is NULL for manifests which failed to parse
+        res = reader_get_string(inst, &reader, &details[i].full_library_path);
+        details[i].version = reader_get_u32(&reader);
+        details[i].is_portability_driver = reader_get_u32(&reader) != 0;
+    }
+    if (VK_ERROR_OUT_OF_HOST_MEMORY != res && reader.failed) {
+        res = VK_INCOMPLETE;
+    }
+    if (VK_SUCCESS != res) {
+        for (uint32_t i = 0; i < count; i++) {
+            loader_instance_heap_free(inst, details[i].full_library_path);
+        }
+        loader_instance_heap_free(inst, details);
+        free_string_list(inst, manifest_files);
+        goto out;
+    }
+    loader_log(inst, VULKAN_LOADER_DEBUG_BIT | VULKAN_LOADER_DRIVER_BIT, 0, "Reusing the results of an earlier driver scan");
+    *out_details = details;
+
+out:
+    scan_snapshot_release(snapshot);
+    return res;
+#else
+    (void)inst;
+    (void)settings_driver_files;
+    (void)settings_flags;
+    (void)manifest_files;
+    (void)out_details;
+    return VK_INCOMPLETE;
+#endif
+}
+
+void loader_scan_snapshot_store_drivers(const struct loader_instance *inst, const struct loader_string_list *settings_driver_files,
+                                        uint32_t settings_flags, const struct loader_string_list *search_paths,
+                                        const struct loader_string_list *manifest_files, const struct ICDManifestInfo *details) {
+#if COMMON_UNIX_PLATFORMS
+    struct manifest_cache_writer key = {0};
+    struct manifest_cache_writer payload = {0};
+    scan_snapshot_build_key(inst, LOADER_MANIFEST_CACHE_ENTRY_DRIVER, settings_driver_files, settings_flags, &key);
+    writer_put_u32(&payload, manifest_files->count);
+    for (uint32_t i = 0; i < manifest_files->count; i++) {
+        writer_put_string(&payload, manifest_files->list[i]);
+        writer_put_string(&payload, details[i].full_library_path);
+        writer_put_u32(&payload, details[i].version);
+        writer_put_u32(&payload, details[i].is_portability_driver ? 1 : 0);
+    }
+    scan_snapshot_publish(&scan_snapshots, &key, search_paths, manifest_files, &payload);
+#else
+    (void)inst;
+    (void)settings_driver_files;
+    (void)settings_flags;
+    (void)search_paths;
+    (void)manifest_files;
+    (void)details;
+#endif
+}
+
+bool loader_pre_instance_cache_get(enum loader_pre_instance_query query, const char *layer_name, uint32_t *count, void *elements,
+                                   size_t element_size, VkResult *result) {
+#if COMMON_UNIX_PLATFORMS
+    if (!loader_scan_snapshot_enabled(NULL)) {
+        return false;
+    }
+    struct manifest_cache_writer key = {0};
+    pre_instance_build_key(query, layer_name, &key);
+    struct loader_scan_snapshot *snapshot = scan_snapshot_acquire(&pre_instance_results, &key);
+    loader_free(NULL, key.data);
+    if (NULL == snapshot) {
+        return false;
+    }
+
+    struct manifest_cache_reader reader = {snapshot->data, snapshot->data_size, 0, false};
+    bool found = pre_instance_env_vars_unchanged(&reader);
+    VkResult cached_result = (VkResult)(int32_t)reader_get_u32(&reader);
+    uint32_t cached_count = reader_get_u32(&reader);
+    uint32_t cached_element_size = reader_get_u32(&reader);
+    found = found && !reader.failed && cached_element_size == element_size &&
+            cached_count <= (reader.size - reader.offset) / element_size;
+    if (found) {
+        const uint8_t *cached_elements = reader.data + reader.offset;
+        *result = cached_result;
+        // Errors such as VK_ERROR_LAYER_NOT_PRESENT don't write anything
+        if (VK_SUCCESS == cached_result && NULL == count) {
+            memcpy(elements, cached_elements, cached_count * element_size);
+        } else if (VK_SUCCESS == cached_result && NULL == elements) {
+            *count = cached_count;
+        } else if (VK_SUCCESS == cached_result) {
+            uint32_t copy_count = *count < cached_count ? *count : cached_count;
+            if (copy_count > 0) {
+                memcpy(elements, cached_elements, copy_count * element_size);
+            }
+            *count = copy_count;
+            if (copy_count < cached_count) {
+                *result = VK_INCOMPLETE;
+            }
+        }
+    }
+    scan_snapshot_release(snapshot);
+    return found;
+#else
+    (void)query;
+    (void)layer_name;
+    (void)count;
+    (void)elements;
+    (void)element_size;
+    (void)result;
+    return false;
+#endif
+}
+
+bool loader_pre_instance_cache_begin(void) {
+#if COMMON_UNIX_PLATFORMS
+    if (!loader_scan_snapshot_enabled(NULL)) {
+        return false;
+    }
+    loader_platform_thread_lock_mutex(&loader_pre_instance_recording_lock);
+    bool started = !pre_instance_recording.active;
+    if (started) {
+        pre_instance_recording.active = true;
+        pre_instance_recording.thread_id = loader_platform_get_thread_id();
+    }
+    loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+    return started;
+#else
+    return false;
+#endif
+}
+
+void loader_pre_instance_cache_end(enum loader_pre_instance_query query, const char *layer_name, bool should_remember) {
+#if COMMON_UNIX_PLATFORMS
+    struct loader_pre_instance_recording recording = {0};
+    loader_platform_thread_lock_mutex(&loader_pre_instance_recording_lock);
+    if (!pre_instance_recording_is_current_thread()) {
+        loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+        return;
+    }
+    // Take over the recording so that another thread can start one while this one is published
+    recording = pre_instance_recording;
+    memset(&pre_instance_recording, 0, sizeof(pre_instance_recording));
+    loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+
+    if (should_remember && !recording.failed && recording.has_result) {
+        struct manifest_cache_writer key = {0};
+        struct manifest_cache_writer payload = {0};
+        struct loader_string_list no_paths = {0};
+        pre_instance_build_key(query, layer_name, &key);
+        writer_put_u32(&payload, recording.env_var_names.count);
+        for (uint32_t i = 0; i < recording.env_var_names.count; i++) {
+            char *value = loader_getenv(recording.env_var_names.list[i], NULL);
+            writer_put_string(&payload, recording.env_var_names.list[i]);
+            writer_put_string(&payload, value);
+            loader_free_getenv(value, NULL);
+        }
+        writer_put_u32(&payload, (uint32_t)(int32_t)recording.result);
+        writer_put_u32(&payload, recording.count);
+        writer_put_u32(&payload, (uint32_t)recording.element_size);
+        writer_put(&payload, recording.elements, recording.count * recording.element_size);
+        scan_snapshot_publish(&pre_instance_results, &key, &recording.paths, &no_paths, &payload);
+    }
+    pre_instance_recording_free(&recording);
+#else
+    (void)query;
+    (void)layer_name;
+    (void)should_remember;
+#endif
+}
+
+bool loader_pre_instance_cache_is_recording(void) {
+#if COMMON_UNIX_PLATFORMS
+    loader_platform_thread_lock_mutex(&loader_pre_instance_recording_lock);
+    bool is_recording = pre_instance_recording_is_current_thread();
+    loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+    return is_recording;
+#else
+    return false;
+#endif
+}
+
+void loader_pre_instance_cache_watch_path(const char *path) {
+#if COMMON_UNIX_PLATFORMS
+    if (NULL == path) {
+        return;
+    }
+    loader_platform_thread_lock_mutex(&loader_pre_instance_recording_lock);
+    if (pre_instance_recording_is_current_thread()) {
+        pre_instance_recording_add_string(&pre_instance_recording.paths, path);
+    }
+    loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+#else
+    (void)path;
+#endif
+}
+
+void loader_pre_instance_cache_watch_paths(const struct loader_string_list *paths) {
+    for (uint32_t i = 0; i < paths->count; i++) {
+        loader_pre_instance_cache_watch_path(paths->list[i]);
+    }
+}
+
+void loader_pre_instance_cache_watch_env_var(const char *name) {
+#if COMMON_UNIX_PLATFORMS
+    if (NULL == name) {
+        return;
+    }
+    loader_platform_thread_lock_mutex(&loader_pre_instance_recording_lock);
+    if (pre_instance_recording_is_current_thread()) {
+        pre_instance_recording_add_string(&pre_instance_recording.env_var_names, name);
+    }
+    loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+#else
+    (void)name;
+#endif
+}
+
+void loader_pre_instance_cache_set_result(const void *elements, uint32_t count, size_t element_size, VkResult result) {
+#if COMMON_UNIX_PLATFORMS
+    loader_platform_thread_lock_mutex(&loader_pre_instance_recording_lock);
+    if (pre_instance_recording_is_current_thread()) {
+        if (pre_instance_recording.has_result) {
+            // Only a call which went through a layer can reach the terminator twice, and those aren't remembered
+            pre_instance_recording.failed = true;
+        } else {
+            pre_instance_recording.has_result = true;
+            pre_instance_recording.result = result;
+            pre_instance_recording.count = count;
+            pre_instance_recording.element_size = element_size;
+            if (count > 0) {
+                pre_instance_recording.elements = loader_alloc(NULL, count * element_size, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+                if (NULL == pre_instance_recording.elements) {
+                    pre_instance_recording.failed = true;
+                } else {
+                    memcpy(pre_instance_recording.elements, elements, count * element_size);
+                }
+            }
+        }
+    }
+    loader_platform_thread_unlock_mutex(&loader_pre_instance_recording_lock);
+#else
+    (void)elements;
+    (void)count;
+    (void)element_size;
+    (void)result;
+#endif
+}
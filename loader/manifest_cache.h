@@ -0,0 +1,153 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "loader_common.h"
+
+// Persistent on-disk cache of manifest discovery results.
+//
+// When VK_LOADER_MANIFEST_CACHE=1 is set, the loader remembers the list of manifest files found in each search directory as
+// well as the parsed contents of every driver and layer manifest it reads. Each entry is tagged with the stat() identity
+// (device, inode, size, modification time) of the directory or file it was derived from, so a later process can reuse it
+// without calling opendir/readdir, fopen, or the JSON parser as long as nothing on disk changed.
+//
+// The cache lives in $XDG_CACHE_HOME/vulkan (falling back to $HOME/.cache/vulkan) and is only used on unix platforms. It is
+// never consulted in privileged processes since the location comes from loader_secure_getenv.
+
+// The stat() identity of a file or directory. A loader_manifest_cache_get_* function which finds no up to date entry hands back
+// the stamp it took, which has to be passed to the matching store function once the caller read the file or directory itself.
+// Because the stamp predates the read, a change made while the file was being read leaves the new entry stale.
+struct loader_manifest_cache_stamp {
+    bool valid;  // false if the path couldn't be stat()'d, in which case nothing is stored
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    uint64_t mtime_sec;
+    uint64_t mtime_nsec;
+};
+
+// Create and destroy the global cache state - called during loader initialization and release.
+void init_global_manifest_cache(void);
+void teardown_global_manifest_cache(void);
+
+// Whether the VK_LOADER_MANIFEST_CACHE environment variable enables the cache.
+bool loader_manifest_cache_enabled(const struct loader_instance *inst);
+
+// Append the cached list of manifest files found in dir_path to out_files.
+// Returns VK_INCOMPLETE if there is no up to date entry for dir_path, in which case out_files is left untouched.
+VkResult loader_manifest_cache_get_directory(const struct loader_instance *inst, const char *dir_path,
+                                             struct loader_manifest_cache_stamp *stamp, struct loader_string_list *out_files);
+// Remember that files [first_file, files->count) were found while reading dir_path.
+void loader_manifest_cache_store_directory(const char *dir_path, const struct loader_manifest_cache_stamp *stamp,
+                                           const struct loader_string_list *files, uint32_t first_file);
+
+// Get the parsed contents of the driver manifest manifest_path. full_library_path is allocated with the instance allocator.
+// Returns VK_INCOMPLETE if there is no up to date entry for manifest_path.
+VkResult loader_manifest_cache_get_driver(const struct loader_instance *inst, const char *manifest_path,
+                                          struct loader_manifest_cache_stamp *stamp, char **full_library_path, uint32_t *version,
+                                          bool *is_portability_driver);
+void loader_manifest_cache_store_driver(const char *manifest_path, const struct loader_manifest_cache_stamp *stamp,
+                                        const char *full_library_path, uint32_t version, bool is_portability_driver);
+
+// Append the layers parsed out of the layer manifest manifest_path to layers.
+// Returns VK_INCOMPLETE if there is no up to date entry for manifest_path, in which case layers is left untouched.
+VkResult loader_manifest_cache_get_layers(const struct loader_instance *inst, const char *manifest_path, bool is_implicit,
+                                          struct loader_manifest_cache_stamp *stamp, struct loader_layer_list *layers);
+// Remember that layers [first_layer, layers->count) were parsed out of manifest_path.
+void loader_manifest_cache_store_layers(const char *manifest_path, bool is_implicit,
+                                        const struct loader_manifest_cache_stamp *stamp, const struct loader_layer_list *layers,
+                                        uint32_t first_layer);
+
+// Write the cache back to disk if any entry was added or replaced since it was loaded.
+void loader_manifest_cache_flush(const struct loader_instance *inst);
+
+// In-process snapshots of complete driver and layer scans.
+//
+// When VK_LOADER_SCAN_CACHE=1 is set, the outcome of each driver and layer scan is kept for the lifetime of the process so that
+// creating further instances does not have to search for and parse the manifests again. A snapshot is only reused if the
+// environment variables and settings which affect the scan are unchanged and if none of the searched paths or the manifest files
+// found in them changed on disk.
+
+// Flags describing the loader settings which affect a driver scan, used as part of the snapshot key.
+#define LOADER_SCAN_SNAPSHOT_USE_DRIVER_ENV_VARS 0x1
+#define LOADER_SCAN_SNAPSHOT_ADDITIONAL_DRIVERS_EXCLUSIVE 0x2
+
+// Whether the VK_LOADER_SCAN_CACHE environment variable enables scan snapshots.
+bool loader_scan_snapshot_enabled(const struct loader_instance *inst);
+
+// Append the layers found by an earlier scan with the same inputs to layers.
+// Returns VK_INCOMPLETE if there is no up to date snapshot, in which case layers is left untouched.
+VkResult loader_scan_snapshot_get_layers(const struct loader_instance *inst, bool is_implicit,
+                                         const struct loader_string_list *path_overrides, struct loader_layer_list *layers);
+// Remember that layers [first_layer, layers->count) were found by searching search_paths, which contained manifest_files.
+void loader_scan_snapshot_store_layers(const struct loader_instance *inst, bool is_implicit,
+                                       const struct loader_string_list *path_overrides,
+                                       const struct loader_string_list *search_paths,
+                                       const struct loader_string_list *manifest_files, const struct loader_layer_list *layers,
+                                       uint32_t first_layer);
+
+// Fill the empty manifest_files with the driver manifests found by an earlier scan with the same inputs. out_details is an array
+// of manifest_files->count elements allocated with the instance allocator; a NULL full_library_path marks a manifest which
+// failed to parse. Returns VK_INCOMPLETE if there is no up to date snapshot.
+VkResult loader_scan_snapshot_get_drivers(const struct loader_instance *inst,
+                                          const struct loader_string_list *settings_driver_files, uint32_t settings_flags,
+                                          struct loader_string_list *manifest_files, struct ICDManifestInfo **out_details);
+void loader_scan_snapshot_store_drivers(const struct loader_instance *inst, const struct loader_string_list *settings_driver_files,
+                                        uint32_t settings_flags, const struct loader_string_list *search_paths,
+                                        const struct loader_string_list *manifest_files, const struct ICDManifestInfo *details);
+
+// Remembered results of the pre-instance functions.
+//
+// When scan snapshots are enabled, the outcome of vkEnumerateInstanceExtensionProperties, vkEnumerateInstanceLayerProperties, and
+// vkEnumerateInstanceVersion is remembered as well, so that repeated calls - such as the count-then-fill idiom - skip reading the
+// settings file, scanning for layers and drivers, and building the layer chain. While a call is computed, every path and
+// environment variable that is consulted is recorded. The result is reused as long as none of those paths changed on disk and
+// none of those environment variables changed. Calls in which an implicit layer intercepts the function are never remembered,
+// so such layers are always called.
+
+enum loader_pre_instance_query {
+    LOADER_PRE_INSTANCE_QUERY_EXTENSION_PROPERTIES = 0,
+    LOADER_PRE_INSTANCE_QUERY_LAYER_PROPERTIES = 1,
+    LOADER_PRE_INSTANCE_QUERY_VERSION = 2,
+};
+
+// Write the remembered result of query into count & elements with the usual count-then-fill semantics and return true, or return
+// false if there is no up to date result. When count is NULL, all remembered elements are written.
+bool loader_pre_instance_cache_get(enum loader_pre_instance_query query, const char *layer_name, uint32_t *count, void *elements,
+                                   size_t element_size, VkResult *result);
+
+// Start recording what the current thread consults while computing a pre-instance result. Returns false if nothing is recorded,
+// because remembering results is disabled or because another thread is already recording.
+bool loader_pre_instance_cache_begin(void);
+// Stop recording on the current thread and remember the result if should_remember is set and the recording is complete.
+void loader_pre_instance_cache_end(enum loader_pre_instance_query query, const char *layer_name, bool should_remember);
+// Whether the current thread is recording.
+bool loader_pre_instance_cache_is_recording(void);
+
+// Record that the result depends on a path, an environment variable, or the complete list of elements that make up the result.
+// These do nothing unless the current thread is recording.
+void loader_pre_instance_cache_watch_path(const char *path);
+void loader_pre_instance_cache_watch_paths(const struct loader_string_list *paths);
+void loader_pre_instance_cache_watch_env_var(const char *name);
+void loader_pre_instance_cache_set_result(const void *elements, uint32_t count, size_t element_size, VkResult result);
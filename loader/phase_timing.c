@@ -0,0 +1,170 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "phase_timing.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "loader_environment.h"
+#include "log.h"
+#include "vk_loader_platform.h"
+
+static const char *const phase_names[LOADER_PHASE_COUNT] = {
+    "settings_load", "manifest_discovery", "json_parse", "driver_load", "layer_load", "instance_chain", "physical_device_setup",
+    "vkCreateInstance",
+};
+
+struct loader_phase_timing {
+    bool enabled;                       // set once during initialization, read without the lock
+    bool log_summary;                   // set once during initialization, read without the lock
+    loader_platform_thread_mutex lock;  // guards everything below
+    struct loader_phase_totals totals;
+    FILE *trace_file;
+    uint64_t trace_start_ns;  // trace timestamps are relative to this
+    uint64_t process_id;
+};
+
+static struct loader_phase_timing phase_timing;
+
+void init_global_phase_timing(void) {
+    memset(&phase_timing, 0, sizeof(phase_timing));
+    loader_platform_thread_create_mutex(&phase_timing.lock);
+}
+
+void loader_init_phase_timing(void) {
+    char *timing_env = loader_getenv(VK_LOADER_PHASE_TIMING_ENV_VAR, NULL);
+    // NOLINTNEXTLINE(bugprone-not-null-terminated-result) - n=2 intentionally excludes "1x" values like "10"
+    phase_timing.log_summary = NULL != timing_env && 0 == strncmp(timing_env, "1", 2);
+    loader_free_getenv(timing_env, NULL);
+
+    char *trace_path = loader_getenv(VK_LOADER_TRACE_FILE_ENV_VAR, NULL);
+    if (NULL != trace_path && '\0' != trace_path[0]) {
+        phase_timing.trace_file = loader_fopen(trace_path, "w");
+        if (NULL != phase_timing.trace_file) {
+            // NOLINTNEXTLINE(cert-err33-c) - a trace that can't be written is only missing events
+            fputs("[\n", phase_timing.trace_file);
+        } else {
+            loader_log(NULL, VULKAN_LOADER_WARN_BIT, 0, "Unable to open %s=%s for writing", VK_LOADER_TRACE_FILE_ENV_VAR,
+                       trace_path);
+        }
+    }
+    loader_free_getenv(trace_path, NULL);
+
+    phase_timing.trace_start_ns = loader_platform_get_time_ns();
+    phase_timing.process_id = loader_platform_get_process_id();
+    phase_timing.enabled = phase_timing.log_summary || NULL != phase_timing.trace_file;
+}
+
+void teardown_global_phase_timing(void) {
+    phase_timing.enabled = false;
+    phase_timing.log_summary = false;
+    if (NULL != phase_timing.trace_file) {
+        // NOLINTNEXTLINE(cert-err33-c) - nothing can be done about a failure to close the trace
+        fclose(phase_timing.trace_file);
+        phase_timing.trace_file = NULL;
+    }
+    loader_platform_thread_delete_mutex(&phase_timing.lock);
+}
+
+uint64_t loader_phase_begin(void) {
+    if (!phase_timing.enabled) {
+        return 0;
+    }
+    return loader_platform_get_time_ns();
+}
+
+// Writes str as the contents of a JSON string, escaping everything JSON doesn't allow to appear as is
+static void phase_timing_write_json_string(FILE *file, const char *str) {
+    // NOLINTBEGIN(cert-err33-c) - a trace that can't be written is only missing events
+    for (const char *c = str; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned int)(unsigned char)*c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    // NOLINTEND(cert-err33-c)
+}
+
+void loader_phase_end(enum loader_phase phase, uint64_t begin, const char *detail) {
+    if (!phase_timing.enabled || 0 == begin) {
+        return;
+    }
+    uint64_t end = loader_platform_get_time_ns();
+    uint64_t duration = end > begin ? end - begin : 0;
+
+    loader_platform_thread_lock_mutex(&phase_timing.lock);
+    phase_timing.totals.duration_ns[phase] += duration;
+    phase_timing.totals.count[phase]++;
+    if (NULL != phase_timing.trace_file) {
+        uint64_t start = begin > phase_timing.trace_start_ns ? begin - phase_timing.trace_start_ns : 0;
+        // Complete events with microsecond timestamps, as described by the Chrome trace event format
+        // NOLINTBEGIN(cert-err33-c) - a trace that can't be written is only missing events
+        fprintf(phase_timing.trace_file,
+                "{\"name\":\"%s\",\"cat\":\"loader\",\"ph\":\"X\",\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"pid\":%llu,\"tid\":%llu",
+                phase_names[phase], (unsigned long long)(start / 1000), (unsigned int)(start % 1000),
+                (unsigned long long)(duration / 1000), (unsigned int)(duration % 1000), (unsigned long long)phase_timing.process_id,
+                (unsigned long long)loader_platform_get_thread_id());
+        if (NULL != detail) {
+            fputs(",\"args\":{\"detail\":\"", phase_timing.trace_file);
+            phase_timing_write_json_string(phase_timing.trace_file, detail);
+            fputs("\"}", phase_timing.trace_file);
+        }
+        fputs("},\n", phase_timing.trace_file);
+        if (LOADER_PHASE_CREATE_INSTANCE == phase) {
+            fflush(phase_timing.trace_file);
+        }
+        // NOLINTEND(cert-err33-c)
+    }
+    loader_platform_thread_unlock_mutex(&phase_timing.lock);
+}
+
+void loader_get_phase_totals(struct loader_phase_totals *totals) {
+    memset(totals, 0, sizeof(struct loader_phase_totals));
+    if (!phase_timing.enabled) {
+        return;
+    }
+    loader_platform_thread_lock_mutex(&phase_timing.lock);
+    memcpy(totals, &phase_timing.totals, sizeof(struct loader_phase_totals));
+    loader_platform_thread_unlock_mutex(&phase_timing.lock);
+}
+
+void loader_log_phase_summary(const struct loader_instance *inst, const struct loader_phase_totals *since) {
+    if (!phase_timing.log_summary) {
+        return;
+    }
+    struct loader_phase_totals now;
+    loader_get_phase_totals(&now);
+
+    // Other threads calling into the loader at the same time also count towards the totals
+    for (uint32_t phase = 0; phase < LOADER_PHASE_COUNT; phase++) {
+        uint32_t count = now.count[phase] - since->count[phase];
+        if (0 == count) {
+            continue;
+        }
+        uint64_t duration = now.duration_ns[phase] - since->duration_ns[phase];
+        loader_log(inst, VULKAN_LOADER_INFO_BIT | VULKAN_LOADER_PERF_BIT, 0, "Phase %-21s %4u.%03u ms in %u call(s)",
+                   phase_names[phase], (unsigned int)(duration / 1000000), (unsigned int)(duration / 1000 % 1000), count);
+    }
+}
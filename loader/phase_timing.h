@@ -0,0 +1,71 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "loader_common.h"
+
+// Timers around the phases which make up most of the time spent in vkCreateInstance and the pre-instance functions.
+//
+// They are opt-in and only looked at once, when the loader is initialized:
+//  * VK_LOADER_PHASE_TIMING=1 logs how long every phase took at the end of each vkCreateInstance, with VULKAN_LOADER_PERF_BIT.
+//  * VK_LOADER_TRACE_FILE=<path> writes every phase to <path> as Chrome trace events, which chrome://tracing and Perfetto can
+//    open. The events form a JSON array which is deliberately left unterminated, so the file stays valid if the process exits
+//    without unloading the loader.
+// When neither is set, loader_phase_begin returns 0 and loader_phase_end returns right away.
+
+enum loader_phase {
+    LOADER_PHASE_SETTINGS_LOAD,          // get_loader_settings
+    LOADER_PHASE_MANIFEST_DISCOVERY,     // loader_get_data_files
+    LOADER_PHASE_JSON_PARSE,             // reading and parsing a single manifest or settings file
+    LOADER_PHASE_DRIVER_LOAD,            // opening a driver and negotiating its interface version, maybe on a worker thread
+    LOADER_PHASE_LAYER_LOAD,             // loader_open_layer_file
+    LOADER_PHASE_INSTANCE_CHAIN,         // loader_create_instance_chain, which includes the vkCreateInstance of layers and drivers
+    LOADER_PHASE_PHYSICAL_DEVICE_SETUP,  // setup_loader_term_phys_devs
+    LOADER_PHASE_CREATE_INSTANCE,        // all of vkCreateInstance
+    LOADER_PHASE_COUNT,
+};
+
+// Time spent in every phase since the loader was initialized, across all threads. Phases nested in others count towards both.
+struct loader_phase_totals {
+    uint64_t duration_ns[LOADER_PHASE_COUNT];
+    uint32_t count[LOADER_PHASE_COUNT];
+};
+
+// Needs to be called during startup and shutdown, like init_global_loader_settings and teardown_global_loader_settings
+void init_global_phase_timing(void);
+void teardown_global_phase_timing(void);
+
+// Checks the environment variables and opens the trace file, called from loader_initialize once logging is set up
+void loader_init_phase_timing(void);
+
+// Returns the timestamp to pass to loader_phase_end, or 0 when phase timing is disabled
+uint64_t loader_phase_begin(void);
+
+// Records that phase ran from begin until now. detail is optional and only added to the trace event, like the path of a file.
+void loader_phase_end(enum loader_phase phase, uint64_t begin, const char *detail);
+
+// Fills out totals, or zeroes it when phase timing is disabled
+void loader_get_phase_totals(struct loader_phase_totals *totals);
+
+// Logs how much time went into each phase since totals were captured with loader_get_phase_totals
+void loader_log_phase_summary(const struct loader_instance *inst, const struct loader_phase_totals *since);
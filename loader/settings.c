@@ -32,9 +32,23 @@
 #include "loader_windows.h"
 #endif
 #include "log.h"
+#include "log_sinks.h"
+#include "manifest_cache.h"
+#include "phase_timing.h"
 #include "stack_allocation.h"
 #include "vk_loader_platform.h"
 
+#if COMMON_UNIX_PLATFORMS
+#include <sys/stat.h>
+#endif
+#if defined(__linux__)
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 loader_platform_thread_mutex global_loader_settings_lock;
 loader_settings global_loader_settings;
 
@@ -54,6 +68,11 @@ void free_device_configuration(const struct loader_instance* inst, loader_settin
     memset(device_configuration, 0, sizeof(loader_settings_device_configuration));
 }
 
+void free_log_location(const struct loader_instance* inst, loader_settings_log_location* log_location) {
+    loader_instance_heap_free(inst, log_location->destination);
+    memset(log_location, 0, sizeof(loader_settings_log_location));
+}
+
 void free_loader_settings(const struct loader_instance* inst, loader_settings* settings) {
     if (NULL != settings->layer_configurations) {
         for (uint32_t i = 0; i < settings->layer_configuration_count; i++) {
@@ -73,6 +92,12 @@ void free_loader_settings(const struct loader_instance* inst, loader_settings* s
         }
         loader_instance_heap_free(inst, settings->device_configurations);
     }
+    if (NULL != settings->log_locations) {
+        for (uint32_t i = 0; i < settings->log_location_count; i++) {
+            free_log_location(inst, &settings->log_locations[i]);
+        }
+        loader_instance_heap_free(inst, settings->log_locations);
+    }
     loader_instance_heap_free(inst, settings->settings_file_path);
     memset(settings, 0, sizeof(loader_settings));
 }
@@ -299,6 +324,71 @@ out:
     return res;
 }
 
+// Flattens the "log_locations" array into one loader_settings_log_location per destination, each carrying the filters of the
+// element it was listed in. Malformed elements are skipped, as are elements whose filters can't match any message.
+VkResult parse_log_locations(const struct loader_instance* inst, cJSON* settings_object, loader_settings* loader_settings) {
+    VkResult res = VK_SUCCESS;
+    struct loader_string_list destinations = {0};
+    struct loader_string_list filters = {0};
+
+    cJSON* log_locations_json = loader_cJSON_GetObjectItem(settings_object, "log_locations");
+    if (NULL == log_locations_json || log_locations_json->type != cJSON_Array) {
+        return VK_SUCCESS;
+    }
+
+    cJSON* log_element = NULL;
+    cJSON_ArrayForEach(log_element, log_locations_json) {
+        if (log_element->type != cJSON_Object) {
+            continue;
+        }
+        VkResult destinations_res = loader_parse_json_array_of_strings(inst, log_element, "destinations", &destinations);
+        VkResult filters_res = loader_parse_json_array_of_strings(inst, log_element, "filters", &filters);
+        if (VK_ERROR_OUT_OF_HOST_MEMORY == destinations_res || VK_ERROR_OUT_OF_HOST_MEMORY == filters_res) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+
+        uint32_t filter_flags = 0;
+        if (VK_SUCCESS == destinations_res && VK_SUCCESS == filters_res) {
+            filter_flags = parse_log_filters_from_strings(&filters);
+        }
+        if (0 != filter_flags && destinations.count > 0) {
+            size_t old_size = sizeof(loader_settings_log_location) * loader_settings->log_location_count;
+            size_t new_size = old_size + sizeof(loader_settings_log_location) * destinations.count;
+            loader_settings_log_location* new_locations = loader_instance_heap_realloc(
+                inst, loader_settings->log_locations, old_size, new_size, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+            if (NULL == new_locations) {
+                res = VK_ERROR_OUT_OF_HOST_MEMORY;
+                goto out;
+            }
+            loader_settings->log_locations = new_locations;
+            for (uint32_t i = 0; i < destinations.count; i++) {
+                // Take ownership of the string so that it isn't freed along with the list
+                loader_settings_log_location* location = &loader_settings->log_locations[loader_settings->log_location_count++];
+                location->destination = destinations.list[i];
+                location->filters = filter_flags;
+                destinations.list[i] = NULL;
+            }
+        }
+        free_string_list(inst, &destinations);
+        free_string_list(inst, &filters);
+    }
+out:
+    free_string_list(inst, &destinations);
+    free_string_list(inst, &filters);
+    if (res != VK_SUCCESS) {
+        if (loader_settings->log_locations) {
+            for (uint32_t index = 0; index < loader_settings->log_location_count; index++) {
+                free_log_location(inst, &(loader_settings->log_locations[index]));
+            }
+            loader_settings->log_location_count = 0;
+            loader_instance_heap_free(inst, loader_settings->log_locations);
+            loader_settings->log_locations = NULL;
+        }
+    }
+    return res;
+}
+
 VkResult parse_uuid_array(cJSON* device_configuration_json, const char* uuid_name, uint8_t uuid[16]) {
     cJSON* uuid_array = loader_cJSON_GetObjectItem(device_configuration_json, uuid_name);
     if (NULL == uuid_array) {
@@ -464,6 +554,8 @@ VkResult check_if_settings_path_exists(const struct loader_instance* inst, const
         loader_strncpy(*settings_file_path, path_len, base + start, segment_len);
         loader_strncat(*settings_file_path, path_len, suffix, suffix_len);
 
+        // Creating a settings file at any of the locations checked so far changes which one is used
+        loader_pre_instance_cache_watch_path(*settings_file_path);
         if (loader_platform_file_exists(*settings_file_path)) {
             return VK_SUCCESS;
         }
@@ -585,6 +677,13 @@ bool check_if_device_configurations_are_equal(loader_settings_device_configurati
     return true;
 }
 
+bool check_if_log_locations_are_equal(loader_settings_log_location* a, loader_settings_log_location* b) {
+    if (!a->destination || !b->destination || 0 != strcmp(a->destination, b->destination)) {
+        return false;
+    }
+    return a->filters == b->filters;
+}
+
 bool check_if_settings_are_equal(loader_settings* a, loader_settings* b) {
     // If either pointer is null, return true
     if (NULL == a || NULL == b) return false;
@@ -598,6 +697,7 @@ bool check_if_settings_are_equal(loader_settings* a, loader_settings* b) {
     are_equal &= a->additional_driver_count == b->additional_driver_count;
     are_equal &= a->device_configurations_active == b->device_configurations_active;
     are_equal &= a->device_configuration_count == b->device_configuration_count;
+    are_equal &= a->log_location_count == b->log_location_count;
     if (!are_equal) return false;
     for (uint32_t i = 0; i < a->layer_configuration_count && i < b->layer_configuration_count; i++) {
         are_equal &= check_if_layer_configurations_are_equal(&a->layer_configurations[i], &b->layer_configurations[i]);
@@ -608,6 +708,9 @@ bool check_if_settings_are_equal(loader_settings* a, loader_settings* b) {
     for (uint32_t i = 0; i < a->device_configuration_count && i < b->device_configuration_count; i++) {
         are_equal &= check_if_device_configurations_are_equal(&a->device_configurations[i], &b->device_configurations[i]);
     }
+    for (uint32_t i = 0; i < a->log_location_count && i < b->log_location_count; i++) {
+        are_equal &= check_if_log_locations_are_equal(&a->log_locations[i], &b->log_locations[i]);
+    }
     return are_equal;
 }
 
@@ -627,6 +730,11 @@ void log_settings(const struct loader_instance* inst, loader_settings* settings)
     if (strlen(cmd_line_msg)) {
         loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "Loader Settings Filters for Logging to Standard Error: %s", cmd_line_msg);
     }
+    for (uint32_t i = 0; i < settings->log_location_count; i++) {
+        generate_debug_flag_str(settings->log_locations[i].filters, cmd_line_size, cmd_line_msg);
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "Loader Settings Filters for Logging to %s: %s",
+                   settings->log_locations[i].destination, cmd_line_msg);
+    }
     if (settings->layer_configurations_active) {
         loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "Layer Configurations count = %d", settings->layer_configuration_count);
         for (uint32_t i = 0; i < settings->layer_configuration_count; i++) {
@@ -675,32 +783,32 @@ void log_settings(const struct loader_instance* inst, loader_settings* settings)
     loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "---------------------------------");
 }
 
-// Loads the vk_loader_settings.json file
-// Returns VK_SUCCESS if it was found & was successfully parsed. Otherwise, it returns VK_ERROR_INITIALIZATION_FAILED if it
-// wasn't found or failed to parse, and returns VK_ERROR_OUT_OF_HOST_MEMORY if it was unable to allocate enough memory.
-VkResult get_loader_settings(const struct loader_instance* inst, loader_settings* loader_settings) {
-    VkResult res = VK_SUCCESS;
-    cJSON* json = NULL;
-    char* file_format_version_string = NULL;
-    char* settings_file_path = NULL;
+// Finds the vk_loader_settings.json file to use, setting settings_file_path to NULL if there is none
+static VkResult get_loader_settings_file_path(const struct loader_instance* inst, char** settings_file_path) {
+    VkResult res = VK_ERROR_INITIALIZATION_FAILED;
+    *settings_file_path = NULL;
 #if defined(WIN32)
-    res = windows_get_loader_settings_file_path(inst, &settings_file_path);
-    if (res != VK_SUCCESS) {
-        loader_log(inst, VULKAN_LOADER_INFO_BIT, 0,
-                   "No valid vk_loader_settings.json file found, no loader settings will be active");
-        goto out;
-    }
-
+    res = windows_get_loader_settings_file_path(inst, settings_file_path);
 #elif COMMON_UNIX_PLATFORMS
-    res = get_unix_settings_path(inst, &settings_file_path);
+    res = get_unix_settings_path(inst, settings_file_path);
+#else
+#warning "Unsupported platform - must specify platform specific location for vk_loader_settings.json"
+#endif
     if (res != VK_SUCCESS) {
         loader_log(inst, VULKAN_LOADER_INFO_BIT, 0,
                    "No valid vk_loader_settings.json file found, no loader settings will be active");
-        goto out;
+        loader_instance_heap_free(inst, *settings_file_path);
+        *settings_file_path = NULL;
     }
-#else
-#warning "Unsupported platform - must specify platform specific location for vk_loader_settings.json"
-#endif
+    return res;
+}
+
+// Parses the vk_loader_settings.json file at settings_file_path into loader_settings
+static VkResult parse_loader_settings_file(const struct loader_instance* inst, const char* settings_file_path,
+                                           loader_settings* loader_settings) {
+    VkResult res = VK_SUCCESS;
+    cJSON* json = NULL;
+    char* file_format_version_string = NULL;
 
     res = loader_get_json(inst, settings_file_path, &json);
     // Make sure sure the top level json value is an object
@@ -808,25 +916,10 @@ VkResult get_loader_settings(const struct loader_instance* inst, loader_settings
         free_string_list(inst, &stderr_log);
     }
 
-    // optional
-    cJSON* logs_to_use = loader_cJSON_GetObjectItem(settings_to_use, "log_locations");
-    if (NULL != logs_to_use) {
-        cJSON* log_element = NULL;
-        cJSON_ArrayForEach(log_element, logs_to_use) {
-            // bool is_valid = true;
-            struct loader_string_list log_destinations = {0};
-            VkResult parse_dest_res = loader_parse_json_array_of_strings(inst, log_element, "destinations", &log_destinations);
-            if (parse_dest_res != VK_SUCCESS) {
-                // is_valid = false;
-            }
-            free_string_list(inst, &log_destinations);
-            struct loader_string_list log_filters = {0};
-            VkResult parse_filters_res = loader_parse_json_array_of_strings(inst, log_element, "filters", &log_filters);
-            if (parse_filters_res != VK_SUCCESS) {
-                // is_valid = false;
-            }
-            free_string_list(inst, &log_filters);
-        }
+    VkResult log_locations_res = parse_log_locations(inst, settings_to_use, loader_settings);
+    if (VK_ERROR_OUT_OF_HOST_MEMORY == log_locations_res) {
+        res = log_locations_res;
+        goto out;
     }
 
     VkResult layer_configurations_res = parse_layer_configurations(inst, settings_to_use, loader_settings);
@@ -858,10 +951,13 @@ VkResult get_loader_settings(const struct loader_instance* inst, loader_settings
 
     // Only consider the settings active if there is at least one "setting" active.
     // Those are either logging, layers, additional_drivers, or device_configurations.
-    if (loader_settings->debug_level != 0 || loader_settings->layer_configurations_active ||
-        loader_settings->additional_driver_count != 0 || loader_settings->device_configurations_active) {
-        loader_settings->settings_file_path = settings_file_path;
-        settings_file_path = NULL;
+    if (loader_settings->debug_level != 0 || loader_settings->log_location_count != 0 ||
+        loader_settings->layer_configurations_active || loader_settings->additional_driver_count != 0 ||
+        loader_settings->device_configurations_active) {
+        res = loader_copy_to_new_str(inst, settings_file_path, &loader_settings->settings_file_path);
+        if (res != VK_SUCCESS) {
+            goto out;
+        }
         loader_settings->settings_active = true;
     } else {
         loader_log(inst, VULKAN_LOADER_INFO_BIT, 0,
@@ -872,15 +968,282 @@ out:
         loader_cJSON_Delete(json);
     }
 
-    loader_instance_heap_free(inst, settings_file_path);
-
     loader_instance_heap_free(inst, file_format_version_string);
     return res;
 }
 
+// The identity of a settings file, the file is parsed again as soon as any part of it changes
+typedef struct loader_settings_file_stamp {
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    uint64_t mtime_sec;
+    uint64_t mtime_nsec;
+} loader_settings_file_stamp;
+
+// The last settings file that was parsed, shared by the global settings and every instance so that the same file isn't parsed
+// over and over. Guarded by global_loader_settings_lock, everything in it is allocated without an instance.
+typedef struct loader_settings_cache {
+    bool valid;
+    char* settings_file_path;  // NULL when no settings file was found
+    loader_settings_file_stamp stamp;
+    VkResult result;  // what parsing settings_file_path returned
+    loader_settings settings;
+    uint64_t generation;  // incremented every time the cache is replaced, never 0 while valid
+} loader_settings_cache;
+
+static loader_settings_cache settings_cache;
+// Generation of settings_cache that global_loader_settings was last updated from, 0 if none
+static uint64_t global_loader_settings_generation;
+
+static bool get_settings_file_stamp(const char* path, loader_settings_file_stamp* stamp) {
+    memset(stamp, 0, sizeof(loader_settings_file_stamp));
+#if defined(WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA attributes = {0};
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+    stamp->size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    // Stored as is, in 100 nanosecond intervals
+    stamp->mtime_sec = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+    return true;
+#elif COMMON_UNIX_PLATFORMS
+    struct stat stats = {0};
+    if (0 != stat(path, &stats)) {
+        return false;
+    }
+    stamp->device = (uint64_t)stats.st_dev;
+    stamp->inode = (uint64_t)stats.st_ino;
+    stamp->size = (uint64_t)stats.st_size;
+    stamp->mtime_sec = (uint64_t)stats.st_mtime;
+#if defined(__linux__)
+    stamp->mtime_nsec = (uint64_t)stats.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    stamp->mtime_nsec = (uint64_t)stats.st_mtimespec.tv_nsec;
+#endif
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+static bool settings_file_paths_equal(const char* a, const char* b) {
+    if (NULL == a || NULL == b) {
+        return a == b;
+    }
+    return 0 == strcmp(a, b);
+}
+
+// Whether settings_cache holds the result of parsing settings_file_path as it currently is. Requires global_loader_settings_lock.
+static bool settings_cache_matches(const char* settings_file_path, bool has_stamp, const loader_settings_file_stamp* stamp) {
+    if (!settings_cache.valid || !settings_file_paths_equal(settings_cache.settings_file_path, settings_file_path)) {
+        return false;
+    }
+    if (NULL == settings_file_path) {
+        return true;
+    }
+    return has_stamp && settings_cache.stamp.device == stamp->device && settings_cache.stamp.inode == stamp->inode &&
+           settings_cache.stamp.size == stamp->size && settings_cache.stamp.mtime_sec == stamp->mtime_sec &&
+           settings_cache.stamp.mtime_nsec == stamp->mtime_nsec;
+}
+
+static void settings_cache_clear(void) {
+    loader_instance_heap_free(NULL, settings_cache.settings_file_path);
+    free_loader_settings(NULL, &settings_cache.settings);
+    uint64_t generation = settings_cache.generation;
+    memset(&settings_cache, 0, sizeof(loader_settings_cache));
+    settings_cache.generation = generation;
+}
+
+// Makes dst a deep copy of src, allocated with the allocator of inst
+static VkResult copy_loader_settings(const struct loader_instance* inst, const loader_settings* src, loader_settings* dst) {
+    VkResult res = VK_SUCCESS;
+    memcpy(dst, src, sizeof(loader_settings));
+    dst->layer_configurations = NULL;
+    dst->additional_drivers = NULL;
+    dst->device_configurations = NULL;
+    dst->log_locations = NULL;
+    dst->settings_file_path = NULL;
+
+    if (NULL != src->layer_configurations && src->layer_configuration_count > 0) {
+        dst->layer_configurations =
+            loader_instance_heap_calloc(inst, sizeof(loader_settings_layer_configuration) * src->layer_configuration_count,
+                                        VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == dst->layer_configurations) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        for (uint32_t i = 0; i < src->layer_configuration_count; i++) {
+            dst->layer_configurations[i].control = src->layer_configurations[i].control;
+            dst->layer_configurations[i].treat_as_implicit_manifest = src->layer_configurations[i].treat_as_implicit_manifest;
+            if (NULL != src->layer_configurations[i].name) {
+                res = loader_copy_to_new_str(inst, src->layer_configurations[i].name, &dst->layer_configurations[i].name);
+                if (VK_SUCCESS != res) {
+                    goto out;
+                }
+            }
+            if (NULL != src->layer_configurations[i].path) {
+                res = loader_copy_to_new_str(inst, src->layer_configurations[i].path, &dst->layer_configurations[i].path);
+                if (VK_SUCCESS != res) {
+                    goto out;
+                }
+            }
+        }
+    }
+
+    if (NULL != src->additional_drivers && src->additional_driver_count > 0) {
+        dst->additional_drivers = loader_instance_heap_calloc(
+            inst, sizeof(loader_settings_driver_configuration) * src->additional_driver_count, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == dst->additional_drivers) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        for (uint32_t i = 0; i < src->additional_driver_count; i++) {
+            if (NULL != src->additional_drivers[i].path) {
+                res = loader_copy_to_new_str(inst, src->additional_drivers[i].path, &dst->additional_drivers[i].path);
+                if (VK_SUCCESS != res) {
+                    goto out;
+                }
+            }
+        }
+    }
+
+    if (NULL != src->device_configurations && src->device_configuration_count > 0) {
+        dst->device_configurations =
+            loader_instance_heap_calloc(inst, sizeof(loader_settings_device_configuration) * src->device_configuration_count,
+                                        VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == dst->device_configurations) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        memcpy(dst->device_configurations, src->device_configurations,
+               sizeof(loader_settings_device_configuration) * src->device_configuration_count);
+    }
+
+    if (NULL != src->log_locations && src->log_location_count > 0) {
+        dst->log_locations = loader_instance_heap_calloc(inst, sizeof(loader_settings_log_location) * src->log_location_count,
+                                                         VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == dst->log_locations) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            goto out;
+        }
+        for (uint32_t i = 0; i < src->log_location_count; i++) {
+            dst->log_locations[i].filters = src->log_locations[i].filters;
+            if (NULL != src->log_locations[i].destination) {
+                res = loader_copy_to_new_str(inst, src->log_locations[i].destination, &dst->log_locations[i].destination);
+                if (VK_SUCCESS != res) {
+                    goto out;
+                }
+            }
+        }
+    }
+
+    if (NULL != src->settings_file_path) {
+        res = loader_copy_to_new_str(inst, src->settings_file_path, &dst->settings_file_path);
+    }
+out:
+    if (VK_SUCCESS != res) {
+        free_loader_settings(inst, dst);
+    }
+    return res;
+}
+
+static void settings_watcher_wake(void);
+
+// Fills loader_settings from settings_cache when the settings file is unchanged since it was last parsed, otherwise parses the
+// file and remembers the result in settings_cache.
+// out_generation receives the generation of settings_cache that loader_settings corresponds to, or 0 if it couldn't be cached.
+// If that is known_generation, loader_settings is left untouched because the caller already has those exact settings.
+static VkResult load_loader_settings(const struct loader_instance* inst, uint64_t known_generation,
+                                     loader_settings* loader_settings, uint64_t* out_generation) {
+    uint64_t phase_begin = loader_phase_begin();
+    char* settings_file_path = NULL;
+    loader_settings_file_stamp stamp = {0};
+    *out_generation = 0;
+
+    VkResult res = get_loader_settings_file_path(inst, &settings_file_path);
+    bool has_stamp = NULL != settings_file_path && get_settings_file_stamp(settings_file_path, &stamp);
+
+    loader_platform_thread_lock_mutex(&global_loader_settings_lock);
+    bool cache_hit = settings_cache_matches(settings_file_path, has_stamp, &stamp);
+    if (cache_hit) {
+        res = settings_cache.result;
+        *out_generation = settings_cache.generation;
+        if (0 == known_generation || known_generation != settings_cache.generation) {
+            VkResult copy_res = copy_loader_settings(inst, &settings_cache.settings, loader_settings);
+            if (VK_SUCCESS != copy_res) {
+                res = copy_res;
+                *out_generation = 0;
+            }
+        }
+    }
+    loader_platform_thread_unlock_mutex(&global_loader_settings_lock);
+    if (cache_hit) {
+        goto out;
+    }
+
+    if (NULL != settings_file_path) {
+        loader_log(inst, VULKAN_LOADER_DEBUG_BIT, 0, "Reading loader settings file %s", settings_file_path);
+        res = parse_loader_settings_file(inst, settings_file_path, loader_settings);
+    }
+
+    // Files without a stamp can't be told apart from their next version, so they are parsed every time
+    if (VK_ERROR_OUT_OF_HOST_MEMORY == res || (NULL != settings_file_path && !has_stamp)) {
+        goto out;
+    }
+    loader_settings_cache new_cache = {0};
+    new_cache.valid = true;
+    new_cache.stamp = stamp;
+    new_cache.result = res;
+    if (VK_SUCCESS != copy_loader_settings(NULL, loader_settings, &new_cache.settings) ||
+        (NULL != settings_file_path &&
+         VK_SUCCESS != loader_copy_to_new_str(NULL, settings_file_path, &new_cache.settings_file_path))) {
+        free_loader_settings(NULL, &new_cache.settings);
+        goto out;
+    }
+
+    loader_platform_thread_lock_mutex(&global_loader_settings_lock);
+    bool path_changed = !settings_cache.valid ||
+                        !settings_file_paths_equal(settings_cache.settings_file_path, new_cache.settings_file_path);
+    new_cache.generation = settings_cache.generation + 1;
+    settings_cache_clear();
+    memcpy(&settings_cache, &new_cache, sizeof(loader_settings_cache));
+    *out_generation = settings_cache.generation;
+    loader_platform_thread_unlock_mutex(&global_loader_settings_lock);
+
+    // The watcher follows whichever settings file is currently in use
+    if (path_changed) {
+        settings_watcher_wake();
+    }
+out:
+    loader_instance_heap_free(inst, settings_file_path);
+    loader_phase_end(LOADER_PHASE_SETTINGS_LOAD, phase_begin, NULL);
+    return res;
+}
+
+// Loads the vk_loader_settings.json file
+// Returns VK_SUCCESS if it was found & was successfully parsed. Otherwise, it returns VK_ERROR_INITIALIZATION_FAILED if it
+// wasn't found or failed to parse, and returns VK_ERROR_OUT_OF_HOST_MEMORY if it was unable to allocate enough memory.
+// The file is only parsed again once its identity (device, inode, size, and modification time) changes.
+VkResult get_loader_settings(const struct loader_instance* inst, loader_settings* loader_settings) {
+    uint64_t generation = 0;
+    return load_loader_settings(inst, 0, loader_settings, &generation);
+}
+
 TEST_FUNCTION_EXPORT VkResult update_global_loader_settings(void) {
     loader_settings settings = {0};
-    VkResult res = get_loader_settings(NULL, &settings);
+    uint64_t generation = 0;
+
+    loader_platform_thread_lock_mutex(&global_loader_settings_lock);
+    uint64_t known_generation = global_loader_settings_generation;
+    loader_platform_thread_unlock_mutex(&global_loader_settings_lock);
+
+    VkResult res = load_loader_settings(NULL, known_generation, &settings, &generation);
+    // Nothing to do when the global settings already came from the current version of the settings file
+    if (0 != known_generation && generation == known_generation) {
+        return res;
+    }
     loader_platform_thread_lock_mutex(&global_loader_settings_lock);
 
     if (res == VK_SUCCESS) {
@@ -892,7 +1255,11 @@ TEST_FUNCTION_EXPORT VkResult update_global_loader_settings(void) {
         if (global_loader_settings.settings_active && global_loader_settings.debug_level > 0) {
             loader_set_global_debug_level(global_loader_settings.debug_level);
         }
+        loader_configure_log_sinks(global_loader_settings.log_location_count, global_loader_settings.log_locations);
+    } else {
+        free_loader_settings(NULL, &settings);
     }
+    global_loader_settings_generation = generation;
     loader_platform_thread_unlock_mutex(&global_loader_settings_lock);
     return res;
 }
@@ -901,12 +1268,156 @@ void init_global_loader_settings(void) {
     loader_platform_thread_create_mutex(&global_loader_settings_lock);
     // Free out the global settings in case the process was loaded & unloaded
     free_loader_settings(NULL, &global_loader_settings);
+    settings_cache_clear();
+    global_loader_settings_generation = 0;
 }
 void teardown_global_loader_settings(void) {
     free_loader_settings(NULL, &global_loader_settings);
+    settings_cache_clear();
+    global_loader_settings_generation = 0;
     loader_platform_thread_delete_mutex(&global_loader_settings_lock);
 }
 
+#if defined(__linux__)
+// Optional thread which reloads the global settings as soon as the directory holding the settings file in use changes, so that
+// long running processes pick up edits to it without calling into the loader. Enabled with VK_LOADER_SETTINGS_WATCH=1.
+struct loader_settings_watcher {
+    bool running;
+    bool exit_requested;  // guarded by global_loader_settings_lock
+    loader_platform_thread thread;
+    int inotify_fd;
+    int wake_fd;  // eventfd signaled whenever the thread should look at settings_cache again
+};
+
+static struct loader_settings_watcher settings_watcher = {false, false, 0, -1, -1};
+
+static void settings_watcher_wake(void) {
+    if (settings_watcher.wake_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(settings_watcher.wake_fd, &one, sizeof(one));
+        (void)written;  // the counter can only fail to increase if it is already about to wake the thread
+    }
+}
+
+static LOADER_PLATFORM_THREAD_ENTRY(settings_watcher_main, arg) {
+    (void)arg;
+    char* watched_directory = NULL;
+    int watch_descriptor = -1;
+    char events[4096];
+    while (true) {
+        char* directory = NULL;
+        loader_platform_thread_lock_mutex(&global_loader_settings_lock);
+        bool exit_requested = settings_watcher.exit_requested;
+        if (!exit_requested && NULL != settings_cache.settings_file_path) {
+            // Can only fail when out of memory, in which case nothing is watched until the next wake up
+            (void)loader_copy_to_new_str(NULL, settings_cache.settings_file_path, &directory);
+        }
+        loader_platform_thread_unlock_mutex(&global_loader_settings_lock);
+        if (exit_requested) {
+            break;
+        }
+
+        // Watch the directory rather than the file so that replacing the file by renaming a new one over it is noticed too
+        if (NULL != directory) {
+            char* last_slash = strrchr(directory, '/');
+            if (last_slash == directory) {
+                last_slash[1] = '\0';
+            } else if (NULL != last_slash) {
+                *last_slash = '\0';
+            }
+        }
+        if (!settings_file_paths_equal(directory, watched_directory)) {
+            if (watch_descriptor >= 0) {
+                inotify_rm_watch(settings_watcher.inotify_fd, watch_descriptor);
+                watch_descriptor = -1;
+            }
+            loader_instance_heap_free(NULL, watched_directory);
+            watched_directory = directory;
+            directory = NULL;
+            if (NULL != watched_directory) {
+                uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ATTRIB;
+                watch_descriptor = inotify_add_watch(settings_watcher.inotify_fd, watched_directory, mask);
+            }
+        }
+        loader_instance_heap_free(NULL, directory);
+
+        struct pollfd fds[2] = {{settings_watcher.inotify_fd, POLLIN, 0}, {settings_watcher.wake_fd, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        // Both descriptors are non-blocking, so drain them completely before waiting again
+        if (0 != (fds[1].revents & POLLIN)) {
+            while (read(settings_watcher.wake_fd, events, sizeof(events)) > 0) {
+            }
+        }
+        if (0 != (fds[0].revents & POLLIN)) {
+            while (read(settings_watcher.inotify_fd, events, sizeof(events)) > 0) {
+            }
+            // Changes to other files in the directory are filtered out by the stamp of the settings file
+            update_global_loader_settings();
+        }
+    }
+    if (watch_descriptor >= 0) {
+        inotify_rm_watch(settings_watcher.inotify_fd, watch_descriptor);
+    }
+    loader_instance_heap_free(NULL, watched_directory);
+    LOADER_PLATFORM_THREAD_RETURN;
+}
+
+static void settings_watcher_close_fds(void) {
+    if (settings_watcher.inotify_fd >= 0) {
+        close(settings_watcher.inotify_fd);
+        settings_watcher.inotify_fd = -1;
+    }
+    if (settings_watcher.wake_fd >= 0) {
+        close(settings_watcher.wake_fd);
+        settings_watcher.wake_fd = -1;
+    }
+}
+#else
+static void settings_watcher_wake(void) {}
+#endif
+
+void loader_init_settings_watcher(void) {
+#if defined(__linux__)
+    char* watch_env = loader_getenv(VK_LOADER_SETTINGS_WATCH_ENV_VAR, NULL);
+    // NOLINTNEXTLINE(bugprone-not-null-terminated-result) - n=2 intentionally excludes "1x" values like "10"
+    bool enabled = NULL != watch_env && 0 == strncmp(watch_env, "1", 2);
+    loader_free_getenv(watch_env, NULL);
+    if (!enabled || settings_watcher.running) {
+        return;
+    }
+    settings_watcher.exit_requested = false;
+    settings_watcher.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    settings_watcher.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (settings_watcher.inotify_fd >= 0 && settings_watcher.wake_fd >= 0) {
+        settings_watcher.running = loader_platform_thread_create(&settings_watcher.thread, settings_watcher_main, NULL);
+    }
+    if (!settings_watcher.running) {
+        settings_watcher_close_fds();
+        loader_log(NULL, VULKAN_LOADER_WARN_BIT, 0, "Unable to start watching the loader settings file for %s",
+                   VK_LOADER_SETTINGS_WATCH_ENV_VAR);
+    }
+#endif
+}
+
+void teardown_global_settings_watcher(void) {
+#if defined(__linux__)
+    if (settings_watcher.running) {
+        loader_platform_thread_lock_mutex(&global_loader_settings_lock);
+        settings_watcher.exit_requested = true;
+        loader_platform_thread_unlock_mutex(&global_loader_settings_lock);
+        settings_watcher_wake();
+        loader_platform_thread_join(settings_watcher.thread);
+        settings_watcher.running = false;
+    }
+    settings_watcher_close_fds();
+#endif
+}
+
 bool should_skip_logging_global_messages(VkFlags msg_type) {
     loader_platform_thread_lock_mutex(&global_loader_settings_lock);
     bool should_skip = global_loader_settings.settings_active && 0 != (msg_type & global_loader_settings.debug_level);
@@ -989,6 +1500,7 @@ TEST_FUNCTION_EXPORT VkResult get_settings_layers(const struct loader_instance*
             continue;
         }
 
+        loader_pre_instance_cache_watch_path(layer_config->path);
         cJSON* json = NULL;
         VkResult local_res = loader_get_json(inst, layer_config->path, &json);
         if (VK_ERROR_OUT_OF_HOST_MEMORY == local_res) {
@@ -1315,3 +1827,13 @@ out:
     release_current_settings_lock(inst);
     return should_use;
 }
+
+bool loader_settings_should_use_additional_drivers_exclusively(const struct loader_instance* inst) {
+    bool exclusive = false;
+    const loader_settings* settings = get_current_settings_and_lock(inst);
+    if (NULL != settings && settings->settings_active) {
+        exclusive = settings->additional_drivers_use_exclusively;
+    }
+    release_current_settings_lock(inst);
+    return exclusive;
+}
@@ -74,6 +74,12 @@ typedef struct loader_settings_device_configuration {
     char driverName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE];
 } loader_settings_device_configuration;
 
+// A single destination from the "log_locations" array along with the filters of the element it was listed in
+typedef struct loader_settings_log_location {
+    char* destination;
+    uint32_t filters;  // enum vulkan_loader_debug_flags
+} loader_settings_log_location;
+
 typedef struct loader_settings {
     bool settings_active;
     bool has_unordered_layer_location;
@@ -91,12 +97,16 @@ typedef struct loader_settings {
     uint32_t device_configuration_count;
     loader_settings_device_configuration* device_configurations;
 
+    uint32_t log_location_count;
+    loader_settings_log_location* log_locations;
+
     char* settings_file_path;
 } loader_settings;
 
 // Call this function to get the current settings that the loader should use.
 // It will open up the current loader settings file and return a loader_settings in out_loader_settings if it.
 // It should be called on every call to the global functions excluding vkGetInstanceProcAddr
+// The file is only parsed again once its identity (device, inode, size, and modification time) changes.
 // Caller is responsible for cleaning up by calling free_loader_settings()
 VkResult get_loader_settings(const struct loader_instance* inst, loader_settings* out_loader_settings);
 
@@ -112,6 +122,11 @@ TEST_FUNCTION_EXPORT VkResult update_global_loader_settings(void);
 void init_global_loader_settings(void);
 void teardown_global_loader_settings(void);
 
+// Starts the thread which reloads the global settings whenever the settings file changes if VK_LOADER_SETTINGS_WATCH is set.
+// Only supported on Linux. The thread has to be stopped before any other global state is torn down.
+void loader_init_settings_watcher(void);
+void teardown_global_settings_watcher(void);
+
 // Check the global settings and return true if msg_type does not correspond to the active global loader settings
 bool should_skip_logging_global_messages(VkFlags msg_type);
 
@@ -142,3 +157,6 @@ VkResult loader_settings_get_additional_driver_files(const struct loader_instanc
 // Check if there are any device_configurations. If so, we don't want to allow environment variables from selecting or ignoring
 // drivers. This is because the VkPhysicalDevices corresponding to a driver_configurations might not be present otherwise.
 bool loader_settings_should_use_driver_environment_variables(const struct loader_instance* inst);
+
+// Check if the drivers from the loader settings file replace the drivers found through the regular search paths.
+bool loader_settings_should_use_additional_drivers_exclusively(const struct loader_instance* inst);
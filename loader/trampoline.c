@@ -35,6 +35,8 @@
 #include "loader.h"
 #include "loader_environment.h"
 #include "log.h"
+#include "manifest_cache.h"
+#include "phase_timing.h"
 #include "settings.h"
 #include "stack_allocation.h"
 #include "vk_loader_extensions.h"
@@ -112,14 +114,9 @@ LOADER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkI
     }
 }
 
-// Get a device level or global level entry point address.
-// @param device
-// @param pName
-// @return
-//    If device is valid, returns a device relative entry point for device level
-//    entry points both core and extensions.
-//    Device relative means call down the device chain.
-LOADER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device, const char *pName) {
+// Resolve pName for device, where disp_table is the dispatch table of device (which may be NULL if device is invalid).
+// Shared by vkGetDeviceProcAddr and loader_get_device_proc_addrs so that both always return the same functions.
+static PFN_vkVoidFunction get_device_proc_addr(VkDevice device, const VkLayerDispatchTable *disp_table, const char *pName) {
     if (!pName || pName[0] != 'v' || pName[1] != 'k') return NULL;
 
     // For entrypoints that loader must handle (ie non-dispatchable or create object)
@@ -151,7 +148,6 @@ LOADER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDev
         return NULL;
     }
     // Return the dispatch table entrypoint for the fastest case
-    const VkLayerDispatchTable *disp_table = loader_get_dispatch(device);
     if (disp_table == NULL) return NULL;
 
     bool found_name = false;
@@ -162,15 +158,46 @@ LOADER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDev
     return disp_table->GetDeviceProcAddr(device, pName);
 }
 
+// Get a device level or global level entry point address.
+// @param device
+// @param pName
+// @return
+//    If device is valid, returns a device relative entry point for device level
+//    entry points both core and extensions.
+//    Device relative means call down the device chain.
+LOADER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device, const char *pName) {
+    if (!pName || pName[0] != 'v' || pName[1] != 'k') return NULL;
+
+    return get_device_proc_addr(device, loader_get_dispatch(device), pName);
+}
+
+// Loader-private batch version of vkGetDeviceProcAddr, queried through vkGetInstanceProcAddr with the name
+// VK_LOADER_GET_DEVICE_PROC_ADDRS_NAME. The dispatch table of device is only looked up once for all of the names.
+VKAPI_ATTR void VKAPI_CALL loader_get_device_proc_addrs(VkDevice device, uint32_t nameCount, const char *const *pNames,
+                                                        PFN_vkVoidFunction *pFunctions) {
+    if (nameCount == 0 || NULL == pNames || NULL == pFunctions) return;
+
+    const VkLayerDispatchTable *disp_table = loader_get_dispatch(device);
+    for (uint32_t i = 0; i < nameCount; i++) {
+        pFunctions[i] = get_device_proc_addr(device, disp_table, pNames[i]);
+    }
+}
+
 LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceExtensionProperties(const char *pLayerName,
                                                                                     uint32_t *pPropertyCount,
                                                                                     VkExtensionProperties *pProperties) {
     LOADER_PLATFORM_THREAD_ONCE(&once_init, loader_initialize);
 
+    VkResult res = VK_SUCCESS;
+    if (loader_pre_instance_cache_get(LOADER_PRE_INSTANCE_QUERY_EXTENSION_PROPERTIES, pLayerName, pPropertyCount, pProperties,
+                                      sizeof(VkExtensionProperties), &res)) {
+        return res;
+    }
+    bool recording = loader_pre_instance_cache_begin();
+
     update_global_loader_settings();
 
     // We know we need to call at least the terminator
-    VkResult res = VK_SUCCESS;
     VkEnumerateInstanceExtensionPropertiesChain chain_tail = {
         .header =
             {
@@ -186,16 +213,16 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceExtensionPropert
     // Get the implicit layers
     struct loader_layer_list layers = {0};
     memset(&layers, 0, sizeof(layers));
-    struct loader_envvar_all_filters layer_filters = {0};
+    struct loader_envvar_snapshot envvar_snapshot;
 
-    res = parse_layer_environment_var_filters(NULL, &layer_filters);
+    res = loader_get_global_envvar_snapshot(&envvar_snapshot);
     if (VK_SUCCESS != res) {
-        return res;
+        goto out;
     }
 
-    res = loader_scan_for_implicit_layers(NULL, &layers, &layer_filters);
+    res = loader_scan_for_implicit_layers(NULL, &layers, &envvar_snapshot.layer_filters);
     if (VK_SUCCESS != res) {
-        return res;
+        goto out;
     }
 
     // Prepend layers onto the chain if they implement this entry point
@@ -240,6 +267,12 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceExtensionPropert
         res = chain_head->pfnNextLayer(chain_head->pNextLink, pLayerName, pPropertyCount, pProperties);
     }
 
+out:
+    if (recording) {
+        // Layers which intercept this function must be called every time, so their results are never remembered
+        loader_pre_instance_cache_end(LOADER_PRE_INSTANCE_QUERY_EXTENSION_PROPERTIES, pLayerName, chain_head == &chain_tail);
+    }
+
     // Free up the layers
     loader_delete_layer_list_and_properties(NULL, &layers);
 
@@ -257,10 +290,16 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(
                                                                                 VkLayerProperties *pProperties) {
     LOADER_PLATFORM_THREAD_ONCE(&once_init, loader_initialize);
 
+    VkResult res = VK_SUCCESS;
+    if (loader_pre_instance_cache_get(LOADER_PRE_INSTANCE_QUERY_LAYER_PROPERTIES, NULL, pPropertyCount, pProperties,
+                                      sizeof(VkLayerProperties), &res)) {
+        return res;
+    }
+    bool recording = loader_pre_instance_cache_begin();
+
     update_global_loader_settings();
 
     // We know we need to call at least the terminator
-    VkResult res = VK_SUCCESS;
     VkEnumerateInstanceLayerPropertiesChain chain_tail = {
         .header =
             {
@@ -276,16 +315,16 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(
     // Get the implicit layers
     struct loader_layer_list layers;
     memset(&layers, 0, sizeof(layers));
-    struct loader_envvar_all_filters layer_filters = {0};
+    struct loader_envvar_snapshot envvar_snapshot;
 
-    res = parse_layer_environment_var_filters(NULL, &layer_filters);
+    res = loader_get_global_envvar_snapshot(&envvar_snapshot);
     if (VK_SUCCESS != res) {
-        return res;
+        goto out;
     }
 
-    res = loader_scan_for_implicit_layers(NULL, &layers, &layer_filters);
+    res = loader_scan_for_implicit_layers(NULL, &layers, &envvar_snapshot.layer_filters);
     if (VK_SUCCESS != res) {
-        return res;
+        goto out;
     }
 
     // Prepend layers onto the chain if they implement this entry point
@@ -330,6 +369,12 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(
         res = chain_head->pfnNextLayer(chain_head->pNextLink, pPropertyCount, pProperties);
     }
 
+out:
+    if (recording) {
+        // Layers which intercept this function must be called every time, so their results are never remembered
+        loader_pre_instance_cache_end(LOADER_PRE_INSTANCE_QUERY_LAYER_PROPERTIES, NULL, chain_head == &chain_tail);
+    }
+
     // Free up the layers
     loader_delete_layer_list_and_properties(NULL, &layers);
 
@@ -346,8 +391,6 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceLayerProperties(
 LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceVersion(uint32_t *pApiVersion) {
     LOADER_PLATFORM_THREAD_ONCE(&once_init, loader_initialize);
 
-    update_global_loader_settings();
-
     if (NULL == pApiVersion) {
         loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
                    "vkEnumerateInstanceVersion: \'pApiVersion\' must not be NULL "
@@ -356,8 +399,15 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceVersion(uint32_t
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    // We know we need to call at least the terminator
     VkResult res = VK_SUCCESS;
+    if (loader_pre_instance_cache_get(LOADER_PRE_INSTANCE_QUERY_VERSION, NULL, NULL, pApiVersion, sizeof(uint32_t), &res)) {
+        return res;
+    }
+    bool recording = loader_pre_instance_cache_begin();
+
+    update_global_loader_settings();
+
+    // We know we need to call at least the terminator
     VkEnumerateInstanceVersionChain chain_tail = {
         .header =
             {
@@ -373,16 +423,16 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceVersion(uint32_t
     // Get the implicit layers
     struct loader_layer_list layers;
     memset(&layers, 0, sizeof(layers));
-    struct loader_envvar_all_filters layer_filters = {0};
+    struct loader_envvar_snapshot envvar_snapshot;
 
-    res = parse_layer_environment_var_filters(NULL, &layer_filters);
+    res = loader_get_global_envvar_snapshot(&envvar_snapshot);
     if (VK_SUCCESS != res) {
-        return res;
+        goto out;
     }
 
-    res = loader_scan_for_implicit_layers(NULL, &layers, &layer_filters);
+    res = loader_scan_for_implicit_layers(NULL, &layers, &envvar_snapshot.layer_filters);
     if (VK_SUCCESS != res) {
-        return res;
+        goto out;
     }
 
     // Prepend layers onto the chain if they implement this entry point
@@ -426,6 +476,12 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateInstanceVersion(uint32_t
         res = chain_head->pfnNextLayer(chain_head->pNextLink, pApiVersion);
     }
 
+out:
+    if (recording) {
+        // Layers which intercept this function must be called every time, so their results are never remembered
+        loader_pre_instance_cache_end(LOADER_PRE_INSTANCE_QUERY_VERSION, NULL, chain_head == &chain_tail);
+    }
+
     // Free up the layers
     loader_delete_layer_list_and_properties(NULL, &layers);
 
@@ -458,6 +514,7 @@ void loader_add_instance_only_debug_funcs(struct loader_instance *ptr_instance)
             cur_node = cur_node->pNext;
         }
     }
+    util_UpdateDebugMessageFilter(ptr_instance);
 }
 
 // Remove the "instance-only" debug functions from the list of active debug functions.
@@ -476,6 +533,7 @@ void loader_remove_instance_only_debug_funcs(struct loader_instance *ptr_instanc
         }
         cur_node = cur_node->pNext;
     }
+    util_UpdateDebugMessageFilter(ptr_instance);
 }
 
 // Dump the app's VkInstanceCreateInfo under VK_LOADER_DEBUG (names, versions, requested layers/extensions). Handy
@@ -529,10 +587,14 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     VkInstanceCreateInfo ici = {0};
     bool portability_enumeration_flag_bit_set = false;
     bool portability_enumeration_extension_enabled = false;
-    struct loader_envvar_all_filters layer_filters = {0};
+    struct loader_phase_totals phase_totals = {0};
+    uint64_t phase_begin = 0;
 
     LOADER_PLATFORM_THREAD_ONCE(&once_init, loader_initialize);
 
+    loader_get_phase_totals(&phase_totals);
+    phase_begin = loader_phase_begin();
+
     if (pCreateInfo == NULL) {
         loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
                    "vkCreateInstance: \'pCreateInfo\' is NULL (VUID-vkCreateInstance-pCreateInfo-parameter)");
@@ -559,6 +621,17 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
         ptr_instance->alloc_callbacks = *pAllocator;
     }
     ptr_instance->magic = LOADER_MAGIC_NUMBER;
+    loader_platform_thread_create_mutex(&ptr_instance->surface_lock);
+    loader_platform_thread_create_mutex(&ptr_instance->phys_dev_lock);
+    loader_platform_thread_create_mutex(&ptr_instance->phys_dev_term_lock);
+    loader_platform_thread_create_mutex(&ptr_instance->phys_dev_snapshot_lock);
+
+    if (loader_instance_arena_enabled(ptr_instance)) {
+        res = loader_instance_arena_create(ptr_instance);
+        if (VK_SUCCESS != res) {
+            goto out;
+        }
+    }
 
     // Save the application version
     if (NULL == pCreateInfo->pApplicationInfo || 0 == pCreateInfo->pApplicationInfo->apiVersion) {
@@ -597,6 +670,8 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
         log_settings(ptr_instance, &ptr_instance->settings);
     }
 
+    ptr_instance->lazy_dispatch = loader_lazy_dispatch_enabled(ptr_instance);
+
     // Providing an apiVersion less than VK_API_VERSION_1_0 but greater than zero prevents the validation layers from starting
     if (pCreateInfo->pApplicationInfo && pCreateInfo->pApplicationInfo->apiVersion != 0u &&
         pCreateInfo->pApplicationInfo->apiVersion < VK_API_VERSION_1_0) {
@@ -638,7 +713,8 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
         }
     }
 
-    res = parse_layer_environment_var_filters(ptr_instance, &layer_filters);
+    // Everything that later depends on the filter environment variables only looks at this snapshot
+    res = loader_parse_envvar_snapshot(ptr_instance, &ptr_instance->envvar_snapshot);
     if (VK_SUCCESS != res) {
         goto out;
     }
@@ -647,7 +723,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     // enabledLayerCount == 0 and VK_INSTANCE_LAYERS is unset. For now always
     // get layer list via loader_scan_for_layers().
     memset(&ptr_instance->instance_layer_list, 0, sizeof(ptr_instance->instance_layer_list));
-    res = loader_scan_for_layers(ptr_instance, &ptr_instance->instance_layer_list, &layer_filters);
+    res = loader_scan_for_layers(ptr_instance, &ptr_instance->instance_layer_list, &ptr_instance->envvar_snapshot.layer_filters);
     if (VK_SUCCESS != res) {
         goto out;
     }
@@ -703,7 +779,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
         goto out;
     }
     res = loader_validate_instance_extensions(ptr_instance, &ptr_instance->ext_list, &ptr_instance->instance_layer_list,
-                                              &layer_filters, &ici);
+                                              &ptr_instance->envvar_snapshot.layer_filters, &ici);
     if (res != VK_SUCCESS) {
         goto out;
     }
@@ -718,17 +794,22 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     }
     memcpy(&ptr_instance->disp->layer_inst_disp, &instance_disp, sizeof(instance_disp));
 
+    loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
     ptr_instance->next = loader.instances;
     loader.instances = ptr_instance;
+    loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
 
     // Activate any layers on instance chain
-    res = loader_enable_instance_layers(ptr_instance, &ici, &ptr_instance->instance_layer_list, &layer_filters);
+    res = loader_enable_instance_layers(ptr_instance, &ici, &ptr_instance->instance_layer_list,
+                                        &ptr_instance->envvar_snapshot.layer_filters);
     if (res != VK_SUCCESS) {
         goto out;
     }
 
     created_instance = (VkInstance)ptr_instance;
+    uint64_t chain_phase_begin = loader_phase_begin();
     res = loader_create_instance_chain(&ici, pAllocator, ptr_instance, &created_instance);
+    loader_phase_end(LOADER_PHASE_INSTANCE_CHAIN, chain_phase_begin, NULL);
 
     if (VK_SUCCESS == res) {
         // Check for enabled extensions here to setup the loader structures so the loader knows what extensions
@@ -754,13 +835,17 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
     }
 
 out:
+    loader_phase_end(LOADER_PHASE_CREATE_INSTANCE, phase_begin, NULL);
+    loader_log_phase_summary(ptr_instance, &phase_totals);
 
     if (NULL != ptr_instance) {
         if (res != VK_SUCCESS) {
             // error path, should clean everything up
+            loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
             if (loader.instances == ptr_instance) {
                 loader.instances = ptr_instance->next;
             }
+            loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
 
             free_loader_settings(ptr_instance, &ptr_instance->settings);
 
@@ -791,17 +876,25 @@ out:
                     icd_term->dispatch.DestroyInstance(icd_term->instance, pAllocator);
                 }
                 icd_term->instance = VK_NULL_HANDLE;
+                loader_platform_thread_lock_rwlock_write(&loader_object_lookup_lock);
                 ptr_instance->icd_terms = icd_term->next;
+                loader_platform_thread_unlock_rwlock_write(&loader_object_lookup_lock);
                 loader_icd_destroy(ptr_instance, icd_term, pAllocator);
             }
 
             loader_clear_scanned_icd_list(ptr_instance, &ptr_instance->icd_tramp_list);
             free_string_list(ptr_instance, &ptr_instance->enabled_layer_names);
 
+            loader_instance_arena_destroy(ptr_instance);
+            loader_platform_thread_delete_mutex(&ptr_instance->surface_lock);
+            loader_platform_thread_delete_mutex(&ptr_instance->phys_dev_lock);
+            loader_platform_thread_delete_mutex(&ptr_instance->phys_dev_term_lock);
+            loader_platform_thread_delete_mutex(&ptr_instance->phys_dev_snapshot_lock);
             loader_instance_heap_free(ptr_instance, ptr_instance);
         } else {
             // success path, swap out created debug callbacks out so they aren't used until instance destruction
             loader_remove_instance_only_debug_funcs(ptr_instance);
+            loader_instance_arena_seal(ptr_instance);
         }
         // Only unlock when ptr_instance isn't NULL, as if it is, the above code didn't make it to when loader_lock was locked.
         loader_platform_thread_unlock_mutex(&loader_lock);
@@ -864,6 +957,11 @@ LOADER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(VkInstance instance,
     destroy_debug_callbacks_chain(ptr_instance, pAllocator);
 
     loader_instance_heap_free(ptr_instance, ptr_instance->disp);
+    loader_instance_arena_destroy(ptr_instance);
+    loader_platform_thread_delete_mutex(&ptr_instance->surface_lock);
+    loader_platform_thread_delete_mutex(&ptr_instance->phys_dev_lock);
+    loader_platform_thread_delete_mutex(&ptr_instance->phys_dev_term_lock);
+    loader_platform_thread_delete_mutex(&ptr_instance->phys_dev_snapshot_lock);
     loader_instance_heap_free(ptr_instance, ptr_instance);
     loader_platform_thread_unlock_mutex(&loader_lock);
 
@@ -877,8 +975,6 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstan
     VkResult res = VK_SUCCESS;
     struct loader_instance *inst;
 
-    loader_platform_thread_lock_mutex(&loader_lock);
-
     inst = loader_get_instance(instance);
     if (NULL == inst) {
         loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
@@ -886,6 +982,9 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstan
         abort(); /* Intentionally fail so user can correct issue. */
     }
 
+    // Only this instance's physical device bookkeeping is locked, enumerating on other instances doesn't wait for the drivers
+    loader_platform_thread_lock_mutex(&inst->phys_dev_lock);
+
     if (NULL == pPhysicalDeviceCount) {
         loader_log(inst, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
                    "vkEnumeratePhysicalDevices: Received NULL pointer for physical device count return value. "
@@ -894,16 +993,12 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstan
         goto out;
     }
 
-    struct loader_envvar_id_filter device_id_filter;
-    struct loader_envvar_id_filter vendor_id_filter;
-    struct loader_envvar_id_filter driver_id_filter;
-
-    parse_id_filter_environment_var(inst, VK_DEVICE_ID_FILTER_ENV_VAR, &device_id_filter);
-    parse_id_filter_environment_var(inst, VK_VENDOR_ID_FILTER_ENV_VAR, &vendor_id_filter);
-    parse_id_filter_environment_var(inst, VK_DRIVER_ID_FILTER_ENV_VAR, &driver_id_filter);
+    const struct loader_envvar_id_filter *device_id_filter = &inst->envvar_snapshot.device_id_filter;
+    const struct loader_envvar_id_filter *vendor_id_filter = &inst->envvar_snapshot.vendor_id_filter;
+    const struct loader_envvar_id_filter *driver_id_filter = &inst->envvar_snapshot.driver_id_filter;
 
     // Call down the chain to get the physical device info
-    if ((0 == device_id_filter.count) && (0 == vendor_id_filter.count) && (0 == driver_id_filter.count)) {
+    if ((0 == device_id_filter->count) && (0 == vendor_id_filter->count) && (0 == driver_id_filter->count)) {
         res = inst->disp->layer_inst_disp.EnumeratePhysicalDevices(inst->instance, pPhysicalDeviceCount, pPhysicalDevices);
     } else {
         uint32_t physical_device_count = 0;
@@ -918,7 +1013,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstan
             goto out;
         }
 
-        res = loader_filter_enumerated_physical_device(inst, &device_id_filter, &vendor_id_filter, &driver_id_filter,
+        res = loader_filter_enumerated_physical_device(inst, device_id_filter, vendor_id_filter, driver_id_filter,
                                                        physical_device_count, physical_devices, pPhysicalDeviceCount,
                                                        pPhysicalDevices);
     }
@@ -936,7 +1031,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(VkInstan
 
 out:
 
-    loader_platform_thread_unlock_mutex(&loader_lock);
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_lock);
 
     return res;
 }
@@ -2637,8 +2732,6 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroups(
     VkResult res = VK_SUCCESS;
     struct loader_instance *inst = NULL;
 
-    loader_platform_thread_lock_mutex(&loader_lock);
-
     inst = loader_get_instance(instance);
     if (NULL == inst) {
         loader_log(NULL, VULKAN_LOADER_FATAL_ERROR_BIT | VULKAN_LOADER_ERROR_BIT | VULKAN_LOADER_VALIDATION_BIT, 0,
@@ -2646,6 +2739,8 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroups(
         abort(); /* Intentionally fail so user can correct issue. */
     }
 
+    loader_platform_thread_lock_mutex(&inst->phys_dev_lock);
+
     if (NULL == pPhysicalDeviceGroupCount) {
         loader_log(inst, VULKAN_LOADER_ERROR_BIT, 0,
                    "vkEnumeratePhysicalDeviceGroups: Received NULL pointer for physical "
@@ -2654,16 +2749,12 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroups(
         goto out;
     }
 
-    struct loader_envvar_id_filter device_id_filter;
-    struct loader_envvar_id_filter vendor_id_filter;
-    struct loader_envvar_id_filter driver_id_filter;
-
-    parse_id_filter_environment_var(inst, VK_DEVICE_ID_FILTER_ENV_VAR, &device_id_filter);
-    parse_id_filter_environment_var(inst, VK_VENDOR_ID_FILTER_ENV_VAR, &vendor_id_filter);
-    parse_id_filter_environment_var(inst, VK_DRIVER_ID_FILTER_ENV_VAR, &driver_id_filter);
+    const struct loader_envvar_id_filter *device_id_filter = &inst->envvar_snapshot.device_id_filter;
+    const struct loader_envvar_id_filter *vendor_id_filter = &inst->envvar_snapshot.vendor_id_filter;
+    const struct loader_envvar_id_filter *driver_id_filter = &inst->envvar_snapshot.driver_id_filter;
 
     // Call down the chain to get the physical device group info.
-    if ((0 == device_id_filter.count) && (0 == vendor_id_filter.count) && (0 == driver_id_filter.count)) {
+    if ((0 == device_id_filter->count) && (0 == vendor_id_filter->count) && (0 == driver_id_filter->count)) {
         res = inst->disp->layer_inst_disp.EnumeratePhysicalDeviceGroups(inst->instance, pPhysicalDeviceGroupCount,
                                                                         pPhysicalDeviceGroupProperties);
     } else {
@@ -2683,7 +2774,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroups(
             goto out;
         }
 
-        res = loader_filter_enumerated_physical_device_groups(inst, &device_id_filter, &vendor_id_filter, &driver_id_filter,
+        res = loader_filter_enumerated_physical_device_groups(inst, device_id_filter, vendor_id_filter, driver_id_filter,
                                                               physical_device_group_count, physical_device_group_properties,
                                                               pPhysicalDeviceGroupCount, pPhysicalDeviceGroupProperties);
     }
@@ -2698,7 +2789,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDeviceGroups(
 
 out:
 
-    loader_platform_thread_unlock_mutex(&loader_lock);
+    loader_platform_thread_unlock_mutex(&inst->phys_dev_lock);
     return res;
 }
 
@@ -70,6 +70,34 @@ void *loader_get_dev_ext_trampoline(uint32_t index);
 void *loader_get_phys_dev_ext_tramp(uint32_t index);
 void *loader_get_phys_dev_ext_termin(uint32_t index);
 
+// Unknown function name maps
+//
+// Names are never removed from the function name arrays while the instance lives, so the maps only need insertion and lookup.
+
+// Returns the index of funcName in functions, or UINT32_MAX if it isn't in the map
+static uint32_t loader_unknown_function_map_find(const struct loader_unknown_function_map_entry *map, char *const *functions,
+                                                 uint32_t name_hash, const char *funcName) {
+    uint32_t slot = name_hash % LOADER_UNKNOWN_FUNCTION_MAP_SIZE;
+    while (0 != map[slot].index_plus_one) {
+        uint32_t index = map[slot].index_plus_one - 1;
+        if (map[slot].name_hash == name_hash && NULL != functions[index] && !strcmp(functions[index], funcName)) {
+            return index;
+        }
+        slot = (slot + 1) % LOADER_UNKNOWN_FUNCTION_MAP_SIZE;
+    }
+    return UINT32_MAX;
+}
+
+// The map has twice as many slots as there can be functions, so there is always an empty slot to insert into
+static void loader_unknown_function_map_insert(struct loader_unknown_function_map_entry *map, uint32_t name_hash, uint32_t index) {
+    uint32_t slot = name_hash % LOADER_UNKNOWN_FUNCTION_MAP_SIZE;
+    while (0 != map[slot].index_plus_one) {
+        slot = (slot + 1) % LOADER_UNKNOWN_FUNCTION_MAP_SIZE;
+    }
+    map[slot].name_hash = name_hash;
+    map[slot].index_plus_one = index + 1;
+}
+
 // Device function handling
 
 // Initialize device_ext dispatch table entry as follows:
@@ -155,6 +183,7 @@ void loader_free_dev_ext_table(struct loader_instance *inst) {
         loader_instance_heap_free(inst, inst->dev_ext_disp_functions[i]);
     }
     memset(inst->dev_ext_disp_functions, 0, sizeof(inst->dev_ext_disp_functions));
+    memset(inst->dev_ext_disp_function_map, 0, sizeof(inst->dev_ext_disp_function_map));
 }
 
 /*
@@ -175,11 +204,12 @@ void loader_free_dev_ext_table(struct loader_instance *inst) {
  * ICD returns a non-NULL GetProcAddr for it.
  */
 void *loader_dev_ext_gpa_impl(struct loader_instance *inst, const char *funcName, bool is_tramp) {
-    // Linearly look through already added functions to make sure we haven't seen it before
-    // if we have, return the function at the index found
-    for (uint32_t i = 0; i < inst->dev_ext_disp_function_count; i++) {
-        if (inst->dev_ext_disp_functions[i] && !strcmp(inst->dev_ext_disp_functions[i], funcName))
-            return loader_get_dev_ext_trampoline(i);
+    // Make sure we haven't seen this function before, if we have, return the function at the index found
+    uint32_t name_hash = loader_hash_string(funcName);
+    uint32_t existing_index =
+        loader_unknown_function_map_find(inst->dev_ext_disp_function_map, inst->dev_ext_disp_functions, name_hash, funcName);
+    if (UINT32_MAX != existing_index) {
+        return loader_get_dev_ext_trampoline(existing_index);
     }
 
     // Check if funcName is supported in either ICDs or a layer library
@@ -206,6 +236,7 @@ void *loader_dev_ext_gpa_impl(struct loader_instance *inst, const char *funcName
     // init any dev dispatch table entries as needed
     loader_init_dispatch_dev_ext_entry(inst, NULL, inst->dev_ext_disp_function_count, funcName);
     void *out_function = loader_get_dev_ext_trampoline(inst->dev_ext_disp_function_count);
+    loader_unknown_function_map_insert(inst->dev_ext_disp_function_map, name_hash, inst->dev_ext_disp_function_count);
     inst->dev_ext_disp_function_count++;
     return out_function;
 }
@@ -256,6 +287,7 @@ void loader_free_phys_dev_ext_table(struct loader_instance *inst) {
         loader_instance_heap_free(inst, inst->phys_dev_ext_disp_functions[i]);
     }
     memset(inst->phys_dev_ext_disp_functions, 0, sizeof(inst->phys_dev_ext_disp_functions));
+    memset(inst->phys_dev_ext_disp_function_map, 0, sizeof(inst->phys_dev_ext_disp_function_map));
 }
 
 // This function returns a generic trampoline or terminator function
@@ -273,6 +305,15 @@ void loader_free_phys_dev_ext_table(struct loader_instance *inst) {
 void *loader_phys_dev_ext_gpa_impl(struct loader_instance *inst, const char *funcName, bool is_tramp) {
     assert(NULL != inst);
 
+    uint32_t name_hash = loader_hash_string(funcName);
+    uint32_t existing_index = loader_unknown_function_map_find(inst->phys_dev_ext_disp_function_map,
+                                                               inst->phys_dev_ext_disp_functions, name_hash, funcName);
+    // Functions are only added once an ICD or layer supports them, so if the dispatch entries were already set up for the same
+    // kind of query there is nothing left to do. Otherwise go through the full setup, which switches them over.
+    if (UINT32_MAX != existing_index && inst->phys_dev_ext_disp_function_is_tramp[existing_index] == is_tramp) {
+        return is_tramp ? loader_get_phys_dev_ext_tramp(existing_index) : loader_get_phys_dev_ext_termin(existing_index);
+    }
+
     // We should always check to see if any ICD supports it.
     if (!loader_check_icds_for_phys_dev_ext_address(inst, funcName)) {
         // If we're not checking layers, or we are and it's not in a layer, just
@@ -282,17 +323,8 @@ void *loader_phys_dev_ext_gpa_impl(struct loader_instance *inst, const char *fun
         }
     }
 
-    bool has_found = false;
-    uint32_t new_function_index = 0;
-    // Linearly look through already added functions to make sure we haven't seen it before
-    // if we have, return the function at the index found
-    for (uint32_t i = 0; i < inst->phys_dev_ext_disp_function_count; i++) {
-        if (inst->phys_dev_ext_disp_functions[i] && !strcmp(inst->phys_dev_ext_disp_functions[i], funcName)) {
-            has_found = true;
-            new_function_index = i;
-            break;
-        }
-    }
+    bool has_found = UINT32_MAX != existing_index;
+    uint32_t new_function_index = has_found ? existing_index : 0;
 
     // A never before seen function name, store it in the array
     if (!has_found) {
@@ -318,6 +350,7 @@ void *loader_phys_dev_ext_gpa_impl(struct loader_instance *inst, const char *fun
                        funcName_len);
 
         new_function_index = inst->phys_dev_ext_disp_function_count;
+        loader_unknown_function_map_insert(inst->phys_dev_ext_disp_function_map, name_hash, new_function_index);
         // increment the count so that the subsequent logic includes the newly added entry point when searching for functions
         inst->phys_dev_ext_disp_function_count++;
     }
@@ -362,6 +395,9 @@ void *loader_phys_dev_ext_gpa_impl(struct loader_instance *inst, const char *fun
         }
     }
 
+    // Recorded last, since querying the layers above can recursively set up the terminator
+    inst->phys_dev_ext_disp_function_is_tramp[new_function_index] = is_tramp;
+
     if (is_tramp) {
         return loader_get_phys_dev_ext_tramp(new_function_index);
     } else {
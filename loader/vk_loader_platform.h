@@ -57,6 +57,7 @@
 #include <pthread.h>
 #include <stdlib.h>
 #include <libgen.h>
+#include <time.h>
 
 #elif defined(_WIN32)
 // WinBase.h defines CreateSemaphore and synchapi.h defines CreateEvent
@@ -134,6 +135,29 @@
 #define VK_VENDOR_ID_FILTER_ENV_VAR "VK_LOADER_VENDOR_ID_FILTER"
 #define VK_DRIVER_ID_FILTER_ENV_VAR "VK_LOADER_DRIVER_ID_FILTER"
 
+// Opt-in persistent cache of manifest search results, see manifest_cache.h
+#define VK_LOADER_MANIFEST_CACHE_ENV_VAR "VK_LOADER_MANIFEST_CACHE"
+#define VK_LOADER_SCAN_CACHE_ENV_VAR "VK_LOADER_SCAN_CACHE"
+
+// Opt-in cache keeping layer libraries loaded between instances, the value is how many seconds an unused library stays loaded
+#define VK_LOADER_LAYER_LIBRARY_CACHE_ENV_VAR "VK_LOADER_LAYER_LIBRARY_CACHE"
+
+// Opt-in population of dispatch table entries on first use
+#define VK_LOADER_LAZY_DISPATCH_ENV_VAR "VK_LOADER_LAZY_DISPATCH"
+
+// Number of threads the loader may use to load drivers, see worker_pool.h
+#define VK_LOADER_WORKER_THREADS_ENV_VAR "VK_LOADER_WORKER_THREADS"
+
+// Opt-in arena for the allocations made while creating an instance, see allocation.h
+#define VK_LOADER_INSTANCE_ARENA_ENV_VAR "VK_LOADER_INSTANCE_ARENA"
+
+// Opt-in timers around the phases of vkCreateInstance, see phase_timing.h
+#define VK_LOADER_PHASE_TIMING_ENV_VAR "VK_LOADER_PHASE_TIMING"
+#define VK_LOADER_TRACE_FILE_ENV_VAR "VK_LOADER_TRACE_FILE"
+
+// Opt-in thread reloading the loader settings file as soon as it changes, see settings.h
+#define VK_LOADER_SETTINGS_WATCH_ENV_VAR "VK_LOADER_SETTINGS_WATCH"
+
 #if defined(__APPLE__)
 #define VK_LOADER_SEARCH_ONLY_IN_BUNDLE_ENV_VAR "VK_LOADER_SEARCH_ONLY_IN_BUNDLE"
 #endif
@@ -193,6 +217,9 @@ typedef pthread_t loader_platform_thread_id;
 // Thread mutex:
 typedef pthread_mutex_t loader_platform_thread_mutex;
 
+// Thread read-write lock:
+typedef pthread_rwlock_t loader_platform_thread_rwlock;
+
 typedef pthread_cond_t loader_platform_thread_cond;
 
 #elif defined(_WIN32)
@@ -232,6 +259,9 @@ typedef DWORD loader_platform_thread_id;
 // Thread mutex:
 typedef CRITICAL_SECTION loader_platform_thread_mutex;
 
+// Thread read-write lock:
+typedef SRWLOCK loader_platform_thread_rwlock;
+
 typedef CONDITION_VARIABLE loader_platform_thread_cond;
 
 #else
@@ -458,6 +488,49 @@ static inline void loader_platform_thread_lock_mutex(loader_platform_thread_mute
 static inline void loader_platform_thread_unlock_mutex(loader_platform_thread_mutex *pMutex) { pthread_mutex_unlock(pMutex); }
 static inline void loader_platform_thread_delete_mutex(loader_platform_thread_mutex *pMutex) { pthread_mutex_destroy(pMutex); }
 
+// Thread read-write lock - unlike the mutex it is not recursive, so a thread holding it must not try to lock it again:
+static inline void loader_platform_thread_create_rwlock(loader_platform_thread_rwlock *pLock) { pthread_rwlock_init(pLock, NULL); }
+static inline void loader_platform_thread_lock_rwlock_read(loader_platform_thread_rwlock *pLock) { pthread_rwlock_rdlock(pLock); }
+static inline void loader_platform_thread_unlock_rwlock_read(loader_platform_thread_rwlock *pLock) { pthread_rwlock_unlock(pLock); }
+static inline void loader_platform_thread_lock_rwlock_write(loader_platform_thread_rwlock *pLock) { pthread_rwlock_wrlock(pLock); }
+static inline void loader_platform_thread_unlock_rwlock_write(loader_platform_thread_rwlock *pLock) { pthread_rwlock_unlock(pLock); }
+static inline void loader_platform_thread_delete_rwlock(loader_platform_thread_rwlock *pLock) { pthread_rwlock_destroy(pLock); }
+
+// Thread condition variable - the mutex must be locked exactly once by the thread waiting on it:
+static inline void loader_platform_thread_create_cond(loader_platform_thread_cond *pCond) { pthread_cond_init(pCond, NULL); }
+static inline void loader_platform_thread_cond_wait(loader_platform_thread_cond *pCond, loader_platform_thread_mutex *pMutex) {
+    pthread_cond_wait(pCond, pMutex);
+}
+static inline void loader_platform_thread_cond_broadcast(loader_platform_thread_cond *pCond) { pthread_cond_broadcast(pCond); }
+static inline void loader_platform_thread_delete_cond(loader_platform_thread_cond *pCond) { pthread_cond_destroy(pCond); }
+
+// Threads - declare entry points with LOADER_PLATFORM_THREAD_ENTRY and leave them with LOADER_PLATFORM_THREAD_RETURN:
+#define LOADER_PLATFORM_THREAD_ENTRY(name, arg) void *name(void *arg)
+#define LOADER_PLATFORM_THREAD_RETURN return NULL
+typedef void *(*loader_platform_thread_entry)(void *);
+static inline bool loader_platform_thread_create(loader_platform_thread *pThread, loader_platform_thread_entry entry, void *arg) {
+    return 0 == pthread_create(pThread, NULL, entry, arg);
+}
+static inline void loader_platform_thread_join(loader_platform_thread thread) { pthread_join(thread, NULL); }
+static inline void loader_platform_thread_detach(loader_platform_thread thread) { pthread_detach(thread); }
+
+// Atomic pointer load and store, for pointers which are read without a lock while another thread may replace them:
+static inline void *loader_platform_atomic_load_pointer(void *const *pTarget) { return __atomic_load_n(pTarget, __ATOMIC_ACQUIRE); }
+static inline void loader_platform_atomic_store_pointer(void **pTarget, void *value) {
+    __atomic_store_n(pTarget, value, __ATOMIC_RELEASE);
+}
+
+// Monotonic clock in nanoseconds, only meaningful when compared to other values it returned
+static inline uint64_t loader_platform_get_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// Numeric identifiers of the current process and thread, only used for diagnostics
+static inline uint64_t loader_platform_get_process_id(void) { return (uint64_t)getpid(); }
+static inline uint64_t loader_platform_get_thread_id(void) { return (uint64_t)(uintptr_t)pthread_self(); }
+
 static inline void *thread_safe_strtok(char *str, const char *delim, char **saveptr) { return strtok_r(str, delim, saveptr); }
 
 static inline FILE *loader_fopen(const char *fileName, const char *mode) { return fopen(fileName, mode); }
@@ -624,6 +697,64 @@ static inline void loader_platform_thread_lock_mutex(loader_platform_thread_mute
 static inline void loader_platform_thread_unlock_mutex(loader_platform_thread_mutex *pMutex) { LeaveCriticalSection(pMutex); }
 static inline void loader_platform_thread_delete_mutex(loader_platform_thread_mutex *pMutex) { DeleteCriticalSection(pMutex); }
 
+// Thread read-write lock - unlike the mutex it is not recursive, so a thread holding it must not try to lock it again:
+static inline void loader_platform_thread_create_rwlock(loader_platform_thread_rwlock *pLock) { InitializeSRWLock(pLock); }
+static inline void loader_platform_thread_lock_rwlock_read(loader_platform_thread_rwlock *pLock) { AcquireSRWLockShared(pLock); }
+static inline void loader_platform_thread_unlock_rwlock_read(loader_platform_thread_rwlock *pLock) { ReleaseSRWLockShared(pLock); }
+static inline void loader_platform_thread_lock_rwlock_write(loader_platform_thread_rwlock *pLock) { AcquireSRWLockExclusive(pLock); }
+static inline void loader_platform_thread_unlock_rwlock_write(loader_platform_thread_rwlock *pLock) {
+    ReleaseSRWLockExclusive(pLock);
+}
+// SRW locks don't need to be destroyed
+static inline void loader_platform_thread_delete_rwlock(loader_platform_thread_rwlock *pLock) { (void)pLock; }
+
+// Thread condition variable - the mutex must be locked exactly once by the thread waiting on it:
+static inline void loader_platform_thread_create_cond(loader_platform_thread_cond *pCond) { InitializeConditionVariable(pCond); }
+static inline void loader_platform_thread_cond_wait(loader_platform_thread_cond *pCond, loader_platform_thread_mutex *pMutex) {
+    SleepConditionVariableCS(pCond, pMutex, INFINITE);
+}
+static inline void loader_platform_thread_cond_broadcast(loader_platform_thread_cond *pCond) { WakeAllConditionVariable(pCond); }
+static inline void loader_platform_thread_delete_cond(loader_platform_thread_cond *pCond) { (void)pCond; }
+
+// Threads - declare entry points with LOADER_PLATFORM_THREAD_ENTRY and leave them with LOADER_PLATFORM_THREAD_RETURN:
+#define LOADER_PLATFORM_THREAD_ENTRY(name, arg) DWORD WINAPI name(LPVOID arg)
+#define LOADER_PLATFORM_THREAD_RETURN return 0
+typedef LPTHREAD_START_ROUTINE loader_platform_thread_entry;
+static inline bool loader_platform_thread_create(loader_platform_thread *pThread, loader_platform_thread_entry entry, void *arg) {
+    *pThread = CreateThread(NULL, 0, entry, arg, 0, NULL);
+    return NULL != *pThread;
+}
+static inline void loader_platform_thread_join(loader_platform_thread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+static inline void loader_platform_thread_detach(loader_platform_thread thread) { CloseHandle(thread); }
+
+// Atomic pointer load and store, for pointers which are read without a lock while another thread may replace them:
+static inline void *loader_platform_atomic_load_pointer(void *const *pTarget) {
+    // Exchanging NULL for NULL never modifies the target but returns its current value with a full barrier
+    return InterlockedCompareExchangePointer((PVOID volatile *)pTarget, NULL, NULL);
+}
+static inline void loader_platform_atomic_store_pointer(void **pTarget, void *value) {
+    InterlockedExchangePointer((PVOID volatile *)pTarget, value);
+}
+
+// Monotonic clock in nanoseconds, only meaningful when compared to other values it returned
+static inline uint64_t loader_platform_get_time_ns(void) {
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    // Split the conversion so that it doesn't overflow for counters which run for a long time
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ULL + remainder * 1000000000ULL / (uint64_t)frequency.QuadPart;
+}
+
+// Numeric identifiers of the current process and thread, only used for diagnostics
+static inline uint64_t loader_platform_get_process_id(void) { return (uint64_t)GetCurrentProcessId(); }
+static inline uint64_t loader_platform_get_thread_id(void) { return (uint64_t)GetCurrentThreadId(); }
+
 static inline void *thread_safe_strtok(char *str, const char *delimiters, char **context) {
     return strtok_s(str, delimiters, context);
 }
@@ -0,0 +1,102 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "worker_pool.h"
+
+#include <stdlib.h>
+
+#include "loader_environment.h"
+#include "vk_loader_platform.h"
+
+struct loader_worker_pool_run {
+    loader_platform_thread_mutex lock;  // guards next_task
+    uint32_t next_task;
+    uint32_t task_count;
+    loader_worker_task task;
+    void *user_data;
+};
+
+static void worker_pool_run_tasks(struct loader_worker_pool_run *run) {
+    for (;;) {
+        loader_platform_thread_lock_mutex(&run->lock);
+        uint32_t task_index = run->next_task;
+        if (task_index < run->task_count) {
+            run->next_task++;
+        }
+        loader_platform_thread_unlock_mutex(&run->lock);
+
+        if (task_index >= run->task_count) {
+            break;
+        }
+        run->task(run->user_data, task_index);
+    }
+}
+
+static LOADER_PLATFORM_THREAD_ENTRY(worker_pool_thread_main, arg) {
+    worker_pool_run_tasks((struct loader_worker_pool_run *)arg);
+    LOADER_PLATFORM_THREAD_RETURN;
+}
+
+uint32_t loader_get_worker_thread_count(const struct loader_instance *inst) {
+    uint32_t thread_count = 1;
+    char *env_value = loader_getenv(VK_LOADER_WORKER_THREADS_ENV_VAR, inst);
+    if (NULL != env_value) {
+        unsigned long requested = strtoul(env_value, NULL, 10);
+        if (requested > LOADER_MAX_WORKER_THREADS) {
+            thread_count = LOADER_MAX_WORKER_THREADS;
+        } else if (requested > 1) {
+            thread_count = (uint32_t)requested;
+        }
+    }
+    loader_free_getenv(env_value, inst);
+    return thread_count;
+}
+
+void loader_run_tasks_in_parallel(uint32_t task_count, uint32_t thread_count, loader_worker_task task, void *user_data) {
+    struct loader_worker_pool_run run = {0};
+    run.task_count = task_count;
+    run.task = task;
+    run.user_data = user_data;
+
+    // The calling thread works on the tasks too, so it only needs helpers for the rest
+    uint32_t worker_count = 0;
+    if (task_count > 1 && thread_count > 1) {
+        worker_count = (thread_count > LOADER_MAX_WORKER_THREADS ? LOADER_MAX_WORKER_THREADS : thread_count) - 1;
+        if (worker_count > task_count - 1) {
+            worker_count = task_count - 1;
+        }
+    }
+
+    loader_platform_thread_create_mutex(&run.lock);
+    loader_platform_thread threads[LOADER_MAX_WORKER_THREADS - 1];
+    uint32_t started_count = 0;
+    for (; started_count < worker_count; started_count++) {
+        if (!loader_platform_thread_create(&threads[started_count], worker_pool_thread_main, &run)) {
+            break;
+        }
+    }
+
+    worker_pool_run_tasks(&run);
+
+    for (uint32_t i = 0; i < started_count; i++) {
+        loader_platform_thread_join(threads[i]);
+    }
+    loader_platform_thread_delete_mutex(&run.lock);
+}
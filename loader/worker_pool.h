@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "loader_common.h"
+
+// Short lived pools of worker threads used to spread independent pieces of work, like opening driver libraries, over several
+// threads.
+//
+// The number of threads is opt-in through VK_LOADER_WORKER_THREADS=<count>, where count includes the calling thread. Leaving it
+// unset, or setting it to 0 or 1, keeps all of the work on the calling thread. Tasks must not log, so that the order of everything
+// observable stays the same as when running serially. They may allocate through the instance allocator, which Vulkan already
+// requires to be callable from several threads at once.
+
+// Upper bound on the number of threads, including the calling thread, used by loader_run_tasks_in_parallel
+#define LOADER_MAX_WORKER_THREADS 16
+
+// Called once for every task_index in [0, task_count)
+typedef void (*loader_worker_task)(void *user_data, uint32_t task_index);
+
+// The number of threads requested with VK_LOADER_WORKER_THREADS, clamped to [1, LOADER_MAX_WORKER_THREADS].
+uint32_t loader_get_worker_thread_count(const struct loader_instance *inst);
+
+// Run task for every index in [0, task_count) on up to thread_count threads, including the calling thread, and return once all
+// of them finished. If worker threads can't be started, the remaining tasks run on the calling thread.
+void loader_run_tasks_in_parallel(uint32_t task_count, uint32_t thread_count, loader_worker_task task, void *user_data);
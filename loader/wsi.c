@@ -73,14 +73,18 @@ VkResult wsi_unwrap_icd_surface(struct loader_icd_term *icd_term, VkSurfaceKHR *
     }
 #endif  // VK_USE_PLATFORM_MACOS_MVK
 
+    VkResult result = VK_SUCCESS;
+    // The list may be resized by a surface being created on another thread
+    loader_platform_thread_mutex *surface_lock = &((struct loader_instance *)icd_term->this_instance)->surface_lock;
+    loader_platform_thread_lock_mutex(surface_lock);
+
     if (NULL == icd_term->surface_list.list ||
         icd_term->surface_list.capacity <= icd_surface->surface_index * sizeof(VkSurfaceKHR)) {
         // This surface handle is not one that was created by the loader, therefore we simply return
         // the input surface handle unmodified. This matches legacy behavior.
-        return VK_SUCCESS;
+        goto out;
     }
 
-    VkResult result = VK_SUCCESS;
     if (icd_term->scanned_icd->interface_version >= ICD_VER_SUPPORTS_ICD_SURFACE_KHR) {
         VkAllocationCallbacks *pAllocator = icd_surface->callbacks_valid ? &icd_surface->callbacks : NULL;
         if (VK_NULL_HANDLE == icd_term->surface_list.list[icd_surface->surface_index]) {
@@ -258,6 +262,8 @@ VkResult wsi_unwrap_icd_surface(struct loader_icd_term *icd_term, VkSurfaceKHR *
         *surface = icd_term->surface_list.list[icd_surface->surface_index];
     }
 
+out:
+    loader_platform_thread_unlock_mutex(surface_lock);
     return result;
 }
 
@@ -327,6 +333,7 @@ VKAPI_ATTR void VKAPI_CALL terminator_DestroySurfaceKHR(VkInstance instance, VkS
             return;
         }
 #endif  // VK_USE_PLATFORM_MACOS_MVK
+        loader_platform_thread_lock_mutex(&loader_inst->surface_lock);
         for (struct loader_icd_term *icd_term = loader_inst->icd_terms; icd_term != NULL; icd_term = icd_term->next) {
             if (icd_term->enabled_instance_extensions.khr_surface &&
                 icd_term->scanned_icd->interface_version >= ICD_VER_SUPPORTS_ICD_SURFACE_KHR &&
@@ -344,10 +351,12 @@ VKAPI_ATTR void VKAPI_CALL terminator_DestroySurfaceKHR(VkInstance instance, VkS
                        (VkSurfaceKHR)(uintptr_t)NULL == icd_term->surface_list.list[icd_surface->surface_index]);
             }
         }
+        loader_release_object_from_list(&loader_inst->surfaces_list, icd_surface->surface_index);
+        loader_platform_thread_unlock_mutex(&loader_inst->surface_lock);
+
         if (NULL != icd_surface->create_info) {
             loader_instance_heap_free(loader_inst, icd_surface->create_info);
         }
-        loader_release_object_from_list(&loader_inst->surfaces_list, icd_surface->surface_index);
         loader_instance_heap_free(loader_inst, (void *)(uintptr_t)surface);
     }
 }
@@ -680,18 +689,20 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkQueuePresentKHR(VkQueue queue, co
 VkResult allocate_icd_surface_struct(struct loader_instance *instance, size_t base_size, size_t platform_size,
                                      const VkAllocationCallbacks *pAllocator, VkIcdSurface **out_icd_surface) {
     uint32_t next_index = 0;
-    VkIcdSurface *icd_surface = NULL;
-    VkResult res = loader_get_next_available_entry(instance, &instance->surfaces_list, &next_index, pAllocator);
-    if (res != VK_SUCCESS) {
-        goto out;
+    bool claimed_index = false;
+    VkResult res = VK_SUCCESS;
+    VkIcdSurface *icd_surface = loader_instance_heap_calloc(instance, sizeof(VkIcdSurface), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    if (icd_surface == NULL) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
 
-    // Next, if so, proceed with the implementation of this function:
-    icd_surface = loader_instance_heap_calloc(instance, sizeof(VkIcdSurface), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-    if (icd_surface == NULL) {
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
+    loader_platform_thread_lock_mutex(&instance->surface_lock);
+    res = loader_get_next_available_entry(instance, &instance->surfaces_list, &next_index, pAllocator);
+    if (res != VK_SUCCESS) {
         goto out;
     }
+    claimed_index = true;
+
     // Setup the new sizes and offsets so we can grow the structures in the
     // future without having problems
     icd_surface->base_size = (uint32_t)base_size;
@@ -721,6 +732,10 @@ VkResult allocate_icd_surface_struct(struct loader_instance *instance, size_t ba
 
     *out_icd_surface = icd_surface;
 out:
+    if (res != VK_SUCCESS && claimed_index) {
+        loader_release_object_from_list(&instance->surfaces_list, next_index);
+    }
+    loader_platform_thread_unlock_mutex(&instance->surface_lock);
     if (res != VK_SUCCESS) {
         loader_instance_heap_free(instance, icd_surface);
         // cleanup of icd_term->surface_list is done during instance destruction
@@ -787,6 +802,7 @@ VkResult copy_surface_create_info(struct loader_instance *loader_inst, VkIcdSurf
 void cleanup_surface_creation(struct loader_instance *loader_inst, VkResult result, VkIcdSurface *icd_surface,
                               const VkAllocationCallbacks *pAllocator) {
     if (VK_SUCCESS != result && NULL != icd_surface) {
+        loader_platform_thread_lock_mutex(&loader_inst->surface_lock);
         for (struct loader_icd_term *icd_term = loader_inst->icd_terms; icd_term != NULL; icd_term = icd_term->next) {
             if (icd_term->enabled_instance_extensions.khr_surface && NULL != icd_term->surface_list.list &&
                 icd_term->surface_list.capacity > icd_surface->surface_index * sizeof(VkSurfaceKHR) &&
@@ -802,6 +818,8 @@ void cleanup_surface_creation(struct loader_instance *loader_inst, VkResult resu
                 loader_inst->surfaces_list.list[icd_surface->surface_index].allocation_callbacks = *pAllocator;
             }
         }
+        loader_platform_thread_unlock_mutex(&loader_inst->surface_lock);
+
         if (NULL != icd_surface->create_info) {
             loader_instance_heap_free(loader_inst, icd_surface->create_info);
         }
@@ -832,7 +850,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateWin32SurfaceKHR(VkInstance insta
                                                                 const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // Initialize pSurface to NULL just to be safe.
     *pSurface = VK_NULL_HANDLE;
@@ -869,7 +886,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateWin32SurfaceKHR(VkInstance insta
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
     return result;
 }
 
@@ -936,7 +952,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateWaylandSurfaceKHR(VkInstance ins
                                                                   const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -971,7 +986,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateWaylandSurfaceKHR(VkInstance ins
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1042,7 +1056,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateXcbSurfaceKHR(VkInstance instanc
                                                               const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1077,7 +1090,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateXcbSurfaceKHR(VkInstance instanc
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1151,7 +1163,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateXlibSurfaceKHR(VkInstance instan
                                                                const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1186,7 +1197,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateXlibSurfaceKHR(VkInstance instan
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1259,7 +1269,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDirectFBSurfaceEXT(VkInstance in
                                                                    VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1294,7 +1303,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDirectFBSurfaceEXT(VkInstance in
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1412,7 +1420,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateHeadlessSurfaceEXT(VkInstance in
                                                                    VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1445,7 +1452,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateHeadlessSurfaceEXT(VkInstance in
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1500,7 +1506,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateMacOSSurfaceMVK(VkInstance insta
                                                                 const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1534,7 +1539,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateMacOSSurfaceMVK(VkInstance insta
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1614,7 +1618,6 @@ terminator_CreateStreamDescriptorSurfaceGGP(VkInstance instance, const VkStreamD
                                             const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1648,7 +1651,6 @@ terminator_CreateStreamDescriptorSurfaceGGP(VkInstance instance, const VkStreamD
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1674,7 +1676,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateMetalSurfaceEXT(VkInstance insta
                                                                 const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1708,7 +1709,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateMetalSurfaceEXT(VkInstance insta
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1737,7 +1737,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateScreenSurfaceQNX(VkInstance inst
                                                                  const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1772,7 +1771,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateScreenSurfaceQNX(VkInstance inst
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -1841,7 +1839,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateViSurfaceNN(VkInstance instance,
                                                             const VkAllocationCallbacks *pAllocator, VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -1875,7 +1872,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateViSurfaceNN(VkInstance instance,
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -2151,7 +2147,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDisplayPlaneSurfaceKHR(VkInstanc
                                                                        VkSurfaceKHR *pSurface) {
     VkResult result = VK_SUCCESS;
     VkIcdSurface *icd_surface = NULL;
-    loader_platform_thread_lock_mutex(&loader_lock);
 
     // First, check to ensure the appropriate extension was enabled:
     struct loader_instance *loader_inst = loader_get_instance(instance);
@@ -2192,7 +2187,6 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateDisplayPlaneSurfaceKHR(VkInstanc
 
 out:
     cleanup_surface_creation(loader_inst, result, icd_surface, pAllocator);
-    loader_platform_thread_unlock_mutex(&loader_lock);
 
     return result;
 }
@@ -100,6 +100,10 @@ SHARED_ALIASES = {
     'vkGetPhysicalDeviceExternalFencePropertiesKHR':        'vkGetPhysicalDeviceExternalFenceProperties',
 }
 
+# Device commands which are resolved when the dispatch table is initialized even in the lazy dispatch mode, because the loader
+# checks whether their dispatch table entry is NULL
+LAZY_DISPATCH_EAGER_CMDS = ['vkCreateSwapchainKHR']
+
 PRE_INSTANCE_FUNCTIONS = ['vkEnumerateInstanceExtensionProperties',
                           'vkEnumerateInstanceLayerProperties',
                           'vkEnumerateInstanceVersion']
@@ -141,8 +145,8 @@ def loader_hash_string(s: str) -> int:
 # Raises if any two names in `names` share a hash - used as a generation-time tripwire so that if the
 # Vulkan command set ever grows into a collision, it's caught immediately with a clear message instead of
 # failing to compile with an inscrutable "duplicate case value" error naming neither colliding string (each
-# name in `names` becomes its own `case <hash>u:` label in the generated switch - see OutputLoaderLookupFunc
-# and InstExtensionGPA below).
+# name in `names` becomes its own `case <hash>u:` label in the switch generated by InstExtensionGPA below),
+# or failing to build the perfect hash tables generated by OutputLoaderLookupFunc, which need distinct hashes.
 def check_no_hash_collisions(names, context: str):
     seen = {}
     for name in names:
@@ -150,11 +154,73 @@ def check_no_hash_collisions(names, context: str):
         if h in seen and seen[h] != name:
             raise RuntimeError(
                 f'FNV-1a hash collision in {context}: "{seen[h]}" and "{name}" both hash to {h:#010x}. '
-                'Left unaddressed, this would make the generated switch emit two identical case labels and '
-                'fail to compile with a "duplicate case value" error naming neither string - '
+                'Left unaddressed, this would make a generated switch emit two identical case labels or make it '
+                'impossible to build a perfect hash table containing both names - '
                 'loader_hash_string() (C and Python copies) should be revisited (e.g. a different seed/prime).')
         seen[h] = name
 
+# Average number of names which share a seed in the perfect hash tables below. Smaller values make the seed
+# search faster at the cost of a longer seed array.
+PERFECT_HASH_NAMES_PER_SEED = 2
+
+# Must stay identical to loader_perfect_hash_slot() in loader/loader_common.h, which the generated lookup
+# functions call at runtime to find the slot of a name. HashString.PerfectHashSlotMatchesGenerator in
+# tests/loader_hash_string_tests.cpp catches any divergence.
+def loader_perfect_hash_slot(name_hash: int, seeds, slot_count: int) -> int:
+    x = name_hash ^ ((seeds[name_hash % len(seeds)] * 0x9e3779b9) & 0xFFFFFFFF)
+    x ^= x >> 16
+    x = (x * 0x85ebca6b) & 0xFFFFFFFF
+    x ^= x >> 13
+    return x % slot_count
+
+# Builds a minimal perfect hash table (hash and displace) for `names`: every name is put into one of the
+# buckets selected by its hash, then each bucket, largest first, gets the smallest seed which moves all of
+# its names into distinct slots which are still free. Returns the seed of every bucket and, for every slot,
+# the index into `names` of the name stored there.
+def build_perfect_hash(names, context: str):
+    check_no_hash_collisions(names, context)
+    hashes = [loader_hash_string(name) for name in names]
+    slot_count = len(names)
+    seed_count = max(1, (slot_count + PERFECT_HASH_NAMES_PER_SEED - 1) // PERFECT_HASH_NAMES_PER_SEED)
+    buckets = [[] for _ in range(seed_count)]
+    for index, name_hash in enumerate(hashes):
+        buckets[name_hash % seed_count].append(index)
+
+    seeds = [0] * seed_count
+    slots = [None] * slot_count
+    for bucket_index in sorted(range(seed_count), key=lambda b: len(buckets[b]), reverse=True):
+        bucket = buckets[bucket_index]
+        if len(bucket) == 0:
+            break
+        for seed in range(0x10000):
+            seeds[bucket_index] = seed
+            candidates = [loader_perfect_hash_slot(hashes[index], seeds, slot_count) for index in bucket]
+            if len(set(candidates)) == len(candidates) and all(slots[slot] is None for slot in candidates):
+                for index, slot in zip(bucket, candidates):
+                    slots[slot] = index
+                break
+        else:
+            raise RuntimeError(
+                f'Could not find a perfect hash seed for {[names[index] for index in bucket]} in {context} - '
+                'lower PERFECT_HASH_NAMES_PER_SEED.')
+    return seeds, slots
+
+# Appends the seed array of a perfect hash table built by build_perfect_hash()
+def output_perfect_hash_seeds(out, array_name: str, seeds):
+    out.append(f'static const uint16_t {array_name}[{len(seeds)}] = {{\n')
+    for i in range(0, len(seeds), 16):
+        out.append('    ' + ' '.join(f'{seed},' for seed in seeds[i:i + 16]) + '\n')
+    out.append('};\n\n')
+
+# A command stored in the perfect hash tables of loader_lookup_{device,instance}_dispatch_table
+class DispatchLookupEntry:
+    def __init__(self, base_name: str, protect, api_version, trampoline_enable, lazy: bool):
+        self.base_name = base_name                  # Command name without the leading 'vk'
+        self.protect = protect                      # Platform define guarding the command, or None
+        self.api_version = api_version              # e.g. 'VK_API_VERSION_1_1' for device core commands, else None
+        self.trampoline_enable = trampoline_enable  # layer_extensions member gating a must-use-trampoline command, else None
+        self.lazy = lazy                            # Whether the dispatch table entry can hold a lazy dispatch stub
+
 # This class is a container for any source code, data, or other behavior that is necessary to
 # customize the generator script for a specific target API variant (e.g. Vulkan SC). As such,
 # all of these API-specific interfaces and their use in the generator script are part of the
@@ -267,6 +333,7 @@ class LoaderExtensionGenerator(BaseGenerator):
 
 
     def print_vk_loader_extensions_c(self, out):
+        out.append('#include <stddef.h>\n')
         out.append('#include <stdio.h>\n')
         out.append('#include <stdlib.h>\n')
         out.append('#include <string.h>\n')
@@ -278,10 +345,12 @@ class LoaderExtensionGenerator(BaseGenerator):
         out.append('#include "extension_manual.h"\n')
         self.OutputUtilitiesInSource(out)
         self.OutputIcdDispatchTableInit(out)
+        self.OutputLazyDispatchStubs(out)
         self.OutputLoaderDispatchTables(out)
         self.InitDeviceFunctionTerminatorDispatchTable(out)
         self.OutputDeviceFunctionTrampolinePrototypes(out)
         self.OutputLoaderLookupFunc(out)
+        self.OutputCoreTrampolineLookupFunc(out)
         self.CreateTrampTermFuncs(out)
         self.InstExtensionGPA(out)
         self.InstantExtensionCreate(out)
@@ -351,24 +420,28 @@ extern const char *const LOADER_INSTANCE_EXTENSIONS[];
 
 VKAPI_ATTR bool VKAPI_CALL loader_icd_init_entries(struct loader_instance* inst, struct loader_icd_term *icd_term);
 
+// The dispatch table init functions below fill the table with stubs which look up each command the first time it is called
+// instead of looking up every command up front when lazy is true.
+
 // Init Device function pointer dispatch table with core commands
 VKAPI_ATTR void VKAPI_CALL loader_init_device_dispatch_table(struct loader_dev_dispatch_table *dev_table, PFN_vkGetDeviceProcAddr gpa,
-                                                             VkDevice dev);
+                                                             VkDevice dev, bool lazy);
 
 // Init Device function pointer dispatch table with extension commands
 VKAPI_ATTR void VKAPI_CALL loader_init_device_extension_dispatch_table(struct loader_dev_dispatch_table *dev_table,
                                                                        PFN_vkGetInstanceProcAddr gipa,
                                                                        PFN_vkGetDeviceProcAddr gdpa,
                                                                        VkInstance inst,
-                                                                       VkDevice dev);
+                                                                       VkDevice dev,
+                                                                       bool lazy);
 
 // Init Instance function pointer dispatch table with core commands
 VKAPI_ATTR void VKAPI_CALL loader_init_instance_core_dispatch_table(VkLayerInstanceDispatchTable *table, PFN_vkGetInstanceProcAddr gpa,
-                                                                    VkInstance inst);
+                                                                    VkInstance inst, bool lazy);
 
 // Init Instance function pointer dispatch table with core commands
 VKAPI_ATTR void VKAPI_CALL loader_init_instance_extension_dispatch_table(VkLayerInstanceDispatchTable *table, PFN_vkGetInstanceProcAddr gpa,
-                                                                         VkInstance inst);
+                                                                         VkInstance inst, bool lazy);
 
 // Device command lookup function
 VKAPI_ATTR void* VKAPI_CALL loader_lookup_device_dispatch_table(const VkLayerDispatchTable *table, const char *name, bool* name_found);
@@ -377,6 +450,10 @@ VKAPI_ATTR void* VKAPI_CALL loader_lookup_device_dispatch_table(const VkLayerDis
 VKAPI_ATTR void* VKAPI_CALL loader_lookup_instance_dispatch_table(const VkLayerInstanceDispatchTable *table, const char *name,
                                                                   bool *found_name);
 
+// Core command trampoline lookup function, used by trampoline_get_proc_addr. Returns NULL if name is not a core command.
+// name_hash and name_length must come from loader_hash_string_length(name).
+void *loader_lookup_core_trampoline(const char *name, uint32_t name_hash, uint32_t name_length);
+
 ''')
 
     # Creates the prototypes for the loader's core instance command terminators
@@ -599,6 +676,64 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
 
 
     # Creates code to initialize the various dispatch tables
+    # Whether the dispatch table entry of command starts out as a lazy dispatch stub when lazy dispatch is enabled
+    def IsLazyDispatchCommand(self, command) -> bool:
+        base_name = command.name[2:]
+        if base_name in ['CreateInstance', 'CreateDevice', 'EnumerateInstanceExtensionProperties', 'EnumerateInstanceLayerProperties',
+                         'EnumerateInstanceVersion', 'GetInstanceProcAddr', 'GetDeviceProcAddr']:
+            return False
+        if command.name in LAZY_DISPATCH_EAGER_CMDS:
+            return False
+        # Device commands of instance extensions are looked up with vkGetInstanceProcAddr when the table is initialized
+        is_inst_handle_type = command.params[0].type in ['VkInstance', 'VkPhysicalDevice']
+        if not is_inst_handle_type and len(command.extensions) > 0 and self.vk.extensions[command.extensions[0]].instance:
+            return False
+        return True
+
+    def DispatchTableEntryInit(self, command, gpa_call: str) -> str:
+        base_name = command.name[2:]
+        if not self.IsLazyDispatchCommand(command):
+            return f'    table->{base_name} = (PFN_{command.name}){gpa_call};\n'
+        return f'    table->{base_name} = lazy ? (PFN_{command.name})lazy_{base_name} : (PFN_{command.name}){gpa_call};\n'
+
+    #
+    # Create the stubs which the dispatch tables point to until each command is first used in the lazy dispatch mode
+    def OutputLazyDispatchStubs(self, out):
+        out.append('// Lazy dispatch stubs. When lazy dispatch is enabled, dispatch table entries start out pointing at these stubs, which\n')
+        out.append('// look up the real function the first time they are called, replace themselves in the dispatch table and call it.\n')
+
+        # Same order as the dispatch table init functions
+        for cur_type, commands in [('device', self.core_commands), ('device', self.extension_commands),
+                                   ('instance', self.core_commands), ('instance', self.extension_commands)]:
+            current_block = ''
+            for command in commands:
+                is_inst_handle_type = command.params[0].type in ['VkInstance', 'VkPhysicalDevice']
+                if (cur_type == 'instance') != is_inst_handle_type or not self.IsLazyDispatchCommand(command):
+                    continue
+
+                current_block = self.DescribeBlock(command, current_block, out, indent='')
+
+                base_name = command.name[2:]
+                first_param = command.params[0].name
+                if command.params[0].type == 'VkInstance':
+                    resolve = f'loader_lazy_resolve_instance_command({first_param}, offsetof(VkLayerInstanceDispatchTable, {base_name}),'
+                elif command.params[0].type == 'VkPhysicalDevice':
+                    resolve = f'loader_lazy_resolve_physical_device_command({first_param}, offsetof(VkLayerInstanceDispatchTable, {base_name}),'
+                else:
+                    resolve = f'loader_lazy_resolve_device_command(loader_get_dispatch({first_param}), offsetof(VkLayerDispatchTable, {base_name}),'
+
+                if command.protect is not None:
+                    out.append(f'#if defined({command.protect})\n')
+                func_header = command.cPrototype.replace('VKAPI_ATTR', 'static VKAPI_ATTR', 1).replace(';', ' {\n')
+                out.append(func_header.replace(f'VKAPI_CALL {command.name}(', f'VKAPI_CALL lazy_{base_name}('))
+                out.append(f'    PFN_{command.name} fn = (PFN_{command.name}){resolve}\n')
+                out.append(f'        (PFN_vkVoidFunction)lazy_{base_name}, "{command.name}");\n')
+                return_prefix = 'return ' if command.returnType != 'void' else ''
+                out.append(f'    {return_prefix}fn({", ".join(param.name for param in command.params)});\n')
+                out.append('}\n\n')
+                if command.protect is not None:
+                    out.append(f'#endif // {command.protect}\n')
+
     def OutputLoaderDispatchTables(self, out):
         commands = []
         gpa_param = ''
@@ -612,7 +747,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
 
                 out.append('// Init Device function pointer dispatch table with core commands\n')
                 out.append('VKAPI_ATTR void VKAPI_CALL loader_init_device_dispatch_table(struct loader_dev_dispatch_table *dev_table, PFN_vkGetDeviceProcAddr gpa,\n')
-                out.append('                                                             VkDevice dev) {\n')
+                out.append('                                                             VkDevice dev, bool lazy) {\n')
                 out.append('    VkLayerDispatchTable *table = &dev_table->core_dispatch;\n')
                 out.append('    if (table->magic != DEVICE_DISP_TABLE_MAGIC_NUMBER) { abort(); }\n')
                 out.append('    for (uint32_t i = 0; i < MAX_NUM_UNKNOWN_EXTS; i++) dev_table->ext_dispatch[i] = (PFN_vkDevExt)vkDevExtError;\n')
@@ -627,7 +762,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
                 out.append('                                                                       PFN_vkGetInstanceProcAddr gipa,\n')
                 out.append('                                                                       PFN_vkGetDeviceProcAddr gdpa,\n')
                 out.append('                                                                       VkInstance inst,\n')
-                out.append('                                                                       VkDevice dev) {\n')
+                out.append('                                                                       VkDevice dev,\n')
+                out.append('                                                                       bool lazy) {\n')
                 out.append('    VkLayerDispatchTable *table = &dev_table->core_dispatch;\n')
                 out.append('    table->magic = DEVICE_DISP_TABLE_MAGIC_NUMBER;\n')
 
@@ -638,7 +774,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
 
                 out.append('// Init Instance function pointer dispatch table with core commands\n')
                 out.append('VKAPI_ATTR void VKAPI_CALL loader_init_instance_core_dispatch_table(VkLayerInstanceDispatchTable *table, PFN_vkGetInstanceProcAddr gpa,\n')
-                out.append('                                                                    VkInstance inst) {\n')
+                out.append('                                                                    VkInstance inst, bool lazy) {\n')
 
             else:
                 cur_type = 'instance'
@@ -647,7 +783,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
 
                 out.append('// Init Instance function pointer dispatch table with core commands\n')
                 out.append('VKAPI_ATTR void VKAPI_CALL loader_init_instance_extension_dispatch_table(VkLayerInstanceDispatchTable *table, PFN_vkGetInstanceProcAddr gpa,\n')
-                out.append('                                                                        VkInstance inst) {\n')
+                out.append('                                                                        VkInstance inst, bool lazy) {\n')
 
             current_block = ''
             for command in commands:
@@ -677,13 +813,13 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
                         elif len(command.extensions) > 0 and self.vk.extensions[command.extensions[0]].instance:
                             out.append(f'    table->{base_name} = (PFN_{command.name})gipa(inst, "{command.name}");\n')
                         else:
-                            out.append(f'    table->{base_name} = (PFN_{command.name})gdpa(dev, "{command.name}");\n')
+                            out.append(self.DispatchTableEntryInit(command, f'gdpa(dev, "{command.name}")'))
                     elif (x < 1 and base_name == 'GetDeviceProcAddr'):
                         out.append('    table->GetDeviceProcAddr = gpa;\n')
                     elif (x > 1 and base_name == 'GetInstanceProcAddr'):
                         out.append('    table->GetInstanceProcAddr = gpa;\n')
                     else:
-                        out.append(f'    table->{base_name} = (PFN_{command.name})gpa({gpa_param}, "{command.name}");\n')
+                        out.append(self.DispatchTableEntryInit(command, f'gpa({gpa_param}, "{command.name}")'))
 
                     if command.protect is not None:
                         out.append(f'#endif // {command.protect}\n')
@@ -738,103 +874,166 @@ VKAPI_ATTR VkResult VKAPI_CALL vkDevExtError(VkDevice dev) {
     #
     # Create a lookup table function from the appropriate list of entrypoints
     def OutputLoaderLookupFunc(self, out):
-        commands = []
-        cur_type = ''
-
-        for x in range(0, 2):
-            if x == 0:
-                cur_type = 'device'
+        for cur_type in ['device', 'instance']:
+            entries = []
+            for command_list in [self.core_commands, self.extension_commands]:
+                for command in command_list:
+                    is_inst_handle_type = command.params[0].type in ['VkInstance', 'VkPhysicalDevice']
+                    if not ((cur_type == 'instance' and is_inst_handle_type) or (cur_type == 'device' and not is_inst_handle_type)):
+                        continue
 
-                out.append('// Device command lookup function\n')
-                out.append('VKAPI_ATTR void* VKAPI_CALL loader_lookup_device_dispatch_table(const VkLayerDispatchTable *table, const char *name, bool* found_name) {\n')
-                out.append('    if (!name || name[0] != \'v\' || name[1] != \'k\') {\n')
-                out.append('        *found_name = false;\n')
-                out.append('        return NULL;\n')
-                out.append('    }\n')
-                out.append('\n')
-                out.append('    name += 2;\n')
-                out.append('    *found_name = true;\n')
-                out.append('    struct loader_device* dev = (struct loader_device *)table;\n')
-                out.append('    const struct loader_instance* inst = dev->phys_dev_term->this_icd_term->this_instance;\n')
-                out.append('    uint32_t api_version = VK_MAKE_API_VERSION(0, inst->app_api_version.major, inst->app_api_version.minor, inst->app_api_version.patch);\n')
-                out.append('    const uint32_t name_hash = loader_hash_string(name);\n')
-                out.append('\n')
-            else:
-                cur_type = 'instance'
+                    # Remove 'vk' from proto name
+                    base_name = command.name[2:]
 
-                out.append('// Instance command lookup function\n')
-                out.append('VKAPI_ATTR void* VKAPI_CALL loader_lookup_instance_dispatch_table(const VkLayerInstanceDispatchTable *table, const char *name,\n')
-                out.append('                                                                 bool *found_name) {\n')
-                out.append('    if (!name || name[0] != \'v\' || name[1] != \'k\') {\n')
-                out.append('        *found_name = false;\n')
-                out.append('        return NULL;\n')
-                out.append('    }\n')
-                out.append('\n')
-                out.append('    *found_name = true;\n')
-                out.append('    name += 2;\n')
-                out.append('    const uint32_t name_hash = loader_hash_string(name);\n')
+                    if (base_name == 'CreateInstance' or base_name == 'CreateDevice' or
+                        base_name == 'EnumerateInstanceExtensionProperties' or
+                        base_name == 'EnumerateInstanceLayerProperties' or
+                        base_name == 'EnumerateInstanceVersion'):
+                        continue
 
-            out.append('    switch (name_hash) {\n')
+                    api_version = None
+                    if cur_type == 'device' and len(command.extensions) == 0:
+                        effective_version_name = APISpecific.getEffectiveVersionName(self.targetApiName, command.version)
+                        api_version = effective_version_name.replace('_VERSION_', '_API_VERSION_')
 
-            base_names_for_collision_check = []
-            for command_list in [self.core_commands, self.extension_commands]:
-                commands = command_list
+                    trampoline_enable = None
+                    if command.name in DEVICE_CMDS_MUST_USE_TRAMP:
+                        trampoline_enable = f'{command.extensions[0][3:].lower()}_enabled'
 
-                version_check = ''
-                current_block = ''
-                for command in commands:
-                    is_inst_handle_type = command.params[0].type in ['VkInstance', 'VkPhysicalDevice']
-                    if ((cur_type == 'instance' and is_inst_handle_type) or (cur_type == 'device' and not is_inst_handle_type)):
-
-                        current_block = self.DescribeBlock(command, current_block, out, indent='        ')
-                        if len(command.extensions) == 0:
-                            if cur_type == 'device':
-                                effective_version_name = APISpecific.getEffectiveVersionName(self.targetApiName, command.version)
-                                api_version = effective_version_name.replace('_VERSION_', '_API_VERSION_')
-                                version_check = f"                if (dev->should_ignore_device_commands_from_newer_version && api_version < {api_version}) return NULL;\n"
-                            else:
-                                version_check = ''
-
-                        # Remove 'vk' from proto name
-                        base_name = command.name[2:]
-
-                        if (base_name == 'CreateInstance' or base_name == 'CreateDevice' or
-                            base_name == 'EnumerateInstanceExtensionProperties' or
-                            base_name == 'EnumerateInstanceLayerProperties' or
-                            base_name == 'EnumerateInstanceVersion'):
-                            continue
-
-                        if command.protect is not None:
-                            out.append(f'#if defined({command.protect})\n')
-
-                        base_names_for_collision_check.append(base_name)
-                        out.append(f'        case {loader_hash_string(base_name):#010x}u:\n')
-                        out.append(f'            if (!strcmp(name, "{base_name}")) ')
-                        if command.name in DEVICE_CMDS_MUST_USE_TRAMP:
-                            if version_check != '':
-                                out.append(f'{{\n{version_check}                return dev->layer_extensions.{command.extensions[0][3:].lower()}_enabled ? (void *){base_name} : NULL;\n            }}\n')
-                            else:
-                                out.append(f'return dev->layer_extensions.{command.extensions[0][3:].lower()}_enabled ? (void *){base_name} : NULL;\n')
+                    entries.append(DispatchLookupEntry(base_name, command.protect, api_version, trampoline_enable,
+                                                       self.IsLazyDispatchCommand(command)))
 
-                        else:
-                            if version_check != '':
-                                out.append(f'{{\n{version_check}                return (void *)table->{base_name};\n            }}\n')
-                            else:
-                                out.append(f'return (void *)table->{base_name};\n')
-                        out.append('            break;\n')
+            self.OutputDispatchLookupTable(out, cur_type, entries)
 
-                        if command.protect is not None:
-                            out.append(f'#endif // {command.protect}\n')
+    #
+    # Create the perfect hash table and lookup function for the given list of dispatch table commands
+    def OutputDispatchLookupTable(self, out, cur_type: str, entries):
+        table_type = 'VkLayerDispatchTable' if cur_type == 'device' else 'VkLayerInstanceDispatchTable'
+        seeds, slots = build_perfect_hash([entry.base_name for entry in entries], f'loader_lookup_{cur_type}_dispatch_table')
+
+        if cur_type == 'device':
+            out.append('// Minimal perfect hash tables used to look up commands by name. loader_perfect_hash_slot() maps the hash of a\n')
+            out.append('// name to the only slot it can be stored in, so a lookup needs a single length-checked comparison. Slots of\n')
+            out.append('// commands from platforms which are not enabled have a NULL name.\n')
+            out.append('struct loader_dispatch_lookup_entry {\n')
+            out.append('    const char *name;       // Command name without the \'vk\' prefix\n')
+            out.append('    uint16_t name_length;\n')
+            out.append('    uint16_t table_offset;  // Offset of the command in the dispatch table\n')
+            out.append('    uint32_t api_version;   // Core version which added a device command, 0 for everything else\n')
+            out.append('};\n\n')
+
+        output_perfect_hash_seeds(out, f'{cur_type}_dispatch_lookup_seeds', seeds)
+        out.append(f'static const struct loader_dispatch_lookup_entry {cur_type}_dispatch_lookup_table[{len(slots)}] = {{\n')
+        for index in slots:
+            entry = entries[index]
+            if entry.protect is not None:
+                out.append(f'#if defined({entry.protect})\n')
+            out.append(f'    {{"{entry.base_name}", {len(entry.base_name)}, offsetof({table_type}, {entry.base_name}), '
+                       f'{entry.api_version if entry.api_version is not None else 0}}},\n')
+            if entry.protect is not None:
+                out.append('#else\n')
+                out.append('    {NULL, 0, 0, 0},\n')
+                out.append(f'#endif // {entry.protect}\n')
+        out.append('};\n\n')
 
-            check_no_hash_collisions(base_names_for_collision_check, f'loader_lookup_{cur_type}_dispatch_table')
+        if cur_type == 'device':
+            # Device dispatch tables are handed out by vkGetDeviceProcAddr, so lazy dispatch stubs must be resolved before
+            # returning them. Instance lookups only ever see the terminator tables, which never hold stubs.
+            out.append('// Lazy dispatch stub of each slot, which is resolved before being returned by the lookup\n')
+            out.append(f'static const PFN_vkVoidFunction device_dispatch_lookup_lazy_stubs[{len(slots)}] = {{\n')
+            for index in slots:
+                entry = entries[index]
+                if not entry.lazy:
+                    out.append('    NULL,\n')
+                    continue
+                if entry.protect is not None:
+                    out.append(f'#if defined({entry.protect})\n')
+                out.append(f'    (PFN_vkVoidFunction)lazy_{entry.base_name},\n')
+                if entry.protect is not None:
+                    out.append('#else\n')
+                    out.append('    NULL,\n')
+                    out.append(f'#endif // {entry.protect}\n')
+            out.append('};\n\n')
+
+            out.append('// Device command lookup function\n')
+            out.append('VKAPI_ATTR void* VKAPI_CALL loader_lookup_device_dispatch_table(const VkLayerDispatchTable *table, const char *name, bool* found_name) {\n')
+        else:
+            out.append('// Instance command lookup function\n')
+            out.append('VKAPI_ATTR void* VKAPI_CALL loader_lookup_instance_dispatch_table(const VkLayerInstanceDispatchTable *table, const char *name,\n')
+            out.append('                                                                 bool *found_name) {\n')
+        out.append('    if (!name || name[0] != \'v\' || name[1] != \'k\') {\n')
+        out.append('        *found_name = false;\n')
+        out.append('        return NULL;\n')
+        out.append('    }\n')
+        out.append('\n')
+        out.append('    name += 2;\n')
+        out.append('    uint32_t name_length = 0;\n')
+        out.append('    const uint32_t name_hash = loader_hash_string_length(name, &name_length);\n')
+        out.append(f'    const uint32_t slot = loader_perfect_hash_slot(name_hash, {cur_type}_dispatch_lookup_seeds, {len(seeds)}, {len(slots)});\n')
+        out.append(f'    const struct loader_dispatch_lookup_entry *entry = &{cur_type}_dispatch_lookup_table[slot];\n')
+        out.append('    if (NULL == entry->name || entry->name_length != name_length || memcmp(name, entry->name, name_length) != 0) {\n')
+        out.append('        *found_name = false;\n')
+        out.append('        return NULL;\n')
+        out.append('    }\n')
+        out.append('\n')
+        out.append('    *found_name = true;\n')
+        if cur_type == 'device':
+            out.append('    struct loader_device* dev = (struct loader_device *)table;\n')
+            out.append('    const struct loader_instance* inst = dev->phys_dev_term->this_icd_term->this_instance;\n')
+            out.append('    uint32_t api_version = VK_MAKE_API_VERSION(0, inst->app_api_version.major, inst->app_api_version.minor, inst->app_api_version.patch);\n')
+            out.append('    if (dev->should_ignore_device_commands_from_newer_version && api_version < entry->api_version) return NULL;\n')
+            out.append('\n')
+            out.append('    // These commands must always go through their trampoline\n')
+            out.append('    switch (slot) {\n')
+            for slot, index in enumerate(slots):
+                entry = entries[index]
+                if entry.trampoline_enable is not None:
+                    out.append(f'        case {slot}:\n')
+                    out.append(f'            return dev->layer_extensions.{entry.trampoline_enable} ? (void *){entry.base_name} : NULL;\n')
             out.append('        default:\n')
             out.append('            break;\n')
             out.append('    }\n')
             out.append('\n')
-            out.append('    *found_name = false;\n')
-            out.append('    return NULL;\n')
-            out.append('}\n\n')
+        if cur_type == 'device':
+            out.append('    // Lazy dispatch stubs are replaced in the table while other threads may be looking them up\n')
+            out.append('    void *addr = loader_platform_atomic_load_pointer((void *const *)((const char *)table + entry->table_offset));\n')
+            out.append('    if (NULL != addr && addr == (void *)device_dispatch_lookup_lazy_stubs[slot]) {\n')
+            out.append('        addr = (void *)loader_lazy_resolve_device_command(table, entry->table_offset, device_dispatch_lookup_lazy_stubs[slot],\n')
+            out.append('                                                          name - 2);\n')
+            out.append('    }\n')
+            out.append('    return addr;\n')
+        else:
+            out.append('    return loader_platform_atomic_load_pointer((void *const *)((const char *)table + entry->table_offset));\n')
+        out.append('}\n\n')
+
+    #
+    # Create the lookup function for the core command trampolines returned by trampoline_get_proc_addr
+    def OutputCoreTrampolineLookupFunc(self, out):
+        # Don't include global functions
+        names = [command.name for command in self.core_commands if command.name not in ADD_INST_CMDS]
+        self.OutputCoreTrampolineLookupTable(out, names)
+
+    def OutputCoreTrampolineLookupTable(self, out, names):
+        seeds, slots = build_perfect_hash(names, 'loader_lookup_core_trampoline')
+
+        out.append('struct loader_trampoline_lookup_entry {\n')
+        out.append('    const char *name;\n')
+        out.append('    uint32_t name_length;\n')
+        out.append('    PFN_vkVoidFunction trampoline;\n')
+        out.append('};\n\n')
+        output_perfect_hash_seeds(out, 'core_trampoline_lookup_seeds', seeds)
+        out.append(f'static const struct loader_trampoline_lookup_entry core_trampoline_lookup_table[{len(slots)}] = {{\n')
+        for index in slots:
+            out.append(f'    {{"{names[index]}", {len(names[index])}, (PFN_vkVoidFunction){names[index]}}},\n')
+        out.append('};\n\n')
 
+        out.append('// Core command trampoline lookup function\n')
+        out.append('void *loader_lookup_core_trampoline(const char *name, uint32_t name_hash, uint32_t name_length) {\n')
+        out.append(f'    const uint32_t slot = loader_perfect_hash_slot(name_hash, core_trampoline_lookup_seeds, {len(seeds)}, {len(slots)});\n')
+        out.append('    const struct loader_trampoline_lookup_entry *entry = &core_trampoline_lookup_table[slot];\n')
+        out.append('    if (entry->name_length != name_length || memcmp(name, entry->name, name_length) != 0) return NULL;\n')
+        out.append('    return (void *)entry->trampoline;\n')
+        out.append('}\n\n')
 
     #
     # Create the appropriate trampoline (and possibly terminator) functions
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2026 The Khronos Group Inc.
+ * Copyright (c) 2026 Valve Corporation
+ * Copyright (c) 2026 LunarG, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and/or associated documentation files (the "Materials"), to
+ * deal in the Materials without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Materials, and to permit persons to whom the Materials are
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice(s) and this permission notice shall be included in
+ * all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE MATERIALS OR THE
+ * USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+// Micro-benchmarks of the loader's entry points. They run against the test drivers and layers on the shimmed filesystem, so the
+// numbers only depend on the loader and not on what happens to be installed on the machine.
+//
+// Every benchmark is a googletest test so that the framework's assertions work as usual. The options below are parsed from the
+// command line after googletest removed its own:
+//   --iterations=<n>  samples taken per benchmark, default 100
+//   --layers=<n>      explicit layers enabled on every instance, default 2
+//   --drivers=<n>     drivers, each with one physical device, default 2
+//   --json=<path>     also write the results to path, for tracking regressions between builds
+
+#include "test_environment.h"
+
+extern "C" {
+#include "loader_common.h"
+#include "gpa_helper.h"
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+#include "util/json_writer.h"
+
+struct BenchmarkOptions {
+    uint32_t iterations = 100;
+    uint32_t layer_count = 2;
+    uint32_t driver_count = 2;
+    std::filesystem::path json_path;
+};
+BenchmarkOptions options;
+
+struct BenchmarkResult {
+    std::string name;
+    uint32_t calls_per_sample = 1;
+    std::vector<double> samples;  // nanoseconds per call, sorted
+};
+std::vector<BenchmarkResult> results;
+
+// Nearest-rank percentile of sorted samples
+double percentile(std::vector<double> const& samples, double percent) {
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * static_cast<double>(samples.size())));
+    return samples[rank == 0 ? 0 : rank - 1];
+}
+
+double mean(std::vector<double> const& samples) {
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+}
+
+// Times func, which makes calls_per_sample calls to whatever is being measured. Cheap functions need many calls per sample to
+// be measurable with the clock. A few warm up runs come first so that libraries are loaded and caches are filled like they would
+// be in an application which already made the same calls.
+template <typename Func>
+void measure(std::string const& name, uint32_t calls_per_sample, Func&& func) {
+    uint32_t warm_up_iterations = std::max(1U, options.iterations / 10);
+    for (uint32_t i = 0; i < warm_up_iterations; i++) {
+        func();
+    }
+    BenchmarkResult result{name, calls_per_sample, {}};
+    result.samples.reserve(options.iterations);
+    for (uint32_t i = 0; i < options.iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        result.samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / calls_per_sample);
+    }
+    // Numbers from a run where the calls failed aren't worth reporting
+    if (::testing::Test::HasFailure()) {
+        return;
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+
+    std::cout << std::left << std::setw(52) << name << std::right << std::fixed << std::setprecision(3);
+    for (double percent : {50.0, 90.0, 99.0}) {
+        std::cout << std::setw(12) << percentile(result.samples, percent) / 1000.0;
+    }
+    std::cout << std::setw(12) << result.samples.back() / 1000.0 << " us\n";
+    results.push_back(std::move(result));
+}
+
+// options.driver_count drivers with one physical device each and options.layer_count explicit layers
+struct BenchmarkEnvironment {
+    BenchmarkEnvironment() : env(FrameworkSettings{}.set_log_filter("")) {
+        for (uint32_t i = 0; i < options.driver_count; i++) {
+            env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_" + std::to_string(i));
+        }
+        for (uint32_t i = 0; i < options.layer_count; i++) {
+            layer_names.push_back("VK_LAYER_benchmark_layer_" + std::to_string(i));
+            env.add_explicit_layer({}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                     .set_name(layer_names.back())
+                                                                     .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+        }
+    }
+
+    void enable_layers(InstWrapper& inst) {
+        for (auto const& layer_name : layer_names) {
+            inst.create_info.add_layer(layer_name.c_str());
+        }
+    }
+
+    FrameworkEnvironment env;
+    std::vector<std::string> layer_names;
+};
+
+TEST(Benchmark, CreateDestroyInstance) {
+    BenchmarkEnvironment bench{};
+    measure("vkCreateInstance + vkDestroyInstance", 1, [&]() {
+        InstWrapper inst{bench.env.vulkan_functions};
+        bench.enable_layers(inst);
+        inst.CheckCreate();
+    });
+}
+
+TEST(Benchmark, EnumerateInstanceProperties) {
+    BenchmarkEnvironment bench{};
+    auto& functions = bench.env.vulkan_functions;
+    measure("vkEnumerateInstanceExtensionProperties", 10, [&]() {
+        for (uint32_t i = 0; i < 10; i++) {
+            uint32_t count = 0;
+            ASSERT_EQ(VK_SUCCESS, functions.vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr));
+            std::vector<VkExtensionProperties> properties(count);
+            ASSERT_EQ(VK_SUCCESS, functions.vkEnumerateInstanceExtensionProperties(nullptr, &count, properties.data()));
+        }
+    });
+    measure("vkEnumerateInstanceLayerProperties", 10, [&]() {
+        for (uint32_t i = 0; i < 10; i++) {
+            uint32_t count = 0;
+            ASSERT_EQ(VK_SUCCESS, functions.vkEnumerateInstanceLayerProperties(&count, nullptr));
+            std::vector<VkLayerProperties> properties(count);
+            ASSERT_EQ(VK_SUCCESS, functions.vkEnumerateInstanceLayerProperties(&count, properties.data()));
+        }
+    });
+    measure("vkEnumerateInstanceVersion", 10, [&]() {
+        for (uint32_t i = 0; i < 10; i++) {
+            uint32_t version = 0;
+            ASSERT_EQ(VK_SUCCESS, functions.vkEnumerateInstanceVersion(&version));
+        }
+    });
+}
+
+TEST(Benchmark, EnumeratePhysicalDeviceProperties) {
+    BenchmarkEnvironment bench{};
+    InstWrapper inst{bench.env.vulkan_functions};
+    bench.enable_layers(inst);
+    inst.CheckCreate();
+    VkPhysicalDevice physical_device = inst.GetPhysDev();
+
+    measure("vkEnumeratePhysicalDevices", 100, [&]() {
+        for (uint32_t i = 0; i < 100; i++) {
+            uint32_t count = 0;
+            ASSERT_EQ(VK_SUCCESS, inst->vkEnumeratePhysicalDevices(inst, &count, nullptr));
+            std::vector<VkPhysicalDevice> physical_devices(count);
+            ASSERT_EQ(VK_SUCCESS, inst->vkEnumeratePhysicalDevices(inst, &count, physical_devices.data()));
+        }
+    });
+    measure("vkEnumerateDeviceExtensionProperties", 100, [&]() {
+        for (uint32_t i = 0; i < 100; i++) {
+            uint32_t count = 0;
+            ASSERT_EQ(VK_SUCCESS, inst->vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &count, nullptr));
+            std::vector<VkExtensionProperties> properties(count);
+            ASSERT_EQ(VK_SUCCESS,
+                      inst->vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &count, properties.data()));
+        }
+    });
+}
+
+TEST(Benchmark, GetInstanceProcAddr) {
+    BenchmarkEnvironment bench{};
+    InstWrapper inst{bench.env.vulkan_functions};
+    bench.enable_layers(inst);
+    inst.CheckCreate();
+
+    // Without an instance only the global functions can be queried
+    measure("vkGetInstanceProcAddr(NULL, core)", 1000, [&]() {
+        for (uint32_t i = 0; i < 1000; i++) {
+            ASSERT_NE(nullptr, inst->vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkCreateInstance"));
+        }
+    });
+    measure("vkGetInstanceProcAddr(instance, core)", 1000, [&]() {
+        for (uint32_t i = 0; i < 1000; i++) {
+            ASSERT_NE(nullptr, inst->vkGetInstanceProcAddr(inst, "vkGetPhysicalDeviceProperties"));
+        }
+    });
+    // Unknown names are passed down the chain of layers and drivers before the loader gives up on them
+    measure("vkGetInstanceProcAddr(instance, unknown)", 1000, [&]() {
+        for (uint32_t i = 0; i < 1000; i++) {
+            inst->vkGetInstanceProcAddr(inst, "vkBenchmarkUnknownFunctionEXT");
+        }
+    });
+}
+
+TEST(Benchmark, GetDeviceProcAddr) {
+    BenchmarkEnvironment bench{};
+    InstWrapper inst{bench.env.vulkan_functions};
+    bench.enable_layers(inst);
+    inst.CheckCreate();
+    DeviceWrapper dev{inst};
+    dev.CheckCreate(inst.GetPhysDev());
+
+    measure("vkGetDeviceProcAddr(device, core)", 1000, [&]() {
+        for (uint32_t i = 0; i < 1000; i++) {
+            ASSERT_NE(nullptr, dev->vkGetDeviceProcAddr(dev, "vkQueueSubmit"));
+        }
+    });
+    measure("vkGetDeviceProcAddr(device, unknown)", 1000, [&]() {
+        for (uint32_t i = 0; i < 1000; i++) {
+            dev->vkGetDeviceProcAddr(dev, "vkBenchmarkUnknownFunctionEXT");
+        }
+    });
+}
+
+// Resolving the names an application typically loads right after creating a device, one vkGetDeviceProcAddr call per name
+// compared to a single call of the loader-private batch entry point
+TEST(Benchmark, GetDeviceProcAddrBatch) {
+    BenchmarkEnvironment bench{};
+    InstWrapper inst{bench.env.vulkan_functions};
+    bench.enable_layers(inst);
+    inst.CheckCreate();
+    DeviceWrapper dev{inst};
+    dev.CheckCreate(inst.GetPhysDev());
+
+    PFN_vk_loaderGetDeviceProcAddrs GetDeviceProcAddrs = inst.load(VK_LOADER_GET_DEVICE_PROC_ADDRS_NAME);
+    ASSERT_NE(nullptr, GetDeviceProcAddrs);
+
+    const std::vector<const char*> names = {
+        "vkDestroyDevice", "vkGetDeviceQueue", "vkQueueSubmit", "vkQueueWaitIdle", "vkDeviceWaitIdle", "vkAllocateMemory",
+        "vkFreeMemory", "vkMapMemory", "vkUnmapMemory", "vkCreateBuffer", "vkDestroyBuffer", "vkCreateImage", "vkDestroyImage",
+        "vkCreateCommandPool", "vkDestroyCommandPool", "vkAllocateCommandBuffers", "vkBeginCommandBuffer", "vkEndCommandBuffer",
+        "vkCmdDraw", "vkCmdDispatch", "vkCreateFence", "vkDestroyFence", "vkWaitForFences", "vkResetFences", "vkCreateSemaphore",
+        "vkDestroySemaphore", "vkCreatePipelineLayout", "vkCreateShaderModule", "vkCreateGraphicsPipelines", "vkDestroyPipeline",
+        "vkBenchmarkUnknownFunctionEXT", "vkCmdPipelineBarrier"};
+    const uint32_t name_count = static_cast<uint32_t>(names.size());
+    std::vector<PFN_vkVoidFunction> functions(names.size());
+
+    measure("vkGetDeviceProcAddr, 32 names", 100, [&]() {
+        for (uint32_t i = 0; i < 100; i++) {
+            for (uint32_t j = 0; j < name_count; j++) {
+                functions[j] = dev->vkGetDeviceProcAddr(dev, names[j]);
+            }
+        }
+    });
+    measure("vk_loaderGetDeviceProcAddrs, 32 names", 100, [&]() {
+        for (uint32_t i = 0; i < 100; i++) {
+            GetDeviceProcAddrs(dev, name_count, names.data(), functions.data());
+        }
+    });
+}
+
+TEST(Benchmark, CreateDestroyDevice) {
+    BenchmarkEnvironment bench{};
+    InstWrapper inst{bench.env.vulkan_functions};
+    bench.enable_layers(inst);
+    inst.CheckCreate();
+    VkPhysicalDevice physical_device = inst.GetPhysDev();
+
+    measure("vkCreateDevice + vkDestroyDevice", 1, [&]() {
+        DeviceWrapper dev{inst};
+        dev.CheckCreate(physical_device);
+    });
+}
+
+VKAPI_ATTR void VKAPI_CALL benchmark_unknown_function(VkPhysicalDevice) {}
+
+// Looking up functions the loader knows nothing about, which it hands out trampolines for. Both kinds share a limit of 250
+// unknown names per instance.
+TEST(Benchmark, GetInstanceProcAddrUnknownFunctions) {
+    const uint32_t function_count = 200;
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    auto& physical_device = env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA).add_and_get_physical_device({});
+    std::vector<std::string> physical_device_names;
+    std::vector<std::string> device_names;
+    for (uint32_t i = 0; i < function_count; i++) {
+        physical_device_names.push_back("vkBenchmarkPhysicalDeviceFunction" + std::to_string(i) + "EXT");
+        physical_device.add_custom_physical_device_function(
+            {physical_device_names.back(), reinterpret_cast<PFN_vkVoidFunction>(benchmark_unknown_function)});
+        device_names.push_back("vkBenchmarkDeviceFunction" + std::to_string(i) + "EXT");
+        physical_device.add_device_function(
+            {device_names.back(), reinterpret_cast<PFN_vkVoidFunction>(benchmark_unknown_function)});
+    }
+    InstWrapper inst{env.vulkan_functions};
+    inst.CheckCreate();
+
+    measure("vkGetInstanceProcAddr, 200 unknown phys dev names", function_count, [&]() {
+        for (auto const& name : physical_device_names) {
+            ASSERT_NE(nullptr, inst->vkGetInstanceProcAddr(inst, name.c_str()));
+        }
+    });
+    measure("vkGetInstanceProcAddr, 200 unknown device names", function_count, [&]() {
+        for (auto const& name : device_names) {
+            ASSERT_NE(nullptr, inst->vkGetInstanceProcAddr(inst, name.c_str()));
+        }
+    });
+}
+
+// Finding a few hundred layer manifests, with them read and parsed on the calling thread and on worker threads
+TEST(Benchmark, ParseLayerManifests) {
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_0");
+    for (uint32_t i = 0; i < 300; i++) {
+        env.add_explicit_layer(ManifestOptions{}.set_json_name("explicit_layer_" + std::to_string(i) + ".json"),
+                               ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_explicit_" + std::to_string(i))
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    }
+    auto& functions = env.vulkan_functions;
+    auto enumerate_layers = [&]() {
+        uint32_t count = 0;
+        ASSERT_EQ(VK_SUCCESS, functions.vkEnumerateInstanceLayerProperties(&count, nullptr));
+        ASSERT_EQ(300U, count);
+    };
+    measure("Parse 300 layer manifests", 1, enumerate_layers);
+    EnvVarWrapper worker_threads_env_var{"VK_LOADER_WORKER_THREADS", "8"};
+    measure("Parse 300 layer manifests, 8 worker threads", 1, enumerate_layers);
+}
+
+void write_json_results(std::filesystem::path const& path) {
+    JsonWriter writer;
+    writer.StartObject();
+    writer.AddKeyedInteger("iterations", options.iterations);
+    writer.AddKeyedInteger("layer_count", options.layer_count);
+    writer.AddKeyedInteger("driver_count", options.driver_count);
+    writer.StartKeyedArray("benchmarks");
+    for (auto const& result : results) {
+        writer.StartObject();
+        writer.AddKeyedString("name", result.name);
+        writer.AddKeyedInteger("calls_per_sample", result.calls_per_sample);
+        writer.AddKeyedNumber("min_ns", result.samples.front());
+        writer.AddKeyedNumber("mean_ns", mean(result.samples));
+        writer.AddKeyedNumber("p50_ns", percentile(result.samples, 50.0));
+        writer.AddKeyedNumber("p90_ns", percentile(result.samples, 90.0));
+        writer.AddKeyedNumber("p99_ns", percentile(result.samples, 99.0));
+        writer.AddKeyedNumber("max_ns", result.samples.back());
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    std::ofstream file{path};
+    file << writer.output << '\n';
+}
+
+// Parses "--name=<value>" into value
+bool parse_option(const char* arg, const char* name, std::string& value) {
+    std::string prefix = std::string("--") + name + "=";
+    if (std::string(arg).rfind(prefix, 0) != 0) {
+        return false;
+    }
+    value = arg + prefix.size();
+    return true;
+}
+
+bool parse_count(std::string const& value, uint32_t& count) {
+    char* end = nullptr;
+    unsigned long parsed = std::strtoul(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || parsed > UINT32_MAX) {
+        return false;
+    }
+    count = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // make sure the benchmarks don't find these env-vars if they were set on the system
+    EnvVarWrapper vk_icd_filenames_env_var{"VK_ICD_FILENAMES"};
+    EnvVarWrapper vk_driver_files_env_var{"VK_DRIVER_FILES"};
+    EnvVarWrapper vk_add_driver_files_env_var{"VK_ADD_DRIVER_FILES"};
+    EnvVarWrapper vk_layer_path_env_var{"VK_LAYER_PATH"};
+    EnvVarWrapper vk_add_layer_path_env_var{"VK_ADD_LAYER_PATH"};
+    EnvVarWrapper vk_implicit_layer_path_env_var{"VK_IMPLICIT_LAYER_PATH"};
+    EnvVarWrapper vk_add_implicit_layer_path_env_var{"VK_ADD_IMPLICIT_LAYER_PATH"};
+    EnvVarWrapper vk_instance_layers_env_var{"VK_INSTANCE_LAYERS"};
+    EnvVarWrapper vk_loader_drivers_select_env_var{"VK_LOADER_DRIVERS_SELECT"};
+    EnvVarWrapper vk_loader_drivers_disable_env_var{"VK_LOADER_DRIVERS_DISABLE"};
+    EnvVarWrapper vk_loader_layers_enable_env_var{"VK_LOADER_LAYERS_ENABLE"};
+    EnvVarWrapper vk_loader_layers_disable_env_var{"VK_LOADER_LAYERS_DISABLE"};
+    EnvVarWrapper vk_loader_debug_env_var{"VK_LOADER_DEBUG"};
+    EnvVarWrapper vk_loader_disable_inst_ext_filter_env_var{"VK_LOADER_DISABLE_INST_EXT_FILTER"};
+    EnvVarWrapper vk_loader_disable_select_env_var{"VK_LOADER_DISABLE_SELECT"};
+#if TESTING_COMMON_UNIX_PLATFORMS
+    EnvVarWrapper xdg_config_home_env_var{"XDG_CONFIG_HOME"};
+    EnvVarWrapper xdg_config_dirs_env_var{"XDG_CONFIG_DIRS"};
+    EnvVarWrapper xdg_data_home_env_var{"XDG_DATA_HOME"};
+    EnvVarWrapper xdg_data_dirs_env_var{"XDG_DATA_DIRS"};
+    EnvVarWrapper home_env_var{"HOME", "/home/test_home_directory"};
+#endif
+    ::testing::InitGoogleTest(&argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        std::string value;
+        bool valid = false;
+        if (parse_option(argv[i], "iterations", value)) {
+            valid = parse_count(value, options.iterations) && options.iterations > 0;
+        } else if (parse_option(argv[i], "layers", value)) {
+            valid = parse_count(value, options.layer_count);
+        } else if (parse_option(argv[i], "drivers", value)) {
+            valid = parse_count(value, options.driver_count) && options.driver_count > 0;
+        } else if (parse_option(argv[i], "json", value)) {
+            options.json_path = value;
+            valid = !value.empty();
+        }
+        if (!valid) {
+            std::cerr << "Unrecognized argument " << argv[i] << "\n"
+                      << "Usage: " << argv[0]
+                      << " [googletest options] [--iterations=<n>] [--layers=<n>] [--drivers=<n>] [--json=<path>]\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Running " << options.iterations << " iterations with " << options.layer_count << " layer(s) and "
+              << options.driver_count << " driver(s)\n";
+    std::cout << std::left << std::setw(52) << "Benchmark" << std::right << std::setw(12) << "p50" << std::setw(12) << "p90"
+              << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+    int result = RUN_ALL_TESTS();
+
+    if (!options.json_path.empty()) {
+        write_json_results(options.json_path);
+    }
+    return result;
+}
@@ -644,7 +644,7 @@ std::string get_loader_settings_file_contents(const LoaderSettings& loader_setti
                     writer.AddString(dest);
                 }
                 writer.EndArray();
-                writer.StartKeyedArray("filter");
+                writer.StartKeyedArray("filters");
                 for (const auto& filter : config.filters) {
                     writer.AddString(filter);
                 }
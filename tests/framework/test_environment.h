@@ -392,6 +392,9 @@ struct LoaderSettings {
     BUILDER_VECTOR(AppSpecificSettings, app_specific_settings, app_specific_setting);
 };
 
+// The contents of the vk_loader_settings.json file which FrameworkEnvironment::update_loader_settings writes
+std::string get_loader_settings_file_contents(const LoaderSettings& loader_settings) noexcept;
+
 struct PlatformShimWrapper {
     PlatformShimWrapper(fs::FileSystemManager& file_system_manager, const char* log_filter) noexcept;
     PlatformShimWrapper(PlatformShimWrapper const&) = delete;
@@ -177,6 +177,12 @@ class MemoryTracker {
 
     bool empty() noexcept { return allocation_count == 0; }
 
+    // Number of successful pfnAllocation and pfnReallocation calls made so far
+    size_t get_call_count() noexcept {
+        std::lock_guard<std::mutex> lg(main_mutex);
+        return call_count;
+    }
+
     // Arm a single failure for the next reallocation that grows an existing block. Used to force the used-object
     // list resize inside loader_get_next_available_entry to fail without disturbing prior allocations.
     void arm_next_growing_reallocation_failure() noexcept {
@@ -458,6 +464,71 @@ TEST(Allocation, CreateInstanceIntentionalAllocFail) {
     }
 }
 
+// Test that the instance arena serves creation time allocations from a few large chunks of the app's allocator,
+// and that everything, including the memory allocated after creation, is released by vkDestroyInstance.
+TEST(Allocation, InstanceArena) {
+    FrameworkEnvironment env{};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_0");
+    env.add_implicit_layer({}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_implicit")
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                                             .set_disable_environment("DISABLE_ENV")));
+
+    auto create_instance_and_device = [&env](MemoryTracker& tracker, size_t& instance_call_count) {
+        InstWrapper inst{env.vulkan_functions, tracker.get()};
+        ASSERT_NO_FATAL_FAILURE(inst.CheckCreate());
+        instance_call_count = tracker.get_call_count();
+
+        DeviceWrapper dev{inst, tracker.get()};
+        ASSERT_NO_FATAL_FAILURE(dev.CheckCreate(inst.GetPhysDev()));
+    };
+
+    MemoryTracker tracker;
+    size_t call_count = 0;
+    ASSERT_NO_FATAL_FAILURE(create_instance_and_device(tracker, call_count));
+    ASSERT_TRUE(tracker.empty());
+
+    EnvVarWrapper arena_env_var{"VK_LOADER_INSTANCE_ARENA", "1"};
+    MemoryTracker arena_tracker;
+    size_t arena_call_count = 0;
+    ASSERT_NO_FATAL_FAILURE(create_instance_and_device(arena_tracker, arena_call_count));
+    ASSERT_TRUE(arena_tracker.empty());
+
+    ASSERT_LT(arena_call_count, call_count);
+}
+
+// Test failure during vkCreateInstance with the instance arena enabled, which fails whenever a new chunk can't be allocated
+TEST(Allocation, InstanceArenaCreateInstanceIntentionalAllocFail) {
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("error,warn")};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_0");
+    env.add_implicit_layer({}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_implicit")
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                                             .set_disable_environment("DISABLE_ENV")));
+    env.get_test_layer().set_do_spurious_allocations_in_create_instance(true);
+    EnvVarWrapper arena_env_var{"VK_LOADER_INSTANCE_ARENA", "1"};
+
+    size_t fail_index = 0;
+    VkResult result = VK_ERROR_OUT_OF_HOST_MEMORY;
+    while (result == VK_ERROR_OUT_OF_HOST_MEMORY && fail_index <= 10000) {
+        MemoryTracker tracker({false, 0, true, fail_index});
+
+        VkInstance instance;
+        InstanceCreateInfo inst_create_info{};
+        result = env.vulkan_functions.vkCreateInstance(inst_create_info.get(), tracker.get(), &instance);
+        if (result == VK_SUCCESS) {
+            uint32_t physical_device_count = 1;
+            VkPhysicalDevice physical_device{};
+            VkResult enum_result =
+                env.vulkan_functions.vkEnumeratePhysicalDevices(instance, &physical_device_count, &physical_device);
+            ASSERT_TRUE(enum_result == VK_SUCCESS || enum_result == VK_ERROR_OUT_OF_HOST_MEMORY);
+            env.vulkan_functions.vkDestroyInstance(instance, tracker.get());
+        }
+        ASSERT_TRUE(tracker.empty());
+        fail_index++;
+    }
+}
+
 // Test failure during vkCreateInstance to make sure we don't leak memory if
 // one of the out-of-memory conditions trigger and there are invalid jsons in the same folder
 TEST(Allocation, CreateInstanceIntentionalAllocFailInvalidManifests) {
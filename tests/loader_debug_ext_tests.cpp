@@ -729,6 +729,38 @@ TEST_F(SeparateMessenger, InfoInEnumDevs) {
     ASSERT_EQ(true, message_found);
 }
 
+// loader_log skips messages no messenger listens to, make sure that keeps up with messengers coming and going.
+TEST_F(SeparateMessenger, InfoInEnumDevsAfterMessengerReplaced) {
+    expected_message = "Trimming device count from 6 to 5";
+    expected_object_type = VK_OBJECT_TYPE_INSTANCE;
+    expected_message_flags = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT;
+    expected_severity_flags = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+
+    VkInstance inst = VK_NULL_HANDLE;
+    ASSERT_EQ(VK_SUCCESS,
+              CreateUtilsInstance(VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT, VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT, &inst));
+
+    VkDebugUtilsMessengerEXT messenger = VK_NULL_HANDLE;
+    ASSERT_EQ(VK_SUCCESS, CreateUtilsMessenger(inst, VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT,
+                                               VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT, &messenger));
+    ASSERT_EQ(VK_SUCCESS, DestroyUtilsMessenger(inst, messenger));
+
+    uint32_t max_count = 5;
+    std::array<VkPhysicalDevice, 5> devices;
+    ASSERT_EQ(env->vulkan_functions.vkEnumeratePhysicalDevices(inst, &max_count, devices.data()), VK_INCOMPLETE);
+    ASSERT_EQ(false, message_found);
+
+    ASSERT_EQ(VK_SUCCESS, CreateUtilsMessenger(inst, VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT,
+                                               VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT, &messenger));
+    max_count = 5;
+    ASSERT_EQ(env->vulkan_functions.vkEnumeratePhysicalDevices(inst, &max_count, devices.data()), VK_INCOMPLETE);
+    ASSERT_EQ(VK_SUCCESS, DestroyUtilsMessenger(inst, messenger));
+
+    env->vulkan_functions.vkDestroyInstance(inst, nullptr);
+
+    ASSERT_EQ(true, message_found);
+}
+
 // Test messenger created outside of vkCreateInstance with a manual info message of the wrong message severity to be logged.
 TEST_F(ManualMessage, InfoMessageIgnoredSeverity) {
     const char my_message[] = "This is my special message!";
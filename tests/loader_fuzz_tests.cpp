@@ -389,3 +389,278 @@ TEST(JsonStringPrint, PrintPreallocatedTerminatesAtRealEnd) {
     loader_cJSON_Delete(json);
     std::filesystem::remove(json_path);
 }
+
+// Manifests are parsed in place, with large ones that only root can write to mapped instead of read, so check that files on both
+// sides of the mapping threshold come back with all of their strings unescaped correctly.
+TEST(JsonInSitu, SmallAndLargeFilesParseIdentically) {
+    for (size_t member_count : {4, 1024}) {
+        std::string json_text = "{";
+        std::string expected = "{";
+        for (size_t i = 0; i < member_count; i++) {
+            if (i != 0) {
+                json_text += ",";
+                expected += ",";
+            }
+            std::string index = std::to_string(i);
+            json_text += "\"key_\\\\" + index + "\":\"value\\n\\\"" + index + "\\\"\\t\\u0041\"";
+            expected += "\"key_\\" + index + "\":\"value\n\"" + index + "\"\tA\"";
+        }
+        json_text += "}";
+        expected += "}";
+
+        std::filesystem::path json_path = std::filesystem::temp_directory_path() / "loader_in_situ_parse_test.json";
+        {
+            std::ofstream f(json_path, std::ios::binary | std::ios::trunc);
+            f << json_text;
+        }
+
+        cJSON* json = NULL;
+        ASSERT_EQ(loader_get_json(NULL, json_path.string().c_str(), &json), VK_SUCCESS);
+        ASSERT_NE(json, nullptr);
+
+        std::vector<char> buffer(expected.size() + 64, 'X');
+        ASSERT_TRUE(loader_cJSON_PrintPreallocated(json, buffer.data(), static_cast<int>(buffer.size()), false));
+        EXPECT_EQ(std::string(buffer.data()), expected);
+
+        loader_cJSON_Delete(json);
+        std::filesystem::remove(json_path);
+    }
+}
+
+// The single pass driver manifest reader has to either find the same fields the cJSON based lookup does or hand the file over
+// to it, and it must never accept a file cJSON rejects.
+void check_icd_manifest_fields_match_cjson(std::filesystem::path const& path, bool expect_streamed) {
+    SCOPED_TRACE(path.string());
+    loader_icd_manifest_fields streamed{};
+    VkResult stream_res = loader_read_icd_manifest_fields(NULL, path.string().c_str(), &streamed);
+    ASSERT_TRUE(stream_res == VK_SUCCESS || stream_res == VK_INCOMPLETE);
+    if (expect_streamed) {
+        ASSERT_EQ(stream_res, VK_SUCCESS);
+    }
+
+    cJSON* json = NULL;
+    if (loader_get_json(NULL, path.string().c_str(), &json) != VK_SUCCESS || json == NULL) {
+        EXPECT_EQ(stream_res, VK_INCOMPLETE);
+        loader_free_icd_manifest_fields(NULL, &streamed);
+        return;
+    }
+    loader_icd_manifest_fields parsed{};
+    ASSERT_EQ(loader_get_icd_manifest_fields_from_json(NULL, json, &parsed), VK_SUCCESS);
+
+    if (stream_res == VK_SUCCESS) {
+        EXPECT_EQ(streamed.has_file_format_version, parsed.has_file_format_version);
+        EXPECT_STREQ(streamed.file_format_version, parsed.file_format_version);
+        EXPECT_EQ(streamed.has_icd, parsed.has_icd);
+        EXPECT_EQ(streamed.has_layer, parsed.has_layer);
+        EXPECT_EQ(streamed.has_library_path, parsed.has_library_path);
+        EXPECT_STREQ(streamed.library_path, parsed.library_path);
+        EXPECT_EQ(streamed.has_api_version, parsed.has_api_version);
+        EXPECT_STREQ(streamed.api_version, parsed.api_version);
+        EXPECT_STREQ(streamed.library_arch, parsed.library_arch);
+        EXPECT_EQ(streamed.is_portability_driver, parsed.is_portability_driver);
+    }
+    loader_free_icd_manifest_fields(NULL, &streamed);
+    loader_free_icd_manifest_fields(NULL, &parsed);
+}
+
+TEST(IcdManifestFields, CorpusMatchesCJSON) {
+    for (auto const& directory : {MANIFEST_CORPUS_DIRECTORY, CLUSTERFUZZ_TESTCASE_DIRECTORY}) {
+        for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file()) {
+                check_icd_manifest_fields_match_cjson(entry.path(), false);
+            }
+        }
+    }
+}
+
+TEST(IcdManifestFields, WellFormedManifestsAreStreamed) {
+    std::filesystem::path corpus{MANIFEST_CORPUS_DIRECTORY};
+    for (auto const& name : {"icd_manifest_basic.json", "icd_manifest_portability.json", "icd_manifest_escapes.json",
+                             "icd_manifest_mixed_case_and_duplicate_keys.json", "icd_manifest_unknown_members.json",
+                             "icd_manifest_layer_manifest.json", "icd_manifest_missing_fields.json",
+                             "icd_manifest_bom_and_trailing_text.json"}) {
+        check_icd_manifest_fields_match_cjson(corpus / name, true);
+    }
+
+    // The first of several keys matching case insensitively wins, whatever its value is
+    loader_icd_manifest_fields fields{};
+    ASSERT_EQ(loader_read_icd_manifest_fields(NULL, (corpus / "icd_manifest_mixed_case_and_duplicate_keys.json").string().c_str(),
+                                              &fields),
+              VK_SUCCESS);
+    EXPECT_STREQ(fields.file_format_version, "1.0.1");
+    EXPECT_STREQ(fields.library_path, "first.so");
+    EXPECT_STREQ(fields.api_version, "1.1.0");
+    EXPECT_FALSE(fields.is_portability_driver);
+    EXPECT_EQ(fields.library_arch, nullptr);
+    loader_free_icd_manifest_fields(NULL, &fields);
+}
+
+void check_string_lists_match(loader_string_list const& streamed, loader_string_list const& parsed) {
+    ASSERT_EQ(streamed.count, parsed.count);
+    for (uint32_t i = 0; i < streamed.count; i++) {
+        EXPECT_STREQ(streamed.list[i], parsed.list[i]);
+    }
+}
+
+void check_layer_properties_match(loader_layer_properties const& streamed, loader_layer_properties const& parsed) {
+    SCOPED_TRACE(parsed.info.layerName);
+    EXPECT_STREQ(streamed.info.layerName, parsed.info.layerName);
+    EXPECT_STREQ(streamed.info.description, parsed.info.description);
+    EXPECT_EQ(streamed.info.specVersion, parsed.info.specVersion);
+    EXPECT_EQ(streamed.info.implementationVersion, parsed.info.implementationVersion);
+    EXPECT_EQ(streamed.type_flags, parsed.type_flags);
+    EXPECT_STREQ(streamed.manifest_file_name, parsed.manifest_file_name);
+    EXPECT_STREQ(streamed.lib_name, parsed.lib_name);
+    EXPECT_STREQ(streamed.functions.str_gipa, parsed.functions.str_gipa);
+    EXPECT_STREQ(streamed.functions.str_gdpa, parsed.functions.str_gdpa);
+    EXPECT_STREQ(streamed.functions.str_negotiate_interface, parsed.functions.str_negotiate_interface);
+    ASSERT_EQ(streamed.instance_extension_list.count, parsed.instance_extension_list.count);
+    for (uint32_t i = 0; i < streamed.instance_extension_list.count; i++) {
+        EXPECT_STREQ(streamed.instance_extension_list.list[i].extensionName, parsed.instance_extension_list.list[i].extensionName);
+        EXPECT_EQ(streamed.instance_extension_list.list[i].specVersion, parsed.instance_extension_list.list[i].specVersion);
+    }
+    ASSERT_EQ(streamed.device_extension_list.count, parsed.device_extension_list.count);
+    for (uint32_t i = 0; i < streamed.device_extension_list.count; i++) {
+        EXPECT_STREQ(streamed.device_extension_list.list[i].props.extensionName,
+                     parsed.device_extension_list.list[i].props.extensionName);
+        EXPECT_EQ(streamed.device_extension_list.list[i].props.specVersion, parsed.device_extension_list.list[i].props.specVersion);
+        check_string_lists_match(streamed.device_extension_list.list[i].entrypoints,
+                                 parsed.device_extension_list.list[i].entrypoints);
+    }
+    EXPECT_STREQ(streamed.disable_env_var.name, parsed.disable_env_var.name);
+    EXPECT_STREQ(streamed.disable_env_var.value, parsed.disable_env_var.value);
+    EXPECT_STREQ(streamed.enable_env_var.name, parsed.enable_env_var.name);
+    EXPECT_STREQ(streamed.enable_env_var.value, parsed.enable_env_var.value);
+    check_string_lists_match(streamed.component_layer_names, parsed.component_layer_names);
+    EXPECT_STREQ(streamed.pre_instance_functions.enumerate_instance_extension_properties,
+                 parsed.pre_instance_functions.enumerate_instance_extension_properties);
+    EXPECT_STREQ(streamed.pre_instance_functions.enumerate_instance_layer_properties,
+                 parsed.pre_instance_functions.enumerate_instance_layer_properties);
+    EXPECT_STREQ(streamed.pre_instance_functions.enumerate_instance_version,
+                 parsed.pre_instance_functions.enumerate_instance_version);
+    check_string_lists_match(streamed.override_paths, parsed.override_paths);
+    EXPECT_EQ(streamed.is_override, parsed.is_override);
+    check_string_lists_match(streamed.blacklist_layer_names, parsed.blacklist_layer_names);
+    check_string_lists_match(streamed.app_key_paths, parsed.app_key_paths);
+}
+
+// Same contract for the layer manifest reader: it has to produce exactly the layers loader_add_layer_properties produces from
+// the cJSON tree, or leave the list alone and hand the file over to it.
+void check_layer_manifest_matches_cjson(std::filesystem::path const& path, bool is_implicit, bool expect_streamed) {
+    SCOPED_TRACE(path.string() + (is_implicit ? " (implicit)" : " (explicit)"));
+    loader_layer_list streamed{};
+    VkResult stream_res = loader_read_layer_manifest(NULL, path.string().c_str(), is_implicit, &streamed);
+    ASSERT_TRUE(stream_res == VK_SUCCESS || stream_res == VK_INCOMPLETE);
+    if (expect_streamed) {
+        ASSERT_EQ(stream_res, VK_SUCCESS);
+    }
+    if (stream_res == VK_INCOMPLETE) {
+        EXPECT_EQ(streamed.count, 0U);
+    }
+
+    cJSON* json = NULL;
+    if (loader_get_json(NULL, path.string().c_str(), &json) != VK_SUCCESS || json == NULL) {
+        EXPECT_EQ(stream_res, VK_INCOMPLETE);
+        loader_delete_layer_list_and_properties(NULL, &streamed);
+        return;
+    }
+    loader_layer_list parsed{};
+    VkResult parse_res = loader_add_layer_properties(NULL, &parsed, json, is_implicit, path.string().c_str());
+    loader_cJSON_Delete(json);
+
+    if (stream_res == VK_SUCCESS) {
+        EXPECT_EQ(parse_res, VK_SUCCESS);
+        ASSERT_EQ(streamed.count, parsed.count);
+        for (uint32_t i = 0; i < streamed.count; i++) {
+            check_layer_properties_match(streamed.list[i], parsed.list[i]);
+        }
+    }
+    loader_delete_layer_list_and_properties(NULL, &streamed);
+    loader_delete_layer_list_and_properties(NULL, &parsed);
+}
+
+TEST(LayerManifest, CorpusMatchesCJSON) {
+    for (auto const& directory : {MANIFEST_CORPUS_DIRECTORY, CLUSTERFUZZ_TESTCASE_DIRECTORY}) {
+        for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file()) {
+                check_layer_manifest_matches_cjson(entry.path(), false, false);
+                check_layer_manifest_matches_cjson(entry.path(), true, false);
+            }
+        }
+    }
+}
+
+TEST(LayerManifest, WellFormedManifestsAreStreamed) {
+    std::filesystem::path corpus{MANIFEST_CORPUS_DIRECTORY};
+    for (auto const& name : {"layer_manifest_basic.json", "layer_manifest_escapes.json", "layer_manifest_layers_array.json",
+                             "layer_manifest_meta_layer.json", "layer_manifest_mixed_case_and_duplicate_keys.json",
+                             "VkLayer_complex_file.json"}) {
+        check_layer_manifest_matches_cjson(corpus / name, false, true);
+    }
+    for (auto const& name : {"layer_manifest_implicit.json", "layer_manifest_meta_layer.json",
+                             "layer_manifest_mixed_case_and_duplicate_keys.json"}) {
+        check_layer_manifest_matches_cjson(corpus / name, true, true);
+    }
+
+    // The first of several keys matching case insensitively wins, the same as loader_cJSON_GetObjectItem
+    loader_layer_list layers{};
+    ASSERT_EQ(loader_read_layer_manifest(NULL, (corpus / "layer_manifest_mixed_case_and_duplicate_keys.json").string().c_str(),
+                                         true, &layers),
+              VK_SUCCESS);
+    ASSERT_EQ(layers.count, 1U);
+    EXPECT_STREQ(layers.list[0].info.layerName, "VK_LAYER_test_first_key");
+    EXPECT_EQ(layers.list[0].info.specVersion, VK_MAKE_API_VERSION(0, 1, 2, 0));
+    EXPECT_STREQ(layers.list[0].disable_env_var.name, "DISABLE_FIRST");
+    loader_delete_layer_list_and_properties(NULL, &layers);
+
+    // Anything that would be warned about is left to the cJSON based path so the messages stay the same
+    ASSERT_EQ(loader_read_layer_manifest(NULL, (corpus / "layer_manifest_deprecated_type.json").string().c_str(), false, &layers),
+              VK_INCOMPLETE);
+    EXPECT_EQ(layers.count, 0U);
+}
+
+// loader_add_to_ext_list merges long lists through a hash set of the extension names, and lists of a single extension by
+// comparing against every entry. Both have to produce the same list, including for names whose hashes collide.
+TEST(ExtensionList, NameSetMergeMatchesLinearMerge) {
+    const uint32_t driver_count = 4;
+    const uint32_t extensions_per_driver = 250;
+    std::vector<std::vector<VkExtensionProperties>> driver_exts(driver_count);
+    for (uint32_t driver = 0; driver < driver_count; driver++) {
+        // Consecutive drivers share most of their extensions
+        for (uint32_t i = 0; i < extensions_per_driver; i++) {
+            VkExtensionProperties props{};
+            std::string name = "VK_EXT_extension_" + std::to_string(driver * 50 + i);
+            memcpy(props.extensionName, name.c_str(), name.size() + 1);
+            props.specVersion = driver + 1;
+            driver_exts[driver].push_back(props);
+        }
+    }
+    // Names with colliding hashes, see HashString.SyntheticCollisionsAreHandledSafelyByConstruction
+    for (const char* colliding_name : {"WrvAi", "jI3i", "I3US", "WWngS", "WrvAi"}) {
+        VkExtensionProperties props{};
+        memcpy(props.extensionName, colliding_name, strlen(colliding_name) + 1);
+        driver_exts[driver_count - 1].push_back(props);
+    }
+
+    loader_extension_list linear_list{};
+    for (auto& exts : driver_exts) {
+        for (auto& props : exts) {
+            ASSERT_EQ(VK_SUCCESS, loader_add_to_ext_list(nullptr, &linear_list, 1, &props));
+        }
+    }
+    loader_extension_list hashed_list{};
+    for (auto& exts : driver_exts) {
+        ASSERT_EQ(VK_SUCCESS, loader_add_to_ext_list(nullptr, &hashed_list, static_cast<uint32_t>(exts.size()), exts.data()));
+    }
+
+    ASSERT_EQ(linear_list.count, (driver_count - 1) * 50 + extensions_per_driver + 4);
+    ASSERT_EQ(linear_list.count, hashed_list.count);
+    for (uint32_t i = 0; i < linear_list.count; i++) {
+        ASSERT_TRUE(string_eq(linear_list.list[i].extensionName, hashed_list.list[i].extensionName));
+        ASSERT_EQ(linear_list.list[i].specVersion, hashed_list.list[i].specVersion);
+        ASSERT_TRUE(has_vk_extension_property(&linear_list.list[i], &hashed_list));
+    }
+
+    loader_destroy_generic_list(nullptr, reinterpret_cast<loader_generic_list*>(&linear_list));
+    loader_destroy_generic_list(nullptr, reinterpret_cast<loader_generic_list*>(&hashed_list));
+}
@@ -29,6 +29,7 @@
 
 extern "C" {
 #include "loader_common.h"
+#include "gpa_helper.h"
 }
 
 #include <array>
@@ -94,12 +95,11 @@ static void assert_gdpa_equivalent(PFN_vkGetDeviceProcAddr from_loader, PFN_vkGe
     }
 }
 
-// Every name gpa_helper.c's trampoline_get_proc_addr() hand-checks via
-// `case 0x...u: if (!strcmp(...)) return ...; break;` (all core Vulkan 1.0-1.4 commands - see
-// loader/gpa_helper.c). This list mirrors that function's checks
-// exactly so a mistake made while mechanically threading the hash pre-filter through ~230 hand-written
-// strcmp branches (wrong hash constant, dropped branch, mismatched name) shows up as a concrete failure
-// here instead of silently returning NULL/wrong-pointer for some entry point.
+// Every name gpa_helper.c's trampoline_get_proc_addr() resolves through the generated
+// loader_lookup_core_trampoline() perfect hash table (all core Vulkan 1.0-1.4 commands except the global
+// ones). Listing them explicitly means a mistake in the generated table (dropped entry, wrong slot,
+// mismatched name) shows up as a concrete failure here instead of silently returning NULL/wrong-pointer for
+// some entry point.
 static constexpr std::array kGpaHelperCoreInstanceNames = {
     "vkGetInstanceProcAddr",
     "vkDestroyInstance",
@@ -333,8 +333,8 @@ static constexpr std::array kGpaHelperCoreInstanceNames = {
     "vkTransitionImageLayout",
 };
 
-// Every name loader_lookup_device_dispatch_table() (loader/generated/vk_loader_extensions.c) hand-checks
-// for the core Vulkan 1.0-1.4 sections. Unlike the instance trampolines above, these entries only resolve
+// Every core Vulkan 1.0-1.4 name in the perfect hash table of loader_lookup_device_dispatch_table()
+// (loader/generated/vk_loader_extensions.c). Unlike the instance trampolines above, these entries only resolve
 // to a non-null pointer if the underlying (mock) driver actually reports the function, so the test
 // physical device must be told about every one of them via add_device_function() first.
 static constexpr std::array kDeviceDispatchCoreNames = {
@@ -1040,9 +1040,9 @@ static constexpr std::array<const char*, 481> kExtensionInstanceGpaNames = {
     "vkCmdDrawMeshTasksIndirectCountEXT",
 };
 
-// Exhaustively call every one of gpa_helper.c's ~230 hand-checked core instance trampoline names through
-// the real vkGetInstanceProcAddr entry point and confirm each still resolves - i.e. the mechanical
-// hash-prefilter transformation of that file didn't drop, misname, or mis-hash any branch.
+// Exhaustively call every one of the ~230 core instance trampoline names through the real
+// vkGetInstanceProcAddr entry point and confirm each still resolves - i.e. the generated table didn't drop,
+// misname, or misplace any entry.
 TEST(GetProcAddr, ExhaustiveCoreInstanceTrampolineNames) {
     FrameworkEnvironment env{};
     env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA).add_physical_device("physical_device_0");
@@ -1052,8 +1052,8 @@ TEST(GetProcAddr, ExhaustiveCoreInstanceTrampolineNames) {
     inst.CheckCreate();
 
     // Every name must also resolve to a pointer distinct from every other name's - not just non-null -
-    // so a hand-edit that pairs one branch's hash/strcmp condition with a different branch's return
-    // statement (e.g. vkCreateBuffer's check returning vkCreateImage) can't hide behind "still non-null".
+    // so a table entry which pairs one name with a different command's trampoline (e.g. vkCreateBuffer's
+    // name returning vkCreateImage) can't hide behind "still non-null".
     std::set<PFN_vkVoidFunction> distinct_pointers;
     for (const auto* name : kGpaHelperCoreInstanceNames) {
         PFN_vkVoidFunction f = inst.load(name);
@@ -1062,11 +1062,9 @@ TEST(GetProcAddr, ExhaustiveCoreInstanceTrampolineNames) {
     }
 }
 
-// Unlike the three generated lookup functions, which get a check_no_hash_collisions() call at generation
-// time, gpa_helper.c is hand-maintained with no equivalent - a real collision there would only ever surface
-// as a bare "duplicate case value" compiler error naming neither string. This test recreates that same
-// diagnostic in C++ over gpa_helper.c's own name list, so a colliding addition fails here with both names
-// named instead of as an inscrutable compiler error.
+// The generator refuses to build a perfect hash table over names with colliding hashes. This test recreates
+// that check in C++ over the core trampoline names, so a colliding addition to the headers is also reported
+// by the test suite with both names named.
 TEST(GetProcAddr, GpaHelperCoreInstanceNamesHaveNoHashCollisions) {
     std::unordered_map<uint32_t, const char*> hash_to_name;
     for (const auto* name : kGpaHelperCoreInstanceNames) {
@@ -1074,15 +1072,15 @@ TEST(GetProcAddr, GpaHelperCoreInstanceNamesHaveNoHashCollisions) {
         auto it = hash_to_name.find(hash);
         if (it != hash_to_name.end()) {
             FAIL() << "Hash collision between \"" << it->second << "\" and \"" << name << "\" (both hash to 0x" << std::hex << hash
-                   << ") - gpa_helper.c's hand-written switch would fail to compile with a duplicate case label";
+                   << ") - the generator can't build loader_lookup_core_trampoline()'s perfect hash table";
         }
         hash_to_name.emplace(hash, name);
     }
 }
 
 // Exhaustively call every core Vulkan 1.0-1.4 name that loader_lookup_device_dispatch_table() (the
-// generated device gpa fast path used by vkGetDeviceProcAddr) hand-checks, confirming the hash-prefilter
-// added in front of each of its ~200 strcmp checks didn't drop or mis-hash any of them.
+// generated device gpa fast path used by vkGetDeviceProcAddr) knows about, confirming its perfect hash
+// table didn't drop or misplace any of its ~200 entries.
 TEST(GetDeviceProcAddr, ExhaustiveCoreDeviceDispatchNames) {
     FrameworkEnvironment env{};
     auto& test_physical_device = env.add_icd(TEST_ICD_PATH_VERSION_2, {}, ManifestICD{}.set_api_version(VK_API_VERSION_1_4))
@@ -1103,8 +1101,8 @@ TEST(GetDeviceProcAddr, ExhaustiveCoreDeviceDispatchNames) {
     dev.CheckCreate(inst.GetPhysDev());
 
     // Every name must resolve to a pointer distinct from every other name's - not just non-null - so a
-    // hand-edit that pairs one branch's hash/strcmp condition with a different branch's return statement
-    // (e.g. vkGetDeviceQueue's check returning table->QueueSubmit) can't hide behind "still non-null".
+    // table entry which pairs one name with a different command's offset (e.g. vkGetDeviceQueue's name
+    // returning table->QueueSubmit) can't hide behind "still non-null".
     std::set<PFN_vkVoidFunction> distinct_pointers;
     for (const auto* name : kDeviceDispatchCoreNames) {
         PFN_vkVoidFunction f = dev->vkGetDeviceProcAddr(dev.dev, name);
@@ -1114,13 +1112,133 @@ TEST(GetDeviceProcAddr, ExhaustiveCoreDeviceDispatchNames) {
     }
 }
 
+// The loader-private batch entry point must return exactly what one vkGetDeviceProcAddr call per name returns. How long both
+// ways of resolving the same names take is measured by the GetDeviceProcAddr benchmark.
+TEST(GetDeviceProcAddr, BatchLookupMatchesSingleCalls) {
+    FrameworkEnvironment env{};
+    auto& test_physical_device = env.add_icd(TEST_ICD_PATH_VERSION_2, {}, ManifestICD{}.set_api_version(VK_API_VERSION_1_4))
+                                     .set_icd_api_version(VK_API_VERSION_1_4)
+                                     .add_and_get_physical_device(PhysicalDevice{}.set_api_version(VK_API_VERSION_1_4));
+    for (size_t i = 0; i < kDeviceDispatchCoreNames.size(); i++) {
+        auto mock_ptr = reinterpret_cast<PFN_vkVoidFunction>(static_cast<uintptr_t>(0x1000 + i * 8));
+        test_physical_device.add_device_function(VulkanFunction{kDeviceDispatchCoreNames[i], mock_ptr});
+    }
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.set_api_version(VK_API_VERSION_1_4);
+    inst.CheckCreate();
+
+    DeviceWrapper dev{inst};
+    dev.CheckCreate(inst.GetPhysDev());
+
+    PFN_vk_loaderGetDeviceProcAddrs GetDeviceProcAddrs = inst.load(VK_LOADER_GET_DEVICE_PROC_ADDRS_NAME);
+    ASSERT_NE(nullptr, GetDeviceProcAddrs);
+
+    std::vector<const char*> names(kDeviceDispatchCoreNames.begin(), kDeviceDispatchCoreNames.end());
+    names.push_back("vkGetDeviceQueue2");
+    names.push_back("vkCreateSwapchainKHR");
+    names.push_back("vkNotARealFunction");
+    names.push_back("vk");
+    names.push_back("");
+    names.push_back(nullptr);
+    const uint32_t name_count = static_cast<uint32_t>(names.size());
+
+    std::vector<PFN_vkVoidFunction> batch_functions(names.size());
+    GetDeviceProcAddrs(dev.dev, name_count, names.data(), batch_functions.data());
+    for (size_t i = 0; i < names.size(); i++) {
+        ASSERT_EQ(dev->vkGetDeviceProcAddr(dev.dev, names[i]), batch_functions[i]) << (names[i] ? names[i] : "NULL");
+    }
+}
+
+// An instance and device created with VK_LOADER_LAZY_DISPATCH=1 must behave exactly like ones whose dispatch tables were fully
+// populated up front, both for vkGetDeviceProcAddr and when calling through the trampolines.
+TEST(GetDeviceProcAddr, LazyDispatchMatchesEagerDispatch) {
+    FrameworkEnvironment env{};
+    auto& test_physical_device = env.add_icd(TEST_ICD_PATH_VERSION_2, {}, ManifestICD{}.set_api_version(VK_API_VERSION_1_4))
+                                     .set_icd_api_version(VK_API_VERSION_1_4)
+                                     .add_and_get_physical_device(PhysicalDevice{"physical_device_0"}
+                                                                      .set_api_version(VK_API_VERSION_1_4)
+                                                                      .add_queue_family_properties(
+                                                                          {{VK_QUEUE_GRAPHICS_BIT, 1, 0, {1, 1, 1}}, false}));
+    for (size_t i = 0; i < kDeviceDispatchCoreNames.size(); i++) {
+        auto mock_ptr = reinterpret_cast<PFN_vkVoidFunction>(static_cast<uintptr_t>(0x1000 + i * 8));
+        test_physical_device.add_device_function(VulkanFunction{kDeviceDispatchCoreNames[i], mock_ptr});
+    }
+    env.add_implicit_layer({}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_implicit_passthrough")
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                                             .set_disable_environment("DISABLE_ME")));
+
+    InstWrapper eager_inst{env.vulkan_functions};
+    eager_inst.create_info.set_api_version(VK_API_VERSION_1_4);
+    eager_inst.CheckCreate();
+
+    EnvVarWrapper lazy_dispatch_env_var{"VK_LOADER_LAZY_DISPATCH", "1"};
+    InstWrapper lazy_inst{env.vulkan_functions};
+    lazy_inst.create_info.set_api_version(VK_API_VERSION_1_4);
+    lazy_inst.CheckCreate();
+
+    VkPhysicalDevice eager_phys_dev = eager_inst.GetPhysDev();
+    VkPhysicalDevice lazy_phys_dev = lazy_inst.GetPhysDev();
+    VkPhysicalDeviceProperties eager_props{};
+    VkPhysicalDeviceProperties lazy_props{};
+    env.vulkan_functions.vkGetPhysicalDeviceProperties(eager_phys_dev, &eager_props);
+    env.vulkan_functions.vkGetPhysicalDeviceProperties(lazy_phys_dev, &lazy_props);
+    ASSERT_EQ(eager_props.apiVersion, lazy_props.apiVersion);
+    ASSERT_EQ(0, strcmp(eager_props.deviceName, lazy_props.deviceName));
+
+    uint32_t eager_family_count = 0;
+    uint32_t lazy_family_count = 0;
+    env.vulkan_functions.vkGetPhysicalDeviceQueueFamilyProperties(eager_phys_dev, &eager_family_count, nullptr);
+    env.vulkan_functions.vkGetPhysicalDeviceQueueFamilyProperties(lazy_phys_dev, &lazy_family_count, nullptr);
+    ASSERT_EQ(eager_family_count, lazy_family_count);
+
+    DeviceWrapper eager_dev{eager_inst};
+    eager_dev.create_info.add_device_queue(DeviceQueueCreateInfo{}.add_priority(0.0f));
+    eager_dev.CheckCreate(eager_phys_dev);
+    DeviceWrapper lazy_dev{lazy_inst};
+    lazy_dev.create_info.add_device_queue(DeviceQueueCreateInfo{}.add_priority(0.0f));
+    lazy_dev.CheckCreate(lazy_phys_dev);
+
+    std::vector<const char*> names(kDeviceDispatchCoreNames.begin(), kDeviceDispatchCoreNames.end());
+    names.push_back("vkCreateSwapchainKHR");
+    names.push_back("vkCmdDrawMeshTasksEXT");
+    names.push_back("vkNotARealFunction");
+    for (const char* name : names) {
+        ASSERT_EQ(eager_dev->vkGetDeviceProcAddr(eager_dev.dev, name), lazy_dev->vkGetDeviceProcAddr(lazy_dev.dev, name)) << name;
+    }
+
+    for (DeviceWrapper* dev : {&eager_dev, &lazy_dev}) {
+        VkQueue queue{};
+        env.vulkan_functions.vkGetDeviceQueue(dev->dev, 0, 0, &queue);
+        ASSERT_NE(queue, VK_NULL_HANDLE);
+
+        VkCommandPool cmd_pool{};
+        VkCommandPoolCreateInfo cmd_pool_info{};
+        cmd_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        ASSERT_EQ(VK_SUCCESS, env.vulkan_functions.vkCreateCommandPool(dev->dev, &cmd_pool_info, nullptr, &cmd_pool));
+        VkCommandBuffer cmd_buf{};
+        VkCommandBufferAllocateInfo cmd_buf_alloc_info{};
+        cmd_buf_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        cmd_buf_alloc_info.commandBufferCount = 1;
+        cmd_buf_alloc_info.commandPool = cmd_pool;
+        ASSERT_EQ(VK_SUCCESS, env.vulkan_functions.vkAllocateCommandBuffers(dev->dev, &cmd_buf_alloc_info, &cmd_buf));
+        env.vulkan_functions.vkDestroyCommandPool(dev->dev, cmd_pool, nullptr);
+    }
+
+    // Calling through the lazily populated table must not change what vkGetDeviceProcAddr returns
+    for (const char* name : names) {
+        ASSERT_EQ(eager_dev->vkGetDeviceProcAddr(eager_dev.dev, name), lazy_dev->vkGetDeviceProcAddr(lazy_dev.dev, name)) << name;
+    }
+}
+
 // Real, engineered FNV-1a collisions against two of the actual embedded hash constants exercised above -
-// one hitting trampoline_get_proc_addr()'s hand-checked instance chain, one hitting
-// loader_lookup_device_dispatch_table()'s generated device chain - found offline by brute-force search
+// one hitting trampoline_get_proc_addr()'s core trampoline table, one hitting
+// loader_lookup_device_dispatch_table()'s device dispatch table - found offline by brute-force search
 // (see loader_hash_string_tests.cpp for the synthetic, hand-simulated version of this same guarantee).
 // Unlike that test, this one drives the collision through the real vkGet{Instance,Device}ProcAddr entry
-// points, proving the switch/case-guarded strcmp actually protects the production lookup, not just the
-// pattern.
+// points, proving the name comparison after the hash lookup actually protects the production lookup, not
+// just the pattern.
 TEST(GetProcAddr, EngineeredHashCollisionsAreRejectedByRealLookup) {
     // trampoline_get_proc_addr() (instance chain) hashes the full "vk"-prefixed name, so the instance
     // collider must collide with "vkCreateBuffer" on the FULL name. loader_lookup_device_dispatch_table()
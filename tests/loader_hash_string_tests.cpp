@@ -34,13 +34,13 @@ extern "C" {
 }
 
 // loader_hash_string() is a plain 32-bit FNV-1a hash used purely as a cheap pre-filter in front of every
-// strcmp() confirmation when resolving vkGet{Instance,Device}ProcAddr names (see loader/gpa_helper.c and
-// loader/generated/vk_loader_extensions.c). Every call site dispatches on the hash via `switch (name_hash)`
-// and confirms the match with strcmp() inside the matching `case` before returning - never a bare
-// hash-only dispatch - so a hash collision can, at worst, cost one extra strcmp; it can never produce a
-// wrong lookup result. These tests don't try to prove real Vulkan command names never collide (the code
-// generator's build-time collision check does that) - they prove the hash-then-strcmp *pattern* stays safe
-// even when two different strings are engineered to collide.
+// string comparison when resolving vkGet{Instance,Device}ProcAddr names (see loader/gpa_helper.c and
+// loader/generated/vk_loader_extensions.c). Every call site either dispatches on the hash via
+// `switch (name_hash)` or uses it to pick a slot of a perfect hash table, and confirms the match by comparing
+// the names before returning - never a bare hash-only dispatch - so a hash collision can, at worst, cost one
+// extra comparison; it can never produce a wrong lookup result. These tests don't try to prove real Vulkan
+// command names never collide (the code generator's build-time collision check does that) - they prove the
+// hash-then-strcmp *pattern* stays safe even when two different strings are engineered to collide.
 
 TEST(HashString, Deterministic) {
     ASSERT_EQ(loader_hash_string("vkCreateInstance"), loader_hash_string("vkCreateInstance"));
@@ -56,13 +56,13 @@ TEST(HashString, DifferentStringsUsuallyHashDifferently) {
 }
 
 // scripts/generators/loader_extension_generator.py has its own copy of this hash function, used to
-// precompute the hash constants embedded in the four switch statements those constants live in (generated
-// and hand-written alike). The pairs below are copied verbatim from those switches, so this test fails
-// directly if the Python and C implementations ever disagree - no need to invoke Python to prove it.
+// precompute the hash constants embedded in the generated switch statements and to lay out the generated
+// perfect hash tables. The pairs below were computed by that Python copy, so this test fails directly if the
+// Python and C implementations ever disagree - no need to invoke Python to prove it.
 //
 // Not every switch hashes the same input for a given command, so the "name" column below is exactly the
 // string each one passes to loader_hash_string(), not always the full "vk"-prefixed name:
-//   - trampoline_get_proc_addr() and extension_instance_gpa() hash the full command name, e.g.
+//   - loader_lookup_core_trampoline() and extension_instance_gpa() hash the full command name, e.g.
 //     loader_hash_string("vkDestroyInstance").
 //   - loader_lookup_device_dispatch_table() and loader_lookup_instance_dispatch_table() strip the leading
 //     "vk" before hashing (`name += 2`), e.g. loader_hash_string("DestroyInstance").
@@ -78,7 +78,7 @@ TEST(HashString, MatchesGeneratorEmbeddedConstants) {
         {"vkCreateVideoSessionKHR", 0x05ff253eu},
         {"vkDestroyVideoSessionKHR", 0xc7cb956cu},
         {"vkGetVideoSessionMemoryRequirementsKHR", 0xf1b97187u},
-        // trampoline_get_proc_addr() (loader/gpa_helper.c, hand-written) - full command name.
+        // loader_lookup_core_trampoline() (generated, called by trampoline_get_proc_addr()) - full command name.
         {"vkGetInstanceProcAddr", 0x9d4599a6u},
         {"vkDestroyInstance", 0xa64dcfc3u},
         {"vkEnumeratePhysicalDevices", 0x09612094u},
@@ -103,6 +103,26 @@ TEST(HashString, MatchesGeneratorEmbeddedConstants) {
     }
 }
 
+// loader_perfect_hash_slot() is mirrored in scripts/generators/loader_extension_generator.py, which uses it to decide which slot
+// of the generated perfect hash tables every name is stored in. The expected slots below were computed with the Python copy.
+TEST(HashString, PerfectHashSlotMatchesGenerator) {
+    const uint16_t seeds[] = {0, 1, 7, 65535, 12345};
+    struct NameAndSlot {
+        const char *name;
+        uint32_t expected_slot;
+    };
+    const NameAndSlot pairs[] = {
+        {"GetDeviceProcAddr", 627}, {"DestroyInstance", 612}, {"vkCreateDevice", 332}, {"QueueSubmit", 378}, {"vkCmdDraw", 323},
+    };
+    for (const auto &pair : pairs) {
+        uint32_t length = 0;
+        uint32_t hash = loader_hash_string_length(pair.name, &length);
+        ASSERT_EQ(loader_hash_string(pair.name), hash);
+        ASSERT_EQ(strlen(pair.name), length);
+        ASSERT_EQ(pair.expected_slot, loader_perfect_hash_slot(hash, seeds, 5, 719));
+    }
+}
+
 // A handful of strings engineered offline to collide under this exact FNV-1a implementation (offset basis
 // 2166136261, prime 16777619). None of these are real Vulkan command names - they exist purely to
 // demonstrate that a hash collision is handled safely by construction.
@@ -128,8 +148,8 @@ TEST(HashString, SyntheticCollisionsAreHandledSafelyByConstruction) {
         ASSERT_EQ(pair.expected_hash, hash_b);
         ASSERT_EQ(hash_a, hash_b);
 
-        // ...which is exactly why every generated/hand-written lookup site guards its `switch (name_hash)`
-        // case body with a strcmp() before returning, rather than trusting the hash match alone: looking up
+        // ...which is exactly why every generated/hand-written lookup site compares the names before
+        // returning, rather than trusting the hash match alone: looking up
         // `a` must match itself but must not be fooled into matching `b`, even though the hash alone can't
         // tell them apart. The `&&` below is just this test's local stand-in for that same guard.
         uint32_t query_hash = loader_hash_string(pair.a);
@@ -27,6 +27,10 @@
 
 #include "test_environment.h"
 
+#include <chrono>
+#include <fstream>
+#include <thread>
+
 #include "util/test_defines.h"
 #include "util/get_executable_path.h"
 
@@ -228,6 +232,85 @@ TEST(ImplicitLayers, PreInstanceVersion) {
     ASSERT_NE(version, layer_version);
 }
 
+// With VK_LOADER_SCAN_CACHE set the results of the pre-instance functions are remembered, but must never go stale
+TEST(ImplicitLayers, PreInstanceResultsRemembered) {
+    EnvVarWrapper scan_cache_env_var{"VK_LOADER_SCAN_CACHE", "1"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA);
+    const char* implicit_layer_name = "VK_LAYER_ImplicitTestLayer";
+    const char* implicit_layer_extension = "VK_EXT_implicit_layer_extension";
+    EnvVarWrapper disable_env_var{"DISABLE_ME"};
+
+    env.add_implicit_layer({}, ManifestLayer{}.set_file_format_version({1, 1, 2}).add_layer(
+                                   ManifestLayer::LayerDescription{}
+                                       .set_name(implicit_layer_name)
+                                       .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                       .set_disable_environment(disable_env_var.get())
+                                       .add_instance_extension({implicit_layer_extension})));
+
+    auto has_layer_extension = [&]() {
+        uint32_t count = 0;
+        EXPECT_EQ(VK_SUCCESS, env.vulkan_functions.vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr));
+        std::vector<VkExtensionProperties> extensions(count);
+        EXPECT_EQ(VK_SUCCESS,
+                  env.vulkan_functions.vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data()));
+        EXPECT_EQ(count, extensions.size());
+        for (const auto& extension : extensions) {
+            if (string_eq(extension.extensionName, implicit_layer_extension)) return true;
+        }
+        return false;
+    };
+    ASSERT_TRUE(has_layer_extension());
+    ASSERT_TRUE(has_layer_extension());
+
+    // The environment variables named by implicit layer manifests are part of what is remembered
+    disable_env_var.set_new_value("1");
+    ASSERT_FALSE(has_layer_extension());
+    disable_env_var.remove_value();
+    ASSERT_TRUE(has_layer_extension());
+
+    // So are the manifests found in each search path. The second manifest is written straight into the folder the first one is
+    // in so that VK_LAYER_PATH stays the same.
+    env.GetLayerProperties(1);
+    env.add_explicit_layer(ManifestOptions{}.set_discovery_type(ManifestDiscoveryType::env_var).set_is_dir(true),
+                           ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                         .set_name("VK_LAYER_ExplicitTestLayer")
+                                                         .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    env.GetLayerProperties(2);
+    env.get_folder(ManifestLocation::explicit_layer_env_var)
+        .write_manifest("second_explicit_layer.json", ManifestLayer{}
+                                                          .add_layer(ManifestLayer::LayerDescription{}
+                                                                         .set_name("VK_LAYER_SecondExplicitTestLayer")
+                                                                         .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2))
+                                                          .get_manifest_str());
+    env.GetLayerProperties(3);
+
+    uint32_t count = 1;
+    VkLayerProperties layer_props{};
+    ASSERT_EQ(VK_INCOMPLETE, env.vulkan_functions.vkEnumerateInstanceLayerProperties(&count, &layer_props));
+    ASSERT_EQ(count, 1U);
+    ASSERT_TRUE(string_eq(layer_props.layerName, implicit_layer_name));
+
+    // A layer which intercepts a pre-instance function is called every time
+    env.add_implicit_layer({},
+                           ManifestLayer{}.set_file_format_version({1, 1, 2}).add_layer(
+                               ManifestLayer::LayerDescription{}
+                                   .set_name("VK_LAYER_ImplicitVersionLayer")
+                                   .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                   .set_disable_environment("DISABLE_ME_TOO")
+                                   .add_pre_instance_function(ManifestLayer::LayerDescription::FunctionOverride{}
+                                                                  .set_vk_func("vkEnumerateInstanceVersion")
+                                                                  .set_override_name("test_preinst_vkEnumerateInstanceVersion"))));
+    auto& version_layer = env.get_test_layer(2);
+    uint32_t version = 0;
+    version_layer.set_reported_instance_version(VK_MAKE_API_VERSION(1, 2, 3, 4));
+    ASSERT_EQ(VK_SUCCESS, env.vulkan_functions.vkEnumerateInstanceVersion(&version));
+    ASSERT_EQ(version, VK_MAKE_API_VERSION(1, 2, 3, 4));
+    version_layer.set_reported_instance_version(VK_MAKE_API_VERSION(1, 2, 3, 5));
+    ASSERT_EQ(VK_SUCCESS, env.vulkan_functions.vkEnumerateInstanceVersion(&version));
+    ASSERT_EQ(version, VK_MAKE_API_VERSION(1, 2, 3, 5));
+}
+
 // Run with a pre-Negotiate function version of the layer so that it has to query vkCreateInstance using the
 // renamed vkGetInstanceProcAddr function which returns one that intentionally fails.  Then disable the
 // layer and verify it works.  The non-override version of vkCreateInstance in the layer also works (and is
@@ -2846,6 +2929,207 @@ TEST(ExplicitLayers, CorrectOrderOfApplicationEnabledLayers) {
     }
 }
 
+// VK_LOADER_LAYER_LIBRARY_CACHE keeps layer libraries loaded after the instance using them is destroyed so the next one reuses them
+TEST(ExplicitLayers, LayerLibraryCache) {
+    EnvVarWrapper layer_library_cache_env_var{"VK_LOADER_LAYER_LIBRARY_CACHE", "60"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+
+    const char* layer_name = "VK_LAYER_RegularLayer";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+
+    ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(1));
+    for (uint32_t i = 0; i < 3; i++) {
+        DebugUtilsLogger log;
+        {
+            InstWrapper inst{env.vulkan_functions};
+            inst.create_info.add_layer(layer_name);
+            FillDebugUtilsCreateDetails(inst.create_info, log);
+            inst.CheckCreate();
+            auto layer_props = inst.GetActiveLayers(inst.GetPhysDev(), 1);
+            ASSERT_TRUE(string_eq(layer_name, layer_props.at(0).layerName));
+        }
+        ASSERT_TRUE(log.find("Releasing cached layer library"));
+        ASSERT_FALSE(log.find("Unloading layer library"));
+        ASSERT_FALSE(log.find("Unloading idle layer library"));
+    }
+}
+
+// Whether the library at path is loaded into the process, without loading it if it isn't
+bool is_library_loaded(std::filesystem::path const& path) {
+#if defined(WIN32)
+    return NULL != GetModuleHandleW(path.native().c_str());
+#elif TESTING_COMMON_UNIX_PLATFORMS
+    void* handle = dlopen(path.c_str(), RTLD_LAZY | RTLD_NOLOAD);
+    if (NULL != handle) {
+        dlclose(handle);
+    }
+    return NULL != handle;
+#endif
+}
+
+// The wrap objects layer is the only layer binary the test framework doesn't load itself, so only the loader keeps it loaded
+TEST(ExplicitLayers, LayerLibraryCacheKeepsLibraryLoadedBetweenInstances) {
+    EnvVarWrapper layer_library_cache_env_var{"VK_LOADER_LAYER_LIBRARY_CACHE", "60"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+
+    const char* wrap_objects_name = "VK_LAYER_LUNARG_wrap_objects";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(wrap_objects_name)
+                                                                            .set_lib_path(TEST_LAYER_WRAP_OBJECTS)));
+    std::string wrap_objects_stem = std::filesystem::path(TEST_LAYER_WRAP_OBJECTS).stem().string();
+    std::filesystem::path wrap_objects_path;
+    for (auto const& entry : std::filesystem::directory_iterator(env.get_folder(ManifestLocation::explicit_layer).location())) {
+        if (entry.path().stem().string().find(wrap_objects_stem) != std::string::npos) {
+            wrap_objects_path = entry.path();
+        }
+    }
+    ASSERT_FALSE(wrap_objects_path.empty());
+
+    for (uint32_t i = 0; i < 2; i++) {
+        DebugUtilsLogger log;
+        {
+            InstWrapper inst{env.vulkan_functions};
+            inst.create_info.add_layer(wrap_objects_name);
+            FillDebugUtilsCreateDetails(inst.create_info, log);
+            inst.CheckCreate();
+        }
+        ASSERT_TRUE(log.find("Releasing cached layer library"));
+        ASSERT_FALSE(log.find("Unloading idle layer library"));
+        ASSERT_TRUE(is_library_loaded(wrap_objects_path));
+    }
+}
+
+// Libraries which were idle for longer than the timeout are unloaded the next time a layer library is loaded
+TEST(ExplicitLayers, LayerLibraryCacheUnloadsIdleLibraries) {
+    EnvVarWrapper layer_library_cache_env_var{"VK_LOADER_LAYER_LIBRARY_CACHE", "1"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+
+    const char* idle_layer_name = "VK_LAYER_IdleLayer";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(idle_layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    const char* other_layer_name = "VK_LAYER_OtherLayer";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(other_layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+
+    {
+        DebugUtilsLogger log;
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(idle_layer_name);
+        FillDebugUtilsCreateDetails(inst.create_info, log);
+        inst.CheckCreate();
+    }
+    // Still within the timeout, so the idle library stays cached
+    {
+        DebugUtilsLogger log;
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(other_layer_name);
+        FillDebugUtilsCreateDetails(inst.create_info, log);
+        inst.CheckCreate();
+        ASSERT_FALSE(log.find("Unloading idle layer library"));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    DebugUtilsLogger log;
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.add_layer(other_layer_name);
+    FillDebugUtilsCreateDetails(inst.create_info, log);
+    inst.CheckCreate();
+    ASSERT_EQ(log.count("Unloading idle layer library"), 2U);
+    ASSERT_TRUE(log.find(std::string("Unloading idle layer library ") + env.get_test_layer_path(0).string()));
+    ASSERT_TRUE(log.find(std::string("Unloading idle layer library ") + env.get_test_layer_path(1).string()));
+}
+
+// Two manifests whose library paths differ but name the same file share one cache entry, so the library is only unloaded once
+TEST(ExplicitLayers, LayerLibraryCacheSharesLibrariesLoadedThroughDifferentPaths) {
+    EnvVarWrapper layer_library_cache_env_var{"VK_LOADER_LAYER_LIBRARY_CACHE", "1"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+
+    const char* first_layer_name = "VK_LAYER_FirstName";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(first_layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    std::filesystem::path first_path = env.get_test_layer_path(0);
+    std::filesystem::path second_path = first_path.parent_path() / "." / first_path.filename();
+    const char* second_layer_name = "VK_LAYER_SecondName";
+    env.write_file_from_string(
+        ManifestLayer{}
+            .add_layer(ManifestLayer::LayerDescription{}.set_name(second_layer_name).set_lib_path(second_path))
+            .get_manifest_str(),
+        ManifestCategory::explicit_layer, ManifestLocation::explicit_layer, "second_name.json");
+    const char* trigger_layer_name = "VK_LAYER_TriggerLayer";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(trigger_layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+
+    for (const char* layer_name : {first_layer_name, second_layer_name}) {
+        DebugUtilsLogger log;
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(layer_name);
+        FillDebugUtilsCreateDetails(inst.create_info, log);
+        inst.CheckCreate();
+        ASSERT_FALSE(log.find("Unloading idle layer library"));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    DebugUtilsLogger log;
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.add_layer(trigger_layer_name);
+    FillDebugUtilsCreateDetails(inst.create_info, log);
+    inst.CheckCreate();
+    ASSERT_EQ(log.count("Unloading idle layer library"), 1U);
+    ASSERT_TRUE(log.find(std::string("Unloading idle layer library ") + first_path.string()));
+}
+
+#if !defined(APPLE_STATIC_LOADER)
+// loader_release() unloads every idle library no matter how recently it was used, and forgets about the ones still in use which
+// are then closed when their instance is destroyed
+TEST(ExplicitLayers, LayerLibraryCacheUnloadsIdleLibrariesOnRelease) {
+    EnvVarWrapper layer_library_cache_env_var{"VK_LOADER_LAYER_LIBRARY_CACHE", "60"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+
+    const char* idle_layer_name = "VK_LAYER_IdleLayer";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(idle_layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    const char* used_layer_name = "VK_LAYER_UsedLayer";
+    env.add_explicit_layer(ManifestOptions{}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                                            .set_name(used_layer_name)
+                                                                            .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+
+    {
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(idle_layer_name);
+        inst.CheckCreate();
+    }
+    DebugUtilsLogger log;
+    {
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(used_layer_name);
+        FillDebugUtilsCreateDetails(inst.create_info, log);
+        inst.CheckCreate();
+
+        env.platform_shim->clear_logs();
+        void (*unload_cached_layer_libraries)(void) =
+            env.vulkan_functions.loader.get_symbol("loader_unload_cached_layer_libraries");
+        unload_cached_layer_libraries();
+        ASSERT_TRUE(
+            env.platform_shim->find_in_log(std::string("Unloading idle layer library ") + env.get_test_layer_path(0).string()));
+        ASSERT_FALSE(env.platform_shim->find_in_log(env.get_test_layer_path(1).string()));
+    }
+    ASSERT_TRUE(log.find(std::string("Releasing cached layer library ") + env.get_test_layer_path(1).string()));
+    ASSERT_FALSE(log.find("Unloading idle layer library"));
+}
+#endif
+
 // Helpers
 bool contains(std::vector<VkExtensionProperties> const& vec, const char* name) {
     return std::any_of(std::begin(vec), std::end(vec),
@@ -5723,3 +6007,179 @@ TEST(TestLayers, AllowFilterWithConditionallyImlicitLayerWithOverrideLayer) {
         ASSERT_NO_FATAL_FAILURE(inst.GetActiveLayers(inst.GetPhysDev(), 0));
     }
 }
+
+#if TESTING_COMMON_UNIX_PLATFORMS
+// The persistent manifest cache is written when the loader is unloaded along with the FrameworkEnvironment, so both the cache and
+// the layer manifests live in folders which outlive it. The manifests are found through VK_LAYER_PATH because the test shim
+// doesn't redirect stat(), which the cache uses to tell whether a manifest changed.
+struct ManifestCacheTestFolders {
+    explicit ManifestCacheTestFolders(std::string const& test_name)
+        : layers(TEST_EXECUTION_DIRECTORY, test_name + "_layers"), cache(TEST_EXECUTION_DIRECTORY, test_name + "_cache") {
+        std::filesystem::create_directories(layers.location());
+        std::filesystem::create_directories(cache.location());
+    }
+
+    // Writes the manifest straight into the folder, so that rewriting it edits the existing file in place
+    void write_layer(std::string const& file_name, std::string const& layer_name, std::string const& description) {
+        std::ofstream file{layers.location() / file_name, std::ios_base::trunc | std::ios_base::out};
+        file << ManifestLayer{}
+                    .add_layer(ManifestLayer::LayerDescription{}
+                                   .set_name(layer_name)
+                                   .set_description(description)
+                                   .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2))
+                    .get_manifest_str();
+    }
+
+    // The cache file is the only file the loader puts into the cache folder
+    std::filesystem::path cache_file() const {
+        std::error_code err;
+        for (auto const& entry : std::filesystem::directory_iterator(cache.location() / "vulkan", err)) {
+            return entry.path();
+        }
+        return {};
+    }
+
+    fs::Folder layers;
+    fs::Folder cache;
+};
+
+struct ManifestCacheRun {
+    std::vector<VkLayerProperties> layers;
+    std::string log;  // Of the first call only, later calls in the same process are served from the cache in memory
+};
+
+// Enumerates the layers with a freshly loaded loader, which has to read the cache file again
+ManifestCacheRun enumerate_layers_with_manifest_cache(ManifestCacheTestFolders const& folders, uint32_t expected_count) {
+    ManifestCacheRun run;
+    EnvVarWrapper manifest_cache_env_var{"VK_LOADER_MANIFEST_CACHE", "1"};
+    FrameworkEnvironment env{};
+    env.add_icd(TEST_ICD_PATH_VERSION_2);
+    EnvVarWrapper layer_path_env_var{"VK_LAYER_PATH", folders.layers.location().string()};
+    EnvVarWrapper cache_home_env_var{"XDG_CACHE_HOME", folders.cache.location().string()};
+    uint32_t count = 0;
+    EXPECT_EQ(VK_SUCCESS, env.vulkan_functions.vkEnumerateInstanceLayerProperties(&count, nullptr));
+    run.log = env.platform_shim->fputs_stderr_log;
+    run.layers = env.GetLayerProperties(expected_count);
+    return run;
+}
+
+bool read_from_manifest_cache(ManifestCacheRun const& run, ManifestCacheTestFolders const& folders, std::string const& file_name) {
+    std::string message = "Using cached contents of layer manifest file " + (folders.layers.location() / file_name).string();
+    return run.log.find(message) != std::string::npos;
+}
+
+TEST(ManifestCache, LaterProcessesUseTheCache) {
+    ManifestCacheTestFolders folders{"ManifestCache_LaterProcessesUseTheCache"};
+    folders.write_layer("layer_a.json", "VK_LAYER_A", "first layer");
+    folders.write_layer("layer_b.json", "VK_LAYER_B", "second layer");
+
+    auto first_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_FALSE(read_from_manifest_cache(first_run, folders, "layer_a.json"));
+    ASSERT_FALSE(read_from_manifest_cache(first_run, folders, "layer_b.json"));
+    ASSERT_FALSE(folders.cache_file().empty());
+
+    auto second_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_TRUE(read_from_manifest_cache(second_run, folders, "layer_a.json"));
+    ASSERT_TRUE(read_from_manifest_cache(second_run, folders, "layer_b.json"));
+    ASSERT_EQ(first_run.layers, second_run.layers);
+}
+
+TEST(ManifestCache, EditedManifestsAreParsedAgain) {
+    ManifestCacheTestFolders folders{"ManifestCache_EditedManifestsAreParsedAgain"};
+    folders.write_layer("layer_a.json", "VK_LAYER_A", "first layer");
+    folders.write_layer("layer_b.json", "VK_LAYER_B", "second layer");
+    enumerate_layers_with_manifest_cache(folders, 2);
+
+    folders.write_layer("layer_b.json", "VK_LAYER_B", "second layer, edited");
+    auto edited_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_TRUE(read_from_manifest_cache(edited_run, folders, "layer_a.json"));
+    ASSERT_FALSE(read_from_manifest_cache(edited_run, folders, "layer_b.json"));
+    for (auto const& layer : edited_run.layers) {
+        if (string_eq(layer.layerName, "VK_LAYER_B")) {
+            ASSERT_TRUE(string_eq(layer.description, "second layer, edited"));
+        }
+    }
+
+    // The edited manifest was stored again
+    auto last_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_TRUE(read_from_manifest_cache(last_run, folders, "layer_b.json"));
+    ASSERT_EQ(edited_run.layers, last_run.layers);
+}
+
+TEST(ManifestCache, CorruptCacheFileIsIgnored) {
+    ManifestCacheTestFolders folders{"ManifestCache_CorruptCacheFileIsIgnored"};
+    folders.write_layer("layer_a.json", "VK_LAYER_A", "first layer");
+    folders.write_layer("layer_b.json", "VK_LAYER_B", "second layer");
+    auto first_run = enumerate_layers_with_manifest_cache(folders, 2);
+    auto cache_file = folders.cache_file();
+    ASSERT_FALSE(cache_file.empty());
+
+    {
+        std::ofstream file{cache_file, std::ios_base::trunc | std::ios_base::out | std::ios_base::binary};
+        file << "this is not a manifest cache";
+    }
+    auto garbage_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_FALSE(read_from_manifest_cache(garbage_run, folders, "layer_a.json"));
+    ASSERT_FALSE(read_from_manifest_cache(garbage_run, folders, "layer_b.json"));
+    ASSERT_EQ(first_run.layers, garbage_run.layers);
+
+    // A cache file cut short keeps working for the entries which are complete, the rest are parsed and written back
+    std::filesystem::resize_file(cache_file, std::filesystem::file_size(cache_file) / 2);
+    auto truncated_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_EQ(first_run.layers, truncated_run.layers);
+
+    auto last_run = enumerate_layers_with_manifest_cache(folders, 2);
+    ASSERT_TRUE(read_from_manifest_cache(last_run, folders, "layer_a.json"));
+    ASSERT_TRUE(read_from_manifest_cache(last_run, folders, "layer_b.json"));
+    ASSERT_EQ(first_run.layers, last_run.layers);
+}
+
+// With VK_LOADER_SCAN_CACHE set, a layer scan with the same inputs as an earlier one reuses its outcome until a manifest or one
+// of the environment variables which decide where layers are searched for changes
+TEST(ScanSnapshot, LayerScanReusedUntilInputsChange) {
+    EnvVarWrapper scan_cache_env_var{"VK_LOADER_SCAN_CACHE", "1"};
+    FrameworkEnvironment env;
+    env.add_icd(TEST_ICD_PATH_VERSION_2);
+    const char* layer_name = "VK_LAYER_ExplicitTestLayer";
+    auto layer_manifest = [&](const char* description) {
+        return ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                             .set_name(layer_name)
+                                             .set_description(description)
+                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2));
+    };
+    env.add_explicit_layer(
+        ManifestOptions{}.set_discovery_type(ManifestDiscoveryType::env_var).set_is_dir(true).set_json_name("explicit_layer.json"),
+        layer_manifest("original"));
+    auto& layer_folder = env.get_folder(ManifestLocation::explicit_layer_env_var);
+    const char* reused_message = "Reusing the results of an earlier explicit layer scan";
+
+    auto create_instance = [&]() {
+        env.platform_shim->clear_logs();
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(layer_name);
+        inst.CheckCreate();
+    };
+    create_instance();
+    create_instance();
+    ASSERT_TRUE(env.platform_shim->find_in_log(reused_message));
+
+    // Editing the manifest in place leaves the folder as it is, only the manifest's own stat() identity changes
+    {
+        std::ofstream file{layer_folder.location() / "explicit_layer.json", std::ios_base::trunc | std::ios_base::out};
+        file << layer_manifest("edited in place").get_manifest_str();
+    }
+    create_instance();
+    ASSERT_FALSE(env.platform_shim->find_in_log(reused_message));
+    auto layer_props = env.GetLayerProperties(1);
+    ASSERT_TRUE(string_eq(layer_props.at(0).description, "edited in place"));
+    create_instance();
+    ASSERT_TRUE(env.platform_shim->find_in_log(reused_message));
+
+    // Environment variables which change where layers are searched for are part of what has to match
+    env.add_env_var_vk_layer_paths.set_new_value(env.get_folder(ManifestLocation::explicit_layer_add_env_var).location().string());
+    create_instance();
+    ASSERT_FALSE(env.platform_shim->find_in_log(reused_message));
+    create_instance();
+    ASSERT_TRUE(env.platform_shim->find_in_log(reused_message));
+}
+#endif  // TESTING_COMMON_UNIX_PLATFORMS
@@ -30,6 +30,8 @@
 #include "manifest_builders.h"
 #include "test_environment.h"
 
+#include <fstream>
+
 // Test case origin
 // LX = lunar exchange
 // LVLGH = loader and validation github
@@ -163,6 +165,38 @@ TEST(CreateInstance, LogsInstanceCreateInfo) {
     ASSERT_TRUE(debug_log.find("VK_EXT_debug_utils"));
 }
 
+// VK_LOADER_PHASE_TIMING logs how long each phase of vkCreateInstance took and VK_LOADER_TRACE_FILE records the same phases
+// as a Chrome trace
+TEST(CreateInstance, PhaseTiming) {
+    std::filesystem::path trace_path = std::filesystem::temp_directory_path() / "loader_phase_timing_test.json";
+    std::filesystem::remove(trace_path);
+    EnvVarWrapper phase_timing_env_var{"VK_LOADER_PHASE_TIMING", "1"};
+    EnvVarWrapper trace_file_env_var{"VK_LOADER_TRACE_FILE", trace_path.string()};
+    {
+        FrameworkEnvironment env{};
+        env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+
+        DebugUtilsLogger debug_log{VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT};
+        InstWrapper inst{env.vulkan_functions};
+        FillDebugUtilsCreateDetails(inst.create_info, debug_log);
+        inst.CheckCreate();
+
+        ASSERT_TRUE(debug_log.find("Phase manifest_discovery"));
+        ASSERT_TRUE(debug_log.find("Phase driver_load"));
+        ASSERT_TRUE(debug_log.find("Phase vkCreateInstance"));
+    }
+
+    std::ifstream trace_file{trace_path};
+    ASSERT_TRUE(trace_file.is_open());
+    std::string contents{std::istreambuf_iterator<char>(trace_file), std::istreambuf_iterator<char>()};
+    trace_file.close();
+    std::filesystem::remove(trace_path);
+
+    ASSERT_EQ(contents.rfind("[\n", 0), 0U);
+    ASSERT_NE(contents.find("{\"name\":\"json_parse\",\"cat\":\"loader\",\"ph\":\"X\""), std::string::npos);
+    ASSERT_NE(contents.find("{\"name\":\"vkCreateInstance\",\"cat\":\"loader\",\"ph\":\"X\""), std::string::npos);
+}
+
 TEST(CreateInstance, ConsecutiveCreate) {
     FrameworkEnvironment env{};
     env.add_icd(TEST_ICD_PATH_VERSION_2);
@@ -686,6 +720,101 @@ TEST(EnumerateDeviceExtensionProperties, ImplicitLayerPresentWithOnlyDuplicateEx
     exercise_EnumerateDeviceExtensionProperties(inst, physical_device, exts);
 }
 
+// Drivers expose hundreds of device extensions, enough for the loader to merge and validate them through a hash set
+TEST(EnumerateDeviceExtensionProperties, ImplicitLayerPresentWithManyDriverExtensions) {
+    FrameworkEnvironment env{};
+    auto& test_physical_device = env.add_icd(TEST_ICD_PATH_VERSION_2).add_and_get_physical_device({});
+
+    std::vector<Extension> exts;
+    for (uint32_t i = 0; i < 300; i++) {
+        exts.emplace_back(std::string("MyDriverExtension") + std::to_string(i), i + 1);
+    }
+    test_physical_device.extensions = exts;
+
+    // Half of the layer extensions are also provided by the driver
+    std::vector<Extension> layer_only_exts;
+    std::vector<ManifestLayer::LayerDescription::Extension> layer_exts;
+    for (uint32_t i = 0; i < 10; i++) {
+        if (i % 2 == 0) {
+            layer_exts.emplace_back(std::string("MyDriverExtension") + std::to_string(i * 30), i * 30 + 1);
+        } else {
+            layer_only_exts.emplace_back(std::string("LayerExtNumba") + std::to_string(i), i + 10);
+            layer_exts.emplace_back(std::string("LayerExtNumba") + std::to_string(i), i + 10);
+        }
+    }
+    env.add_implicit_layer({}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("implicit_layer_name")
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                                             .set_disable_environment("DISABLE_ME")
+                                                             .add_device_extensions({layer_exts})));
+    exts.insert(exts.end(), layer_only_exts.begin(), layer_only_exts.end());
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.CheckCreate();
+
+    VkPhysicalDevice physical_device = inst.GetPhysDev();
+    exercise_EnumerateDeviceExtensionProperties(inst, physical_device, exts);
+
+    {  // Every enumerated extension can be enabled
+        DeviceWrapper dev{inst};
+        for (auto& ext : exts) {
+            dev.create_info.add_extension(ext.extensionName.c_str());
+        }
+        dev.CheckCreate(physical_device);
+    }
+    {  // But not one nobody provides
+        DeviceWrapper dev{inst};
+        for (auto& ext : exts) {
+            dev.create_info.add_extension(ext.extensionName.c_str());
+        }
+        dev.create_info.add_extension("NotPresent");
+        dev.CheckCreate(physical_device, VK_ERROR_EXTENSION_NOT_PRESENT);
+    }
+}
+
+TEST(EnumerateDeviceExtensionProperties, DriverExtensionsQueriedOncePerInstance) {
+    FrameworkEnvironment env{};
+    auto& test_physical_device = env.add_icd(TEST_ICD_PATH_VERSION_2).add_and_get_physical_device("physical_device_0");
+    test_physical_device.add_extensions({{"MyExtension0", 4}, {"MyExtension1", 7}});
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.CheckCreate();
+    VkPhysicalDevice physical_device = inst.GetPhysDev();
+
+    auto first_exts = inst.EnumerateDeviceExtensions(physical_device, 2);
+
+    // The instance keeps using the snapshot it took of the driver's extensions
+    test_physical_device.add_extension({"MyExtension2", 1});
+    auto second_exts = inst.EnumerateDeviceExtensions(physical_device, 2);
+    ASSERT_EQ(first_exts.size(), second_exts.size());
+    for (size_t i = 0; i < first_exts.size(); i++) {
+        ASSERT_TRUE(string_eq(first_exts[i].extensionName, second_exts[i].extensionName));
+        ASSERT_EQ(first_exts[i].specVersion, second_exts[i].specVersion);
+    }
+
+    // Smaller arrays are still reported as incomplete when served from the snapshot
+    uint32_t extension_count = 1;
+    std::array<VkExtensionProperties, 1> partial_exts{};
+    ASSERT_EQ(VK_INCOMPLETE,
+              inst->vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, partial_exts.data()));
+    ASSERT_EQ(extension_count, 1U);
+    ASSERT_TRUE(string_eq(partial_exts[0].extensionName, "MyExtension0"));
+
+    // Extensions enabled at device creation are checked against the same snapshot
+    DeviceWrapper dev{inst};
+    dev.create_info.add_extension("MyExtension1");
+    dev.CheckCreate(physical_device);
+
+    DeviceWrapper dev_missing{inst};
+    dev_missing.create_info.add_extension("MyExtension2");
+    dev_missing.CheckCreate(physical_device, VK_ERROR_EXTENSION_NOT_PRESENT);
+
+    // A new instance queries the driver again
+    InstWrapper inst2{env.vulkan_functions};
+    inst2.CheckCreate();
+    inst2.EnumerateDeviceExtensions(inst2.GetPhysDev(), 3);
+}
+
 TEST(EnumeratePhysicalDevices, OneCall) {
     FrameworkEnvironment env{};
     auto& driver = env.add_icd(TEST_ICD_PATH_VERSION_2).set_min_icd_interface_version(5);
@@ -1244,14 +1373,14 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
         physical_device.properties.vendorID = 0x2000 + i;
     }
 
-    InstWrapper inst{env.vulkan_functions};
-    inst.CheckCreate();
-
     uint32_t physical_count = static_cast<uint32_t>(driver.physical_devices.size());
 
+    // The filters are read when the instance is created
     // filter multiple device by device id
     {
         env.env_var_vk_loader_device_id_filter.set_new_value("0x1001-0x1003,0x1006");
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1264,6 +1393,8 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
     // filter multiple device by vendor id
     {
         env.env_var_vk_loader_vendor_id_filter.set_new_value("0x2001-0x2003,0x2006");
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1277,6 +1408,8 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
     {
         env.env_var_vk_loader_device_id_filter.set_new_value("0x1002-0x1004");
         env.env_var_vk_loader_vendor_id_filter.set_new_value("0x2003-0x2007");
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1289,6 +1422,9 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
 
     // return value change by device filter
     {
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
+
         uint32_t returned_physical_count = 5;
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
         ASSERT_EQ(VK_INCOMPLETE, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
@@ -1296,7 +1432,14 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
 
         env.env_var_vk_loader_device_id_filter.set_new_value("0x1003-0x1004");
 
-        ASSERT_EQ(VK_SUCCESS, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
+        // An existing instance keeps the filters it was created with
+        ASSERT_EQ(VK_INCOMPLETE, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
+        ASSERT_EQ(5, returned_physical_count);
+
+        InstWrapper filtered_inst{env.vulkan_functions};
+        filtered_inst.CheckCreate();
+        ASSERT_EQ(VK_SUCCESS, filtered_inst->vkEnumeratePhysicalDevices(filtered_inst, &returned_physical_count,
+                                                                        physical_device_handles.data()));
         ASSERT_EQ(2, returned_physical_count);
 
         env.env_var_vk_loader_device_id_filter.remove_value();
@@ -1304,6 +1447,9 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
 
     // return value change by vendor filter
     {
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
+
         uint32_t returned_physical_count = 5;
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
         ASSERT_EQ(VK_INCOMPLETE, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
@@ -1311,7 +1457,10 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
 
         env.env_var_vk_loader_vendor_id_filter.set_new_value("0x2005-0x2006");
 
-        ASSERT_EQ(VK_SUCCESS, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
+        InstWrapper filtered_inst{env.vulkan_functions};
+        filtered_inst.CheckCreate();
+        ASSERT_EQ(VK_SUCCESS, filtered_inst->vkEnumeratePhysicalDevices(filtered_inst, &returned_physical_count,
+                                                                        physical_device_handles.data()));
         ASSERT_EQ(2, returned_physical_count);
 
         env.env_var_vk_loader_vendor_id_filter.remove_value();
@@ -1320,6 +1469,8 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
     // incomplete result with device filter
     {
         env.env_var_vk_loader_device_id_filter.set_new_value("0x1001-0x1006");
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = 3;
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1332,6 +1483,8 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
     // filter all device
     {
         env.env_var_vk_loader_device_id_filter.set_new_value("0x2002-0x2003");
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1345,6 +1498,8 @@ TEST(EnumeratePhysicalDevices, DeviceFiltering) {
     {
         env.env_var_vk_loader_vendor_id_filter.remove_value();
         env.env_var_vk_loader_device_id_filter.remove_value();
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1366,15 +1521,14 @@ TEST(EnumeratePhysicalDevices, DeviceFilteringByDriverId) {
         physical_device.driver_properties.driverID = VkDriverId(100 + i);
     }
 
-    InstWrapper inst{env.vulkan_functions};
-    inst.create_info.set_api_version(VK_API_VERSION_1_1);
-    inst.CheckCreate();
-
     uint32_t physical_count = static_cast<uint32_t>(driver.physical_devices.size());
 
     // filter multiple device by driver id
     {
         env.env_var_vk_loader_driver_id_filter.set_new_value("103-105,107");
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1386,6 +1540,10 @@ TEST(EnumeratePhysicalDevices, DeviceFilteringByDriverId) {
 
     // return value change by driver filter
     {
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        inst.CheckCreate();
+
         uint32_t returned_physical_count = 5;
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
         ASSERT_EQ(VK_INCOMPLETE, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
@@ -1393,7 +1551,11 @@ TEST(EnumeratePhysicalDevices, DeviceFilteringByDriverId) {
 
         env.env_var_vk_loader_driver_id_filter.set_new_value("103-104");
 
-        ASSERT_EQ(VK_SUCCESS, inst->vkEnumeratePhysicalDevices(inst, &returned_physical_count, physical_device_handles.data()));
+        InstWrapper filtered_inst{env.vulkan_functions};
+        filtered_inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        filtered_inst.CheckCreate();
+        ASSERT_EQ(VK_SUCCESS, filtered_inst->vkEnumeratePhysicalDevices(filtered_inst, &returned_physical_count,
+                                                                        physical_device_handles.data()));
         ASSERT_EQ(2, returned_physical_count);
 
         env.env_var_vk_loader_driver_id_filter.remove_value();
@@ -1402,6 +1564,9 @@ TEST(EnumeratePhysicalDevices, DeviceFilteringByDriverId) {
     // incomplete result with driver filter
     {
         env.env_var_vk_loader_driver_id_filter.set_new_value("102-105");
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = 3;
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1414,6 +1579,9 @@ TEST(EnumeratePhysicalDevices, DeviceFilteringByDriverId) {
     // filter all device
     {
         env.env_var_vk_loader_driver_id_filter.set_new_value("50");
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        inst.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1423,13 +1591,12 @@ TEST(EnumeratePhysicalDevices, DeviceFilteringByDriverId) {
         env.env_var_vk_loader_driver_id_filter.remove_value();
     }
 
-    InstWrapper inst_1_0{env.vulkan_functions};
-    inst_1_0.create_info.set_api_version(VK_API_VERSION_1_0);
-    inst_1_0.CheckCreate();
-
     // Unsupported device filtering by driver id
     {
         env.env_var_vk_loader_driver_id_filter.set_new_value("103-105,107");
+        InstWrapper inst_1_0{env.vulkan_functions};
+        inst_1_0.create_info.set_api_version(VK_API_VERSION_1_0);
+        inst_1_0.CheckCreate();
 
         uint32_t returned_physical_count = static_cast<uint32_t>(driver.physical_devices.size());
         std::vector<VkPhysicalDevice> physical_device_handles = std::vector<VkPhysicalDevice>(physical_count);
@@ -1599,6 +1766,46 @@ TEST(CreateDevice, ConsecutiveCreateWithoutDestruction) {
     }
 }
 
+// vkGetDeviceQueue2 has to find the instance of the device, make sure that keeps working as devices come and go
+TEST(CreateDevice, LookupDevicesAfterDestroyingSome) {
+    FrameworkEnvironment env{};
+    auto& driver = env.add_icd(TEST_ICD_PATH_VERSION_2).set_icd_api_version(VK_API_VERSION_1_1);
+
+    for (uint32_t i = 0; i < 100; i++) {
+        driver.add_physical_device("physical_device_0");
+    }
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.set_api_version(VK_API_VERSION_1_1);
+    inst.CheckCreate();
+
+    auto phys_devs = inst.GetPhysDevs(100);
+
+    std::vector<std::unique_ptr<DeviceWrapper>> devices;
+    for (uint32_t i = 0; i < 100; i++) {
+        devices.emplace_back(std::make_unique<DeviceWrapper>(inst));
+        devices.back()->CheckCreate(phys_devs[i]);
+    }
+    for (auto& dev : devices) {
+        ASSERT_NE(nullptr, dev->load("vkGetDeviceQueue2"));
+    }
+    // Destroy every third device, then recreate them
+    for (uint32_t i = 0; i < 100; i += 3) {
+        devices[i].reset();
+    }
+    for (uint32_t i = 0; i < 100; i++) {
+        if (devices[i]) {
+            ASSERT_NE(nullptr, devices[i]->load("vkGetDeviceQueue2"));
+        }
+    }
+    for (uint32_t i = 0; i < 100; i += 3) {
+        devices[i] = std::make_unique<DeviceWrapper>(inst);
+        devices[i]->CheckCreate(phys_devs[i]);
+    }
+    for (auto& dev : devices) {
+        ASSERT_NE(nullptr, dev->load("vkGetDeviceQueue2"));
+    }
+}
+
 TEST(TryLoadWrongBinaries, WrongICD) {
     FrameworkEnvironment env{};
     env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_0");
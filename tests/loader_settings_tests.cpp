@@ -29,6 +29,11 @@
 
 #include <fstream>
 
+#if TESTING_COMMON_UNIX_PLATFORMS
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "util/get_executable_path.h"
 #include "util/json_writer.h"
 #include "util/test_defines.h"
@@ -3857,3 +3862,190 @@ TEST(SettingsFile, CyclicMetaLayerComponentDoesNotRecurse) {
     inst.CheckCreate();
     ASSERT_TRUE(env.debug_log.find("recursively references itself through its component layers"));
 }
+
+// Messages matching the filters of a "log_locations" element are written to its destinations
+TEST(SettingsFile, LogLocationsWriteToFile) {
+    FrameworkEnvironment env{};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+    std::filesystem::path log_path = std::filesystem::temp_directory_path() / "loader_settings_log_locations_test.txt";
+    std::filesystem::remove(log_path);
+
+    env.update_loader_settings(env.loader_settings.set_file_format_version({1, 0, 0}).add_app_specific_setting(
+        AppSpecificSettings{}.add_log_configuration(
+            LoaderLogConfiguration{}.add_destination(log_path.string()).add_filter("driver").add_filter("error"))));
+    {
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
+    }
+
+    // Replacing the log locations writes out everything queued for the old ones before closing them
+    env.loader_settings.app_specific_settings.at(0).log_configurations.clear();
+    env.loader_settings.app_specific_settings.at(0).add_stderr_log_filter("error");
+    env.update_loader_settings(env.loader_settings);
+    ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(0));
+
+    std::ifstream log_file{log_path};
+    ASSERT_TRUE(log_file.is_open());
+    std::string contents{std::istreambuf_iterator<char>(log_file), std::istreambuf_iterator<char>()};
+    log_file.close();
+    std::filesystem::remove(log_path);
+
+    EXPECT_NE(contents.find("[Vulkan Loader] DRIVER:         Searching for driver manifest files\n"), std::string::npos);
+    // Debug messages, like the ones describing the settings, don't pass the filters
+    EXPECT_EQ(contents.find("Loader Settings Filters for Logging to"), std::string::npos);
+}
+
+#if TESTING_COMMON_UNIX_PLATFORMS && !defined(__APPLE__)
+// The settings file is only read again once stat() reports a different file, size, or modification time. The test shim doesn't
+// redirect stat(), so the settings file lives in a real folder that XDG_CONFIG_HOME points to.
+TEST(SettingsFile, UnchangedFileOnDiskIsNotReadAgain) {
+    FrameworkEnvironment env{};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+    env.loader_settings.set_file_format_version({1, 0, 0}).add_app_specific_setting(AppSpecificSettings{});
+    const char* layer_name = add_layer_and_settings(env, "VK_LAYER_TestLayer_0", LayerType::exp, "on");
+
+    fs::Folder config_home{TEST_EXECUTION_DIRECTORY, "SettingsFile_UnchangedFileOnDiskIsNotReadAgain"};
+    std::filesystem::path settings_folder = config_home.location() / "vulkan" / "loader_settings.d";
+    std::filesystem::create_directories(settings_folder);
+    std::filesystem::path settings_path = settings_folder / "vk_loader_settings.json";
+    // Rewrites the file in place, keeping its inode
+    auto write_settings_file = [&]() {
+        std::ofstream file{settings_path, std::ios_base::trunc | std::ios_base::out};
+        file << get_loader_settings_file_contents(env.loader_settings);
+    };
+    write_settings_file();
+    EnvVarWrapper xdg_config_home_env_var{"XDG_CONFIG_HOME", config_home.location().string()};
+    std::string read_message = "Reading loader settings file " + settings_path.string();
+
+    ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(1));
+    ASSERT_TRUE(env.platform_shim->find_in_log(read_message));
+
+    env.platform_shim->clear_logs();
+    for (uint32_t i = 0; i < 3; i++) {
+        ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(1));
+    }
+    {
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(layer_name);
+        inst.CheckCreate();
+        ASSERT_NO_FATAL_FAILURE(inst.GetActiveLayers(inst.GetPhysDev(), 1));
+    }
+    ASSERT_FALSE(env.platform_shim->find_in_log(read_message));
+
+    // "off" is longer than "on", so the edit is noticed even if the modification time doesn't change
+    env.loader_settings.app_specific_settings.at(0).layer_configurations.at(0).set_control("off");
+    write_settings_file();
+    ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(0));
+    ASSERT_TRUE(env.platform_shim->find_in_log(read_message));
+    {
+        InstWrapper inst{env.vulkan_functions};
+        inst.create_info.add_layer(layer_name);
+        ASSERT_NO_FATAL_FAILURE(inst.CheckCreate(VK_ERROR_LAYER_NOT_PRESENT));
+    }
+}
+#endif  // TESTING_COMMON_UNIX_PLATFORMS && !defined(__APPLE__)
+
+// A "stderr" log location is written by the thread that logs, so the messages are there as soon as the call returns
+TEST(SettingsFile, LogLocationsWriteToStderrSynchronously) {
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+    env.update_loader_settings(env.loader_settings.set_file_format_version({1, 0, 0}).add_app_specific_setting(
+        AppSpecificSettings{}.add_stderr_log_filter("error").add_log_configuration(
+            LoaderLogConfiguration{}.add_destination("stderr").add_filter("driver"))));
+    for (uint32_t i = 0; i < 3; i++) {
+        env.platform_shim->clear_logs();
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
+        ASSERT_TRUE(env.platform_shim->find_in_log("[Vulkan Loader] DRIVER:         Searching for driver manifest files\n"));
+    }
+}
+
+#if TESTING_COMMON_UNIX_PLATFORMS
+// The child of a fork() doesn't have the writer thread of the log locations, so it has to write its messages itself
+TEST(SettingsFile, LogLocationsWriteToFileAfterFork) {
+    FrameworkEnvironment env{};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+    std::filesystem::path log_path = std::filesystem::temp_directory_path() / "loader_settings_log_locations_fork_test.txt";
+    std::filesystem::remove(log_path);
+
+    env.update_loader_settings(env.loader_settings.set_file_format_version({1, 0, 0}).add_app_specific_setting(
+        AppSpecificSettings{}.add_log_configuration(
+            LoaderLogConfiguration{}.add_destination(log_path.string()).add_filter("driver"))));
+    {
+        InstWrapper inst{env.vulkan_functions};
+        inst.CheckCreate();
+    }
+
+    pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (0 == child) {
+        // Only the exit code tells the parent how it went, and the loader tears down its globals on exit like it does in the
+        // parent, which must not wait on the parent's writer thread either
+        VkInstance instance = VK_NULL_HANDLE;
+        InstanceCreateInfo create_info{};
+        if (VK_SUCCESS != env.vulkan_functions.vkCreateInstance(create_info.get(), nullptr, &instance)) {
+            exit(1);
+        }
+        env.vulkan_functions.vkDestroyInstance(instance, nullptr);
+        exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    // Flushes the parent's messages by replacing the log locations
+    env.loader_settings.app_specific_settings.at(0).log_configurations.clear();
+    env.update_loader_settings(env.loader_settings);
+    ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(0));
+
+    std::ifstream log_file{log_path};
+    ASSERT_TRUE(log_file.is_open());
+    std::string contents{std::istreambuf_iterator<char>(log_file), std::istreambuf_iterator<char>()};
+    log_file.close();
+    std::filesystem::remove(log_path);
+
+    // Once from the parent's instance and once from the child's
+    std::string message = "[Vulkan Loader] DRIVER:         Searching for driver manifest files\n";
+    size_t first = contents.find(message);
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(contents.find(message, first + message.size()), std::string::npos);
+}
+#endif  // TESTING_COMMON_UNIX_PLATFORMS
+
+// The settings file is only parsed again once it changes, which has to be noticed between calls both with and without
+// VK_LOADER_SETTINGS_WATCH watching it
+TEST(SettingsFile, ChangesBetweenCallsAreHonored) {
+    for (const char* watch : {"0", "1"}) {
+        EnvVarWrapper watch_env_var{"VK_LOADER_SETTINGS_WATCH", watch};
+        FrameworkEnvironment env{};
+        env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device({});
+        env.loader_settings.set_file_format_version({1, 0, 0}).add_app_specific_setting(AppSpecificSettings{});
+        const char* layer_name = add_layer_and_settings(env, "VK_LAYER_TestLayer_0", LayerType::exp, "on");
+        env.update_loader_settings(env.loader_settings);
+        for (uint32_t i = 0; i < 3; i++) {
+            auto layer_props = env.GetLayerProperties(1);
+            ASSERT_TRUE(string_eq(layer_props.at(0).layerName, layer_name));
+        }
+
+        env.loader_settings.app_specific_settings.at(0).layer_configurations.at(0).set_control("off");
+        env.update_loader_settings(env.loader_settings);
+        for (uint32_t i = 0; i < 3; i++) {
+            ASSERT_NO_FATAL_FAILURE(env.GetLayerProperties(0));
+        }
+        {
+            InstWrapper inst{env.vulkan_functions};
+            inst.create_info.add_layer(layer_name);
+            ASSERT_NO_FATAL_FAILURE(inst.CheckCreate(VK_ERROR_LAYER_NOT_PRESENT));
+        }
+
+        env.loader_settings.app_specific_settings.at(0).layer_configurations.at(0).set_control("on");
+        env.update_loader_settings(env.loader_settings);
+        {
+            InstWrapper inst{env.vulkan_functions};
+            inst.create_info.add_layer(layer_name);
+            inst.CheckCreate();
+            ASSERT_NO_FATAL_FAILURE(inst.GetActiveLayers(inst.GetPhysDev(), 1));
+        }
+    }
+}
@@ -27,6 +27,7 @@
 
 #include "test_environment.h"
 
+#include <atomic>
 #include <thread>
 
 void create_destroy_instance_loop_with_function_queries(FrameworkEnvironment* env, uint32_t num_loops_create_destroy_instance,
@@ -172,3 +173,362 @@ TEST(Threading, SetDebugUtilsNameCreateDestroyLoop) {
         set_debug_name_threads[i].join();
     }
 }
+
+void create_destroy_surface_loop(uint32_t num_loops, InstWrapper* inst, std::vector<VkPhysicalDevice> const* phys_devs) {
+    for (uint32_t i = 0; i < num_loops; i++) {
+        VkSurfaceKHR surface{};
+        VkHeadlessSurfaceCreateInfoEXT create_info{VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT};
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkCreateHeadlessSurfaceEXT(inst->inst, &create_info, nullptr, &surface));
+        // Makes the loader create each driver's surface while other threads grow the same lists
+        for (auto const& phys_dev : *phys_devs) {
+            VkBool32 supported = VK_FALSE;
+            ASSERT_EQ(VK_SUCCESS, inst->functions->vkGetPhysicalDeviceSurfaceSupportKHR(phys_dev, 0, surface, &supported));
+            ASSERT_EQ(VK_TRUE, supported);
+        }
+        inst->functions->vkDestroySurfaceKHR(inst->inst, surface, nullptr);
+    }
+}
+
+// Surfaces are tracked per instance, creating and destroying them on many threads and instances at once must not lose any
+TEST(Threading, SurfaceCreateDestroyLoop) {
+    const auto processor_count = std::thread::hardware_concurrency();
+    uint32_t num_loops = 200;
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    for (uint32_t i = 0; i < 2; i++) {
+        auto& driver = env.add_icd(TEST_ICD_PATH_VERSION_2);
+        driver.add_instance_extensions({{VK_KHR_SURFACE_EXTENSION_NAME}, {VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME}});
+        driver.set_min_icd_interface_version(5);
+        driver.enable_icd_wsi = true;
+        driver.add_and_get_physical_device("physical_device_" + std::to_string(i))
+            .add_queue_family_properties({{VK_QUEUE_GRAPHICS_BIT, 1, 0, {1, 1, 1}}, true});
+    }
+
+    std::vector<InstWrapper> instances;
+    std::vector<std::vector<VkPhysicalDevice>> phys_devs;
+    for (uint32_t i = 0; i < 2; i++) {
+        auto& inst = instances.emplace_back(env.vulkan_functions);
+        inst.create_info.add_extensions({VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME});
+        inst.CheckCreate();
+        phys_devs.push_back(inst.GetPhysDevs(2));
+    }
+
+    std::vector<std::thread> surface_threads;
+    for (uint32_t i = 0; i < processor_count; i++) {
+        surface_threads.emplace_back(create_destroy_surface_loop, num_loops, &instances[i % 2], &phys_devs[i % 2]);
+    }
+    for (uint32_t i = 0; i < processor_count; i++) {
+        surface_threads[i].join();
+    }
+}
+
+void enumerate_physical_devices_loop(uint32_t num_loops, InstWrapper* inst, uint32_t expected_count) {
+    for (uint32_t i = 0; i < num_loops; i++) {
+        uint32_t count = 0;
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDevices(inst->inst, &count, nullptr));
+        ASSERT_EQ(count, expected_count);
+        std::vector<VkPhysicalDevice> phys_devs(count);
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDevices(inst->inst, &count, phys_devs.data()));
+        ASSERT_EQ(count, expected_count);
+
+        uint32_t group_count = 0;
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDeviceGroups(inst->inst, &group_count, nullptr));
+        std::vector<VkPhysicalDeviceGroupProperties> groups(group_count, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES});
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDeviceGroups(inst->inst, &group_count, groups.data()));
+        ASSERT_EQ(group_count, expected_count);
+
+        // Physical devices handed out by an earlier call must stay usable while other threads enumerate again
+        DeviceWrapper dev{*inst};
+        dev.CheckCreate(phys_devs[i % count]);
+    }
+}
+
+// Enumerating physical devices on one instance must neither block nor corrupt the physical devices of others
+TEST(Threading, EnumeratePhysicalDevicesLoop) {
+    const auto processor_count = std::thread::hardware_concurrency();
+    uint32_t num_loops = 200;
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    for (uint32_t i = 0; i < 2; i++) {
+        env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA)
+            .add_and_get_physical_device("physical_device_" + std::to_string(i))
+            .add_queue_family_properties({{VK_QUEUE_GRAPHICS_BIT, 1, 0, {1, 1, 1}}, true});
+    }
+
+    std::vector<InstWrapper> instances;
+    for (uint32_t i = 0; i < 2; i++) {
+        auto& inst = instances.emplace_back(env.vulkan_functions);
+        inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        inst.CheckCreate();
+    }
+
+    std::vector<std::thread> enumerate_threads;
+    for (uint32_t i = 0; i < processor_count; i++) {
+        enumerate_threads.emplace_back(enumerate_physical_devices_loop, num_loops, &instances[i % 2], 2);
+    }
+    for (uint32_t i = 0; i < processor_count; i++) {
+        enumerate_threads[i].join();
+    }
+}
+
+void enumerate_physical_devices_without_devices_loop(std::atomic<bool>* done, InstWrapper* inst, uint32_t expected_count) {
+    while (!done->load()) {
+        uint32_t count = 0;
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDevices(inst->inst, &count, nullptr));
+        ASSERT_EQ(count, expected_count);
+        std::vector<VkPhysicalDevice> phys_devs(count);
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDevices(inst->inst, &count, phys_devs.data()));
+        ASSERT_EQ(count, expected_count);
+
+        uint32_t group_count = 0;
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDeviceGroups(inst->inst, &group_count, nullptr));
+        std::vector<VkPhysicalDeviceGroupProperties> groups(group_count, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES});
+        ASSERT_EQ(VK_SUCCESS, inst->functions->vkEnumeratePhysicalDeviceGroups(inst->inst, &group_count, groups.data()));
+        ASSERT_EQ(group_count, expected_count);
+    }
+}
+
+// A layer calling vkEnumeratePhysicalDevices down the chain from vkCreateDevice reaches the terminator without the lock the
+// trampoline takes, so the terminator must keep it apart from applications enumerating on other threads
+TEST(Threading, LayerEnumeratesPhysicalDevicesWhileApplicationDoes) {
+    const auto processor_count = std::thread::hardware_concurrency();
+    uint32_t num_loops = 100;
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    for (uint32_t i = 0; i < 2; i++) {
+        env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA)
+            .add_and_get_physical_device("physical_device_" + std::to_string(i))
+            .add_queue_family_properties({{VK_QUEUE_GRAPHICS_BIT, 1, 0, {1, 1, 1}}, true});
+    }
+    const char* layer_name = "VK_LAYER_enumerating_layer";
+    env.add_explicit_layer(ManifestOptions{}.set_json_name("enumerating_layer.json"),
+                           ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                         .set_name(layer_name)
+                                                         .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    env.get_test_layer().set_create_device_callback([](TestLayer& layer) -> VkResult {
+        for (uint32_t i = 0; i < 10; i++) {
+            uint32_t count = 0;
+            VkResult res = layer.instance_dispatch_table.EnumeratePhysicalDevices(layer.instance_handle, &count, nullptr);
+            if (res != VK_SUCCESS || count != 2) {
+                return VK_ERROR_INITIALIZATION_FAILED;
+            }
+            std::vector<VkPhysicalDevice> phys_devs(count);
+            res = layer.instance_dispatch_table.EnumeratePhysicalDevices(layer.instance_handle, &count, phys_devs.data());
+            if (res != VK_SUCCESS || count != 2) {
+                return VK_ERROR_INITIALIZATION_FAILED;
+            }
+        }
+        return VK_SUCCESS;
+    });
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.set_api_version(VK_API_VERSION_1_1).add_layer(layer_name);
+    inst.CheckCreate();
+    auto phys_devs = inst.GetPhysDevs(2);
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> enumerate_threads;
+    for (uint32_t i = 0; i < processor_count; i++) {
+        enumerate_threads.emplace_back(enumerate_physical_devices_without_devices_loop, &done, &inst, 2);
+    }
+    // The test layer's device bookkeeping isn't thread safe, so only this thread creates devices
+    for (uint32_t i = 0; i < num_loops; i++) {
+        DeviceWrapper dev{inst};
+        dev.CheckCreate(phys_devs[i % 2]);
+    }
+    done = true;
+    for (uint32_t i = 0; i < processor_count; i++) {
+        enumerate_threads[i].join();
+    }
+}
+
+void query_functions_loop(uint32_t num_loops, InstWrapper* inst, DeviceWrapper* dev) {
+    for (uint32_t i = 0; i < num_loops; i++) {
+        PFN_vkEnumeratePhysicalDevices enum_pd = inst->load("vkEnumeratePhysicalDevices");
+        ASSERT_NE(enum_pd, nullptr);
+        // vkGetDeviceQueue2 has to look up which instance the device belongs to
+        PFN_vkGetDeviceQueue2 get_device_queue2 = dev->load("vkGetDeviceQueue2");
+        ASSERT_NE(get_device_queue2, nullptr);
+    }
+}
+
+// Lookups of existing instances and devices should not be disturbed by other threads creating and destroying them
+TEST(Threading, FunctionQueriesDuringInstanceCreateDestroyLoop) {
+    const auto processor_count = std::thread::hardware_concurrency();
+
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    auto& driver = env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA);
+    driver.add_and_get_physical_device("physical_device_0")
+        .known_device_functions.push_back({"vkCmdBindPipeline", to_vkVoidFunction(test_vkCmdBindPipeline)});
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.set_api_version(VK_API_VERSION_1_1);
+    inst.CheckCreate();
+    DeviceWrapper dev{inst};
+    dev.CheckCreate(inst.GetPhysDev());
+
+    std::vector<std::thread> instance_creation_threads;
+    std::vector<std::thread> function_query_threads;
+    for (uint32_t i = 0; i < processor_count; i++) {
+        instance_creation_threads.emplace_back(create_destroy_instance_loop_with_function_queries, &env, 20, 5, 5);
+        function_query_threads.emplace_back(query_functions_loop, 1000, &inst, &dev);
+    }
+    for (uint32_t i = 0; i < processor_count; i++) {
+        instance_creation_threads[i].join();
+        function_query_threads[i].join();
+    }
+}
+
+void create_enumerate_destroy_instance_loop(uint32_t num_loops, FrameworkEnvironment* env) {
+    for (uint32_t i = 0; i < num_loops; i++) {
+        InstWrapper inst{env->vulkan_functions};
+        inst.create_info.set_api_version(VK_API_VERSION_1_1);
+        inst.CheckCreate();
+        // Enumerating the physical devices removes the driver which doesn't have any from the instance
+        inst.GetPhysDev();
+    }
+}
+
+// Drivers without physical devices are removed from an instance while other threads walk the drivers of every instance to
+// find the device a function is queried for
+TEST(Threading, DeviceLookupsWhileDriversWithoutPhysicalDevicesAreRemoved) {
+    const auto processor_count = std::thread::hardware_concurrency();
+
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA).add_physical_device("physical_device_0");
+    env.add_icd(TEST_ICD_PATH_VERSION_2);
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.create_info.set_api_version(VK_API_VERSION_1_1);
+    inst.CheckCreate();
+    DeviceWrapper dev{inst};
+    dev.CheckCreate(inst.GetPhysDev());
+
+    std::vector<std::thread> enumerate_threads;
+    std::vector<std::thread> function_query_threads;
+    for (uint32_t i = 0; i < processor_count; i++) {
+        enumerate_threads.emplace_back(create_enumerate_destroy_instance_loop, 20, &env);
+        function_query_threads.emplace_back(query_functions_loop, 1000, &inst, &dev);
+    }
+    for (uint32_t i = 0; i < processor_count; i++) {
+        enumerate_threads[i].join();
+        function_query_threads[i].join();
+    }
+}
+
+std::vector<std::string> get_physical_device_names(FrameworkEnvironment& env) {
+    InstWrapper inst{env.vulkan_functions};
+    inst.CheckCreate();
+    std::vector<std::string> names;
+    for (auto physical_device : inst.GetPhysDevs()) {
+        VkPhysicalDeviceProperties props{};
+        inst->vkGetPhysicalDeviceProperties(physical_device, &props);
+        names.push_back(props.deviceName);
+    }
+    return names;
+}
+
+// Opening drivers on worker threads must not change which drivers are used nor the order of their physical devices
+TEST(Threading, WorkerThreadsLoadDriversInManifestOrder) {
+    FrameworkEnvironment env{};
+    for (uint32_t i = 0; i < 6; i++) {
+        if (i == 2) {
+            // Doesn't export any of the driver entrypoints, so it has to be skipped
+            env.add_icd(TEST_ICD_PATH_EXPORT_NONE);
+        }
+        env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device(std::string("physical_device_") + std::to_string(i));
+    }
+
+    auto serial_names = get_physical_device_names(env);
+    ASSERT_EQ(serial_names.size(), 6U);
+
+    EnvVarWrapper worker_threads_env_var{"VK_LOADER_WORKER_THREADS", "4"};
+    auto parallel_names = get_physical_device_names(env);
+    ASSERT_EQ(serial_names, parallel_names);
+}
+
+std::vector<VkLayerProperties> enumerate_layers(FrameworkEnvironment& env) {
+    uint32_t count = 0;
+    EXPECT_EQ(VK_SUCCESS, env.vulkan_functions.vkEnumerateInstanceLayerProperties(&count, nullptr));
+    std::vector<VkLayerProperties> layers{count};
+    EXPECT_EQ(VK_SUCCESS, env.vulkan_functions.vkEnumerateInstanceLayerProperties(&count, layers.data()));
+    layers.resize(count);
+    return layers;
+}
+
+// Parsing layer manifests on worker threads must find the same layers in the same order, keeping the same one of each set of
+// duplicates. How long it takes is measured by the ParseLayerManifests benchmark.
+TEST(Threading, WorkerThreadsParseLayerManifestsInOrder) {
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_0");
+
+    const uint32_t manifest_count = 300;
+    for (uint32_t i = 0; i < manifest_count; i++) {
+        // Every tenth manifest duplicates the name of the one before it
+        uint32_t name_index = i % 10 == 9 ? i - 1 : i;
+        env.add_explicit_layer(ManifestOptions{}.set_json_name("explicit_layer_" + std::to_string(i) + ".json"),
+                               ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_explicit_" + std::to_string(name_index))
+                                                             .set_description("from manifest " + std::to_string(i))
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    }
+    env.get_folder(ManifestLocation::explicit_layer).write_manifest("explicit_layer_invalid.json", "{ \"file_format_version\": ");
+
+    auto serial_layers = enumerate_layers(env);
+    ASSERT_EQ(serial_layers.size(), manifest_count - manifest_count / 10);
+
+    EnvVarWrapper worker_threads_env_var{"VK_LOADER_WORKER_THREADS", "8"};
+    auto parallel_layers = enumerate_layers(env);
+    ASSERT_EQ(serial_layers.size(), parallel_layers.size());
+    for (size_t i = 0; i < serial_layers.size(); i++) {
+        ASSERT_TRUE(string_eq(serial_layers[i].layerName, parallel_layers[i].layerName));
+        ASSERT_TRUE(string_eq(serial_layers[i].description, parallel_layers[i].description));
+    }
+}
+
+// Allocation callbacks which remember whether they were ever called from a thread other than the one that created them
+struct ThreadCheckingAllocator {
+    std::thread::id owner = std::this_thread::get_id();
+    std::atomic<uint32_t> call_count{0};
+    std::atomic<bool> called_from_other_thread{false};
+
+    void record_call() {
+        call_count++;
+        if (std::this_thread::get_id() != owner) {
+            called_from_other_thread = true;
+        }
+    }
+    static VKAPI_ATTR void* VKAPI_CALL allocate(void* pUserData, size_t size, size_t, VkSystemAllocationScope) {
+        static_cast<ThreadCheckingAllocator*>(pUserData)->record_call();
+        return malloc(size);
+    }
+    static VKAPI_ATTR void* VKAPI_CALL reallocate(void* pUserData, void* pOriginal, size_t size, size_t, VkSystemAllocationScope) {
+        static_cast<ThreadCheckingAllocator*>(pUserData)->record_call();
+        return realloc(pOriginal, size);
+    }
+    static VKAPI_ATTR void VKAPI_CALL free_memory(void* pUserData, void* pMemory) {
+        static_cast<ThreadCheckingAllocator*>(pUserData)->record_call();
+        free(pMemory);
+    }
+    VkAllocationCallbacks get() { return VkAllocationCallbacks{this, allocate, reallocate, free_memory, nullptr, nullptr}; }
+};
+
+// The application's allocation callbacks don't have to be thread safe, so the worker threads must never call them
+TEST(Threading, WorkerThreadsDontUseApplicationAllocator) {
+    FrameworkEnvironment env{FrameworkSettings{}.set_log_filter("")};
+    env.add_icd(TEST_ICD_PATH_VERSION_2).add_physical_device("physical_device_0");
+    for (uint32_t i = 0; i < 20; i++) {
+        env.add_explicit_layer(ManifestOptions{}.set_json_name("explicit_layer_" + std::to_string(i) + ".json"),
+                               ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_explicit_" + std::to_string(i))
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)));
+    }
+    EnvVarWrapper worker_threads_env_var{"VK_LOADER_WORKER_THREADS", "8"};
+
+    ThreadCheckingAllocator allocator;
+    VkAllocationCallbacks callbacks = allocator.get();
+    {
+        InstWrapper inst{env.vulkan_functions, &callbacks};
+        inst.create_info.add_layer("VK_LAYER_explicit_19");
+        inst.CheckCreate();
+    }
+    ASSERT_GT(allocator.call_count.load(), 0U);
+    ASSERT_FALSE(allocator.called_from_other_thread.load());
+}
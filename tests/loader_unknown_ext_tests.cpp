@@ -1295,3 +1295,61 @@ TEST(UnknownFunction, PhysicalDeviceFunctionInLayer) {
 
     unknown_func.check<Functions::four::physical_device>(env.vulkan_functions, inst.inst, phys_dev);
 }
+
+// Query the whole unknown function tables many times, every repeated query must hand back the same pointer that the first
+// query did, and names nobody supports must keep returning NULL.
+TEST(UnknownFunction, RepeatedQueriesOfManyFunctions) {
+    FrameworkEnvironment env{};
+    auto& pd = env.add_icd(TEST_ICD_PATH_VERSION_2_EXPORT_ICD_GPDPA).add_and_get_physical_device({});
+    env.add_implicit_layer({}, ManifestLayer{}.add_layer(ManifestLayer::LayerDescription{}
+                                                             .set_name("VK_LAYER_implicit_layer_unknown_function_passthrough")
+                                                             .set_lib_path(TEST_LAYER_PATH_EXPORT_VERSION_2)
+                                                             .set_disable_environment("DISABLE_ME")));
+    uint32_t function_count = MAX_NUM_UNKNOWN_EXTS;
+    const uint32_t query_rounds = 20;
+
+    std::vector<std::string> phys_dev_function_names;
+    add_function_names(phys_dev_function_names, function_count);
+    fill_implementation_functions(pd.custom_physical_device_functions, phys_dev_function_names, custom_physical_device_functions{},
+                                  function_count);
+    std::vector<std::string> device_function_names;
+    for (uint32_t i = 0; i < function_count; i++) {
+        device_function_names.push_back(std::string("vkUnknownDeviceFunctionTEST_") + std::to_string(i));
+    }
+    for (auto const& name : device_function_names) {
+        pd.known_device_functions.push_back(VulkanFunction{name, to_vkVoidFunction(custom_functions<VkDevice>::func_zero)});
+    }
+
+    InstWrapper inst{env.vulkan_functions};
+    inst.CheckCreate();
+    VkPhysicalDevice phys_dev = inst.GetPhysDev();
+    DeviceWrapper dev{inst};
+    dev.CheckCreate(phys_dev);
+
+    std::vector<PFN_vkVoidFunction> phys_dev_functions;
+    for (auto const& name : phys_dev_function_names) {
+        phys_dev_functions.push_back(inst.load(name.c_str()));
+        ASSERT_NE(phys_dev_functions.back(), nullptr);
+    }
+    std::vector<PFN_vkVoidFunction> device_functions;
+    for (auto const& name : device_function_names) {
+        device_functions.push_back(dev.load(name.c_str()));
+        ASSERT_NE(device_functions.back(), nullptr);
+    }
+
+    for (uint32_t round = 0; round < query_rounds; round++) {
+        for (uint32_t i = 0; i < function_count; i++) {
+            ASSERT_EQ(phys_dev_functions[i], static_cast<PFN_vkVoidFunction>(inst.load(phys_dev_function_names[i].c_str())));
+            ASSERT_EQ(device_functions[i], static_cast<PFN_vkVoidFunction>(dev.load(device_function_names[i].c_str())));
+        }
+        ASSERT_EQ(nullptr, static_cast<PFN_vkVoidFunction>(inst.load("vkNotSupportedByAnyoneTEST")));
+        ASSERT_EQ(nullptr, static_cast<PFN_vkVoidFunction>(dev.load("vkNotSupportedByAnyoneTEST")));
+    }
+
+    check_custom_functions(env.vulkan_functions, inst.inst, phys_dev, custom_physical_device_functions{}, phys_dev_function_names,
+                           function_count);
+    for (uint32_t i = 0; i < function_count; i++) {
+        auto returned_func = reinterpret_cast<decltype(&custom_functions<VkDevice>::func_zero)>(device_functions[i]);
+        EXPECT_EQ(returned_func(dev.dev, i), i);
+    }
+}